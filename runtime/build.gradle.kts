@@ -30,7 +30,32 @@ android {
         targetSdk = 35
         consumerProguardFiles("consumer-rules.pro")
 
+        // Opt-in JNI bridge micro-benchmarks: ./gradlew -Pwaterui.benchmarks=true
+        if (providers.gradleProperty("waterui.benchmarks").orNull == "true") {
+            externalNativeBuild {
+                cmake {
+                    arguments += "-DWATERUI_JNI_BENCHMARKS=ON"
+                }
+            }
+        }
 
+        // Opt-in ATrace instrumentation of the bridge: ./gradlew -Pwaterui.tracing=true
+        if (providers.gradleProperty("waterui.tracing").orNull == "true") {
+            externalNativeBuild {
+                cmake {
+                    arguments += "-DWATERUI_JNI_TRACING=ON"
+                }
+            }
+        }
+
+        // Opt-in live handle tracking for leak reports: ./gradlew -Pwaterui.handleTracking=true
+        if (providers.gradleProperty("waterui.handleTracking").orNull == "true") {
+            externalNativeBuild {
+                cmake {
+                    arguments += "-DWATERUI_JNI_HANDLE_TRACKING=ON"
+                }
+            }
+        }
     }
 
     buildFeatures {
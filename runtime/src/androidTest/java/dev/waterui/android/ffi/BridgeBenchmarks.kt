@@ -0,0 +1,25 @@
+package dev.waterui.android.ffi
+
+/**
+ * Entry point into the native bridge benchmarks compiled into
+ * libwaterui_android.so when built with `-Pwaterui.benchmarks=true`.
+ */
+object BridgeBenchmarks {
+    const val PATH_STR_TO_JSTRING = 0
+    const val PATH_STYLED_STR = 1
+    const val PATH_PRIMITIVE_WATCHER = 2
+    const val PATH_BULK_MEASURE = 3
+    const val PATH_SIZE_STRUCT = 4
+    const val PATH_FLAT_STYLED_STR = 5
+    const val PATH_PICKER_ITEMS = 6
+    const val PATH_LAYOUT_BULK = 7
+    const val PATH_FORCE_AS_BUTTON = 8
+
+    init {
+        System.loadLibrary("waterui_android")
+    }
+
+    /** Runs [path] [iterations] times and returns the elapsed nanoseconds, or -1. */
+    @JvmStatic
+    external fun nativeRun(path: Int, iterations: Int, callback: Any?): Long
+}
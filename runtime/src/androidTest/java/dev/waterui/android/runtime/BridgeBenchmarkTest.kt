@@ -0,0 +1,91 @@
+package dev.waterui.android.runtime
+
+import android.os.Debug
+import android.util.Log
+import androidx.test.ext.junit.runners.AndroidJUnit4
+import dev.waterui.android.ffi.BridgeBenchmarks
+import dev.waterui.android.reactive.FloatWatcherCallback
+import org.junit.Assert.assertTrue
+import org.junit.Assume.assumeTrue
+import org.junit.Before
+import org.junit.Test
+import org.junit.runner.RunWith
+
+/**
+ * Reports ns/call and Java allocations/call for the JNI bridge hot paths.
+ * Skipped unless the native library was built with `-Pwaterui.benchmarks=true`.
+ */
+@RunWith(AndroidJUnit4::class)
+class BridgeBenchmarkTest {
+    private class FloatSink : FloatWatcherCallback {
+        @Volatile
+        var last = 0f
+
+        override fun onFloat(value: Float, metadata: Long) {
+            last = value
+        }
+    }
+
+    @Before
+    fun requireBenchmarks() {
+        val available = try {
+            BridgeBenchmarks.nativeRun(BridgeBenchmarks.PATH_SIZE_STRUCT, 1, null) >= 0
+        } catch (_: UnsatisfiedLinkError) {
+            false
+        }
+        assumeTrue("native benchmarks not compiled in", available)
+    }
+
+    @Test
+    fun strToJString() = run("str_to_jstring", BridgeBenchmarks.PATH_STR_TO_JSTRING)
+
+    @Test
+    fun styledStr() = run("styled_str", BridgeBenchmarks.PATH_STYLED_STR, iterations = 2_000)
+
+    @Test
+    fun flatStyledStr() = run("flat_styled_str", BridgeBenchmarks.PATH_FLAT_STYLED_STR, iterations = 2_000)
+
+    @Test
+    fun primitiveWatcher() =
+        run("primitive_watcher", BridgeBenchmarks.PATH_PRIMITIVE_WATCHER, callback = FloatSink())
+
+    @Test
+    fun bulkMeasure() = run("bulk_measure_200", BridgeBenchmarks.PATH_BULK_MEASURE, iterations = 1_000)
+
+    @Test
+    fun sizeStruct() = run("size_struct", BridgeBenchmarks.PATH_SIZE_STRUCT)
+
+    @Test
+    fun pickerItems() = run("picker_items_8", BridgeBenchmarks.PATH_PICKER_ITEMS, iterations = 1_000)
+
+    @Test
+    fun layoutBulk() = run("layout_bulk_200", BridgeBenchmarks.PATH_LAYOUT_BULK, iterations = 1_000)
+
+    @Test
+    fun forceAsButton() = run("force_as_button", BridgeBenchmarks.PATH_FORCE_AS_BUTTON)
+
+    private fun run(name: String, path: Int, iterations: Int = 20_000, callback: Any? = null) {
+        // Warm up JIT and the native pools before measuring.
+        BridgeBenchmarks.nativeRun(path, iterations / 10, callback)
+
+        Debug.resetThreadAllocCount()
+        Debug.startAllocCounting()
+        val elapsed = BridgeBenchmarks.nativeRun(path, iterations, callback)
+        Debug.stopAllocCounting()
+        val allocs = Debug.getThreadAllocCount()
+
+        assertTrue("benchmark path $path failed", elapsed >= 0)
+        Log.i(
+            TAG,
+            "%s: %.1f ns/call, %.2f allocs/call".format(
+                name,
+                elapsed.toDouble() / iterations,
+                allocs.toDouble() / iterations,
+            ),
+        )
+    }
+
+    private companion object {
+        const val TAG = "WaterUIBench"
+    }
+}
@@ -10,323 +10,59 @@
  */
 
 #include "waterui.h"
+#include "waterui_symbol_table.h"
+#include <android/choreographer.h>
 #include <android/log.h>
+#include <android/looper.h>
 #include <android/native_window.h>
 #include <android/native_window_jni.h>
+#include <android/trace.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cmath>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
+#include <ctime>
 #include <dlfcn.h>
+#include <fcntl.h>
 #include <jni.h>
+#include <mutex>
+#include <pthread.h>
 #include <string>
+#include <unordered_map>
+#include <unistd.h>
+#include <utility>
 #include <vector>
 
 namespace {
 
 constexpr char LOG_TAG[] = "WaterUI.JNI";
 
-// Symbols we need for watcher operations and complex struct handling
-#define WATCHER_SYMBOL_LIST(X)                                                 \
-  X(waterui_drop_watcher_metadata)                                             \
-  X(waterui_new_watcher_guard)                                                 \
-  X(waterui_new_watcher_any_view)                                              \
-  X(waterui_new_watcher_bool)                                                  \
-  X(waterui_new_watcher_f64)                                                   \
-  X(waterui_new_watcher_i32)                                                   \
-  X(waterui_new_watcher_picker_items)                                          \
-  X(waterui_new_watcher_resolved_color)                                        \
-  X(waterui_new_watcher_resolved_font)                                         \
-  X(waterui_new_watcher_str)                                                   \
-  X(waterui_new_watcher_styled_str)                                            \
-  X(waterui_watch_binding_bool)                                                \
-  X(waterui_watch_binding_f64)                                                 \
-  X(waterui_watch_binding_i32)                                                 \
-  X(waterui_watch_binding_str)                                                 \
-  X(waterui_watch_computed_f64)                                                \
-  X(waterui_watch_computed_i32)                                                \
-  X(waterui_watch_computed_resolved_font)                                      \
-  X(waterui_watch_computed_resolved_color)                                     \
-  X(waterui_watch_computed_styled_str)                                         \
-  X(waterui_watch_computed_picker_items)                                       \
-  X(waterui_watch_computed_color_scheme)                                       \
-  X(waterui_new_watcher_color_scheme)                                          \
-  X(waterui_call_watcher_color_scheme)                                         \
-  X(waterui_drop_watcher_color_scheme)                                         \
-  X(waterui_dynamic_connect)                                                   \
-  X(waterui_read_computed_styled_str)                                          \
-  X(waterui_read_computed_picker_items)                                        \
-  X(waterui_read_binding_str)                                                  \
-  X(waterui_set_binding_str)                                                   \
-  X(waterui_set_binding_secure)                                                \
-  X(waterui_secure_field_id)                                                   \
-  X(waterui_force_as_secure_field)                                             \
-  X(waterui_call_watcher_resolved_color)                                       \
-  X(waterui_call_watcher_resolved_font)                                        \
-  X(waterui_drop_watcher_resolved_color)                                       \
-  X(waterui_drop_watcher_resolved_font)                                        \
-  X(waterui_new_computed_resolved_color)                                       \
-  X(waterui_new_computed_resolved_font)                                        \
-  X(waterui_new_computed_color_scheme)                                         \
-  X(waterui_layout_size_that_fits)                                             \
-  X(waterui_layout_place)                                                      \
-  X(waterui_view_id)                                                           \
-  X(waterui_view_stretch_axis)                                                 \
-  X(waterui_force_as_plain)                                                    \
-  X(waterui_empty_id)                                                          \
-  X(waterui_text_id)                                                           \
-  X(waterui_plain_id)                                                          \
-  X(waterui_button_id)                                                         \
-  X(waterui_color_id)                                                          \
-  X(waterui_text_field_id)                                                     \
-  X(waterui_stepper_id)                                                        \
-  X(waterui_date_picker_id)                                                    \
-  X(waterui_color_picker_id)                                                   \
-  X(waterui_progress_id)                                                       \
-  X(waterui_dynamic_id)                                                        \
-  X(waterui_scroll_view_id)                                                    \
-  X(waterui_spacer_id)                                                         \
-  X(waterui_toggle_id)                                                         \
-  X(waterui_slider_id)                                                         \
-  X(waterui_fixed_container_id)                                                \
-  X(waterui_picker_id)                                                         \
-  X(waterui_layout_container_id)                                               \
-  X(waterui_init)                                                              \
-  X(waterui_app)                                                               \
-  X(waterui_view_body)                                                         \
-  X(waterui_clone_env)                                                         \
-  X(waterui_drop_env)                                                          \
-  X(waterui_drop_anyview)                                                      \
-  X(waterui_force_as_button)                                                   \
-  X(waterui_force_as_text)                                                     \
-  X(waterui_force_as_color)                                                    \
-  X(waterui_force_as_text_field)                                               \
-  X(waterui_force_as_toggle)                                                   \
-  X(waterui_force_as_slider)                                                   \
-  X(waterui_force_as_stepper)                                                  \
-  X(waterui_force_as_date_picker)                                              \
-  X(waterui_force_as_color_picker)                                             \
-  X(waterui_force_as_progress)                                                 \
-  X(waterui_force_as_scroll_view)                                              \
-  X(waterui_force_as_picker)                                                   \
-  X(waterui_force_as_layout_container)                                         \
-  X(waterui_force_as_fixed_container)                                          \
-  X(waterui_force_as_dynamic)                                                  \
-  X(waterui_drop_layout)                                                       \
-  X(waterui_drop_action)                                                       \
-  X(waterui_call_action)                                                       \
-  X(waterui_drop_index_action)                                                 \
-  X(waterui_call_index_action)                                                 \
-  X(waterui_drop_move_action)                                                  \
-  X(waterui_call_move_action)                                                  \
-  X(waterui_drop_dynamic)                                                      \
-  X(waterui_drop_color)                                                        \
-  X(waterui_color_from_srgba)                                                  \
-  X(waterui_color_from_linear_rgba_headroom)                                   \
-  X(waterui_drop_font)                                                         \
-  X(waterui_resolve_color)                                                     \
-  X(waterui_resolve_font)                                                      \
-  X(waterui_resolved_font_new)                                                 \
-  X(waterui_drop_box_watcher_guard)                                            \
-  X(waterui_get_animation)                                                     \
-  X(waterui_anyviews_len)                                                      \
-  X(waterui_anyviews_get_view)                                                 \
-  X(waterui_anyviews_get_id)                                                   \
-  X(waterui_drop_anyviews)                                                     \
-  X(waterui_read_binding_bool)                                                 \
-  X(waterui_read_binding_color)                                                \
-  X(waterui_read_binding_f64)                                                  \
-  X(waterui_read_binding_i32)                                                  \
-  X(waterui_set_binding_bool)                                                  \
-  X(waterui_set_binding_color)                                                 \
-  X(waterui_set_binding_f64)                                                   \
-  X(waterui_set_binding_i32)                                                   \
-  X(waterui_drop_binding_bool)                                                 \
-  X(waterui_drop_binding_color)                                                \
-  X(waterui_drop_binding_f64)                                                  \
-  X(waterui_drop_binding_i32)                                                  \
-  X(waterui_drop_binding_str)                                                  \
-  X(waterui_read_binding_date)                                                 \
-  X(waterui_set_binding_date)                                                  \
-  X(waterui_drop_binding_date)                                                 \
-  X(waterui_watch_binding_date)                                                \
-  X(waterui_new_watcher_date)                                                  \
-  X(waterui_read_computed_f64)                                                 \
-  X(waterui_read_computed_i32)                                                 \
-  X(waterui_read_computed_resolved_color)                                      \
-  X(waterui_read_computed_resolved_font)                                       \
-  X(waterui_drop_computed_f64)                                                 \
-  X(waterui_drop_computed_i32)                                                 \
-  X(waterui_drop_computed_resolved_color)                                      \
-  X(waterui_drop_computed_resolved_font)                                       \
-  X(waterui_drop_computed_styled_str)                                          \
-  X(waterui_drop_computed_picker_items)                                        \
-  X(waterui_theme_color_background)                                            \
-  X(waterui_theme_color_surface)                                               \
-  X(waterui_theme_color_surface_variant)                                       \
-  X(waterui_theme_color_border)                                                \
-  X(waterui_theme_color_foreground)                                            \
-  X(waterui_theme_color_muted_foreground)                                      \
-  X(waterui_theme_color_accent)                                                \
-  X(waterui_theme_color_accent_foreground)                                     \
-  X(waterui_theme_font_body)                                                   \
-  X(waterui_theme_font_title)                                                  \
-  X(waterui_theme_font_headline)                                               \
-  X(waterui_theme_font_subheadline)                                            \
-  X(waterui_theme_font_caption)                                                \
-  X(waterui_theme_font_footnote)                                               \
-  X(waterui_theme_install_color)                                               \
-  X(waterui_theme_install_font)                                                \
-  X(waterui_theme_install_color_scheme)                                        \
-  X(waterui_theme_color)                                                       \
-  X(waterui_theme_font)                                                        \
-  X(waterui_theme_color_scheme)                                                \
-  X(waterui_computed_color_scheme_constant)                                    \
-  X(waterui_read_computed_color_scheme)                                        \
-  X(waterui_drop_computed_color_scheme)                                        \
-  X(waterui_metadata_env_id)                                                   \
-  X(waterui_force_as_metadata_env)                                             \
-  X(waterui_metadata_secure_id)                                                \
-  X(waterui_force_as_metadata_secure)                                          \
-  X(waterui_metadata_standard_dynamic_range_id)                                \
-  X(waterui_force_as_metadata_standard_dynamic_range)                          \
-  X(waterui_metadata_high_dynamic_range_id)                                    \
-  X(waterui_force_as_metadata_high_dynamic_range)                              \
-  X(waterui_metadata_gesture_id)                                               \
-  X(waterui_force_as_metadata_gesture)                                         \
-  X(waterui_metadata_lifecycle_hook_id)                                        \
-  X(waterui_force_as_metadata_lifecycle_hook)                                  \
-  X(waterui_metadata_on_event_id)                                              \
-  X(waterui_force_as_metadata_on_event)                                        \
-  X(waterui_metadata_cursor_id)                                                \
-  X(waterui_force_as_metadata_cursor)                                          \
-  X(waterui_metadata_foreground_id)                                            \
-  X(waterui_force_as_metadata_foreground)                                      \
-  X(waterui_metadata_shadow_id)                                                \
-  X(waterui_force_as_metadata_shadow)                                          \
-  X(waterui_metadata_border_id)                                                \
-  X(waterui_force_as_metadata_border)                                          \
-  X(waterui_metadata_focused_id)                                               \
-  X(waterui_force_as_metadata_focused)                                         \
-  X(waterui_metadata_ignore_safe_area_id)                                      \
-  X(waterui_force_as_metadata_ignore_safe_area)                                \
-  X(waterui_metadata_retain_id)                                                \
-  X(waterui_force_as_metadata_retain)                                          \
-  X(waterui_drop_retain)                                                       \
-  X(waterui_metadata_scale_id)                                                 \
-  X(waterui_force_as_metadata_scale)                                           \
-  X(waterui_metadata_rotation_id)                                              \
-  X(waterui_force_as_metadata_rotation)                                        \
-  X(waterui_metadata_offset_id)                                                \
-  X(waterui_force_as_metadata_offset)                                          \
-  X(waterui_metadata_blur_id)                                                  \
-  X(waterui_force_as_metadata_blur)                                            \
-  X(waterui_metadata_brightness_id)                                            \
-  X(waterui_force_as_metadata_brightness)                                      \
-  X(waterui_metadata_saturation_id)                                            \
-  X(waterui_force_as_metadata_saturation)                                      \
-  X(waterui_metadata_contrast_id)                                              \
-  X(waterui_force_as_metadata_contrast)                                        \
-  X(waterui_metadata_hue_rotation_id)                                          \
-  X(waterui_force_as_metadata_hue_rotation)                                    \
-  X(waterui_metadata_grayscale_id)                                             \
-  X(waterui_force_as_metadata_grayscale)                                       \
-  X(waterui_metadata_opacity_id)                                               \
-  X(waterui_force_as_metadata_opacity)                                         \
-  X(waterui_call_lifecycle_hook)                                               \
-  X(waterui_drop_lifecycle_hook)                                               \
-  X(waterui_call_on_event)                                                     \
-  X(waterui_drop_on_event)                                                     \
-  X(waterui_read_computed_cursor_style)                                        \
-  X(waterui_watch_computed_cursor_style)                                       \
-  X(waterui_drop_computed_cursor_style)                                        \
-  X(waterui_new_watcher_cursor_style)                                          \
-  X(waterui_read_computed_color)                                               \
-  X(waterui_photo_id)                                                          \
-  X(waterui_force_as_photo)                                                    \
-  X(waterui_video_id)                                                          \
-  X(waterui_force_as_video)                                                    \
-  X(waterui_video_player_id)                                                   \
-  X(waterui_force_as_video_player)                                             \
-  X(waterui_webview_id)                                                        \
-  X(waterui_force_as_webview)                                                  \
-  X(waterui_webview_native_handle)                                             \
-  X(waterui_drop_web_view)                                                     \
-  X(waterui_read_binding_f32)                                                  \
-  X(waterui_set_binding_f32)                                                   \
-  X(waterui_drop_binding_f32)                                                  \
-  X(waterui_new_watcher_f32)                                                   \
-  X(waterui_watch_binding_f32)                                                 \
-  X(waterui_read_computed_f32)                                                 \
-  X(waterui_watch_computed_f32)                                                \
-  X(waterui_drop_computed_f32)                                                 \
-  X(waterui_read_computed_str)                                                 \
-  X(waterui_watch_computed_str)                                                \
-  X(waterui_drop_computed_str)                                                 \
-  X(waterui_read_computed_video)                                               \
-  X(waterui_watch_computed_video)                                              \
-  X(waterui_drop_computed_video)                                               \
-  X(waterui_new_watcher_video)                                                 \
-  X(waterui_navigation_stack_id)                                               \
-  X(waterui_navigation_view_id)                                                \
-  X(waterui_tabs_id)                                                           \
-  X(waterui_force_as_navigation_stack)                                         \
-  X(waterui_force_as_navigation_view)                                          \
-  X(waterui_force_as_tabs)                                                     \
-  X(waterui_tab_content)                                                       \
-  X(waterui_navigation_controller_new)                                         \
-  X(waterui_env_install_navigation_controller)                                 \
-  X(waterui_drop_navigation_controller)                                        \
-  X(waterui_env_install_webview_controller)                                    \
-  X(waterui_gpu_surface_id)                                                    \
-  X(waterui_force_as_gpu_surface)                                              \
-  X(waterui_gpu_surface_init)                                                  \
-  X(waterui_gpu_surface_render)                                                \
-  X(waterui_gpu_surface_drop)                                                  \
-  X(waterui_list_id)                                                           \
-  X(waterui_list_item_id)                                                      \
-  X(waterui_force_as_list)                                                     \
-  X(waterui_force_as_list_item)                                                \
-  X(waterui_env_install_media_picker_manager)                                  \
-  X(waterui_metadata_clip_shape_id)                                            \
-  X(waterui_force_as_metadata_clip_shape)                                      \
-  X(waterui_metadata_context_menu_id)                                          \
-  X(waterui_force_as_metadata_context_menu)                                    \
-  X(waterui_read_computed_menu_items)                                          \
-  X(waterui_drop_computed_menu_items)                                          \
-  X(waterui_call_shared_action)                                                \
-  X(waterui_drop_shared_action)                                                \
-  X(waterui_menu_id)                                                           \
-  X(waterui_force_as_menu)                                                     \
-  X(waterui_metadata_draggable_id)                                             \
-  X(waterui_force_as_metadata_draggable)                                       \
-  X(waterui_metadata_drop_destination_id)                                      \
-  X(waterui_force_as_metadata_drop_destination)                                \
-  X(waterui_draggable_get_data)                                                \
-  X(waterui_drop_draggable)                                                    \
-  X(waterui_drop_drop_destination)                                             \
-  X(waterui_call_drop_handler)                                                 \
-  X(waterui_call_drop_enter_handler)                                           \
-  X(waterui_call_drop_exit_handler)
-
-struct WatcherSymbols {
-#define DECLARE_SYMBOL(name) decltype(&::name) name = nullptr;
-  WATCHER_SYMBOL_LIST(DECLARE_SYMBOL)
-#undef DECLARE_SYMBOL
-};
+// Groups of the component lists in waterui_symbol_table.h. Component groups
+// are not resolved by nativeInit. Each is resolved on first use through
+// ensure_symbol_group(), so startup only pays for the core list and a library
+// built without a component still starts.
+#define SYMBOL_GROUP_LIST(X)                                                   \
+  X(WebView, WEBVIEW_SYMBOL_LIST, WEBVIEW_TYPE_ID_LIST)                        \
+  X(Video, VIDEO_SYMBOL_LIST, VIDEO_TYPE_ID_LIST)                              \
+  X(Media, MEDIA_SYMBOL_LIST, MEDIA_TYPE_ID_LIST)                              \
+  X(GpuSurface, GPU_SURFACE_SYMBOL_LIST, GPU_SURFACE_TYPE_ID_LIST)             \
+  X(DragDrop, DRAG_DROP_SYMBOL_LIST, DRAG_DROP_TYPE_ID_LIST)
+
+using WatcherSymbols = WuiSymbols;
+using TypeIds = WuiTypeIds;
 
 WatcherSymbols g_sym{};
+TypeIds g_type_ids{};
 bool g_symbols_ready = false;
 
 static JavaVM *g_vm = nullptr;
-static jclass gBooleanClass = nullptr;
-static jmethodID gBooleanValueOf = nullptr;
-static jclass gIntegerClass = nullptr;
-static jmethodID gIntegerValueOf = nullptr;
-static jclass gDoubleClass = nullptr;
-static jmethodID gDoubleValueOf = nullptr;
-static jclass gFloatClass = nullptr;
-static jmethodID gFloatValueOf = nullptr;
+static jclass gObjectClass = nullptr;
 static jclass gLongClass = nullptr;
 static jmethodID gLongValueOf = nullptr;
 static jclass gMetadataClass = nullptr;
@@ -351,7 +87,7 @@ static jmethodID gWebViewWrapperSetRedirectsEnabled = nullptr;
 static jmethodID gWebViewWrapperInjectScript = nullptr;
 static jmethodID gWebViewWrapperSetEventCallback = nullptr;
 static jmethodID gWebViewWrapperRunJavaScript = nullptr;
-static jmethodID gWebViewWrapperRelease = nullptr;
+static jmethodID gWebViewWrapperDispose = nullptr;
 static jclass gNativeWebViewEventCallbackClass = nullptr;
 static jmethodID gNativeWebViewEventCallbackCtor = nullptr;
 static jobject gAppClassLoader = nullptr;
@@ -367,6 +103,282 @@ void throw_unsatisfied(JNIEnv *env, const std::string &message) {
   env->ThrowNew(errorClass, message.c_str());
 }
 
+// ============================================================================
+// Symbol Groups
+// ============================================================================
+
+enum class SymbolGroup : uint8_t {
+#define DECLARE_SYMBOL_GROUP(group, list, ids) group,
+  SYMBOL_GROUP_LIST(DECLARE_SYMBOL_GROUP)
+#undef DECLARE_SYMBOL_GROUP
+  Count
+};
+
+enum : uint8_t { kSymbolGroupPending, kSymbolGroupReady, kSymbolGroupMissing };
+
+// Handle of libwaterui_app.so, kept by nativeInit for lazy resolution.
+void *g_app_handle = nullptr;
+std::mutex g_symbol_group_mutex;
+std::atomic<uint8_t>
+    g_symbol_group_state[static_cast<size_t>(SymbolGroup::Count)]{};
+
+#define CACHE_TYPE_ID(name) g_type_ids.name = g_sym.name();
+
+const char *symbol_group_name(SymbolGroup group) {
+  switch (group) {
+#define SYMBOL_GROUP_NAME(group, list, ids)                                    \
+  case SymbolGroup::group:                                                     \
+    return #group;
+    SYMBOL_GROUP_LIST(SYMBOL_GROUP_NAME)
+#undef SYMBOL_GROUP_NAME
+  case SymbolGroup::Count:
+    break;
+  }
+  return "?";
+}
+
+// Looks up every symbol of a group and caches its type ids. On failure
+// missing names the first absent symbol.
+bool resolve_symbol_group(SymbolGroup group, const char **missing) {
+  switch (group) {
+#define RESOLVE_SYMBOL(name)                                                   \
+  g_sym.name =                                                                 \
+      reinterpret_cast<decltype(&::name)>(dlsym(g_app_handle, #name));         \
+  if (g_sym.name == nullptr) {                                                 \
+    *missing = #name;                                                          \
+    return false;                                                              \
+  }
+#define RESOLVE_SYMBOL_GROUP(group, list, ids)                                 \
+  case SymbolGroup::group:                                                     \
+    list(RESOLVE_SYMBOL) ids(CACHE_TYPE_ID) return true;
+    SYMBOL_GROUP_LIST(RESOLVE_SYMBOL_GROUP)
+#undef RESOLVE_SYMBOL_GROUP
+#undef RESOLVE_SYMBOL
+  case SymbolGroup::Count:
+    break;
+  }
+  return false;
+}
+
+// ========== Symbol Table ==========
+//
+// A library exporting waterui_get_symbol_table hands over every function
+// pointer and type id in one call, replacing the per-symbol dlsym lookups and
+// the type-id calls. The layout is declared in waterui_symbol_table.h, which
+// the Rust exporter is generated from. Null entries mark a component the
+// library was built without.
+
+constexpr uint32_t kSymbolTableAbiVersion = WUI_SYMBOL_TABLE_ABI_VERSION;
+
+using GetSymbolTableFn = decltype(&::waterui_get_symbol_table);
+
+// Reports the first null entry of list in *missing.
+#define CHECK_SYMBOL(name)                                                     \
+  if (g_sym.name == nullptr) {                                                 \
+    *missing = #name;                                                          \
+    return false;                                                              \
+  }
+
+bool core_symbols_present(const char **missing) {
+  WATCHER_SYMBOL_LIST(CHECK_SYMBOL)
+  return true;
+}
+
+bool symbol_group_present(SymbolGroup group, const char **missing) {
+  switch (group) {
+#define CHECK_SYMBOL_GROUP(group, list, ids)                                   \
+  case SymbolGroup::group:                                                     \
+    list(CHECK_SYMBOL) return true;
+    SYMBOL_GROUP_LIST(CHECK_SYMBOL_GROUP)
+#undef CHECK_SYMBOL_GROUP
+  case SymbolGroup::Count:
+    break;
+  }
+  return false;
+}
+
+#undef CHECK_SYMBOL
+
+// Adopts the library's symbol table if it exports one with our ABI version
+// and layout; every group's state is settled up front. Returns false when the
+// caller should fall back to dlsym.
+bool adopt_symbol_table(void *handle) {
+  auto getTable = reinterpret_cast<GetSymbolTableFn>(
+      dlsym(handle, "waterui_get_symbol_table"));
+  if (getTable == nullptr) {
+    return false;
+  }
+  const WuiSymbolTable *table = getTable();
+  if (table == nullptr || table->abi_version != kSymbolTableAbiVersion ||
+      table->size != sizeof(WuiSymbolTable)) {
+    __android_log_print(
+        ANDROID_LOG_WARN, LOG_TAG,
+        "Ignoring symbol table (ABI %u, %u bytes; expected %u, %zu bytes)",
+        table != nullptr ? table->abi_version : 0,
+        table != nullptr ? table->size : 0, kSymbolTableAbiVersion,
+        sizeof(WuiSymbolTable));
+    return false;
+  }
+
+  g_sym = table->symbols;
+  g_type_ids = table->type_ids;
+  const char *missing = nullptr;
+  if (!core_symbols_present(&missing)) {
+    __android_log_print(ANDROID_LOG_WARN, LOG_TAG,
+                        "Symbol table lacks core symbol %s", missing);
+    return false;
+  }
+  for (size_t i = 0; i < static_cast<size_t>(SymbolGroup::Count); ++i) {
+    auto group = static_cast<SymbolGroup>(i);
+    bool present = symbol_group_present(group, &missing);
+    if (!present) {
+      __android_log_print(ANDROID_LOG_INFO, LOG_TAG,
+                          "%s symbols unavailable: %s",
+                          symbol_group_name(group), missing);
+    }
+    g_symbol_group_state[i].store(
+        present ? kSymbolGroupReady : kSymbolGroupMissing,
+        std::memory_order_release);
+  }
+  return true;
+}
+
+// ========== Component Kinds ==========
+//
+// Every id in ALL_TYPE_ID_LIST gets a dense tag, its position in the list, so
+// Kotlin can dispatch on an int instead of hashing 128-bit ids. Ids live in a
+// sorted, immutable table published through an atomic pointer, so lookups take
+// no lock. Resolving a symbol group caches new ids and publishes a new table.
+
+#define COUNT_TYPE_ID(name) +1
+constexpr int32_t kComponentKindCount = 0 ALL_TYPE_ID_LIST(COUNT_TYPE_ID);
+#undef COUNT_TYPE_ID
+
+constexpr int32_t kUnknownComponentKind = -1;
+
+struct ComponentKindEntry {
+  WuiTypeId id;
+  int32_t kind;
+};
+
+struct ComponentKindTable {
+  ComponentKindEntry entries[kComponentKindCount];
+  size_t count;
+};
+
+// Superseded tables are never freed: a lookup may still be reading one, and
+// there is at most one per symbol group plus the core table.
+std::atomic<const ComponentKindTable *> g_component_kinds{nullptr};
+
+bool type_id_less(const WuiTypeId &a, const WuiTypeId &b) {
+  return a.high != b.high ? a.high < b.high : a.low < b.low;
+}
+
+// Caller holds g_symbol_group_mutex, which orders writers of g_type_ids. Ids
+// of unresolved groups are zero and left out.
+void publish_component_kinds() {
+  auto *table = new ComponentKindTable();
+  size_t n = 0;
+  int32_t kind = 0;
+#define ADD_COMPONENT_KIND(name)                                               \
+  if (g_type_ids.name.low != 0 || g_type_ids.name.high != 0) {                 \
+    table->entries[n++] = {g_type_ids.name, kind};                             \
+  }                                                                            \
+  ++kind;
+  ALL_TYPE_ID_LIST(ADD_COMPONENT_KIND)
+#undef ADD_COMPONENT_KIND
+  std::sort(table->entries, table->entries + n,
+            [](const ComponentKindEntry &a, const ComponentKindEntry &b) {
+              return type_id_less(a.id, b.id);
+            });
+  table->count = n;
+  g_component_kinds.store(table, std::memory_order_release);
+}
+
+// Dense tag for id, or kUnknownComponentKind for a type outside
+// ALL_TYPE_ID_LIST (or in a group that has not been resolved).
+int32_t component_kind(WuiTypeId id) {
+  const ComponentKindTable *table =
+      g_component_kinds.load(std::memory_order_acquire);
+  if (table == nullptr) {
+    return kUnknownComponentKind;
+  }
+  const ComponentKindEntry *begin = table->entries;
+  const ComponentKindEntry *end = begin + table->count;
+  const ComponentKindEntry *it = std::lower_bound(
+      begin, end, id,
+      [](const ComponentKindEntry &entry, const WuiTypeId &key) {
+        return type_id_less(entry.id, key);
+      });
+  if (it == end || it->id.low != id.low || it->id.high != id.high) {
+    return kUnknownComponentKind;
+  }
+  return it->kind;
+}
+
+// Resolves a component group on first use; later calls are one atomic load.
+// If the app library does not export the group, throws UnsatisfiedLinkError
+// (every time) and returns false; the caller must return straight away.
+bool ensure_symbol_group(JNIEnv *env, SymbolGroup group) {
+  std::atomic<uint8_t> &slot =
+      g_symbol_group_state[static_cast<size_t>(group)];
+  uint8_t state = slot.load(std::memory_order_acquire);
+  if (state == kSymbolGroupPending) {
+    std::lock_guard<std::mutex> lock(g_symbol_group_mutex);
+    state = slot.load(std::memory_order_relaxed);
+    if (state == kSymbolGroupPending) {
+      const char *missing = "libwaterui_app.so not loaded";
+      if (g_app_handle != nullptr && resolve_symbol_group(group, &missing)) {
+        state = kSymbolGroupReady;
+        publish_component_kinds();
+      } else {
+        __android_log_print(ANDROID_LOG_ERROR, LOG_TAG,
+                            "%s symbols unavailable: %s",
+                            symbol_group_name(group), missing);
+        state = kSymbolGroupMissing;
+      }
+      slot.store(state, std::memory_order_release);
+    }
+  }
+  if (state == kSymbolGroupReady) {
+    return true;
+  }
+  std::string message = "WaterUI ";
+  message += symbol_group_name(group);
+  message += " symbols are not available";
+  throw_unsatisfied(env, message);
+  return false;
+}
+
+// Caches the type ids of every component group whose id functions the app
+// library exports, leaving the groups themselves unresolved. The component
+// kind table then knows those ids from the start, and asking for one does not
+// resolve its group (see group_type_id_ready). dlsym path only; a symbol table
+// carries every id already.
+void prefetch_group_type_ids(void *handle) {
+#define PREFETCH_TYPE_ID(name)                                                 \
+  if (auto fn = reinterpret_cast<decltype(&::name)>(dlsym(handle, #name))) {   \
+    g_type_ids.name = fn();                                                    \
+  }
+#define PREFETCH_GROUP_TYPE_IDS(group, list, ids) ids(PREFETCH_TYPE_ID)
+  SYMBOL_GROUP_LIST(PREFETCH_GROUP_TYPE_IDS)
+#undef PREFETCH_GROUP_TYPE_IDS
+#undef PREFETCH_TYPE_ID
+}
+
+// Whether id, a type id of a component in group, can be handed out. A cached
+// id is, unless the group is known to be missing; the group is resolved by
+// the first call that needs its other symbols. Otherwise resolves the group,
+// with UnsatisfiedLinkError pending if that fails.
+bool group_type_id_ready(JNIEnv *env, SymbolGroup group, const WuiTypeId &id) {
+  uint8_t state = g_symbol_group_state[static_cast<size_t>(group)].load(
+      std::memory_order_acquire);
+  if ((id.low != 0 || id.high != 0) && state != kSymbolGroupMissing) {
+    return true;
+  }
+  return ensure_symbol_group(env, group);
+}
+
 void clear_jni_exception(JNIEnv *env, const char *context) {
   if (!env->ExceptionCheck()) {
     return;
@@ -459,29 +471,718 @@ jclass find_app_class(JNIEnv *env, const char *name) {
   return cls;
 }
 
-class ScopedEnv {
+// ============================================================================
+// Struct Class Cache
+// ============================================================================
+
+// Every Kotlin struct the bridge constructs, with its constructor signature.
+// Classes are resolved once through the app ClassLoader in nativeInit and held
+// as global refs, so marshalling never goes through loadClass/GetMethodID.
+#define RUNTIME_PKG "dev/waterui/android/runtime/"
+#define COMPONENTS_PKG "dev/waterui/android/components/"
+
+#define STRUCT_CLASS_LIST(X)                                                   \
+  X(ResolvedColorStruct, RUNTIME_PKG, "(FFFFF)V")                              \
+  X(ResolvedFontStruct, RUNTIME_PKG, "(FI)V")                                  \
+  X(TextStyleStruct, RUNTIME_PKG, "(JZZZJJ)V")                                 \
+  X(StyledChunkStruct, RUNTIME_PKG,                                            \
+    "(Ljava/lang/String;Ldev/waterui/android/runtime/TextStyleStruct;)V")      \
+  X(StyledStrStruct, RUNTIME_PKG,                                              \
+    "([Ldev/waterui/android/runtime/StyledChunkStruct;)V")                     \
+  X(FlatStyledStrStruct, RUNTIME_PKG, "(Ljava/lang/String;[I[J)V")            \
+  X(PickerItemStruct, RUNTIME_PKG,                                             \
+    "(ILdev/waterui/android/runtime/StyledStrStruct;)V")                       \
+  X(PickerItemsDiffStruct, RUNTIME_PKG,                                        \
+    "([I[I[Ldev/waterui/android/runtime/FlatStyledStrStruct;)V")               \
+  X(PlainStruct, RUNTIME_PKG, "([B)V")                                         \
+  X(ProposalStruct, RUNTIME_PKG, "(FF)V")                                      \
+  X(SizeStruct, RUNTIME_PKG, "(FF)V")                                          \
+  X(RectStruct, RUNTIME_PKG, "(FFFF)V")                                        \
+  X(WindowStruct, RUNTIME_PKG, "(JZZJJJJI)V")                                  \
+  X(AppStruct, RUNTIME_PKG, "([Ldev/waterui/android/runtime/WindowStruct;J)V") \
+  X(ButtonStruct, RUNTIME_PKG, "(JJI)V")                                       \
+  X(TextFieldStruct, RUNTIME_PKG, "(JJJI)V")                                   \
+  X(SecureFieldStruct, RUNTIME_PKG, "(JJ)V")                                   \
+  X(ToggleStruct, RUNTIME_PKG, "(JJI)V")                                       \
+  X(SliderStruct, RUNTIME_PKG, "(JJJDDJ)V")                                    \
+  X(StepperStruct, RUNTIME_PKG, "(JJJII)V")                                    \
+  X(DateStruct, RUNTIME_PKG, "(III)V")                                         \
+  X(DateRangeStruct, RUNTIME_PKG,                                              \
+    "(Ldev/waterui/android/runtime/DateStruct;"                                \
+    "Ldev/waterui/android/runtime/DateStruct;)V")                              \
+  X(DatePickerStruct, RUNTIME_PKG,                                             \
+    "(JJLdev/waterui/android/runtime/DateRangeStruct;I)V")                     \
+  X(ColorPickerStruct, RUNTIME_PKG, "(JJZZ)V")                                 \
+  X(ProgressStruct, RUNTIME_PKG, "(JJJI)V")                                    \
+  X(ScrollStruct, RUNTIME_PKG, "(IJ)V")                                        \
+  X(PickerStruct, RUNTIME_PKG, "(JJI)V")                                       \
+  X(LayoutContainerStruct, RUNTIME_PKG, "(JJ)V")                               \
+  X(FixedContainerStruct, RUNTIME_PKG, "(J[J)V")                               \
+  X(MetadataEnvStruct, RUNTIME_PKG, "(JJ)V")                                   \
+  X(MetadataSecureStruct, RUNTIME_PKG, "(J)V")                                 \
+  X(MetadataStandardDynamicRangeStruct, RUNTIME_PKG, "(J)V")                   \
+  X(MetadataHighDynamicRangeStruct, RUNTIME_PKG, "(J)V")                       \
+  X(GestureDataStruct, RUNTIME_PKG, "(IIFFFJJ)V")                              \
+  X(MetadataGestureStruct, RUNTIME_PKG,                                        \
+    "(JILdev/waterui/android/runtime/GestureDataStruct;J)V")                   \
+  X(MetadataLifeCycleHookStruct, RUNTIME_PKG, "(JIJ)V")                        \
+  X(MetadataOnEventStruct, RUNTIME_PKG, "(JIJ)V")                              \
+  X(MetadataCursorStruct, RUNTIME_PKG, "(JJ)V")                                \
+  X(MetadataShadowStruct, RUNTIME_PKG, "(JJFFF)V")                             \
+  X(MetadataBorderStruct, RUNTIME_PKG, "(JJFFZZZZ)V")                          \
+  X(MetadataFocusedStruct, RUNTIME_PKG, "(JJ)V")                               \
+  X(MetadataIgnoreSafeAreaStruct, RUNTIME_PKG, "(JZZZZ)V")                     \
+  X(MetadataRetainStruct, RUNTIME_PKG, "(JJ)V")                                \
+  X(MetadataScaleStruct, RUNTIME_PKG, "(JJJFF)V")                              \
+  X(MetadataRotationStruct, RUNTIME_PKG, "(JJFF)V")                            \
+  X(MetadataOffsetStruct, RUNTIME_PKG, "(JJJ)V")                               \
+  X(MetadataBlurStruct, RUNTIME_PKG, "(JJ)V")                                  \
+  X(MetadataBrightnessStruct, RUNTIME_PKG, "(JJ)V")                            \
+  X(MetadataSaturationStruct, RUNTIME_PKG, "(JJ)V")                            \
+  X(MetadataContrastStruct, RUNTIME_PKG, "(JJ)V")                              \
+  X(MetadataHueRotationStruct, RUNTIME_PKG, "(JJ)V")                           \
+  X(MetadataGrayscaleStruct, RUNTIME_PKG, "(JJ)V")                             \
+  X(MetadataOpacityStruct, RUNTIME_PKG, "(JJ)V")                               \
+  X(PathCommandStruct, RUNTIME_PKG, "(IFFFFFFFFFFFF)V")                        \
+  X(MetadataClipShapeStruct, RUNTIME_PKG,                                      \
+    "(J[Ldev/waterui/android/runtime/PathCommandStruct;)V")                    \
+  X(MetadataContextMenuStruct, RUNTIME_PKG, "(JJ)V")                           \
+  X(MenuStruct, RUNTIME_PKG, "(JJ)V")                                          \
+  X(MenuItemStruct, RUNTIME_PKG, "(JJ)V")                                      \
+  X(PhotoStruct, RUNTIME_PKG, "(Ljava/lang/String;)V")                         \
+  X(VideoStruct2, RUNTIME_PKG, "(JJIZZ)V")                                     \
+  X(VideoPlayerStruct, RUNTIME_PKG, "(JJIZ)V")                                 \
+  X(VideoStruct, RUNTIME_PKG, "(Ljava/lang/String;)V")                         \
+  X(NavigationStackStruct, RUNTIME_PKG, "(J)V")                                \
+  X(BarStruct, RUNTIME_PKG, "(JJJ)V")                                          \
+  X(NavigationViewStruct, RUNTIME_PKG,                                         \
+    "(Ldev/waterui/android/runtime/BarStruct;J)V")                             \
+  X(TabStruct, RUNTIME_PKG, "(JJJ)V")                                          \
+  X(TabsStruct, RUNTIME_PKG, "(J[Ldev/waterui/android/runtime/TabStruct;I)V")  \
+  X(GpuSurfaceStruct, RUNTIME_PKG, "(J)V")                                     \
+  X(ListStruct, RUNTIME_PKG, "(JJJJ)V")                                        \
+  X(ListItemStruct, RUNTIME_PKG, "(JJ)V")                                      \
+  X(MetadataDraggableStruct, COMPONENTS_PKG, "(JJ)V")                          \
+  X(MetadataDropDestinationStruct, COMPONENTS_PKG, "(JJ)V")                    \
+  X(DragDataStruct, COMPONENTS_PKG,                                            \
+    "(Ldev/waterui/android/components/DragDataTag;Ljava/lang/String;)V")
+
+enum class StructClass : size_t {
+#define DECLARE_STRUCT_CLASS(name, pkg, sig) name,
+  STRUCT_CLASS_LIST(DECLARE_STRUCT_CLASS)
+#undef DECLARE_STRUCT_CLASS
+      Count
+};
+
+struct StructClassEntry {
+  const char *path;
+  const char *ctorSig;
+  jclass cls;
+  jmethodID ctor;
+};
+
+StructClassEntry g_struct_classes[] = {
+#define DEFINE_STRUCT_CLASS(name, pkg, sig) {pkg #name, sig, nullptr, nullptr},
+    STRUCT_CLASS_LIST(DEFINE_STRUCT_CLASS)
+#undef DEFINE_STRUCT_CLASS
+};
+
+static_assert(sizeof(g_struct_classes) / sizeof(g_struct_classes[0]) ==
+                  static_cast<size_t>(StructClass::Count),
+              "struct class table out of sync");
+
+// Accessors used when reading structs back from Kotlin
+static jfieldID gSizeStructWidth = nullptr;
+static jfieldID gSizeStructHeight = nullptr;
+static jmethodID gProposalStructGetWidth = nullptr;
+static jmethodID gProposalStructGetHeight = nullptr;
+static jmethodID gRectStructGetX = nullptr;
+static jmethodID gRectStructGetY = nullptr;
+static jmethodID gRectStructGetWidth = nullptr;
+static jmethodID gRectStructGetHeight = nullptr;
+static jfieldID gWatcherStructData = nullptr;
+static jfieldID gWatcherStructCall = nullptr;
+static jfieldID gWatcherStructDrop = nullptr;
+static jclass gSubViewStructClass = nullptr;
+static jfieldID gSubViewStructStretchAxis = nullptr;
+static jfieldID gSubViewStructPriority = nullptr;
+static jmethodID gSubViewStructMeasure = nullptr;
+static jclass gStretchAxisClass = nullptr;
+static jmethodID gStretchAxisGetValue = nullptr;
+
+inline jclass struct_class(StructClass id) {
+  return g_struct_classes[static_cast<size_t>(id)].cls;
+}
+
+jclass new_global_class(JNIEnv *env, const char *name) {
+  jclass local = find_app_class(env, name);
+  if (local == nullptr) {
+    return nullptr;
+  }
+  auto global = static_cast<jclass>(env->NewGlobalRef(local));
+  env->DeleteLocalRef(local);
+  return global;
+}
+
+// Resolves the struct class table and accessor IDs. A missing class is logged
+// and left null rather than failing init, matching the lazy lookups it
+// replaces: only the view types that actually use it are affected.
+void init_struct_classes(JNIEnv *env) {
+  for (auto &entry : g_struct_classes) {
+    if (entry.cls != nullptr) {
+      continue;
+    }
+    entry.cls = new_global_class(env, entry.path);
+    if (entry.cls == nullptr) {
+      __android_log_print(ANDROID_LOG_ERROR, LOG_TAG,
+                          "Failed to resolve struct class %s", entry.path);
+      continue;
+    }
+    entry.ctor = env->GetMethodID(entry.cls, "<init>", entry.ctorSig);
+    if (entry.ctor == nullptr) {
+      clear_jni_exception(env, "resolving struct constructor");
+      __android_log_print(ANDROID_LOG_ERROR, LOG_TAG,
+                          "Failed to resolve constructor %s%s", entry.path,
+                          entry.ctorSig);
+    }
+  }
+
+  auto field = [&](StructClass id, const char *name,
+                   const char *sig) -> jfieldID {
+    jclass cls = struct_class(id);
+    if (cls == nullptr) {
+      return nullptr;
+    }
+    jfieldID fid = env->GetFieldID(cls, name, sig);
+    if (fid == nullptr) {
+      clear_jni_exception(env, "resolving struct field");
+    }
+    return fid;
+  };
+  auto method = [&](jclass cls, const char *name,
+                    const char *sig) -> jmethodID {
+    if (cls == nullptr) {
+      return nullptr;
+    }
+    jmethodID mid = env->GetMethodID(cls, name, sig);
+    if (mid == nullptr) {
+      clear_jni_exception(env, "resolving struct method");
+    }
+    return mid;
+  };
+  gSizeStructWidth = field(StructClass::SizeStruct, "width", "F");
+  gSizeStructHeight = field(StructClass::SizeStruct, "height", "F");
+  gProposalStructGetWidth =
+      method(struct_class(StructClass::ProposalStruct), "getWidth", "()F");
+  gProposalStructGetHeight =
+      method(struct_class(StructClass::ProposalStruct), "getHeight", "()F");
+  gRectStructGetX =
+      method(struct_class(StructClass::RectStruct), "getX", "()F");
+  gRectStructGetY =
+      method(struct_class(StructClass::RectStruct), "getY", "()F");
+  gRectStructGetWidth =
+      method(struct_class(StructClass::RectStruct), "getWidth", "()F");
+  gRectStructGetHeight =
+      method(struct_class(StructClass::RectStruct), "getHeight", "()F");
+  gWatcherStructData = env->GetFieldID(gWatcherStructClass, "dataPtr", "J");
+  gWatcherStructCall = env->GetFieldID(gWatcherStructClass, "callPtr", "J");
+  gWatcherStructDrop = env->GetFieldID(gWatcherStructClass, "dropPtr", "J");
+
+  if (gSubViewStructClass == nullptr) {
+    gSubViewStructClass =
+        new_global_class(env, "dev/waterui/android/runtime/SubViewStruct");
+  }
+  if (gStretchAxisClass == nullptr) {
+    gStretchAxisClass =
+        new_global_class(env, "dev/waterui/android/runtime/StretchAxis");
+  }
+  if (gSubViewStructClass != nullptr) {
+    gSubViewStructStretchAxis =
+        env->GetFieldID(gSubViewStructClass, "stretchAxis",
+                        "Ldev/waterui/android/runtime/StretchAxis;");
+    gSubViewStructPriority =
+        env->GetFieldID(gSubViewStructClass, "priority", "I");
+  }
+  gSubViewStructMeasure =
+      method(gSubViewStructClass, "measureForLayout",
+             "(FF)Ldev/waterui/android/runtime/SizeStruct;");
+  gStretchAxisGetValue = method(gStretchAxisClass, "getValue", "()I");
+  clear_jni_exception(env, "resolving struct accessors");
+}
+
+void release_struct_classes(JNIEnv *env) {
+  for (auto &entry : g_struct_classes) {
+    if (entry.cls != nullptr) {
+      env->DeleteGlobalRef(entry.cls);
+    }
+    entry.cls = nullptr;
+    entry.ctor = nullptr;
+  }
+  if (gSubViewStructClass != nullptr) {
+    env->DeleteGlobalRef(gSubViewStructClass);
+    gSubViewStructClass = nullptr;
+  }
+  if (gStretchAxisClass != nullptr) {
+    env->DeleteGlobalRef(gStretchAxisClass);
+    gStretchAxisClass = nullptr;
+  }
+  gSizeStructWidth = nullptr;
+  gSizeStructHeight = nullptr;
+  gProposalStructGetWidth = nullptr;
+  gProposalStructGetHeight = nullptr;
+  gRectStructGetX = nullptr;
+  gRectStructGetY = nullptr;
+  gRectStructGetWidth = nullptr;
+  gRectStructGetHeight = nullptr;
+  gWatcherStructData = nullptr;
+  gWatcherStructCall = nullptr;
+  gWatcherStructDrop = nullptr;
+  gSubViewStructStretchAxis = nullptr;
+  gSubViewStructPriority = nullptr;
+  gSubViewStructMeasure = nullptr;
+  gStretchAxisGetValue = nullptr;
+}
+
+jobject new_struct(JNIEnv *env, StructClass id, ...) {
+  const StructClassEntry &entry = g_struct_classes[static_cast<size_t>(id)];
+  if (entry.cls == nullptr || entry.ctor == nullptr) {
+    __android_log_print(ANDROID_LOG_ERROR, LOG_TAG,
+                        "Struct class %s is not available", entry.path);
+    return nullptr;
+  }
+  va_list args;
+  va_start(args, id);
+  jobject obj = env->NewObjectV(entry.cls, entry.ctor, args);
+  va_end(args);
+  return obj;
+}
+
+// ============================================================================
+// Tracing
+// ============================================================================
+//
+// Built with WATERUI_JNI_TRACING, bridge entry points open ATrace sections
+// (visible in Perfetto/systrace under the app's own tracing category) and the
+// bridge maintains two counters, published and reset once per frame (see
+// "Counter Publisher"): WaterUI.jniUpcalls (native -> Java method calls) and
+// WaterUI.bytesMarshalled (string/styled text bytes crossing the boundary).
+// Without the flag every macro expands to nothing.
+
+// ATrace_setCounter is API 29; resolved at runtime so older devices still get
+// the sections.
+using ATraceSetCounterFn = void (*)(const char *, int64_t);
+
+ATraceSetCounterFn atrace_set_counter() {
+  static auto setCounter = reinterpret_cast<ATraceSetCounterFn>(
+      dlsym(RTLD_DEFAULT, "ATrace_setCounter"));
+  return setCounter;
+}
+
+#if defined(WATERUI_JNI_TRACING) || defined(WATERUI_JNI_HANDLE_TRACKING)
+void arm_counter_frame();
+#endif
+
+#ifdef WATERUI_JNI_TRACING
+
+class ScopedTrace {
 public:
-  JNIEnv *env = nullptr;
-  bool attached = false;
+  explicit ScopedTrace(const char *name) : active_(ATrace_isEnabled()) {
+    if (active_) {
+      arm_counter_frame();
+      ATrace_beginSection(name);
+    }
+  }
+  ~ScopedTrace() {
+    if (active_) {
+      ATrace_endSection();
+    }
+  }
+  ScopedTrace(const ScopedTrace &) = delete;
+  ScopedTrace &operator=(const ScopedTrace &) = delete;
+
+private:
+  bool active_;
+};
+
+std::atomic<int64_t> g_trace_upcalls{0};
+std::atomic<int64_t> g_trace_bytes{0};
+
+// Returns whether anything was counted since the last call.
+bool trace_publish_counters() {
+  ATraceSetCounterFn setCounter = atrace_set_counter();
+  int64_t upcalls = g_trace_upcalls.exchange(0, std::memory_order_relaxed);
+  int64_t bytes = g_trace_bytes.exchange(0, std::memory_order_relaxed);
+  if (setCounter != nullptr) {
+    setCounter("WaterUI.jniUpcalls", upcalls);
+    setCounter("WaterUI.bytesMarshalled", bytes);
+  }
+  return upcalls != 0 || bytes != 0;
+}
+
+void trace_reset_counters() {
+  g_trace_upcalls.store(0, std::memory_order_relaxed);
+  g_trace_bytes.store(0, std::memory_order_relaxed);
+}
+
+#define WUI_TRACE_CONCAT_INNER(a, b) a##b
+#define WUI_TRACE_CONCAT(a, b) WUI_TRACE_CONCAT_INNER(a, b)
+#define WUI_TRACE_SCOPE(name)                                                  \
+  ScopedTrace WUI_TRACE_CONCAT(wuiTraceScope, __LINE__)(name)
+#define WUI_TRACE_UPCALL()                                                     \
+  g_trace_upcalls.fetch_add(1, std::memory_order_relaxed)
+#define WUI_TRACE_BYTES(count)                                                 \
+  g_trace_bytes.fetch_add(static_cast<int64_t>(count),                         \
+                          std::memory_order_relaxed)
+#define WUI_TRACE_PUBLISH_COUNTERS() trace_publish_counters()
+#define WUI_TRACE_RESET_COUNTERS() trace_reset_counters()
+
+#else
+
+#define WUI_TRACE_SCOPE(name) ((void)0)
+#define WUI_TRACE_UPCALL() ((void)0)
+#define WUI_TRACE_BYTES(count) ((void)0)
+#define WUI_TRACE_PUBLISH_COUNTERS() false
+#define WUI_TRACE_RESET_COUNTERS() ((void)0)
+
+#endif
+
+int64_t monotonic_nanos() {
+  timespec ts{};
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+// ============================================================================
+// Handle Tracking
+// ============================================================================
+//
+// Built with WATERUI_JNI_HANDLE_TRACKING, the bridge records every handle that
+// pins Java or native memory on behalf of the other side: watcher callback
+// states and subview contexts (each holding a global ref), watcher guards
+// handed to Kotlin and WebView handle contexts. Each live handle carries the
+// bridge function that created it, so a leak report names the call site.
+//
+// Drop-to-free latency is the time from the owner asking for a drop to the
+// handle actually being released: a watcher dropped while its emit is being
+// delivered is only freed by the next flush. Counters WaterUI.handles.<kind>
+// (live handles) are published once per frame while they change, and
+// handleTrackerDump() returns a text report. Without the flag every macro
+// expands to nothing and the dump returns null.
+
+#ifdef WATERUI_JNI_HANDLE_TRACKING
+
+enum class HandleKind : uint8_t {
+  WatcherCallback,
+  SubviewRef,
+  WatcherGuard,
+  WebViewContext,
+  Count,
+};
 
-  ScopedEnv() {
-    if (g_vm == nullptr)
+constexpr size_t kHandleKindCount = static_cast<size_t>(HandleKind::Count);
+
+constexpr const char *kHandleKindNames[kHandleKindCount] = {
+    "watcherCallback", "subviewRef", "watcherGuard", "webViewContext"};
+
+constexpr const char *kHandleCounterNames[kHandleKindCount] = {
+    "WaterUI.handles.watcherCallback", "WaterUI.handles.subviewRef",
+    "WaterUI.handles.watcherGuard", "WaterUI.handles.webViewContext"};
+
+// Shown in the dump instead of the full JNI symbol of a creating export.
+const char *short_handle_tag(const char *tag) {
+  if (strncmp(tag, "Java_", 5) != 0) {
+    return tag;
+  }
+  const char *last = strrchr(tag, '_');
+  return last != nullptr ? last + 1 : tag;
+}
+
+class HandleTracker {
+public:
+  void created(HandleKind kind, const void *handle, const char *tag) {
+    if (handle == nullptr) {
       return;
-    if (g_vm->GetEnv(reinterpret_cast<void **>(&env), JNI_VERSION_1_6) !=
-        JNI_OK) {
-      if (g_vm->AttachCurrentThread(&env, nullptr) == JNI_OK) {
-        attached = true;
-      } else {
-        env = nullptr;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    KindStats &stats = stats_[static_cast<size_t>(kind)];
+    auto inserted =
+        live_.emplace(handle, LiveHandle{kind, tag, monotonic_nanos(), 0});
+    if (!inserted.second) {
+      // The previous owner of this address was freed without being tracked.
+      stats_[static_cast<size_t>(inserted.first->second.kind)].live--;
+      inserted.first->second = LiveHandle{kind, tag, monotonic_nanos(), 0};
+    }
+    stats.created++;
+    stats.live++;
+    arm_counter_frame();
+  }
+
+  void drop_requested(const void *handle) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = live_.find(handle);
+    if (it != live_.end() && it->second.dropRequestedNanos == 0) {
+      it->second.dropRequestedNanos = monotonic_nanos();
+    }
+  }
+
+  void freed(HandleKind kind, const void *handle) {
+    if (handle == nullptr) {
+      return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    KindStats &stats = stats_[static_cast<size_t>(kind)];
+    auto it = live_.find(handle);
+    if (it == live_.end() || it->second.kind != kind) {
+      stats.untrackedFrees++;
+      return;
+    }
+    if (it->second.dropRequestedNanos != 0) {
+      int64_t latency = monotonic_nanos() - it->second.dropRequestedNanos;
+      stats.latencyTotalNanos += latency;
+      stats.latencyMaxNanos = std::max(stats.latencyMaxNanos, latency);
+      stats.requestedFrees++;
+    }
+    live_.erase(it);
+    stats.freed++;
+    stats.live--;
+    arm_counter_frame();
+  }
+
+  // Returns whether any live count changed since the last call.
+  bool publish_counters() {
+    ATraceSetCounterFn setCounter = atrace_set_counter();
+    bool changed = false;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < kHandleKindCount; ++i) {
+      changed = changed || stats_[i].live != published_[i];
+      published_[i] = stats_[i].live;
+      if (setCounter != nullptr) {
+        setCounter(kHandleCounterNames[i], stats_[i].live);
+      }
+    }
+    return changed;
+  }
+
+  std::string dump() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int64_t now = monotonic_nanos();
+    std::string out;
+    char line[256];
+    for (size_t i = 0; i < kHandleKindCount; ++i) {
+      const KindStats &stats = stats_[i];
+      int64_t averageNanos =
+          stats.requestedFrees > 0
+              ? stats.latencyTotalNanos / stats.requestedFrees
+              : 0;
+      snprintf(line, sizeof(line),
+               "%s: live=%lld created=%lld freed=%lld untrackedFrees=%lld "
+               "dropToFreeAvgUs=%lld dropToFreeMaxUs=%lld\n",
+               kHandleKindNames[i], static_cast<long long>(stats.live),
+               static_cast<long long>(stats.created),
+               static_cast<long long>(stats.freed),
+               static_cast<long long>(stats.untrackedFrees),
+               static_cast<long long>(averageNanos / 1000),
+               static_cast<long long>(stats.latencyMaxNanos / 1000));
+      out += line;
+    }
+
+    // Live handles grouped by kind and creating function, with the age of the
+    // oldest one: a count that only grows points at a leak.
+    struct SiteStats {
+      HandleKind kind;
+      const char *tag;
+      int64_t count;
+      int64_t oldestNanos;
+      int64_t pendingDrops;
+    };
+    std::vector<SiteStats> sites;
+    for (const auto &entry : live_) {
+      const LiveHandle &handle = entry.second;
+      auto site = std::find_if(sites.begin(), sites.end(),
+                               [&](const SiteStats &candidate) {
+                                 return candidate.kind == handle.kind &&
+                                        candidate.tag == handle.tag;
+                               });
+      if (site == sites.end()) {
+        sites.push_back(SiteStats{handle.kind, handle.tag, 0, now, 0});
+        site = sites.end() - 1;
       }
+      site->count++;
+      site->oldestNanos = std::min(site->oldestNanos, handle.createdNanos);
+      if (handle.dropRequestedNanos != 0) {
+        site->pendingDrops++;
+      }
+    }
+    std::sort(sites.begin(), sites.end(),
+              [](const SiteStats &a, const SiteStats &b) {
+                return a.count > b.count;
+              });
+    for (const SiteStats &site : sites) {
+      snprintf(line, sizeof(line),
+               "  %s %s: live=%lld pendingDrops=%lld oldestMs=%lld\n",
+               kHandleKindNames[static_cast<size_t>(site.kind)],
+               short_handle_tag(site.tag), static_cast<long long>(site.count),
+               static_cast<long long>(site.pendingDrops),
+               static_cast<long long>((now - site.oldestNanos) / 1000000));
+      out += line;
+    }
+    return out;
+  }
+
+private:
+  struct LiveHandle {
+    HandleKind kind;
+    const char *tag; // String literal (__func__ of the creating function)
+    int64_t createdNanos;
+    int64_t dropRequestedNanos; // 0 until a drop is requested
+  };
+
+  struct KindStats {
+    int64_t live = 0;
+    int64_t created = 0;
+    int64_t freed = 0;
+    int64_t untrackedFrees = 0; // Freed without a matching creation
+    int64_t requestedFrees = 0; // Frees preceded by a drop request
+    int64_t latencyTotalNanos = 0;
+    int64_t latencyMaxNanos = 0;
+  };
+
+  std::mutex mutex_;
+  std::unordered_map<const void *, LiveHandle> live_;
+  KindStats stats_[kHandleKindCount];
+  int64_t published_[kHandleKindCount] = {};
+};
+
+HandleTracker g_handle_tracker;
+
+WuiWatcherGuard *track_watcher_guard(WuiWatcherGuard *guard, const char *tag) {
+  g_handle_tracker.created(HandleKind::WatcherGuard, guard, tag);
+  return guard;
+}
+
+#define WUI_TRACK_HANDLE(kind, handle)                                         \
+  g_handle_tracker.created(HandleKind::kind, handle, __func__)
+#define WUI_TRACK_DROP_REQUEST(handle) g_handle_tracker.drop_requested(handle)
+#define WUI_TRACK_FREE(kind, handle)                                           \
+  g_handle_tracker.freed(HandleKind::kind, handle)
+#define WUI_TRACK_GUARD(guard) track_watcher_guard(guard, __func__)
+#define WUI_TRACK_PUBLISH_COUNTERS() g_handle_tracker.publish_counters()
+
+#else
+
+#define WUI_TRACK_HANDLE(kind, handle) ((void)0)
+#define WUI_TRACK_DROP_REQUEST(handle) ((void)0)
+#define WUI_TRACK_FREE(kind, handle) ((void)0)
+#define WUI_TRACK_GUARD(guard) (guard)
+#define WUI_TRACK_PUBLISH_COUNTERS() false
+
+#endif
+
+// ============================================================================
+// Thread Attachment
+// ============================================================================
+//
+// Rust worker threads that call back into Java are attached once and stay
+// attached for the rest of their lifetime; a pthread key destructor detaches
+// them on thread exit. This avoids an AttachCurrentThread/DetachCurrentThread
+// pair (and a new java.lang.Thread peer) per callback.
+
+pthread_key_t g_attach_key;
+pthread_once_t g_attach_key_once = PTHREAD_ONCE_INIT;
+// True on threads attached by attached_env(), which have no Java frame below
+// them, so local references must be scoped by the caller.
+thread_local bool t_native_attached = false;
+
+constexpr size_t kThreadNameMax = 16; // Including NUL, see pthread_setname_np
+// Written by setNativeThreadNamePrefix while Rust threads may be attaching.
+std::mutex g_thread_name_mutex;
+char g_thread_name_prefix[kThreadNameMax] = "WaterUI";
+
+void detach_on_thread_exit(void *) {
+  if (g_vm != nullptr) {
+    g_vm->DetachCurrentThread();
+  }
+}
+
+void create_attach_key() {
+  pthread_key_create(&g_attach_key, detach_on_thread_exit);
+}
+
+// Name used for the Java peer of an attached thread. Keeps the pthread name
+// if the thread already has one (Rust sets it from thread::Builder::name);
+// otherwise names the thread "<prefix>-<tid>" so it is identifiable in traces.
+void attach_thread_name(char (&name)[kThreadNameMax]) {
+  name[0] = '\0';
+  pthread_getname_np(pthread_self(), name, sizeof(name));
+  if (name[0] == '\0') {
+    std::lock_guard<std::mutex> lock(g_thread_name_mutex);
+    snprintf(name, sizeof(name), "%s-%d", g_thread_name_prefix,
+             static_cast<int>(gettid()));
+    pthread_setname_np(pthread_self(), name);
+  }
+}
+
+// Returns the JNIEnv for the current thread, attaching it until thread exit
+// if it is not attached yet. Returns nullptr if attaching fails.
+JNIEnv *attached_env(JavaVM *vm) {
+  if (vm == nullptr)
+    return nullptr;
+  JNIEnv *env = nullptr;
+  if (vm->GetEnv(reinterpret_cast<void **>(&env), JNI_VERSION_1_6) == JNI_OK) {
+    return env;
+  }
+
+  pthread_once(&g_attach_key_once, create_attach_key);
+  char name[kThreadNameMax];
+  attach_thread_name(name);
+  JavaVMAttachArgs args{};
+  args.version = JNI_VERSION_1_6;
+  args.name = name;
+  args.group = nullptr;
+  if (vm->AttachCurrentThread(&env, &args) != JNI_OK) {
+    __android_log_print(ANDROID_LOG_ERROR, LOG_TAG,
+                        "Failed to attach thread %s", name);
+    return nullptr;
+  }
+  // The destructor only runs for non-null values.
+  pthread_setspecific(g_attach_key, env);
+  t_native_attached = true;
+  return env;
+}
+
+// Provides a JNIEnv for the scope of a callback. On natively attached threads
+// the scope also owns a local reference frame and clears any exception left
+// pending, which detaching used to do.
+class ScopedEnv {
+public:
+  JNIEnv *env = nullptr;
+
+  explicit ScopedEnv(JavaVM *vm = g_vm) {
+    env = attached_env(vm);
+    if (env != nullptr && t_native_attached &&
+        env->PushLocalFrame(kLocalFrameCapacity) == JNI_OK) {
+      framePushed = true;
     }
   }
 
   ~ScopedEnv() {
-    if (attached && g_vm != nullptr) {
-      g_vm->DetachCurrentThread();
+    if (env == nullptr || !t_native_attached)
+      return;
+    if (env->ExceptionCheck()) {
+      env->ExceptionDescribe();
+      env->ExceptionClear();
+    }
+    if (framePushed) {
+      env->PopLocalFrame(nullptr);
     }
   }
+
+  ScopedEnv(const ScopedEnv &) = delete;
+  ScopedEnv &operator=(const ScopedEnv &) = delete;
+
+private:
+  static constexpr jint kLocalFrameCapacity = 16;
+  bool framePushed = false;
 };
 
 template <typename T> inline jlong ptr_to_jlong(T *ptr) {
@@ -492,17 +1193,223 @@ template <typename T> inline T *jlong_to_ptr(jlong value) {
   return reinterpret_cast<T *>(value);
 }
 
+// ============================================================================
+// FFI Holder Allocation
+// ============================================================================
+//
+// Holders handed to Rust (string bytes, layout subview arrays) are short-lived:
+// allocated for one crossing or one layout pass and freed by the matching
+// vtable drop. BlockPool recycles those blocks in power-of-two size classes so
+// the measure path does not go through the general-purpose allocator.
+
+class BlockPool {
+public:
+  static constexpr uint8_t kUnpooled = 0xFF;
+
+  // Returns a block of at least size bytes (max_align_t aligned) and the size
+  // class to release it with. Oversized requests fall back to malloc.
+  void *acquire(size_t size, uint8_t *sizeClass) {
+    uint8_t cls = class_for(size);
+    *sizeClass = cls;
+    if (cls == kUnpooled) {
+      return std::malloc(size);
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      FreeBlock *block = freeLists[cls];
+      if (block != nullptr) {
+        freeLists[cls] = block->next;
+        --cached[cls];
+        return block;
+      }
+    }
+    return std::malloc(size_t{1} << (cls + kMinShift));
+  }
+
+  void release(void *block, uint8_t sizeClass) {
+    if (block == nullptr)
+      return;
+    if (sizeClass != kUnpooled) {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (cached[sizeClass] < kMaxCachedPerClass) {
+        auto *node = static_cast<FreeBlock *>(block);
+        node->next = freeLists[sizeClass];
+        freeLists[sizeClass] = node;
+        ++cached[sizeClass];
+        return;
+      }
+    }
+    std::free(block);
+  }
+
+private:
+  static constexpr size_t kMinShift = 6;  // 64 B
+  static constexpr size_t kMaxShift = 16; // 64 KiB
+  static constexpr size_t kClassCount = kMaxShift - kMinShift + 1;
+  static constexpr uint8_t kMaxCachedPerClass = 16;
+
+  struct FreeBlock {
+    FreeBlock *next;
+  };
+
+  static uint8_t class_for(size_t size) {
+    for (size_t shift = kMinShift; shift <= kMaxShift; ++shift) {
+      if (size <= (size_t{1} << shift)) {
+        return static_cast<uint8_t>(shift - kMinShift);
+      }
+    }
+    return kUnpooled;
+  }
+
+  std::mutex mutex;
+  FreeBlock *freeLists[kClassCount] = {};
+  uint8_t cached[kClassCount] = {};
+};
+
+BlockPool g_block_pool;
+
+// Carves typed arrays out of one pooled block.
+class BumpAllocator {
+public:
+  BumpAllocator(void *block, size_t size)
+      : cursor(static_cast<uint8_t *>(block)), end(cursor + size) {}
+
+  // Bytes to request from the pool for the given arrays, including padding.
+  template <typename T> static constexpr size_t bytes_for(size_t count) {
+    return count * sizeof(T) + alignof(T);
+  }
+
+  // Returns zero-initialized storage for count objects of a trivial type T.
+  template <typename T> T *alloc(size_t count) {
+    auto addr = reinterpret_cast<uintptr_t>(cursor);
+    uintptr_t aligned = (addr + alignof(T) - 1) & ~(uintptr_t{alignof(T)} - 1);
+    auto *start = reinterpret_cast<uint8_t *>(aligned);
+    if (start + count * sizeof(T) > end) {
+      return nullptr;
+    }
+    cursor = start + count * sizeof(T);
+    std::memset(start, 0, count * sizeof(T));
+    return reinterpret_cast<T *>(start);
+  }
+
+private:
+  uint8_t *cursor;
+  uint8_t *end;
+};
+
 // ============================================================================
 // String Conversion Utilities
 // ============================================================================
 
+// Decodes standard UTF-8 into UTF-16, writing at most len code units to out
+// (UTF-16 never needs more units than UTF-8 has bytes). Invalid sequences
+// become U+FFFD. Returns the number of code units written.
+size_t utf8_to_utf16(const uint8_t *in, size_t len, jchar *out) {
+  size_t i = 0;
+  size_t n = 0;
+  while (i < len) {
+    uint32_t c = in[i];
+    if (c < 0x80) {
+      out[n++] = static_cast<jchar>(c);
+      ++i;
+      continue;
+    }
+    size_t extra;
+    uint32_t min;
+    if ((c & 0xE0) == 0xC0) {
+      extra = 1;
+      min = 0x80;
+      c &= 0x1F;
+    } else if ((c & 0xF0) == 0xE0) {
+      extra = 2;
+      min = 0x800;
+      c &= 0x0F;
+    } else if ((c & 0xF8) == 0xF0) {
+      extra = 3;
+      min = 0x10000;
+      c &= 0x07;
+    } else {
+      out[n++] = 0xFFFD;
+      ++i;
+      continue;
+    }
+    size_t k = 1;
+    for (; k <= extra && i + k < len; ++k) {
+      uint8_t cont = in[i + k];
+      if ((cont & 0xC0) != 0x80)
+        break;
+      c = (c << 6) | (cont & 0x3F);
+    }
+    if (k <= extra || c < min || c > 0x10FFFF || (c >= 0xD800 && c <= 0xDFFF)) {
+      out[n++] = 0xFFFD;
+      i += k;
+      continue;
+    }
+    i += extra + 1;
+    if (c >= 0x10000) {
+      c -= 0x10000;
+      out[n++] = static_cast<jchar>(0xD800 | (c >> 10));
+      out[n++] = static_cast<jchar>(0xDC00 | (c & 0x3FF));
+    } else {
+      out[n++] = static_cast<jchar>(c);
+    }
+  }
+  return n;
+}
+
+// Encodes UTF-16 (unpaired surrogates become U+FFFD) as standard UTF-8. out
+// must hold 3 bytes per input unit. Returns the number of bytes written.
+size_t utf16_to_utf8(const jchar *in, size_t len, uint8_t *out) {
+  size_t n = 0;
+  for (size_t i = 0; i < len; ++i) {
+    uint32_t c = in[i];
+    if (c >= 0xD800 && c <= 0xDBFF && i + 1 < len && in[i + 1] >= 0xDC00 &&
+        in[i + 1] <= 0xDFFF) {
+      c = 0x10000 + ((c - 0xD800) << 10) + (in[i + 1] - 0xDC00);
+      ++i;
+    } else if (c >= 0xD800 && c <= 0xDFFF) {
+      c = 0xFFFD;
+    }
+    if (c < 0x80) {
+      out[n++] = static_cast<uint8_t>(c);
+    } else if (c < 0x800) {
+      out[n++] = static_cast<uint8_t>(0xC0 | (c >> 6));
+      out[n++] = static_cast<uint8_t>(0x80 | (c & 0x3F));
+    } else if (c < 0x10000) {
+      out[n++] = static_cast<uint8_t>(0xE0 | (c >> 12));
+      out[n++] = static_cast<uint8_t>(0x80 | ((c >> 6) & 0x3F));
+      out[n++] = static_cast<uint8_t>(0x80 | (c & 0x3F));
+    } else {
+      out[n++] = static_cast<uint8_t>(0xF0 | (c >> 18));
+      out[n++] = static_cast<uint8_t>(0x80 | ((c >> 12) & 0x3F));
+      out[n++] = static_cast<uint8_t>(0x80 | ((c >> 6) & 0x3F));
+      out[n++] = static_cast<uint8_t>(0x80 | (c & 0x3F));
+    }
+  }
+  return n;
+}
+
+// Strings up to this many UTF-8 bytes are converted through a stack buffer.
+constexpr size_t kStackStringUnits = 256;
+
+// Rust -> Java: decodes the UTF-8 bytes straight into UTF-16 for NewString.
+// NewStringUTF expects modified UTF-8 and mangles 4-byte sequences (emoji).
 jstring wui_str_to_jstring(JNIEnv *env, WuiStr value) {
   WuiArray_u8 bytes = value._0;
   WuiArraySlice_u8 slice = bytes.vtable.slice(bytes.data);
-  auto *data = static_cast<uint8_t *>(slice.head);
-  std::string utf8(reinterpret_cast<const char *>(data), slice.len);
+  auto *data = static_cast<const uint8_t *>(slice.head);
+
+  jchar stackUnits[kStackStringUnits];
+  std::vector<jchar> heapUnits;
+  jchar *units = stackUnits;
+  if (slice.len > kStackStringUnits) {
+    heapUnits.resize(slice.len);
+    units = heapUnits.data();
+  }
+  size_t count = slice.len > 0 ? utf8_to_utf16(data, slice.len, units) : 0;
   bytes.vtable.drop(bytes.data);
-  return env->NewStringUTF(utf8.c_str());
+  WUI_TRACE_BYTES(slice.len);
+  return env->NewString(units, static_cast<jsize>(count));
 }
 
 jbyteArray wui_str_to_byte_array(JNIEnv *env, WuiStr value) {
@@ -515,6 +1422,7 @@ jbyteArray wui_str_to_byte_array(JNIEnv *env, WuiStr value) {
                             reinterpret_cast<const jbyte *>(data));
   }
   bytes.vtable.drop(bytes.data);
+  WUI_TRACE_BYTES(slice.len);
   return array;
 }
 
@@ -527,9 +1435,12 @@ std::string wui_str_to_std_string(WuiStr value) {
   return utf8;
 }
 
+// Owned byte buffer handed to Rust. The bytes follow the header in the same
+// pooled block.
 struct ByteArrayHolder {
   uint8_t *data;
   size_t len;
+  uint8_t sizeClass;
 };
 
 WuiArraySlice_u8 byte_slice(const void *opaque) {
@@ -544,19 +1455,21 @@ void byte_drop(void *opaque) {
   auto *holder = static_cast<ByteArrayHolder *>(opaque);
   if (holder == nullptr)
     return;
-  std::free(holder->data);
-  std::free(holder);
+  g_block_pool.release(holder, holder->sizeClass);
 }
 
-WuiStr str_from_byte_array(JNIEnv *env, jbyteArray array) {
-  jsize len = env->GetArrayLength(array);
-  auto *holder =
-      static_cast<ByteArrayHolder *>(std::malloc(sizeof(ByteArrayHolder)));
-  holder->len = static_cast<size_t>(len);
-  holder->data = static_cast<uint8_t *>(std::malloc(holder->len));
-  env->GetByteArrayRegion(array, 0, len,
-                          reinterpret_cast<jbyte *>(holder->data));
+// Allocates a holder with room for capacity bytes; len starts at capacity.
+ByteArrayHolder *new_byte_holder(size_t capacity) {
+  uint8_t sizeClass = BlockPool::kUnpooled;
+  auto *holder = static_cast<ByteArrayHolder *>(
+      g_block_pool.acquire(sizeof(ByteArrayHolder) + capacity, &sizeClass));
+  holder->data = reinterpret_cast<uint8_t *>(holder + 1);
+  holder->len = capacity;
+  holder->sizeClass = sizeClass;
+  return holder;
+}
 
+WuiStr wui_str_from_holder(ByteArrayHolder *holder) {
   WuiArray_u8 ffiArray{};
   ffiArray.data = holder;
   ffiArray.vtable.slice = byte_slice;
@@ -567,31 +1480,61 @@ WuiStr str_from_byte_array(JNIEnv *env, jbyteArray array) {
   return str;
 }
 
-WuiStr str_from_jstring(JNIEnv *env, jstring str) {
-  auto *holder =
-      static_cast<ByteArrayHolder *>(std::malloc(sizeof(ByteArrayHolder)));
-  holder->len = 0;
-  holder->data = nullptr;
+WuiStr str_from_byte_array(JNIEnv *env, jbyteArray array) {
+  jsize len = env->GetArrayLength(array);
+  ByteArrayHolder *holder = new_byte_holder(static_cast<size_t>(len));
+  env->GetByteArrayRegion(array, 0, len,
+                          reinterpret_cast<jbyte *>(holder->data));
+  return wui_str_from_holder(holder);
+}
 
-  if (str != nullptr) {
-    const char *chars = env->GetStringUTFChars(str, nullptr);
-    jsize len = env->GetStringUTFLength(str);
-    holder->len = static_cast<size_t>(len);
-    if (holder->len > 0) {
-      holder->data = static_cast<uint8_t *>(std::malloc(holder->len));
-      std::memcpy(holder->data, chars, holder->len);
+// Encodes the UTF-16 chars as standard UTF-8 (not the modified UTF-8
+// GetStringUTFChars produces) into a new holder; a null string encodes as
+// empty. Release with byte_drop unless ownership passes to Rust.
+ByteArrayHolder *utf8_holder_from_jstring(JNIEnv *env, jstring str) {
+  jsize units = str != nullptr ? env->GetStringLength(str) : 0;
+  ByteArrayHolder *holder = new_byte_holder(static_cast<size_t>(units) * 3);
+  holder->len = 0;
+  if (units > 0) {
+    const jchar *chars = env->GetStringCritical(str, nullptr);
+    if (chars != nullptr) {
+      holder->len =
+          utf16_to_utf8(chars, static_cast<size_t>(units), holder->data);
+      env->ReleaseStringCritical(str, chars);
     }
-    env->ReleaseStringUTFChars(str, chars);
   }
+  WUI_TRACE_BYTES(holder->len);
+  return holder;
+}
 
-  WuiArray_u8 ffiArray{};
-  ffiArray.data = holder;
-  ffiArray.vtable.slice = byte_slice;
-  ffiArray.vtable.drop = byte_drop;
+// Java -> Rust: encodes the string directly into the holder Rust will own.
+WuiStr str_from_jstring(JNIEnv *env, jstring str) {
+  return wui_str_from_holder(utf8_holder_from_jstring(env, str));
+}
 
-  WuiStr result{};
-  result._0 = ffiArray;
-  return result;
+// Borrowed view of memory owned by the caller (e.g. a direct ByteBuffer).
+// Only valid for the duration of the JNI call; never hand it to Rust as an
+// owned value.
+struct BorrowedBytes {
+  uint8_t *data;
+  size_t len;
+};
+
+// Borrows the first length bytes of a direct ByteBuffer. Returns false if the
+// buffer is not direct or too small.
+bool borrow_direct_buffer(JNIEnv *env, jobject buffer, jint length,
+                          BorrowedBytes *out) {
+  if (buffer == nullptr || length < 0) {
+    return false;
+  }
+  void *address = env->GetDirectBufferAddress(buffer);
+  jlong capacity = env->GetDirectBufferCapacity(buffer);
+  if (address == nullptr || capacity < length) {
+    return false;
+  }
+  out->data = static_cast<uint8_t *>(address);
+  out->len = static_cast<size_t>(length);
+  return true;
 }
 
 // ============================================================================
@@ -601,15 +1544,24 @@ WuiStr str_from_jstring(JNIEnv *env, jstring str) {
 struct WatcherCallbackState {
   jobject callback;
   jmethodID method;
+  // Dispatch queue bookkeeping, guarded by g_watcher_dispatch.mutex. See
+  // "Watcher Dispatch Queue" below.
+  int32_t pendingIndex = -1; // Coalesced primitive slot in the batch, or -1
+  int32_t queued = 0;        // Object emits waiting in the pending batch
+  bool inFlight = false;     // Part of the batch being delivered
+  bool dropped = false;      // Dropped while queued or in flight
 };
 
-WatcherCallbackState *create_watcher_state(JNIEnv *env, jobject callback) {
+constexpr char kOnChangedSig[] =
+    "(Ljava/lang/Object;Ldev/waterui/android/reactive/WuiWatcherMetadata;)V";
+
+WatcherCallbackState *create_watcher_state(JNIEnv *env, jobject callback,
+                                           const char *method = "onChanged",
+                                           const char *sig = kOnChangedSig) {
   auto *state = new WatcherCallbackState();
   state->callback = env->NewGlobalRef(callback);
   jclass cls = env->GetObjectClass(callback);
-  state->method = env->GetMethodID(
-      cls, "onChanged",
-      "(Ljava/lang/Object;Ldev/waterui/android/reactive/WuiWatcherMetadata;)V");
+  state->method = env->GetMethodID(cls, method, sig);
   env->DeleteLocalRef(cls);
   return state;
 }
@@ -618,6 +1570,7 @@ void drop_watcher_state(JNIEnv *env, WatcherCallbackState *state) {
   if (state == nullptr)
     return;
   env->DeleteGlobalRef(state->callback);
+  WUI_TRACK_FREE(WatcherCallback, state);
   delete state;
 }
 
@@ -636,23 +1589,6 @@ jobject new_type_id_struct(JNIEnv *env, WuiTypeId typeId) {
                         static_cast<jlong>(typeId.high));
 }
 
-jobject box_boolean(JNIEnv *env, bool value) {
-  return env->CallStaticObjectMethod(gBooleanClass, gBooleanValueOf,
-                                     value ? JNI_TRUE : JNI_FALSE);
-}
-
-jobject box_int(JNIEnv *env, jint value) {
-  return env->CallStaticObjectMethod(gIntegerClass, gIntegerValueOf, value);
-}
-
-jobject box_double(JNIEnv *env, jdouble value) {
-  return env->CallStaticObjectMethod(gDoubleClass, gDoubleValueOf, value);
-}
-
-jobject box_float(JNIEnv *env, jfloat value) {
-  return env->CallStaticObjectMethod(gFloatClass, gFloatValueOf, value);
-}
-
 jobject box_long(JNIEnv *env, jlong value) {
   return env->CallStaticObjectMethod(gLongClass, gLongValueOf, value);
 }
@@ -664,7 +1600,9 @@ void invoke_watcher(JNIEnv *env, WatcherCallbackState *state, jobject value_obj,
     return;
   }
   jobject metadata_obj = new_metadata(env, metadata);
+  WUI_TRACE_UPCALL();
   env->CallVoidMethod(state->callback, state->method, value_obj, metadata_obj);
+  clear_jni_exception(env, "delivering a watcher emit");
   env->DeleteLocalRef(metadata_obj);
   g_sym.waterui_drop_watcher_metadata(metadata);
 }
@@ -673,46 +1611,631 @@ void invoke_watcher(JNIEnv *env, WatcherCallbackState *state, jobject value_obj,
 // Watcher Callback Implementations
 // ============================================================================
 
-void watcher_bool_call(const void *data, bool value,
-                       WuiWatcherMetadata *metadata) {
+// Primitive watchers call the typed callbacks (onBool/onInt/onDouble/onFloat)
+// with the raw value and the metadata pointer as a jlong, so an emit neither
+// boxes the value nor allocates a WuiWatcherMetadata. The pointer is only
+// valid for the duration of the call.
+template <typename JniT>
+void invoke_primitive_watcher(const void *data, JniT value,
+                              WuiWatcherMetadata *metadata) {
+  ScopedEnv scoped;
+  auto *state = static_cast<WatcherCallbackState const *>(data);
+  if (scoped.env != nullptr && state != nullptr) {
+    WUI_TRACE_UPCALL();
+    scoped.env->CallVoidMethod(state->callback, state->method, value,
+                               ptr_to_jlong(metadata));
+    clear_jni_exception(scoped.env, "delivering a primitive watcher emit");
+  }
+  g_sym.waterui_drop_watcher_metadata(metadata);
+}
+
+// ============================================================================
+// Watcher Dispatch Queue
+// ============================================================================
+//
+// Watcher emits are not delivered from the emitting thread. Every kind is
+// queued here, in emit order, so Kotlin never sees a primitive watcher lag
+// behind an object watcher fed by the same change. Primitive emits are
+// coalesced per watcher (last value wins, together with its metadata, so the
+// animation of the final emit is kept); object emits (strings, styled text,
+// resolved theme values, views, diffs) are kept individually, since their
+// values may own Rust handles or, like diffs, only make sense in sequence.
+//
+// The first emit into an empty queue asks WatcherDispatcher to post a
+// Choreographer frame callback, which calls flushWatcherQueue(); the whole
+// batch then reaches Kotlin in a single deliverBatch call on the main thread.
+// Emits raised on the main thread inside a WatcherFlushScope (binding writes,
+// actions) skip the frame and are flushed when the outermost scope returns,
+// so a write's echo arrives before the write call does. Metadata pointers are
+// dropped only after deliverBatch returns, so the callbacks see the same
+// "valid until return" contract as before.
+//
+// Without the Kotlin dispatcher (init failed), emits are delivered directly.
+
+// Must match WatcherDispatcher.KIND_* in Kotlin.
+enum class WatcherValueKind : jint {
+  Bool = 0,
+  Int = 1,
+  Double = 2,
+  Float = 3,
+  Object = 4
+};
+
+struct PendingEmit {
+  WatcherCallbackState *state; // nullptr if the watcher was dropped
+  WatcherValueKind kind;
+  jlong bits;     // Value bits; doubles/floats are stored bit-exact
+  jobject object; // Object emits: global ref to the value, else nullptr
+  WuiWatcherMetadata *metadata;
+};
+
+struct WatcherDispatchQueue {
+  std::mutex mutex;
+  std::vector<PendingEmit> pending;
+  bool flushScheduled = false;
+};
+
+WatcherDispatchQueue g_watcher_dispatch;
+static jclass gWatcherDispatcherClass = nullptr;
+static jmethodID gWatcherDispatcherScheduleFlush = nullptr;
+static jmethodID gWatcherDispatcherDeliverBatch = nullptr;
+
+void init_watcher_dispatcher(JNIEnv *env) {
+  if (gWatcherDispatcherClass != nullptr) {
+    return;
+  }
+  jclass cls =
+      new_global_class(env, "dev/waterui/android/reactive/WatcherDispatcher");
+  if (cls == nullptr) {
+    __android_log_print(ANDROID_LOG_ERROR, LOG_TAG,
+                        "WatcherDispatcher not found; emits are unbatched");
+    return;
+  }
+  gWatcherDispatcherScheduleFlush =
+      env->GetStaticMethodID(cls, "scheduleFlush", "()V");
+  gWatcherDispatcherDeliverBatch = env->GetStaticMethodID(
+      cls, "deliverBatch",
+      "(I[Ljava/lang/Object;[I[J[J[Ljava/lang/Object;)V");
+  if (gWatcherDispatcherScheduleFlush == nullptr ||
+      gWatcherDispatcherDeliverBatch == nullptr) {
+    clear_jni_exception(env, "resolving WatcherDispatcher methods");
+    env->DeleteGlobalRef(cls);
+    gWatcherDispatcherScheduleFlush = nullptr;
+    gWatcherDispatcherDeliverBatch = nullptr;
+    return;
+  }
+  gWatcherDispatcherClass = cls;
+}
+
+using PostFrameCallback64Fn = void (*)(AChoreographer *,
+                                       AChoreographer_frameCallback64, void *);
+using PostFrameCallbackFn = void (*)(AChoreographer *,
+                                     AChoreographer_frameCallback, void *);
+
+// AChoreographer frame callbacks, for the counter publisher, the GPU render
+// driver and the animation engine. postFrameCallback64 is API 29+ and the long
+// variant is deprecated there, so both are resolved at runtime rather than
+// linked against minSdk.
+struct ChoreographerApi {
+  PostFrameCallback64Fn postFrameCallback64 = nullptr;
+  PostFrameCallbackFn postFrameCallback = nullptr;
+};
+
+const ChoreographerApi &choreographer_api() {
+  static const ChoreographerApi api = [] {
+    ChoreographerApi resolved;
+    void *lib = dlopen("libandroid.so", RTLD_NOW);
+    if (lib != nullptr) {
+      resolved.postFrameCallback64 = reinterpret_cast<PostFrameCallback64Fn>(
+          dlsym(lib, "AChoreographer_postFrameCallback64"));
+      resolved.postFrameCallback = reinterpret_cast<PostFrameCallbackFn>(
+          dlsym(lib, "AChoreographer_postFrameCallback"));
+    }
+    return resolved;
+  }();
+  return api;
+}
+
+// ============================================================================
+// Counter Publisher
+// ============================================================================
+// With tracing or handle tracking built in, the bridge counters are published
+// from a frame callback on the main thread's AChoreographer, so
+// WaterUI.jniUpcalls and WaterUI.bytesMarshalled are per-frame values and
+// WaterUI.pendingEmits is the queue depth at each frame. The callback is armed
+// by the main thread's first traced entry point (or tracked handle change)
+// while a trace is recording, and re-posts itself for as long as the counters
+// move. The frame that finds them still publishes its zeros, then the clock
+// stops until the next activity, so an idle app costs no frames.
+
+#if defined(WATERUI_JNI_TRACING) || defined(WATERUI_JNI_HANDLE_TRACKING)
+
+// Main thread only.
+bool g_counter_frame_posted = false;
+
+bool publish_bridge_counters() {
+  bool active = WUI_TRACE_PUBLISH_COUNTERS();
+  active = WUI_TRACK_PUBLISH_COUNTERS() || active;
+#ifdef WATERUI_JNI_TRACING
+  ATraceSetCounterFn setCounter = atrace_set_counter();
+  size_t pending = 0;
+  {
+    std::lock_guard<std::mutex> lock(g_watcher_dispatch.mutex);
+    pending = g_watcher_dispatch.pending.size();
+  }
+  if (setCounter != nullptr) {
+    setCounter("WaterUI.pendingEmits", static_cast<int64_t>(pending));
+  }
+  active = active || pending != 0;
+#endif
+  return active;
+}
+
+void post_counter_frame();
+
+void on_counter_frame() {
+  g_counter_frame_posted = false;
+  if (!ATrace_isEnabled()) {
+    return;
+  }
+  if (publish_bridge_counters()) {
+    post_counter_frame();
+  }
+}
+
+void on_counter_frame64(int64_t, void *) { on_counter_frame(); }
+
+void on_counter_frame32(long, void *) { on_counter_frame(); }
+
+void post_counter_frame() {
+  const ChoreographerApi &api = choreographer_api();
+  AChoreographer *choreographer = AChoreographer_getInstance();
+  if (choreographer == nullptr) {
+    return;
+  }
+  if (api.postFrameCallback64 != nullptr) {
+    api.postFrameCallback64(choreographer, &on_counter_frame64, nullptr);
+  } else if (api.postFrameCallback != nullptr) {
+    api.postFrameCallback(choreographer, &on_counter_frame32, nullptr);
+  } else {
+    return;
+  }
+  g_counter_frame_posted = true;
+}
+
+// Cheap when the clock is already running. Off the main thread it does
+// nothing: the counters still accumulate and are picked up by the next frame
+// the main thread arms.
+void arm_counter_frame() {
+  if (gettid() != getpid() || g_counter_frame_posted || !ATrace_isEnabled()) {
+    return;
+  }
+  // Drop what built up while no trace was recording.
+  WUI_TRACE_RESET_COUNTERS();
+  post_counter_frame();
+}
+
+#endif
+
+void release_watcher_dispatcher(JNIEnv *env) {
+  if (gWatcherDispatcherClass != nullptr) {
+    env->DeleteGlobalRef(gWatcherDispatcherClass);
+  }
+  gWatcherDispatcherClass = nullptr;
+  gWatcherDispatcherScheduleFlush = nullptr;
+  gWatcherDispatcherDeliverBatch = nullptr;
+}
+
+// Fallback when WatcherDispatcher is missing: the callback runs on the
+// emitting thread, which may be a Rust worker. The Kotlin primitive callbacks
+// (WuiBinding/WuiComputed.applyFromRust) post to the main thread themselves
+// when called off it.
+void deliver_emit_directly(const PendingEmit &emit) {
+  const void *data = emit.state;
+  switch (emit.kind) {
+  case WatcherValueKind::Bool:
+    invoke_primitive_watcher<jboolean>(data, static_cast<jboolean>(emit.bits),
+                                       emit.metadata);
+    break;
+  case WatcherValueKind::Int:
+    invoke_primitive_watcher<jint>(data, static_cast<jint>(emit.bits),
+                                   emit.metadata);
+    break;
+  case WatcherValueKind::Double: {
+    jdouble value;
+    std::memcpy(&value, &emit.bits, sizeof(value));
+    invoke_primitive_watcher<jdouble>(data, value, emit.metadata);
+    break;
+  }
+  case WatcherValueKind::Float: {
+    jfloat value;
+    auto bits = static_cast<uint32_t>(emit.bits);
+    std::memcpy(&value, &bits, sizeof(value));
+    invoke_primitive_watcher<jfloat>(data, value, emit.metadata);
+    break;
+  }
+  case WatcherValueKind::Object:
+    // Object emits never reach the queue without the dispatcher.
+    g_sym.waterui_drop_watcher_metadata(emit.metadata);
+    break;
+  }
+}
+
+// On Android the main thread's tid is the process id.
+bool on_main_thread() { return gettid() == getpid(); }
+
+// Depth of WatcherFlushScopes and flushes on this thread. While it is
+// non-zero, emits from this thread are queued without posting a frame; the
+// outermost scope flushes them.
+thread_local int t_watcher_flush_depth = 0;
+
+bool schedule_watcher_flush() {
   ScopedEnv scoped;
   if (scoped.env == nullptr) {
-    g_sym.waterui_drop_watcher_metadata(metadata);
+    return false;
+  }
+  WUI_TRACE_UPCALL();
+  scoped.env->CallStaticVoidMethod(gWatcherDispatcherClass,
+                                   gWatcherDispatcherScheduleFlush);
+  bool posted = !scoped.env->ExceptionCheck();
+  clear_jni_exception(scoped.env, "scheduling a watcher flush");
+  return posted;
+}
+
+// Appends (or, for primitives, coalesces) an emit under the queue lock.
+// Returns true if the caller has to post a flush.
+bool push_pending_emit(const PendingEmit &emit,
+                       WuiWatcherMetadata **superseded) {
+  WatcherCallbackState *state = emit.state;
+  auto &pending = g_watcher_dispatch.pending;
+  if (emit.kind != WatcherValueKind::Object && state->pendingIndex >= 0) {
+    PendingEmit &slot = pending[static_cast<size_t>(state->pendingIndex)];
+    *superseded = slot.metadata;
+    slot.bits = emit.bits;
+    slot.metadata = emit.metadata;
+    return false;
+  }
+  if (emit.kind == WatcherValueKind::Object) {
+    ++state->queued;
+  } else {
+    state->pendingIndex = static_cast<int32_t>(pending.size());
+  }
+  pending.push_back(emit);
+  if (g_watcher_dispatch.flushScheduled || t_watcher_flush_depth > 0) {
+    return false;
+  }
+  g_watcher_dispatch.flushScheduled = true;
+  return true;
+}
+
+void enqueue_pending_emit(const PendingEmit &emit) {
+  WuiWatcherMetadata *superseded = nullptr;
+  bool schedule = false;
+  {
+    std::lock_guard<std::mutex> lock(g_watcher_dispatch.mutex);
+    schedule = push_pending_emit(emit, &superseded);
+  }
+  if (superseded != nullptr) {
+    g_sym.waterui_drop_watcher_metadata(superseded);
+  }
+  if (schedule && !schedule_watcher_flush()) {
+    // Let the next emit try again instead of waiting for a flush that was
+    // never posted.
+    std::lock_guard<std::mutex> lock(g_watcher_dispatch.mutex);
+    g_watcher_dispatch.flushScheduled = false;
+  }
+}
+
+void enqueue_watcher_emit(const void *data, WatcherValueKind kind, jlong bits,
+                          WuiWatcherMetadata *metadata) {
+  auto *state = const_cast<WatcherCallbackState *>(
+      static_cast<WatcherCallbackState const *>(data));
+  PendingEmit emit{state, kind, bits, nullptr, metadata};
+  if (state == nullptr || gWatcherDispatcherClass == nullptr) {
+    deliver_emit_directly(emit);
     return;
   }
-  auto *state = static_cast<WatcherCallbackState const *>(data);
-  jobject boxed = box_boolean(scoped.env, value);
-  invoke_watcher(scoped.env, const_cast<WatcherCallbackState *>(state), boxed,
-                 metadata);
-  scoped.env->DeleteLocalRef(boxed);
+  enqueue_pending_emit(emit);
+}
+
+// Queues an object value for an onChanged watcher. The value is held by a
+// global ref until the batch is delivered; the caller keeps its local ref.
+void enqueue_object_emit(JNIEnv *env, WatcherCallbackState *state,
+                         jobject value_obj, WuiWatcherMetadata *metadata) {
+  if (env == nullptr || state == nullptr ||
+      gWatcherDispatcherClass == nullptr) {
+    invoke_watcher(env, state, value_obj, metadata);
+    return;
+  }
+  jobject global =
+      value_obj != nullptr ? env->NewGlobalRef(value_obj) : nullptr;
+  enqueue_pending_emit(
+      PendingEmit{state, WatcherValueKind::Object, 0, global, metadata});
+}
+
+// Drop for every queued watcher state. A coalesced primitive emit is
+// discarded, including one queued while the watcher's previous emit is being
+// delivered. Object emits are still delivered, since their values may own Rust
+// handles that only Kotlin releases; the state is then freed by the flush, as
+// it is when the watcher is in the batch being delivered.
+void drop_queued_watcher_state(JNIEnv *env, WatcherCallbackState *state) {
+  if (state == nullptr)
+    return;
+  WUI_TRACK_DROP_REQUEST(state);
+  WuiWatcherMetadata *discarded = nullptr;
+  bool deferred = false;
+  {
+    std::lock_guard<std::mutex> lock(g_watcher_dispatch.mutex);
+    if (state->pendingIndex >= 0) {
+      PendingEmit &slot =
+          g_watcher_dispatch.pending[static_cast<size_t>(state->pendingIndex)];
+      discarded = slot.metadata;
+      slot.state = nullptr;
+      slot.metadata = nullptr;
+      state->pendingIndex = -1;
+    }
+    if (state->inFlight || state->queued > 0) {
+      state->dropped = true;
+      deferred = true;
+    }
+  }
+  if (discarded != nullptr) {
+    g_sym.waterui_drop_watcher_metadata(discarded);
+  }
+  if (deferred) {
+    return;
+  }
+  if (env != nullptr) {
+    drop_watcher_state(env, state);
+  }
+}
+
+// Java arrays and staging vectors handed to deliverBatch. The main thread
+// keeps one set for the life of the process and grows it on demand, so a
+// steady-state flush allocates nothing; other threads (benchmarks) use a
+// temporary set.
+struct WatcherBatchBuffers {
+  std::vector<PendingEmit> batch;
+  std::vector<jint> kinds;
+  std::vector<jlong> values;
+  std::vector<jlong> metadata;
+  jobjectArray callbackArray = nullptr;
+  jintArray kindArray = nullptr;
+  jlongArray valueArray = nullptr;
+  jlongArray metadataArray = nullptr;
+  jobjectArray objectArray = nullptr;
+  jsize capacity = 0;
+
+  bool reserve(JNIEnv *env, jsize count) {
+    if (count <= capacity) {
+      return true;
+    }
+    release(env);
+    jsize grown = std::max<jsize>(count, 64);
+    callbackArray = new_global_array(env, env->NewObjectArray(
+                                              grown, gObjectClass, nullptr));
+    kindArray = new_global_array(env, env->NewIntArray(grown));
+    valueArray = new_global_array(env, env->NewLongArray(grown));
+    metadataArray = new_global_array(env, env->NewLongArray(grown));
+    objectArray = new_global_array(env, env->NewObjectArray(
+                                            grown, gObjectClass, nullptr));
+    if (callbackArray == nullptr || kindArray == nullptr ||
+        valueArray == nullptr || metadataArray == nullptr ||
+        objectArray == nullptr) {
+      clear_jni_exception(env, "allocating watcher batch arrays");
+      release(env);
+      return false;
+    }
+    capacity = grown;
+    return true;
+  }
+
+  void release(JNIEnv *env) {
+    for (jobject array : {static_cast<jobject>(callbackArray),
+                          static_cast<jobject>(kindArray),
+                          static_cast<jobject>(valueArray),
+                          static_cast<jobject>(metadataArray),
+                          static_cast<jobject>(objectArray)}) {
+      if (array != nullptr) {
+        env->DeleteGlobalRef(array);
+      }
+    }
+    callbackArray = nullptr;
+    kindArray = nullptr;
+    valueArray = nullptr;
+    metadataArray = nullptr;
+    objectArray = nullptr;
+    capacity = 0;
+  }
+
+private:
+  template <typename ArrayT> static ArrayT new_global_array(JNIEnv *env,
+                                                            ArrayT local) {
+    if (local == nullptr) {
+      return nullptr;
+    }
+    auto global = static_cast<ArrayT>(env->NewGlobalRef(local));
+    env->DeleteLocalRef(local);
+    return global;
+  }
+};
+
+WatcherBatchBuffers g_main_batch_buffers; // Main thread only
+
+// Callbacks that keep writing to the bindings they watch would otherwise
+// keep one flush going forever; after this many passes the rest waits for
+// the next frame.
+constexpr int kMaxWatcherFlushPasses = 8;
+
+// Delivers the current batch. Returns false if there was nothing to deliver.
+bool deliver_watcher_batch(JNIEnv *env, WatcherBatchBuffers &buffers) {
+  std::vector<PendingEmit> &batch = buffers.batch;
+  batch.clear();
+  {
+    std::lock_guard<std::mutex> lock(g_watcher_dispatch.mutex);
+    batch.swap(g_watcher_dispatch.pending);
+    g_watcher_dispatch.flushScheduled = false;
+    for (auto &emit : batch) {
+      if (emit.state != nullptr) {
+        emit.state->pendingIndex = -1;
+        emit.state->queued = 0;
+        emit.state->inFlight = true;
+      }
+    }
+  }
+  if (batch.empty()) {
+    return false;
+  }
+
+  auto count = static_cast<jsize>(batch.size());
+  if (buffers.reserve(env, count)) {
+    buffers.kinds.resize(batch.size());
+    buffers.values.resize(batch.size());
+    buffers.metadata.resize(batch.size());
+    for (jsize i = 0; i < count; ++i) {
+      const PendingEmit &emit = batch[static_cast<size_t>(i)];
+      env->SetObjectArrayElement(buffers.callbackArray, i,
+                                 emit.state != nullptr ? emit.state->callback
+                                                       : nullptr);
+      if (emit.object != nullptr) {
+        env->SetObjectArrayElement(buffers.objectArray, i, emit.object);
+      }
+      buffers.kinds[i] = static_cast<jint>(emit.kind);
+      buffers.values[i] = emit.bits;
+      buffers.metadata[i] = ptr_to_jlong(emit.metadata);
+    }
+    env->SetIntArrayRegion(buffers.kindArray, 0, count, buffers.kinds.data());
+    env->SetLongArrayRegion(buffers.valueArray, 0, count,
+                            buffers.values.data());
+    env->SetLongArrayRegion(buffers.metadataArray, 0, count,
+                            buffers.metadata.data());
+    WUI_TRACE_UPCALL();
+    env->CallStaticVoidMethod(gWatcherDispatcherClass,
+                              gWatcherDispatcherDeliverBatch, count,
+                              buffers.callbackArray, buffers.kindArray,
+                              buffers.valueArray, buffers.metadataArray,
+                              buffers.objectArray);
+    clear_jni_exception(env, "delivering a watcher batch");
+  }
+
+  std::vector<WatcherCallbackState *> dropped;
+  {
+    std::lock_guard<std::mutex> lock(g_watcher_dispatch.mutex);
+    for (auto &emit : batch) {
+      WatcherCallbackState *state = emit.state;
+      if (state == nullptr || !state->inFlight)
+        continue;
+      state->inFlight = false;
+      // A state with emits queued during delivery is freed by the next flush.
+      if (state->dropped && state->queued == 0 && state->pendingIndex < 0) {
+        dropped.push_back(state);
+      }
+    }
+  }
+  for (auto &emit : batch) {
+    if (emit.object != nullptr) {
+      env->DeleteGlobalRef(emit.object);
+    }
+    if (emit.metadata != nullptr) {
+      g_sym.waterui_drop_watcher_metadata(emit.metadata);
+    }
+  }
+  for (auto *state : dropped) {
+    drop_watcher_state(env, state);
+  }
+  batch.clear();
+  return true;
+}
+
+void flush_watcher_queue(JNIEnv *env) {
+  WUI_TRACE_SCOPE("WaterUI.flushWatcherQueue");
+  if (gWatcherDispatcherClass == nullptr) {
+    return;
+  }
+  bool main = on_main_thread();
+  WatcherBatchBuffers local;
+  WatcherBatchBuffers &buffers = main ? g_main_batch_buffers : local;
+
+  // Emits raised by the callbacks are picked up by the next pass.
+  ++t_watcher_flush_depth;
+  for (int pass = 0; pass < kMaxWatcherFlushPasses; ++pass) {
+    if (!deliver_watcher_batch(env, buffers)) {
+      break;
+    }
+  }
+  --t_watcher_flush_depth;
+  if (!main) {
+    local.release(env);
+  }
+
+  bool schedule = false;
+  {
+    std::lock_guard<std::mutex> lock(g_watcher_dispatch.mutex);
+    if (!g_watcher_dispatch.pending.empty() &&
+        !g_watcher_dispatch.flushScheduled) {
+      g_watcher_dispatch.flushScheduled = true;
+      schedule = true;
+    }
+  }
+  if (schedule && !schedule_watcher_flush()) {
+    std::lock_guard<std::mutex> lock(g_watcher_dispatch.mutex);
+    g_watcher_dispatch.flushScheduled = false;
+  }
+}
+
+// Placed at the top of JNI entry points the main thread uses to write into
+// Rust (binding setters, actions). Emits raised before the call returns are
+// flushed synchronously when the outermost scope exits. Off the main thread
+// it does nothing; those emits reach the main thread through the frame.
+class WatcherFlushScope {
+public:
+  explicit WatcherFlushScope(JNIEnv *env)
+      : env_(on_main_thread() ? env : nullptr) {
+    if (env_ != nullptr) {
+      ++t_watcher_flush_depth;
+    }
+  }
+
+  WatcherFlushScope(const WatcherFlushScope &) = delete;
+  WatcherFlushScope &operator=(const WatcherFlushScope &) = delete;
+
+  ~WatcherFlushScope() {
+    if (env_ != nullptr && --t_watcher_flush_depth == 0) {
+      flush_watcher_queue(env_);
+    }
+  }
+
+private:
+  JNIEnv *env_;
+};
+
+void watcher_bool_call(const void *data, bool value,
+                       WuiWatcherMetadata *metadata) {
+  WUI_TRACE_SCOPE("WaterUI.watcher.bool");
+  enqueue_watcher_emit(data, WatcherValueKind::Bool, value ? 1 : 0, metadata);
 }
 
 void watcher_bool_drop(void *data) {
   ScopedEnv scoped;
-  drop_watcher_state(scoped.env, static_cast<WatcherCallbackState *>(data));
+  drop_queued_watcher_state(scoped.env,
+                            static_cast<WatcherCallbackState *>(data));
 }
 
 void watcher_int_call(const void *data, int32_t value,
                       WuiWatcherMetadata *metadata) {
-  ScopedEnv scoped;
-  if (scoped.env == nullptr) {
-    g_sym.waterui_drop_watcher_metadata(metadata);
-    return;
-  }
-  auto *state = static_cast<WatcherCallbackState const *>(data);
-  jobject boxed = box_int(scoped.env, value);
-  invoke_watcher(scoped.env, const_cast<WatcherCallbackState *>(state), boxed,
-                 metadata);
-  scoped.env->DeleteLocalRef(boxed);
+  WUI_TRACE_SCOPE("WaterUI.watcher.int");
+  enqueue_watcher_emit(data, WatcherValueKind::Int, value, metadata);
 }
 
 void watcher_int_drop(void *data) {
   ScopedEnv scoped;
-  drop_watcher_state(scoped.env, static_cast<WatcherCallbackState *>(data));
+  drop_queued_watcher_state(scoped.env,
+                            static_cast<WatcherCallbackState *>(data));
 }
 
 void watcher_cursor_style_call(const void *data, WuiCursorStyle value,
                                WuiWatcherMetadata *metadata) {
+  WUI_TRACE_SCOPE("WaterUI.watcher.cursor_style");
   watcher_int_call(data, static_cast<int32_t>(value), metadata);
 }
 
@@ -720,44 +2243,36 @@ void watcher_cursor_style_drop(void *data) { watcher_int_drop(data); }
 
 void watcher_double_call(const void *data, double value,
                          WuiWatcherMetadata *metadata) {
-  ScopedEnv scoped;
-  if (scoped.env == nullptr) {
-    g_sym.waterui_drop_watcher_metadata(metadata);
-    return;
-  }
-  auto *state = static_cast<WatcherCallbackState const *>(data);
-  jobject boxed = box_double(scoped.env, value);
-  invoke_watcher(scoped.env, const_cast<WatcherCallbackState *>(state), boxed,
-                 metadata);
-  scoped.env->DeleteLocalRef(boxed);
+  WUI_TRACE_SCOPE("WaterUI.watcher.double");
+  jlong bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  enqueue_watcher_emit(data, WatcherValueKind::Double, bits, metadata);
 }
 
 void watcher_double_drop(void *data) {
   ScopedEnv scoped;
-  drop_watcher_state(scoped.env, static_cast<WatcherCallbackState *>(data));
+  drop_queued_watcher_state(scoped.env,
+                            static_cast<WatcherCallbackState *>(data));
 }
 
 void watcher_float_call(const void *data, float value,
                         WuiWatcherMetadata *metadata) {
-  ScopedEnv scoped;
-  if (scoped.env == nullptr) {
-    g_sym.waterui_drop_watcher_metadata(metadata);
-    return;
-  }
-  auto *state = static_cast<WatcherCallbackState const *>(data);
-  jobject boxed = box_float(scoped.env, value);
-  invoke_watcher(scoped.env, const_cast<WatcherCallbackState *>(state), boxed,
-                 metadata);
-  scoped.env->DeleteLocalRef(boxed);
+  WUI_TRACE_SCOPE("WaterUI.watcher.float");
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  enqueue_watcher_emit(data, WatcherValueKind::Float, static_cast<jlong>(bits),
+                       metadata);
 }
 
 void watcher_float_drop(void *data) {
   ScopedEnv scoped;
-  drop_watcher_state(scoped.env, static_cast<WatcherCallbackState *>(data));
+  drop_queued_watcher_state(scoped.env,
+                            static_cast<WatcherCallbackState *>(data));
 }
 
 void watcher_str_call(const void *data, WuiStr value,
                       WuiWatcherMetadata *metadata) {
+  WUI_TRACE_SCOPE("WaterUI.watcher.str");
   ScopedEnv scoped;
   if (scoped.env == nullptr) {
     g_sym.waterui_drop_watcher_metadata(metadata);
@@ -765,51 +2280,44 @@ void watcher_str_call(const void *data, WuiStr value,
   }
   auto *state = static_cast<WatcherCallbackState const *>(data);
   jstring str = wui_str_to_jstring(scoped.env, value);
-  invoke_watcher(scoped.env, const_cast<WatcherCallbackState *>(state), str,
-                 metadata);
+  enqueue_object_emit(scoped.env, const_cast<WatcherCallbackState *>(state),
+                      str, metadata);
   scoped.env->DeleteLocalRef(str);
 }
 
 void watcher_str_drop(void *data) {
   ScopedEnv scoped;
-  drop_watcher_state(scoped.env, static_cast<WatcherCallbackState *>(data));
+  drop_queued_watcher_state(scoped.env,
+                            static_cast<WatcherCallbackState *>(data));
 }
 
 jobject new_resolved_color(JNIEnv *env, const WuiResolvedColor &color) {
-  jclass cls =
-      find_app_class(env, "dev/waterui/android/runtime/ResolvedColorStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(FFFFF)V");
-  jobject obj = env->NewObject(cls, ctor, color.red, color.green, color.blue,
-                               color.opacity, color.headroom);
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::ResolvedColorStruct, color.red,
+                           color.green, color.blue, color.opacity,
+                           color.headroom);
   return obj;
 }
 
 jobject new_resolved_font(JNIEnv *env, const WuiResolvedFont &font) {
-  jclass cls =
-      find_app_class(env, "dev/waterui/android/runtime/ResolvedFontStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(FI)V");
-  jobject obj =
-      env->NewObject(cls, ctor, font.size, static_cast<jint>(font.weight));
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::ResolvedFontStruct, font.size,
+                           static_cast<jint>(font.weight));
   return obj;
 }
 
-jobject new_text_style(JNIEnv *env, const WuiTextStyle &style, jclass cls,
-                       jmethodID ctor) {
-  return env->NewObject(
-      cls, ctor, ptr_to_jlong(style.font), style.italic ? JNI_TRUE : JNI_FALSE,
-      style.underline ? JNI_TRUE : JNI_FALSE,
-      style.strikethrough ? JNI_TRUE : JNI_FALSE,
-      ptr_to_jlong(style.foreground), ptr_to_jlong(style.background));
+jobject new_text_style(JNIEnv *env, const WuiTextStyle &style) {
+  return new_struct(env, StructClass::TextStyleStruct, ptr_to_jlong(style.font),
+                    style.italic ? JNI_TRUE : JNI_FALSE,
+                    style.underline ? JNI_TRUE : JNI_FALSE,
+                    style.strikethrough ? JNI_TRUE : JNI_FALSE,
+                    ptr_to_jlong(style.foreground),
+                    ptr_to_jlong(style.background));
 }
 
-jobject new_styled_chunk(JNIEnv *env, const WuiStyledChunk &chunk,
-                         jclass chunkCls, jmethodID chunkCtor, jclass styleCls,
-                         jmethodID styleCtor) {
+jobject new_styled_chunk(JNIEnv *env, const WuiStyledChunk &chunk) {
   jstring text = wui_str_to_jstring(env, chunk.text);
-  jobject styleObj = new_text_style(env, chunk.style, styleCls, styleCtor);
-  jobject chunkObj = env->NewObject(chunkCls, chunkCtor, text, styleObj);
+  jobject styleObj = new_text_style(env, chunk.style);
+  jobject chunkObj = new_struct(env, StructClass::StyledChunkStruct, text,
+                                styleObj);
   env->DeleteLocalRef(text);
   env->DeleteLocalRef(styleObj);
   return chunkObj;
@@ -819,42 +2327,117 @@ jobject new_styled_str(JNIEnv *env, WuiStyledStr styled) {
   WuiArray_WuiStyledChunk chunks = styled.chunks;
   WuiArraySlice_WuiStyledChunk slice = chunks.vtable.slice(chunks.data);
 
-  jclass styleCls =
-      find_app_class(env, "dev/waterui/android/runtime/TextStyleStruct");
-  jmethodID styleCtor = env->GetMethodID(styleCls, "<init>", "(JZZZJJ)V");
-  jclass chunkCls =
-      find_app_class(env, "dev/waterui/android/runtime/StyledChunkStruct");
-  jmethodID chunkCtor = env->GetMethodID(
-      chunkCls, "<init>",
-      "(Ljava/lang/String;Ldev/waterui/android/runtime/TextStyleStruct;)V");
-  jclass strCls =
-      find_app_class(env, "dev/waterui/android/runtime/StyledStrStruct");
-  jmethodID strCtor = env->GetMethodID(
-      strCls, "<init>", "([Ldev/waterui/android/runtime/StyledChunkStruct;)V");
-
   jobjectArray chunkArray =
-      env->NewObjectArray(static_cast<jsize>(slice.len), chunkCls, nullptr);
+      env->NewObjectArray(static_cast<jsize>(slice.len),
+                          struct_class(StructClass::StyledChunkStruct),
+                          nullptr);
 
   for (uintptr_t i = 0; i < slice.len; ++i) {
-    jobject chunkObj = new_styled_chunk(env, slice.head[i], chunkCls, chunkCtor,
-                                        styleCls, styleCtor);
+    jobject chunkObj = new_styled_chunk(env, slice.head[i]);
     env->SetObjectArrayElement(chunkArray, static_cast<jsize>(i), chunkObj);
     env->DeleteLocalRef(chunkObj);
   }
 
-  jobject result = env->NewObject(strCls, strCtor, chunkArray);
+  jobject result = new_struct(env, StructClass::StyledStrStruct, chunkArray);
 
   env->DeleteLocalRef(chunkArray);
-  env->DeleteLocalRef(strCls);
-  env->DeleteLocalRef(chunkCls);
-  env->DeleteLocalRef(styleCls);
 
   chunks.vtable.drop(chunks.data);
   return result;
 }
 
+// Flat StyledStr encoding: the whole text as one String plus parallel run
+// tables, so a styled string costs three Java allocations regardless of its
+// chunk count. Run i occupies runs[i * kFlatRunStride ..] as (start, length,
+// flags) in UTF-16 units and styles[i * kFlatStyleStride ..] as (font,
+// foreground, background) pointers, owned by the receiver.
+constexpr size_t kFlatRunStride = 3;
+constexpr size_t kFlatStyleStride = 3;
+
+enum FlatStyleFlag : jint {
+  kFlatStyleItalic = 1 << 0,
+  kFlatStyleUnderline = 1 << 1,
+  kFlatStyleStrikethrough = 1 << 2,
+};
+
+jobject new_flat_styled_str(JNIEnv *env, WuiStyledStr styled) {
+  WuiArray_WuiStyledChunk chunks = styled.chunks;
+  WuiArraySlice_WuiStyledChunk slice = chunks.vtable.slice(chunks.data);
+
+  size_t totalBytes = 0;
+  for (uintptr_t i = 0; i < slice.len; ++i) {
+    WuiArray_u8 bytes = slice.head[i].text._0;
+    totalBytes += bytes.vtable.slice(bytes.data).len;
+  }
+
+  size_t blockSize = BumpAllocator::bytes_for<jchar>(totalBytes) +
+                     BumpAllocator::bytes_for<jint>(slice.len * kFlatRunStride) +
+                     BumpAllocator::bytes_for<jlong>(slice.len * kFlatStyleStride);
+  uint8_t sizeClass = BlockPool::kUnpooled;
+  void *block = g_block_pool.acquire(blockSize, &sizeClass);
+  BumpAllocator bump(block, blockSize);
+  auto *units = bump.alloc<jchar>(totalBytes);
+  auto *runs = bump.alloc<jint>(slice.len * kFlatRunStride);
+  auto *styles = bump.alloc<jlong>(slice.len * kFlatStyleStride);
+
+  size_t unitCount = 0;
+  for (uintptr_t i = 0; i < slice.len; ++i) {
+    const WuiStyledChunk &chunk = slice.head[i];
+    WuiArray_u8 bytes = chunk.text._0;
+    WuiArraySlice_u8 text = bytes.vtable.slice(bytes.data);
+    size_t written =
+        text.len > 0 ? utf8_to_utf16(static_cast<const uint8_t *>(text.head),
+                                     text.len, units + unitCount)
+                     : 0;
+    bytes.vtable.drop(bytes.data);
+
+    jint flags = 0;
+    if (chunk.style.italic)
+      flags |= kFlatStyleItalic;
+    if (chunk.style.underline)
+      flags |= kFlatStyleUnderline;
+    if (chunk.style.strikethrough)
+      flags |= kFlatStyleStrikethrough;
+
+    jint *run = runs + i * kFlatRunStride;
+    run[0] = static_cast<jint>(unitCount);
+    run[1] = static_cast<jint>(written);
+    run[2] = flags;
+
+    jlong *style = styles + i * kFlatStyleStride;
+    style[0] = ptr_to_jlong(chunk.style.font);
+    style[1] = ptr_to_jlong(chunk.style.foreground);
+    style[2] = ptr_to_jlong(chunk.style.background);
+
+    unitCount += written;
+  }
+  chunks.vtable.drop(chunks.data);
+
+  WUI_TRACE_BYTES(totalBytes + slice.len * (kFlatRunStride * sizeof(jint) +
+                                           kFlatStyleStride * sizeof(jlong)));
+  jsize runLen = static_cast<jsize>(slice.len * kFlatRunStride);
+  jsize styleLen = static_cast<jsize>(slice.len * kFlatStyleStride);
+  jstring text = env->NewString(units, static_cast<jsize>(unitCount));
+  jintArray runArray = env->NewIntArray(runLen);
+  jlongArray styleArray = env->NewLongArray(styleLen);
+  jobject result = nullptr;
+  if (text != nullptr && runArray != nullptr && styleArray != nullptr) {
+    env->SetIntArrayRegion(runArray, 0, runLen, runs);
+    env->SetLongArrayRegion(styleArray, 0, styleLen, styles);
+    result = new_struct(env, StructClass::FlatStyledStrStruct, text, runArray,
+                        styleArray);
+  }
+  g_block_pool.release(block, sizeClass);
+
+  env->DeleteLocalRef(text);
+  env->DeleteLocalRef(runArray);
+  env->DeleteLocalRef(styleArray);
+  return result;
+}
+
 void watcher_styled_str_call(const void *data, WuiStyledStr value,
                              WuiWatcherMetadata *metadata) {
+  WUI_TRACE_SCOPE("WaterUI.watcher.styled_str");
   ScopedEnv scoped;
   if (scoped.env == nullptr) {
     g_sym.waterui_drop_watcher_metadata(metadata);
@@ -862,18 +2445,41 @@ void watcher_styled_str_call(const void *data, WuiStyledStr value,
   }
   auto *state = static_cast<WatcherCallbackState const *>(data);
   jobject styled = new_styled_str(scoped.env, value);
-  invoke_watcher(scoped.env, const_cast<WatcherCallbackState *>(state), styled,
-                 metadata);
+  enqueue_object_emit(scoped.env, const_cast<WatcherCallbackState *>(state),
+                      styled, metadata);
   scoped.env->DeleteLocalRef(styled);
 }
 
 void watcher_styled_str_drop(void *data) {
   ScopedEnv scoped;
-  drop_watcher_state(scoped.env, static_cast<WatcherCallbackState *>(data));
+  drop_queued_watcher_state(scoped.env,
+                            static_cast<WatcherCallbackState *>(data));
+}
+
+void watcher_flat_styled_str_call(const void *data, WuiStyledStr value,
+                                  WuiWatcherMetadata *metadata) {
+  WUI_TRACE_SCOPE("WaterUI.watcher.flat_styled_str");
+  ScopedEnv scoped;
+  if (scoped.env == nullptr) {
+    g_sym.waterui_drop_watcher_metadata(metadata);
+    return;
+  }
+  auto *state = static_cast<WatcherCallbackState const *>(data);
+  jobject styled = new_flat_styled_str(scoped.env, value);
+  enqueue_object_emit(scoped.env, const_cast<WatcherCallbackState *>(state),
+                      styled, metadata);
+  scoped.env->DeleteLocalRef(styled);
+}
+
+void watcher_flat_styled_str_drop(void *data) {
+  ScopedEnv scoped;
+  drop_queued_watcher_state(scoped.env,
+                            static_cast<WatcherCallbackState *>(data));
 }
 
 void watcher_resolved_color_call(const void *data, WuiResolvedColor value,
                                  WuiWatcherMetadata *metadata) {
+  WUI_TRACE_SCOPE("WaterUI.watcher.resolved_color");
   ScopedEnv scoped;
   if (scoped.env == nullptr) {
     g_sym.waterui_drop_watcher_metadata(metadata);
@@ -881,18 +2487,20 @@ void watcher_resolved_color_call(const void *data, WuiResolvedColor value,
   }
   auto *state = static_cast<WatcherCallbackState const *>(data);
   jobject color_obj = new_resolved_color(scoped.env, value);
-  invoke_watcher(scoped.env, const_cast<WatcherCallbackState *>(state),
-                 color_obj, metadata);
+  enqueue_object_emit(scoped.env, const_cast<WatcherCallbackState *>(state),
+                      color_obj, metadata);
   scoped.env->DeleteLocalRef(color_obj);
 }
 
 void watcher_resolved_color_drop(void *data) {
   ScopedEnv scoped;
-  drop_watcher_state(scoped.env, static_cast<WatcherCallbackState *>(data));
+  drop_queued_watcher_state(scoped.env,
+                            static_cast<WatcherCallbackState *>(data));
 }
 
 void watcher_resolved_font_call(const void *data, WuiResolvedFont value,
                                 WuiWatcherMetadata *metadata) {
+  WUI_TRACE_SCOPE("WaterUI.watcher.resolved_font");
   ScopedEnv scoped;
   if (scoped.env == nullptr) {
     g_sym.waterui_drop_watcher_metadata(metadata);
@@ -900,44 +2508,42 @@ void watcher_resolved_font_call(const void *data, WuiResolvedFont value,
   }
   auto *state = static_cast<WatcherCallbackState const *>(data);
   jobject font_obj = new_resolved_font(scoped.env, value);
-  invoke_watcher(scoped.env, const_cast<WatcherCallbackState *>(state),
-                 font_obj, metadata);
+  enqueue_object_emit(scoped.env, const_cast<WatcherCallbackState *>(state),
+                      font_obj, metadata);
   scoped.env->DeleteLocalRef(font_obj);
 }
 
 void watcher_resolved_font_drop(void *data) {
   ScopedEnv scoped;
-  drop_watcher_state(scoped.env, static_cast<WatcherCallbackState *>(data));
+  drop_queued_watcher_state(scoped.env,
+                            static_cast<WatcherCallbackState *>(data));
 }
 
 jobjectArray picker_items_to_java(JNIEnv *env, WuiArray_WuiPickerItem items) {
   WuiArraySlice_WuiPickerItem slice = items.vtable.slice(items.data);
-  jclass itemCls =
-      find_app_class(env, "dev/waterui/android/runtime/PickerItemStruct");
-  jmethodID itemCtor = env->GetMethodID(
-      itemCls, "<init>", "(ILdev/waterui/android/runtime/StyledStrStruct;)V");
 
   jobjectArray array =
-      env->NewObjectArray(static_cast<jsize>(slice.len), itemCls, nullptr);
+      env->NewObjectArray(static_cast<jsize>(slice.len),
+                          struct_class(StructClass::PickerItemStruct), nullptr);
   for (uintptr_t i = 0; i < slice.len; ++i) {
     const WuiPickerItem &item = slice.head[i];
     WuiStyledStr styled =
         g_sym.waterui_read_computed_styled_str(item.content.content);
     jobject label = new_styled_str(env, styled);
-    jobject pickerItem = env->NewObject(
-        itemCls, itemCtor, static_cast<jint>(item.tag.inner), label);
+    jobject pickerItem = new_struct(env, StructClass::PickerItemStruct,
+                                    static_cast<jint>(item.tag.inner), label);
     env->SetObjectArrayElement(array, static_cast<jsize>(i), pickerItem);
     env->DeleteLocalRef(label);
     env->DeleteLocalRef(pickerItem);
   }
 
-  env->DeleteLocalRef(itemCls);
   items.vtable.drop(items.data);
   return array;
 }
 
 void watcher_picker_items_call(const void *data, WuiArray_WuiPickerItem value,
                                WuiWatcherMetadata *metadata) {
+  WUI_TRACE_SCOPE("WaterUI.watcher.picker_items");
   ScopedEnv scoped;
   if (scoped.env == nullptr) {
     g_sym.waterui_drop_watcher_metadata(metadata);
@@ -945,18 +2551,365 @@ void watcher_picker_items_call(const void *data, WuiArray_WuiPickerItem value,
   }
   auto *state = static_cast<WatcherCallbackState const *>(data);
   jobject array = picker_items_to_java(scoped.env, value);
-  invoke_watcher(scoped.env, const_cast<WatcherCallbackState *>(state), array,
-                 metadata);
+  enqueue_object_emit(scoped.env, const_cast<WatcherCallbackState *>(state),
+                      array, metadata);
   scoped.env->DeleteLocalRef(array);
 }
 
 void watcher_picker_items_drop(void *data) {
   ScopedEnv scoped;
-  drop_watcher_state(scoped.env, static_cast<WatcherCallbackState *>(data));
+  drop_queued_watcher_state(scoped.env,
+                            static_cast<WatcherCallbackState *>(data));
+}
+
+// ========== Keyed Diff ==========
+//
+// Turns two id sequences into an ordered change set that Kotlin replays
+// against its own list, RecyclerView notify* style. Each op is kDiffOpStride
+// ints: (kind, position, count) for Remove/Insert/Update/Reload and
+// (kind, from, to) for Move. Positions refer to the list as it stands after
+// the preceding ops, and Insert/Update positions always equal final indices,
+// so a consumer can read payloads for them from the new sequence directly.
+// Keys must be unique; duplicates, or churn past kDiffMaxMoves, degrade to a
+// single Reload(0, newLen). Survivors on a longest increasing run of their old
+// order stay put, so moving one row anywhere costs one Move.
+
+enum class DiffOp : jint {
+  Remove = 0,
+  Insert = 1,
+  Move = 2,
+  Update = 3,
+  Reload = 4,
+};
+
+constexpr size_t kDiffOpStride = 3;
+constexpr size_t kDiffMaxMoves = 64;
+
+// Appends an op, merging it into the previous one when the ranges are
+// contiguous.
+void push_diff_op(std::vector<jint> &ops, DiffOp kind, jint position,
+                  jint count) {
+  size_t n = ops.size();
+  if (n >= kDiffOpStride && kind != DiffOp::Move &&
+      ops[n - 3] == static_cast<jint>(kind)) {
+    jint &lastPos = ops[n - 2];
+    jint &lastCount = ops[n - 1];
+    bool merges = kind == DiffOp::Remove ? lastPos == position
+                                         : lastPos + lastCount == position;
+    if (merges) {
+      lastCount += count;
+      return;
+    }
+  }
+  ops.push_back(static_cast<jint>(kind));
+  ops.push_back(position);
+  ops.push_back(count);
+}
+
+void reset_diff(std::vector<jint> &ops, size_t newLen) {
+  ops.clear();
+  push_diff_op(ops, DiffOp::Reload, 0, static_cast<jint>(newLen));
+}
+
+// Marks one longest strictly increasing subsequence of values (patience
+// sorting, O(n log n)).
+std::vector<bool>
+longest_increasing_mask(const std::vector<uint32_t> &values) {
+  std::vector<size_t> tails; // tails[l]: index ending the best run of l + 1
+  std::vector<size_t> previous(values.size(), SIZE_MAX); // Run links
+  for (size_t i = 0; i < values.size(); ++i) {
+    auto it = std::lower_bound(
+        tails.begin(), tails.end(), values[i],
+        [&](size_t index, uint32_t v) { return values[index] < v; });
+    if (it != tails.begin()) {
+      previous[i] = *(it - 1);
+    }
+    if (it == tails.end()) {
+      tails.push_back(i);
+    } else {
+      *it = i;
+    }
+  }
+  std::vector<bool> mask(values.size(), false);
+  for (size_t i = tails.empty() ? SIZE_MAX : tails.back(); i != SIZE_MAX;
+       i = previous[i]) {
+    mask[i] = true;
+  }
+  return mask;
+}
+
+// Computes the change set from oldIds to newIds into ops. When both hash
+// arrays are given, retained ids whose hash changed also get Update ops;
+// with updateRetained, every retained id does, for items whose content can't
+// be hashed.
+void keyed_diff(const int32_t *oldIds, size_t oldLen, const int32_t *newIds,
+                size_t newLen, std::vector<jint> &ops,
+                const uint64_t *oldHashes = nullptr,
+                const uint64_t *newHashes = nullptr,
+                bool updateRetained = false) {
+  ops.clear();
+
+  // Sorted (id, index) views of both sides for O(log n) membership.
+  std::vector<std::pair<int32_t, uint32_t>> sortedOld(oldLen);
+  for (size_t i = 0; i < oldLen; ++i) {
+    sortedOld[i] = {oldIds[i], static_cast<uint32_t>(i)};
+  }
+  std::sort(sortedOld.begin(), sortedOld.end());
+  std::vector<int32_t> sortedNew(newIds, newIds + newLen);
+  std::sort(sortedNew.begin(), sortedNew.end());
+  auto uniqueOld = [](const std::pair<int32_t, uint32_t> &a,
+                      const std::pair<int32_t, uint32_t> &b) {
+    return a.first == b.first;
+  };
+  if (std::adjacent_find(sortedOld.begin(), sortedOld.end(), uniqueOld) !=
+          sortedOld.end() ||
+      std::adjacent_find(sortedNew.begin(), sortedNew.end()) !=
+          sortedNew.end()) {
+    reset_diff(ops, newLen);
+    return;
+  }
+  auto findOld = [&](int32_t id) -> const std::pair<int32_t, uint32_t> * {
+    auto it = std::lower_bound(
+        sortedOld.begin(), sortedOld.end(), id,
+        [](const std::pair<int32_t, uint32_t> &e, int32_t v) {
+          return e.first < v;
+        });
+    return it != sortedOld.end() && it->first == id ? &*it : nullptr;
+  };
+
+  // Removals, front to back; cur ends up as the surviving old ids in order.
+  std::vector<int32_t> cur;
+  cur.reserve(std::max(oldLen, newLen));
+  for (size_t i = 0; i < oldLen; ++i) {
+    if (std::binary_search(sortedNew.begin(), sortedNew.end(), oldIds[i])) {
+      cur.push_back(oldIds[i]);
+    } else {
+      push_diff_op(ops, DiffOp::Remove, static_cast<jint>(cur.size()), 1);
+    }
+  }
+
+  // Survivors in target order, by old index. The longest increasing run of
+  // old indices stays put; only the other survivors move.
+  std::vector<uint32_t> targetOld;
+  targetOld.reserve(cur.size());
+  for (size_t j = 0; j < newLen; ++j) {
+    if (const auto *old = findOld(newIds[j])) {
+      targetOld.push_back(old->second);
+    }
+  }
+  std::vector<bool> stable = longest_increasing_mask(targetOld);
+  if (targetOld.size() -
+          static_cast<size_t>(std::count(stable.begin(), stable.end(), true)) >
+      kDiffMaxMoves) {
+    reset_diff(ops, newLen);
+    return;
+  }
+
+  // Moves, right to left: each moved survivor goes just before the survivor
+  // that follows it in the target order, which is already in place.
+  for (size_t k = targetOld.size(); k-- > 0;) {
+    if (stable[k])
+      continue;
+    int32_t id = oldIds[targetOld[k]];
+    auto from = std::find(cur.begin(), cur.end(), id) - cur.begin();
+    auto before = k + 1 < targetOld.size()
+                      ? std::find(cur.begin(), cur.end(),
+                                  oldIds[targetOld[k + 1]]) -
+                            cur.begin()
+                      : static_cast<ptrdiff_t>(cur.size());
+    auto to = from < before ? before - 1 : before;
+    if (from == to)
+      continue;
+    push_diff_op(ops, DiffOp::Move, static_cast<jint>(from),
+                 static_cast<jint>(to));
+    cur.erase(cur.begin() + from);
+    cur.insert(cur.begin() + to, id);
+  }
+
+  // Inserts, front to back; after step j, cur[0..j] matches newIds[0..j].
+  for (size_t j = 0; j < newLen; ++j) {
+    if (j < cur.size() && cur[j] == newIds[j])
+      continue;
+    push_diff_op(ops, DiffOp::Insert, static_cast<jint>(j), 1);
+    cur.insert(cur.begin() + static_cast<ptrdiff_t>(j), newIds[j]);
+  }
+
+  bool hashed = oldHashes != nullptr && newHashes != nullptr;
+  if (!hashed && !updateRetained)
+    return;
+  for (size_t j = 0; j < newLen; ++j) {
+    const auto *old = findOld(newIds[j]);
+    if (old != nullptr &&
+        (updateRetained || oldHashes[old->second] != newHashes[j])) {
+      push_diff_op(ops, DiffOp::Update, static_cast<jint>(j), 1);
+    }
+  }
+}
+
+// Whether new index `index` needs a payload after replaying ops: it was
+// inserted, updated, or the change set is a reload.
+std::vector<bool> diff_payload_mask(const std::vector<jint> &ops,
+                                    size_t newLen) {
+  std::vector<bool> mask(newLen, false);
+  for (size_t i = 0; i < ops.size(); i += kDiffOpStride) {
+    auto kind = static_cast<DiffOp>(ops[i]);
+    if (kind == DiffOp::Insert || kind == DiffOp::Update ||
+        kind == DiffOp::Reload) {
+      for (jint k = 0; k < ops[i + 2]; ++k) {
+        mask[static_cast<size_t>(ops[i + 1] + k)] = true;
+      }
+    }
+  }
+  return mask;
+}
+
+jintArray new_int_array(JNIEnv *env, const jint *data, size_t len) {
+  jintArray array = env->NewIntArray(static_cast<jsize>(len));
+  if (array != nullptr && len > 0) {
+    env->SetIntArrayRegion(array, 0, static_cast<jsize>(len), data);
+  }
+  return array;
+}
+
+// ========== Picker Items Diff ==========
+
+// Releases a styled string that is not handed to Kotlin, including the font
+// and color handles that would otherwise pass to WuiStyledStr.
+void drop_styled_str(WuiStyledStr styled) {
+  WuiArray_WuiStyledChunk chunks = styled.chunks;
+  WuiArraySlice_WuiStyledChunk slice = chunks.vtable.slice(chunks.data);
+  for (uintptr_t i = 0; i < slice.len; ++i) {
+    const WuiStyledChunk &chunk = slice.head[i];
+    WuiArray_u8 bytes = chunk.text._0;
+    bytes.vtable.drop(bytes.data);
+    if (chunk.style.font != nullptr)
+      g_sym.waterui_drop_font(chunk.style.font);
+    if (chunk.style.foreground != nullptr)
+      g_sym.waterui_drop_color(chunk.style.foreground);
+    if (chunk.style.background != nullptr &&
+        chunk.style.background != chunk.style.foreground)
+      g_sym.waterui_drop_color(chunk.style.background);
+  }
+  chunks.vtable.drop(chunks.data);
+}
+
+// FNV-1a over the label text and style flags. Font and color handles are
+// fresh on every read, so handle-only changes do not register as updates.
+uint64_t styled_str_hash(const WuiStyledStr &styled) {
+  uint64_t hash = 1469598103934665603ULL;
+  auto mix = [&hash](uint8_t byte) {
+    hash ^= byte;
+    hash *= 1099511628211ULL;
+  };
+  WuiArraySlice_WuiStyledChunk slice =
+      styled.chunks.vtable.slice(styled.chunks.data);
+  for (uintptr_t i = 0; i < slice.len; ++i) {
+    const WuiStyledChunk &chunk = slice.head[i];
+    WuiArraySlice_u8 text = chunk.text._0.vtable.slice(chunk.text._0.data);
+    auto *bytes = static_cast<const uint8_t *>(text.head);
+    for (uintptr_t b = 0; b < text.len; ++b) {
+      mix(bytes[b]);
+    }
+    mix(static_cast<uint8_t>((chunk.style.italic ? 1 : 0) |
+                             (chunk.style.underline ? 2 : 0) |
+                             (chunk.style.strikethrough ? 4 : 0)));
+    mix(0xFF); // chunk boundary
+  }
+  return hash;
+}
+
+// Tags and label hashes of the last delivered item list.
+struct PickerItemsBaseline {
+  std::vector<int32_t> tags;
+  std::vector<uint64_t> hashes;
+};
+
+struct PickerItemsDiffState {
+  WatcherCallbackState *watcher;
+  PickerItemsBaseline baseline;
+};
+
+// Diffs items against baseline and advances it. Labels are marshalled only for
+// inserted, updated or reloaded positions, in new-index order.
+jobject picker_items_diff_to_java(JNIEnv *env, WuiArray_WuiPickerItem items,
+                                  PickerItemsBaseline &baseline) {
+  WuiArraySlice_WuiPickerItem slice = items.vtable.slice(items.data);
+  size_t count = slice.len;
+
+  std::vector<int32_t> tags(count);
+  std::vector<uint64_t> hashes(count);
+  std::vector<WuiStyledStr> labels(count);
+  for (size_t i = 0; i < count; ++i) {
+    tags[i] = slice.head[i].tag.inner;
+    labels[i] =
+        g_sym.waterui_read_computed_styled_str(slice.head[i].content.content);
+    hashes[i] = styled_str_hash(labels[i]);
+  }
+  items.vtable.drop(items.data);
+
+  std::vector<jint> ops;
+  keyed_diff(baseline.tags.data(), baseline.tags.size(), tags.data(), count,
+             ops, baseline.hashes.data(), hashes.data());
+  std::vector<bool> needsLabel = diff_payload_mask(ops, count);
+
+  size_t labelCount = static_cast<size_t>(
+      std::count(needsLabel.begin(), needsLabel.end(), true));
+  jobjectArray labelArray = env->NewObjectArray(
+      static_cast<jsize>(labelCount),
+      struct_class(StructClass::FlatStyledStrStruct), nullptr);
+  jsize next = 0;
+  for (size_t i = 0; i < count; ++i) {
+    if (!needsLabel[i] || labelArray == nullptr) {
+      drop_styled_str(labels[i]);
+      continue;
+    }
+    jobject label = new_flat_styled_str(env, labels[i]);
+    env->SetObjectArrayElement(labelArray, next++, label);
+    env->DeleteLocalRef(label);
+  }
+
+  jintArray opArray = new_int_array(env, ops.data(), ops.size());
+  jintArray tagArray = new_int_array(env, tags.data(), count);
+  jobject result = nullptr;
+  if (opArray != nullptr && tagArray != nullptr && labelArray != nullptr) {
+    result = new_struct(env, StructClass::PickerItemsDiffStruct, opArray,
+                        tagArray, labelArray);
+  }
+  env->DeleteLocalRef(opArray);
+  env->DeleteLocalRef(tagArray);
+  env->DeleteLocalRef(labelArray);
+
+  baseline.tags = std::move(tags);
+  baseline.hashes = std::move(hashes);
+  return result;
+}
+
+void watcher_picker_items_diff_call(const void *data,
+                                    WuiArray_WuiPickerItem value,
+                                    WuiWatcherMetadata *metadata) {
+  WUI_TRACE_SCOPE("WaterUI.watcher.picker_items_diff");
+  ScopedEnv scoped;
+  if (scoped.env == nullptr) {
+    g_sym.waterui_drop_watcher_metadata(metadata);
+    return;
+  }
+  auto *state =
+      static_cast<PickerItemsDiffState *>(const_cast<void *>(data));
+  jobject diff = picker_items_diff_to_java(scoped.env, value, state->baseline);
+  enqueue_object_emit(scoped.env, state->watcher, diff, metadata);
+  scoped.env->DeleteLocalRef(diff);
+}
+
+void watcher_picker_items_diff_drop(void *data) {
+  ScopedEnv scoped;
+  auto *state = static_cast<PickerItemsDiffState *>(data);
+  drop_queued_watcher_state(scoped.env, state->watcher);
+  delete state;
 }
 
 void watcher_anyview_call(const void *data, WuiAnyView *value,
                           WuiWatcherMetadata *metadata) {
+  WUI_TRACE_SCOPE("WaterUI.watcher.anyview");
   ScopedEnv scoped;
   if (scoped.env == nullptr) {
     g_sym.waterui_drop_watcher_metadata(metadata);
@@ -964,71 +2917,209 @@ void watcher_anyview_call(const void *data, WuiAnyView *value,
   }
   auto *state = static_cast<WatcherCallbackState const *>(data);
   jobject boxed = box_long(scoped.env, ptr_to_jlong(value));
-  invoke_watcher(scoped.env, const_cast<WatcherCallbackState *>(state), boxed,
-                 metadata);
+  enqueue_object_emit(scoped.env, const_cast<WatcherCallbackState *>(state),
+                      boxed, metadata);
   scoped.env->DeleteLocalRef(boxed);
 }
 
 void watcher_anyview_drop(void *data) {
   ScopedEnv scoped;
-  drop_watcher_state(scoped.env, static_cast<WatcherCallbackState *>(data));
+  drop_queued_watcher_state(scoped.env,
+                            static_cast<WatcherCallbackState *>(data));
 }
 
 // ============================================================================
 // Reactive State for Theme Colors/Fonts
 // ============================================================================
 
-struct WatcherEntry {
-  WuiWatcher_ResolvedColor *watcher;
-  bool active;
-};
+// Slot-recycling watcher registry shared by the reactive states below.
+//
+// Each watcher lives in a slot addressed by a WatcherHandle (index plus
+// generation). Removing a watcher bumps the slot's generation and returns the
+// slot to a free list, so a stale handle held by an old guard can never
+// remove the watcher that reuses the slot. Watchers are called outside the
+// lock (they re-enter Rust and possibly the JVM); a watcher removed while a
+// notify is calling it is dropped once that call finishes.
+struct WatcherHandle {
+  uint32_t index;
+  uint32_t generation;
+};
+
+template <typename WatcherT> class WatcherRegistry {
+public:
+  using DropFn = void (*)(WatcherT *);
+
+  explicit WatcherRegistry(DropFn drop) : dropWatcher(drop) {}
 
-struct ReactiveColorState {
-  WuiResolvedColor color;
-  std::vector<WatcherEntry> watchers;
-  int ref_count = 1;
+  WatcherRegistry(const WatcherRegistry &) = delete;
+  WatcherRegistry &operator=(const WatcherRegistry &) = delete;
 
-  void set_color(const WuiResolvedColor &new_color) {
-    color = new_color;
-    for (auto &entry : watchers) {
-      if (entry.active && entry.watcher != nullptr) {
-        g_sym.waterui_call_watcher_resolved_color(entry.watcher, color);
+  ~WatcherRegistry() { clear(); }
+
+  WatcherHandle add(WatcherT *watcher) {
+    std::lock_guard<std::mutex> lock(mutex);
+    uint32_t index;
+    if (freeHead != kNoSlot) {
+      index = freeHead;
+      freeHead = slots[index].nextFree;
+    } else {
+      index = static_cast<uint32_t>(slots.size());
+      slots.push_back(Slot{});
+    }
+    Slot &slot = slots[index];
+    slot.watcher = watcher;
+    slot.nextFree = kNoSlot;
+    return WatcherHandle{index, slot.generation};
+  }
+
+  void remove(WatcherHandle handle) {
+    WatcherT *dropped = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (handle.index >= slots.size())
+        return;
+      Slot &slot = slots[handle.index];
+      if (slot.generation != handle.generation || slot.watcher == nullptr)
+        return;
+      ++slot.generation;
+      if (slot.inFlight > 0) {
+        slot.dropPending = true;
+        return;
+      }
+      dropped = slot.watcher;
+      free_slot(handle.index);
+    }
+    dropWatcher(dropped);
+  }
+
+  // Calls fn(watcher) for every registered watcher, outside the lock.
+  template <typename Fn> void for_each(Fn &&fn) {
+    std::vector<std::pair<uint32_t, WatcherT *>> snapshot;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      snapshot.reserve(slots.size());
+      for (uint32_t i = 0; i < slots.size(); ++i) {
+        Slot &slot = slots[i];
+        if (slot.watcher != nullptr && !slot.dropPending) {
+          ++slot.inFlight;
+          snapshot.emplace_back(i, slot.watcher);
+        }
       }
     }
-  }
 
-  size_t add_watcher(WuiWatcher_ResolvedColor *watcher) {
-    size_t index = watchers.size();
-    watchers.push_back({watcher, true});
-    return index;
-  }
+    for (auto &entry : snapshot) {
+      fn(entry.second);
+    }
 
-  void remove_watcher(size_t index) {
-    if (index < watchers.size()) {
-      watchers[index].active = false;
-      if (watchers[index].watcher != nullptr) {
-        g_sym.waterui_drop_watcher_resolved_color(watchers[index].watcher);
+    std::vector<WatcherT *> dropped;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      for (auto &entry : snapshot) {
+        Slot &slot = slots[entry.first];
+        if (--slot.inFlight == 0 && slot.dropPending) {
+          dropped.push_back(slot.watcher);
+          free_slot(entry.first);
+        }
       }
-      watchers[index].watcher = nullptr;
+    }
+    for (auto *watcher : dropped) {
+      dropWatcher(watcher);
     }
   }
 
-  void clear_watchers() {
-    for (auto &entry : watchers) {
-      entry.active = false;
-      if (entry.watcher != nullptr) {
-        g_sym.waterui_drop_watcher_resolved_color(entry.watcher);
-        entry.watcher = nullptr;
+  // Drops every watcher. Only called once no notify can be running.
+  void clear() {
+    std::vector<Slot> old;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      old.swap(slots);
+      freeHead = kNoSlot;
+    }
+    for (auto &slot : old) {
+      if (slot.watcher != nullptr) {
+        dropWatcher(slot.watcher);
       }
     }
-    watchers.clear();
   }
 
-  void retain() { ++ref_count; }
+private:
+  static constexpr uint32_t kNoSlot = UINT32_MAX;
+
+  struct Slot {
+    WatcherT *watcher = nullptr;
+    uint32_t generation = 0;
+    uint32_t inFlight = 0;
+    uint32_t nextFree = kNoSlot;
+    bool dropPending = false;
+  };
+
+  // Caller holds the lock.
+  void free_slot(uint32_t index) {
+    Slot &slot = slots[index];
+    slot.watcher = nullptr;
+    slot.dropPending = false;
+    slot.nextFree = freeHead;
+    freeHead = index;
+  }
+
+  std::mutex mutex;
+  std::vector<Slot> slots;
+  uint32_t freeHead = kNoSlot;
+  DropFn dropWatcher;
+};
+
+// Reference count shared by the reactive states: Kotlin holds one reference,
+// every computed and every watcher guard holds another.
+struct ReactiveRefCount {
+  std::atomic<int> ref_count{1};
+
+  void retain() { ref_count.fetch_add(1, std::memory_order_relaxed); }
+
+  // Returns true when the last reference was released.
+  bool release_last() {
+    return ref_count.fetch_sub(1, std::memory_order_acq_rel) == 1;
+  }
+};
+
+struct ReactiveColorState : ReactiveRefCount {
+  std::mutex value_mutex;
+  WuiResolvedColor color{};
+  WatcherRegistry<WuiWatcher_ResolvedColor> watchers{
+      [](WuiWatcher_ResolvedColor *watcher) {
+        g_sym.waterui_drop_watcher_resolved_color(watcher);
+      }};
+
+  WuiResolvedColor get() {
+    std::lock_guard<std::mutex> lock(value_mutex);
+    return color;
+  }
+
+  void set_color(const WuiResolvedColor &new_color) {
+    store(new_color);
+    notify();
+  }
+
+  // Returns false if the color was already new_color.
+  bool store(const WuiResolvedColor &new_color) {
+    std::lock_guard<std::mutex> lock(value_mutex);
+    bool changed = color.red != new_color.red ||
+                   color.green != new_color.green ||
+                   color.blue != new_color.blue ||
+                   color.opacity != new_color.opacity ||
+                   color.headroom != new_color.headroom;
+    color = new_color;
+    return changed;
+  }
+
+  void notify() {
+    WuiResolvedColor current = get();
+    watchers.for_each([&](WuiWatcher_ResolvedColor *watcher) {
+      g_sym.waterui_call_watcher_resolved_color(watcher, current);
+    });
+  }
 
   void release() {
-    if (--ref_count == 0) {
-      clear_watchers();
+    if (release_last()) {
       delete this;
     }
   }
@@ -1036,18 +3127,19 @@ struct ReactiveColorState {
 
 struct ReactiveGuardState {
   ReactiveColorState *color_state;
-  size_t watcher_index;
+  WatcherHandle watcher;
 };
 
 WuiResolvedColor reactive_color_get(const void *data) {
-  auto *state = static_cast<const ReactiveColorState *>(data);
-  return state->color;
+  auto *state = const_cast<ReactiveColorState *>(
+      static_cast<const ReactiveColorState *>(data));
+  return state->get();
 }
 
 void reactive_guard_drop(void *data) {
   auto *guard_state = static_cast<ReactiveGuardState *>(data);
   if (guard_state->color_state) {
-    guard_state->color_state->remove_watcher(guard_state->watcher_index);
+    guard_state->color_state->watchers.remove(guard_state->watcher);
     guard_state->color_state->release();
   }
   delete guard_state;
@@ -1057,9 +3149,9 @@ WuiWatcherGuard *reactive_color_watch(const void *data,
                                       WuiWatcher_ResolvedColor *watcher) {
   auto *state = const_cast<ReactiveColorState *>(
       static_cast<const ReactiveColorState *>(data));
-  size_t index = state->add_watcher(watcher);
+  WatcherHandle handle = state->watchers.add(watcher);
   state->retain();
-  auto *guard_state = new ReactiveGuardState{state, index};
+  auto *guard_state = new ReactiveGuardState{state, handle};
   return g_sym.waterui_new_watcher_guard(guard_state, reactive_guard_drop);
 }
 
@@ -1071,62 +3163,54 @@ void reactive_color_drop(void *data) {
 }
 
 // Reactive Font State
-struct WatcherEntryFont {
-  WuiWatcher_ResolvedFont *watcher;
-  bool active;
-};
-
-struct ReactiveFontState {
+struct ReactiveFontState : ReactiveRefCount {
   // Store primitive values to avoid ownership issues with WuiResolvedFont
-  float size;
-  WuiFontWeight weight;
-  std::vector<WatcherEntryFont> watchers;
-  int ref_count = 1;
+  std::mutex value_mutex;
+  float size = 0.0f;
+  WuiFontWeight weight{};
+  WatcherRegistry<WuiWatcher_ResolvedFont> watchers{
+      [](WuiWatcher_ResolvedFont *watcher) {
+        g_sym.waterui_drop_watcher_resolved_font(watcher);
+      }};
 
-  void set_font(float new_size, WuiFontWeight new_weight) {
-    size = new_size;
-    weight = new_weight;
-    // Create a fresh WuiResolvedFont for each watcher call
-    for (auto &entry : watchers) {
-      if (entry.active && entry.watcher != nullptr) {
-        g_sym.waterui_call_watcher_resolved_font(
-            entry.watcher, g_sym.waterui_resolved_font_new(size, weight));
-      }
-    }
+  WuiResolvedFont get() {
+    std::lock_guard<std::mutex> lock(value_mutex);
+    // Create a fresh WuiResolvedFont that Rust can take ownership of
+    return g_sym.waterui_resolved_font_new(size, weight);
   }
 
-  size_t add_watcher(WuiWatcher_ResolvedFont *watcher) {
-    size_t index = watchers.size();
-    watchers.push_back({watcher, true});
-    return index;
+  void set_font(float new_size, WuiFontWeight new_weight) {
+    store(new_size, new_weight);
+    notify();
   }
 
-  void remove_watcher(size_t index) {
-    if (index < watchers.size()) {
-      watchers[index].active = false;
-      if (watchers[index].watcher != nullptr) {
-        g_sym.waterui_drop_watcher_resolved_font(watchers[index].watcher);
-      }
-      watchers[index].watcher = nullptr;
-    }
+  // Returns false if the font was already new_size and new_weight.
+  bool store(float new_size, WuiFontWeight new_weight) {
+    std::lock_guard<std::mutex> lock(value_mutex);
+    bool changed = size != new_size || weight != new_weight;
+    size = new_size;
+    weight = new_weight;
+    return changed;
   }
 
-  void clear_watchers() {
-    for (auto &entry : watchers) {
-      entry.active = false;
-      if (entry.watcher != nullptr) {
-        g_sym.waterui_drop_watcher_resolved_font(entry.watcher);
-        entry.watcher = nullptr;
-      }
+  void notify() {
+    float current_size;
+    WuiFontWeight current_weight;
+    {
+      std::lock_guard<std::mutex> lock(value_mutex);
+      current_size = size;
+      current_weight = weight;
     }
-    watchers.clear();
+    // Create a fresh WuiResolvedFont for each watcher call
+    watchers.for_each([&](WuiWatcher_ResolvedFont *watcher) {
+      g_sym.waterui_call_watcher_resolved_font(
+          watcher, g_sym.waterui_resolved_font_new(current_size,
+                                                   current_weight));
+    });
   }
 
-  void retain() { ++ref_count; }
-
   void release() {
-    if (--ref_count == 0) {
-      clear_watchers();
+    if (release_last()) {
       delete this;
     }
   }
@@ -1134,19 +3218,19 @@ struct ReactiveFontState {
 
 struct ReactiveGuardStateFont {
   ReactiveFontState *font_state;
-  size_t watcher_index;
+  WatcherHandle watcher;
 };
 
 WuiResolvedFont reactive_font_get(const void *data) {
-  auto *state = static_cast<const ReactiveFontState *>(data);
-  // Create a fresh WuiResolvedFont that Rust can take ownership of
-  return g_sym.waterui_resolved_font_new(state->size, state->weight);
+  auto *state = const_cast<ReactiveFontState *>(
+      static_cast<const ReactiveFontState *>(data));
+  return state->get();
 }
 
 void reactive_font_guard_drop(void *data) {
   auto *guard_state = static_cast<ReactiveGuardStateFont *>(data);
   if (guard_state->font_state) {
-    guard_state->font_state->remove_watcher(guard_state->watcher_index);
+    guard_state->font_state->watchers.remove(guard_state->watcher);
     guard_state->font_state->release();
   }
   delete guard_state;
@@ -1156,9 +3240,9 @@ WuiWatcherGuard *reactive_font_watch(const void *data,
                                      WuiWatcher_ResolvedFont *watcher) {
   auto *state = const_cast<ReactiveFontState *>(
       static_cast<const ReactiveFontState *>(data));
-  size_t index = state->add_watcher(watcher);
+  WatcherHandle handle = state->watchers.add(watcher);
   state->retain();
-  auto *guard_state = new ReactiveGuardStateFont{state, index};
+  auto *guard_state = new ReactiveGuardStateFont{state, handle};
   return g_sym.waterui_new_watcher_guard(guard_state, reactive_font_guard_drop);
 }
 
@@ -1170,57 +3254,33 @@ void reactive_font_drop(void *data) {
 }
 
 // Reactive Color Scheme State
-struct WatcherEntryScheme {
-  WuiWatcher_ColorScheme *watcher;
-  bool active;
-};
-
-struct ReactiveColorSchemeState {
-  WuiColorScheme scheme;
-  std::vector<WatcherEntryScheme> watchers;
-  int ref_count = 1;
+struct ReactiveColorSchemeState : ReactiveRefCount {
+  std::atomic<WuiColorScheme> scheme{};
+  WatcherRegistry<WuiWatcher_ColorScheme> watchers{
+      [](WuiWatcher_ColorScheme *watcher) {
+        g_sym.waterui_drop_watcher_color_scheme(watcher);
+      }};
 
   void set_scheme(WuiColorScheme new_scheme) {
-    scheme = new_scheme;
-    for (auto &entry : watchers) {
-      if (entry.active && entry.watcher != nullptr) {
-        g_sym.waterui_call_watcher_color_scheme(entry.watcher, scheme);
-      }
-    }
+    store(new_scheme);
+    notify();
   }
 
-  size_t add_watcher(WuiWatcher_ColorScheme *watcher) {
-    size_t index = watchers.size();
-    watchers.push_back({watcher, true});
-    return index;
+  // Returns false if the scheme was already new_scheme.
+  bool store(WuiColorScheme new_scheme) {
+    return scheme.exchange(new_scheme, std::memory_order_acq_rel) !=
+           new_scheme;
   }
 
-  void remove_watcher(size_t index) {
-    if (index < watchers.size()) {
-      watchers[index].active = false;
-      if (watchers[index].watcher != nullptr) {
-        g_sym.waterui_drop_watcher_color_scheme(watchers[index].watcher);
-      }
-      watchers[index].watcher = nullptr;
-    }
-  }
-
-  void clear_watchers() {
-    for (auto &entry : watchers) {
-      entry.active = false;
-      if (entry.watcher != nullptr) {
-        g_sym.waterui_drop_watcher_color_scheme(entry.watcher);
-        entry.watcher = nullptr;
-      }
-    }
-    watchers.clear();
+  void notify() {
+    WuiColorScheme current = scheme.load(std::memory_order_acquire);
+    watchers.for_each([&](WuiWatcher_ColorScheme *watcher) {
+      g_sym.waterui_call_watcher_color_scheme(watcher, current);
+    });
   }
 
-  void retain() { ++ref_count; }
-
   void release() {
-    if (--ref_count == 0) {
-      clear_watchers();
+    if (release_last()) {
       delete this;
     }
   }
@@ -1228,18 +3288,18 @@ struct ReactiveColorSchemeState {
 
 struct ReactiveGuardStateScheme {
   ReactiveColorSchemeState *scheme_state;
-  size_t watcher_index;
+  WatcherHandle watcher;
 };
 
 WuiColorScheme reactive_color_scheme_get(const void *data) {
   auto *state = static_cast<const ReactiveColorSchemeState *>(data);
-  return state->scheme;
+  return state->scheme.load(std::memory_order_acquire);
 }
 
 void reactive_color_scheme_guard_drop(void *data) {
   auto *guard_state = static_cast<ReactiveGuardStateScheme *>(data);
   if (guard_state->scheme_state) {
-    guard_state->scheme_state->remove_watcher(guard_state->watcher_index);
+    guard_state->scheme_state->watchers.remove(guard_state->watcher);
     guard_state->scheme_state->release();
   }
   delete guard_state;
@@ -1249,9 +3309,9 @@ WuiWatcherGuard *reactive_color_scheme_watch(const void *data,
                                              WuiWatcher_ColorScheme *watcher) {
   auto *state = const_cast<ReactiveColorSchemeState *>(
       static_cast<const ReactiveColorSchemeState *>(data));
-  size_t index = state->add_watcher(watcher);
+  WatcherHandle handle = state->watchers.add(watcher);
   state->retain();
-  auto *guard_state = new ReactiveGuardStateScheme{state, index};
+  auto *guard_state = new ReactiveGuardStateScheme{state, handle};
   return g_sym.waterui_new_watcher_guard(guard_state,
                                          reactive_color_scheme_guard_drop);
 }
@@ -1263,27 +3323,126 @@ void reactive_color_scheme_drop(void *data) {
   }
 }
 
+// Linear value of every 8-bit sRGB channel value, built on first use. Saves
+// three pow calls per converted color.
+const std::array<float, 256> &srgb_to_linear_table() {
+  static const std::array<float, 256> table = [] {
+    std::array<float, 256> values{};
+    for (size_t i = 0; i < values.size(); ++i) {
+      const float c = static_cast<float>(i) / 255.0f;
+      values[i] = c <= 0.04045f ? c / 12.92f
+                                : std::pow((c + 0.055f) / 1.055f, 2.4f);
+    }
+    return values;
+  }();
+  return table;
+}
+
 WuiResolvedColor argb_to_resolved_color(jint color) {
+  const std::array<float, 256> &linear = srgb_to_linear_table();
   const uint32_t argb = static_cast<uint32_t>(color);
-  const float a = ((argb >> 24) & 0xFFu) / 255.0f;
-  const float r = ((argb >> 16) & 0xFFu) / 255.0f;
-  const float g = ((argb >> 8) & 0xFFu) / 255.0f;
-  const float b = (argb & 0xFFu) / 255.0f;
-  const auto srgb_to_linear = [](float c) {
-    if (c <= 0.04045f) {
-      return c / 12.92f;
-    }
-    return std::pow((c + 0.055f) / 1.055f, 2.4f);
-  };
   WuiResolvedColor resolved{};
-  resolved.red = srgb_to_linear(r);
-  resolved.green = srgb_to_linear(g);
-  resolved.blue = srgb_to_linear(b);
-  resolved.opacity = a;
+  resolved.red = linear[(argb >> 16) & 0xFFu];
+  resolved.green = linear[(argb >> 8) & 0xFFu];
+  resolved.blue = linear[argb & 0xFFu];
+  resolved.opacity = ((argb >> 24) & 0xFFu) / 255.0f;
   resolved.headroom = 0.0f;
   return resolved;
 }
 
+// ============================================================================
+// Theme Palette
+// ============================================================================
+//
+// The reactive color, font and scheme states of the system theme, installed
+// and updated as one unit. An update stores every new value before notifying
+// anyone, so a watcher that reads another slot sees the new theme rather than
+// a half-switched one, and only watchers of slots whose value changed are
+// called. Colors and fonts keep the order they were installed in.
+
+struct ThemePalette {
+  ReactiveColorSchemeState *scheme = nullptr;
+  std::vector<ReactiveColorState *> colors;
+  std::vector<ReactiveFontState *> fonts;
+
+  ~ThemePalette() {
+    if (scheme != nullptr) {
+      scheme->release();
+    }
+    for (auto *color : colors) {
+      color->release();
+    }
+    for (auto *font : fonts) {
+      font->release();
+    }
+  }
+
+  void update(WuiColorScheme new_scheme, const jint *argb,
+              const jfloat *font_sizes, const jint *font_weights) {
+    std::vector<bool> colorChanged(colors.size());
+    std::vector<bool> fontChanged(fonts.size());
+    bool schemeChanged = scheme->store(new_scheme);
+    for (size_t i = 0; i < colors.size(); ++i) {
+      colorChanged[i] = colors[i]->store(argb_to_resolved_color(argb[i]));
+    }
+    for (size_t i = 0; i < fonts.size(); ++i) {
+      fontChanged[i] = fonts[i]->store(
+          font_sizes[i], static_cast<WuiFontWeight>(font_weights[i]));
+    }
+
+    if (schemeChanged) {
+      scheme->notify();
+    }
+    for (size_t i = 0; i < colors.size(); ++i) {
+      if (colorChanged[i]) {
+        colors[i]->notify();
+      }
+    }
+    for (size_t i = 0; i < fonts.size(); ++i) {
+      if (fontChanged[i]) {
+        fonts[i]->notify();
+      }
+    }
+  }
+};
+
+// Copies a palette's values out of their Java arrays. A null or short array
+// fails the whole call.
+struct ThemePaletteValues {
+  std::vector<jint> argb;
+  std::vector<jfloat> fontSizes;
+  std::vector<jint> fontWeights;
+
+  bool read(JNIEnv *env, jintArray argbArr, jfloatArray fontSizesArr,
+            jintArray fontWeightsArr, size_t colorCount, size_t fontCount) {
+    auto tooShort = [env](jarray array, size_t count) {
+      return count > 0 &&
+             (array == nullptr ||
+              static_cast<size_t>(env->GetArrayLength(array)) < count);
+    };
+    if (tooShort(argbArr, colorCount) || tooShort(fontSizesArr, fontCount) ||
+        tooShort(fontWeightsArr, fontCount)) {
+      __android_log_print(ANDROID_LOG_ERROR, LOG_TAG,
+                          "Theme palette arrays are shorter than the palette");
+      return false;
+    }
+    argb.resize(colorCount);
+    fontSizes.resize(fontCount);
+    fontWeights.resize(fontCount);
+    if (colorCount > 0) {
+      env->GetIntArrayRegion(argbArr, 0, static_cast<jsize>(colorCount),
+                             argb.data());
+    }
+    if (fontCount > 0) {
+      env->GetFloatArrayRegion(fontSizesArr, 0, static_cast<jsize>(fontCount),
+                               fontSizes.data());
+      env->GetIntArrayRegion(fontWeightsArr, 0, static_cast<jsize>(fontCount),
+                             fontWeights.data());
+    }
+    return true;
+  }
+};
+
 // ============================================================================
 // WatcherStruct field extraction
 // ============================================================================
@@ -1298,14 +3457,9 @@ WatcherStructFields watcher_struct_from_java(JNIEnv *env, jobject watcher_obj) {
   WatcherStructFields fields{0, 0, 0};
   if (watcher_obj == nullptr)
     return fields;
-  jclass cls = env->GetObjectClass(watcher_obj);
-  jfieldID dataField = env->GetFieldID(cls, "dataPtr", "J");
-  jfieldID callField = env->GetFieldID(cls, "callPtr", "J");
-  jfieldID dropField = env->GetFieldID(cls, "dropPtr", "J");
-  fields.data = env->GetLongField(watcher_obj, dataField);
-  fields.call = env->GetLongField(watcher_obj, callField);
-  fields.drop = env->GetLongField(watcher_obj, dropField);
-  env->DeleteLocalRef(cls);
+  fields.data = env->GetLongField(watcher_obj, gWatcherStructData);
+  fields.call = env->GetLongField(watcher_obj, gWatcherStructCall);
+  fields.drop = env->GetLongField(watcher_obj, gWatcherStructDrop);
   return fields;
 }
 
@@ -1397,9 +3551,9 @@ static bool init_webview_wrapper_jni(JNIEnv *env) {
       gWebViewWrapperClass, "setEventCallback",
       "(Ldev/waterui/android/components/WebViewEventCallback;)V");
   gWebViewWrapperRunJavaScript = env->GetMethodID(
-      gWebViewWrapperClass, "runJavaScript", "(Ljava/lang/String;JJ)V");
-  gWebViewWrapperRelease =
-      env->GetMethodID(gWebViewWrapperClass, "release", "()V");
+      gWebViewWrapperClass, "runJavaScript", "(Ljava/lang/String;J)V");
+  gWebViewWrapperDispose =
+      env->GetMethodID(gWebViewWrapperClass, "dispose", "(J)V");
 
   if (!gWebViewWrapperGetView || !gWebViewWrapperGoBack ||
       !gWebViewWrapperGoForward || !gWebViewWrapperGoTo ||
@@ -1407,58 +3561,741 @@ static bool init_webview_wrapper_jni(JNIEnv *env) {
       !gWebViewWrapperCanGoBack || !gWebViewWrapperCanGoForward ||
       !gWebViewWrapperSetUserAgent || !gWebViewWrapperSetRedirectsEnabled ||
       !gWebViewWrapperInjectScript || !gWebViewWrapperSetEventCallback ||
-      !gWebViewWrapperRunJavaScript || !gWebViewWrapperRelease) {
+      !gWebViewWrapperRunJavaScript || !gWebViewWrapperDispose) {
     clear_jni_exception(env, "resolving WebViewWrapper methods");
     __android_log_print(ANDROID_LOG_ERROR, LOG_TAG,
                         "Failed to resolve WebViewWrapper methods");
     return false;
   }
 
-  return true;
-}
+  return true;
+}
+
+static bool init_webview_callback_jni(JNIEnv *env) {
+  if (gNativeWebViewEventCallbackClass != nullptr &&
+      gNativeWebViewEventCallbackCtor != nullptr) {
+    return true;
+  }
+
+  jclass cls = find_app_class(
+      env, "dev/waterui/android/components/NativeWebViewEventCallback");
+  if (cls == nullptr) {
+    __android_log_print(ANDROID_LOG_ERROR, LOG_TAG,
+                        "Failed to find NativeWebViewEventCallback class");
+    return false;
+  }
+
+  gNativeWebViewEventCallbackClass =
+      reinterpret_cast<jclass>(env->NewGlobalRef(cls));
+  env->DeleteLocalRef(cls);
+
+  gNativeWebViewEventCallbackCtor =
+      env->GetMethodID(gNativeWebViewEventCallbackClass, "<init>", "(J)V");
+  if (gNativeWebViewEventCallbackCtor == nullptr) {
+    clear_jni_exception(env, "resolving NativeWebViewEventCallback ctor");
+    __android_log_print(
+        ANDROID_LOG_ERROR, LOG_TAG,
+        "Failed to find NativeWebViewEventCallback constructor");
+    return false;
+  }
+
+  return true;
+}
+
+static jobject create_webview_wrapper(JNIEnv *env) {
+  if (!init_webview_manager_jni(env)) {
+    return nullptr;
+  }
+  jobject wrapper =
+      env->CallStaticObjectMethod(gWebViewManagerClass, gWebViewManagerCreate);
+  if (env->ExceptionCheck()) {
+    clear_jni_exception(env, "creating WebViewWrapper");
+    return nullptr;
+  }
+  return wrapper;
+}
+
+// ============================================================================
+// GPU Surface Render Driver
+// ============================================================================
+//
+// Drives a WuiGpuSurfaceState from a dedicated render thread paced by that
+// thread's own AChoreographer, so wgpu frames neither wait on nor block the UI
+// thread. The render thread creates, renders and drops the state; other
+// threads only post resize/pause/stop requests and wake its looper.
+
+uint64_t pack_surface_size(uint32_t width, uint32_t height) {
+  return (static_cast<uint64_t>(width) << 32) | height;
+}
+
+// Per-frame timing for a render driver, written by the render thread and read
+// lock-free from any thread. Records live in a ring of kCapacity slots; a
+// reader copies the newest ones and drops any the writer lapped meanwhile.
+// Built with WATERUI_JNI_TRACING, each frame and skip also sets the
+// WaterUI.gpuSurface.* counters while a trace is recording, next to the
+// render sections; the ring itself backs gpuSurfaceStats in every build.
+class GpuFrameStats {
+public:
+  static constexpr size_t kCapacity = 128;
+  // gpuSurfaceStats layout: header, then (vsync, start latency, cpu) records.
+  static constexpr size_t kHeaderSize = 4;
+  static constexpr size_t kRecordStride = 3;
+
+  void record_frame(int64_t vsyncNanos, int64_t latencyNanos,
+                    int64_t cpuNanos) {
+    uint64_t index = written.load(std::memory_order_relaxed);
+    Slot &slot = slots[index % kCapacity];
+    slot.vsyncNanos.store(vsyncNanos, std::memory_order_relaxed);
+    slot.latencyNanos.store(latencyNanos, std::memory_order_relaxed);
+    slot.cpuNanos.store(cpuNanos, std::memory_order_relaxed);
+    written.store(index + 1, std::memory_order_release);
+#ifdef WATERUI_JNI_TRACING
+    ATraceSetCounterFn setCounter = atrace_set_counter();
+    if (setCounter != nullptr && ATrace_isEnabled()) {
+      setCounter("WaterUI.gpuSurface.startLatencyUs", latencyNanos / 1000);
+      setCounter("WaterUI.gpuSurface.cpuUs", cpuNanos / 1000);
+    }
+#endif
+  }
+
+  void record_skip() {
+#ifdef WATERUI_JNI_TRACING
+    uint64_t total = skipped.fetch_add(1, std::memory_order_relaxed) + 1;
+    ATraceSetCounterFn setCounter = atrace_set_counter();
+    if (setCounter != nullptr && ATrace_isEnabled()) {
+      setCounter("WaterUI.gpuSurface.skippedFrames",
+                 static_cast<int64_t>(total));
+    }
+#else
+    skipped.fetch_add(1, std::memory_order_relaxed);
+#endif
+  }
+
+  void record_reconfigure() {
+    reconfigurations.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Writes the header and up to the newest (capacity - kHeaderSize) /
+  // kRecordStride records, oldest first. Returns the longs written.
+  size_t copy_to(jlong *out, size_t capacity) const {
+    if (capacity < kHeaderSize)
+      return 0;
+    uint64_t end = written.load(std::memory_order_acquire);
+    size_t wanted = std::min<uint64_t>(
+        std::min<uint64_t>(end, kCapacity),
+        (capacity - kHeaderSize) / kRecordStride);
+    uint64_t begin = end - wanted;
+    for (uint64_t i = begin; i < end; ++i) {
+      const Slot &slot = slots[i % kCapacity];
+      jlong *record = out + kHeaderSize + (i - begin) * kRecordStride;
+      record[0] = slot.vsyncNanos.load(std::memory_order_relaxed);
+      record[1] = slot.latencyNanos.load(std::memory_order_relaxed);
+      record[2] = slot.cpuNanos.load(std::memory_order_relaxed);
+    }
+    // Records the writer overwrote (or may be overwriting) while we copied
+    // are stale; drop them.
+    uint64_t after = written.load(std::memory_order_acquire);
+    uint64_t lapped = after + 1 > kCapacity ? after + 1 - kCapacity : 0;
+    size_t stale = lapped > begin ? static_cast<size_t>(
+                                        std::min<uint64_t>(lapped - begin,
+                                                           wanted))
+                                  : 0;
+    if (stale > 0) {
+      std::memmove(out + kHeaderSize, out + kHeaderSize + stale * kRecordStride,
+                   (wanted - stale) * kRecordStride * sizeof(jlong));
+    }
+    size_t count = wanted - stale;
+    out[0] = static_cast<jlong>(end);
+    out[1] = static_cast<jlong>(skipped.load(std::memory_order_relaxed));
+    out[2] =
+        static_cast<jlong>(reconfigurations.load(std::memory_order_relaxed));
+    out[3] = static_cast<jlong>(count);
+    return kHeaderSize + count * kRecordStride;
+  }
+
+private:
+  struct Slot {
+    std::atomic<int64_t> vsyncNanos{0};
+    std::atomic<int64_t> latencyNanos{0};
+    std::atomic<int64_t> cpuNanos{0};
+  };
+
+  Slot slots[kCapacity];
+  std::atomic<uint64_t> written{0};
+  std::atomic<uint64_t> skipped{0};
+  std::atomic<uint64_t> reconfigurations{0};
+};
+
+class GpuRenderDriver {
+public:
+  // Takes ownership of the window reference and the renderer.
+  GpuRenderDriver(ANativeWindow *window, void *renderer, uint32_t width,
+                  uint32_t height)
+      : window(window), renderer(renderer),
+        pendingSize(pack_surface_size(width, height)) {}
+
+  ~GpuRenderDriver() { ANativeWindow_release(window); }
+
+  // Spawns the render thread and waits for it to initialize the surface.
+  bool start() {
+    if (pthread_create(&thread, nullptr, &GpuRenderDriver::thread_main,
+                       this) != 0) {
+      __android_log_print(ANDROID_LOG_ERROR, LOG_TAG,
+                          "GpuRenderDriver: failed to spawn render thread");
+      return false;
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    startedCv.wait(lock, [this] { return started; });
+    if (looper == nullptr) {
+      lock.unlock();
+      pthread_join(thread, nullptr);
+      return false;
+    }
+    return true;
+  }
+
+  // Applied before the next rendered frame.
+  void resize(uint32_t width, uint32_t height) {
+    pendingSize.store(pack_surface_size(width, height),
+                      std::memory_order_release);
+  }
+
+  void set_paused(bool value) {
+    paused.store(value, std::memory_order_release);
+    wake();
+  }
+
+  const GpuFrameStats &frame_stats() const { return stats; }
+
+  // Stops rendering, drops the state on the render thread and joins it.
+  void stop() {
+    stopping.store(true, std::memory_order_release);
+    wake();
+    pthread_join(thread, nullptr);
+  }
+
+private:
+  static void *thread_main(void *self) {
+    static_cast<GpuRenderDriver *>(self)->run();
+    return nullptr;
+  }
+
+  static void on_frame64(int64_t frameTimeNanos, void *self) {
+    static_cast<GpuRenderDriver *>(self)->on_frame(frameTimeNanos);
+  }
+
+  static void on_frame32(long frameTimeNanos, void *self) {
+    static_cast<GpuRenderDriver *>(self)->on_frame(
+        static_cast<int64_t>(frameTimeNanos));
+  }
+
+  void run() {
+    pthread_setname_np(pthread_self(), "WaterUI-gpu");
+    ALooper *threadLooper = ALooper_prepare(0);
+    ALooper_acquire(threadLooper);
+
+    uint64_t size = pendingSize.load(std::memory_order_acquire);
+    WuiGpuSurface surface{};
+    surface.renderer = renderer;
+    state = g_sym.waterui_gpu_surface_init(
+        &surface, window, static_cast<uint32_t>(size >> 32),
+        static_cast<uint32_t>(size));
+    appliedSize = size;
+    choreographer = AChoreographer_getInstance();
+    const ChoreographerApi &api = choreographer_api();
+    bool ok = state != nullptr && choreographer != nullptr &&
+              (api.postFrameCallback64 != nullptr ||
+               api.postFrameCallback != nullptr);
+    if (!ok) {
+      __android_log_print(ANDROID_LOG_ERROR, LOG_TAG,
+                          "GpuRenderDriver: surface or choreographer init "
+                          "failed");
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      looper = ok ? threadLooper : nullptr;
+      started = true;
+    }
+    startedCv.notify_all();
+
+    if (ok) {
+      while (!stopping.load(std::memory_order_acquire)) {
+        if (!callbackPosted && !paused.load(std::memory_order_acquire)) {
+          post_frame();
+        }
+        ALooper_pollOnce(-1, nullptr, nullptr, nullptr);
+      }
+    }
+
+    if (state != nullptr) {
+      g_sym.waterui_gpu_surface_drop(state);
+      state = nullptr;
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      looper = nullptr;
+    }
+    ALooper_release(threadLooper);
+  }
+
+  void post_frame() {
+    const ChoreographerApi &api = choreographer_api();
+    if (api.postFrameCallback64 != nullptr) {
+      api.postFrameCallback64(choreographer, &GpuRenderDriver::on_frame64,
+                              this);
+    } else {
+      api.postFrameCallback(choreographer, &GpuRenderDriver::on_frame32, this);
+    }
+    callbackPosted = true;
+  }
+
+  void on_frame(int64_t frameTimeNanos) {
+    callbackPosted = false;
+    if (stopping.load(std::memory_order_acquire) ||
+        paused.load(std::memory_order_acquire)) {
+      return; // Resumed by set_paused(false), which wakes the loop
+    }
+
+    if (lastFrameNanos != 0 && frameTimeNanos > lastFrameNanos) {
+      track_frame_period(frameTimeNanos - lastFrameNanos);
+    }
+    lastFrameNanos = frameTimeNanos;
+
+    // A callback arriving more than a vsync late means the previous frame
+    // has not been presented in time; skip this one to fall back in phase
+    // instead of queueing more work behind it.
+    int64_t startNanos = monotonic_nanos();
+    if (framePeriodNanos > 0 && startNanos - frameTimeNanos > framePeriodNanos) {
+      stats.record_skip();
+      post_frame();
+      return;
+    }
+
+    uint64_t size = pendingSize.load(std::memory_order_acquire);
+    uint32_t width = static_cast<uint32_t>(size >> 32);
+    uint32_t height = static_cast<uint32_t>(size);
+    if (size != appliedSize) {
+      {
+        WUI_TRACE_SCOPE("WaterUI.gpuSurface.reconfigure");
+        ANativeWindow_setBuffersGeometry(window, static_cast<int32_t>(width),
+                                         static_cast<int32_t>(height), 0);
+      }
+      appliedSize = size;
+      stats.record_reconfigure();
+    }
+    if (width > 0 && height > 0) {
+      {
+        WUI_TRACE_SCOPE("WaterUI.gpuSurface.render");
+        g_sym.waterui_gpu_surface_render(state, width, height);
+      }
+      int64_t endNanos = monotonic_nanos();
+      stats.record_frame(frameTimeNanos, startNanos - frameTimeNanos,
+                         endNanos - startNanos);
+    }
+    post_frame();
+  }
+
+  // The vsync period is the shortest gap between callbacks: a skipped or late
+  // frame only ever lengthens a gap. The minimum is re-taken over each window
+  // of kPeriodWindowFrames, so a drop in refresh rate is picked up.
+  static constexpr int kPeriodWindowFrames = 120;
+
+  void track_frame_period(int64_t intervalNanos) {
+    if (framePeriodNanos == 0 || intervalNanos < framePeriodNanos) {
+      framePeriodNanos = intervalNanos;
+    }
+    if (windowMinNanos == 0 || intervalNanos < windowMinNanos) {
+      windowMinNanos = intervalNanos;
+    }
+    if (++windowFrames == kPeriodWindowFrames) {
+      framePeriodNanos = windowMinNanos;
+      windowMinNanos = 0;
+      windowFrames = 0;
+    }
+  }
+
+  void wake() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (looper != nullptr) {
+      ALooper_wake(looper);
+    }
+  }
+
+  ANativeWindow *window;
+  void *renderer;
+  pthread_t thread{};
+
+  std::mutex mutex;
+  std::condition_variable startedCv;
+  bool started = false;      // guarded by mutex
+  ALooper *looper = nullptr; // guarded by mutex; null once the loop exits
+
+  std::atomic<uint64_t> pendingSize;
+  std::atomic<bool> paused{false};
+  std::atomic<bool> stopping{false};
+
+  GpuFrameStats stats;
+
+  // Render thread only.
+  WuiGpuSurfaceState *state = nullptr;
+  AChoreographer *choreographer = nullptr;
+  uint64_t appliedSize = 0;
+  bool callbackPosted = false;
+  int64_t lastFrameNanos = 0;
+  int64_t framePeriodNanos = 0;
+  int64_t windowMinNanos = 0;
+  int windowFrames = 0;
+};
+
+// ============================================================================
+// Animation Engine
+// ============================================================================
+// Animates f32 watcher values natively. An animated watcher reads the
+// WuiAnimation off each emit's metadata and retargets its slot; the engine
+// steps every moving slot on the main thread's AChoreographer, writes the new
+// values into the direct buffer NativeAnimator allocated, and makes a single
+// onFrame(count) upcall listing the slots that changed. Emits from other
+// threads wake the main looper through a pipe rather than posting to its
+// choreographer, which is only safe from its own thread.
+//
+// Buffer layout (must match NativeAnimator in Kotlin): capacity floats of
+// slot values, then capacity ints naming the slots changed this frame.
+
+struct AnimationSlot {
+  float value = 0.0f;
+  float from = 0.0f;
+  float target = 0.0f;
+  float velocity = 0.0f;    // Spring only
+  float threshold = 0.01f;  // Smallest visible change
+  float stiffness = 0.0f;   // Spring only
+  float damping = 0.0f;     // Spring only: 2 * ratio * sqrt(stiffness)
+  int64_t startNanos = 0;   // 0 until the first frame after a retarget
+  int64_t lastNanos = 0;
+  int64_t durationNanos = 0;
+  WuiAnimation_Tag curve = WuiAnimation_None;
+  uint32_t generation = 0;
+  bool open = false;
+  bool moving = false;
+  bool dirty = false; // value changed and not yet reported
+};
+
+// Handed to Rust as the watcher data of an animated f32 watcher.
+struct AnimatedWatcher {
+  uint32_t slot;
+  uint32_t generation;
+};
+
+class AnimationEngine {
+public:
+  static constexpr int64_t kDefaultDurationNanos = 250000000LL;
+  // Longest step integrated at once, so a stalled frame does not overshoot.
+  static constexpr int64_t kMaxStepNanos = 100000000LL;
+  static constexpr float kSpringSubstepSeconds = 0.004f;
+  static constexpr float kPi = 3.14159265358979f;
+
+  // Must be called on the main thread with NativeAnimator's buffer.
+  static AnimationEngine *create(JNIEnv *env, jobject buffer, jint capacity) {
+    if (buffer == nullptr || capacity <= 0 ||
+        env->GetDirectBufferCapacity(buffer) <
+            static_cast<jlong>(capacity) * 8) {
+      return nullptr;
+    }
+    const ChoreographerApi &api = choreographer_api();
+    AChoreographer *choreographer = AChoreographer_getInstance();
+    ALooper *looper = ALooper_forThread();
+    if (choreographer == nullptr || looper == nullptr ||
+        (api.postFrameCallback64 == nullptr &&
+         api.postFrameCallback == nullptr)) {
+      return nullptr;
+    }
+    jclass cls =
+        new_global_class(env, "dev/waterui/android/runtime/NativeAnimator");
+    if (cls == nullptr) {
+      return nullptr;
+    }
+    jmethodID onFrame = env->GetStaticMethodID(cls, "onFrame", "(I)V");
+    int fds[2];
+    if (onFrame == nullptr || pipe2(fds, O_NONBLOCK | O_CLOEXEC) != 0) {
+      clear_jni_exception(env, "resolving NativeAnimator.onFrame");
+      env->DeleteGlobalRef(cls);
+      return nullptr;
+    }
+    auto *engine = new AnimationEngine();
+    engine->values = static_cast<float *>(env->GetDirectBufferAddress(buffer));
+    engine->changed = reinterpret_cast<int32_t *>(engine->values + capacity);
+    engine->slots.resize(static_cast<size_t>(capacity));
+    engine->choreographer = choreographer;
+    engine->looper = looper;
+    engine->ownerThread = pthread_self();
+    engine->animatorClass = cls;
+    engine->onFrameMethod = onFrame;
+    engine->wakeRead = fds[0];
+    engine->wakeWrite = fds[1];
+    ALooper_acquire(looper);
+    ALooper_addFd(looper, fds[0], ALOOPER_POLL_CALLBACK, ALOOPER_EVENT_INPUT,
+                  &AnimationEngine::on_wake, engine);
+    return engine;
+  }
+
+  // Returns the slot index, or -1 when every slot is in use.
+  int32_t open_slot(float initial, float threshold) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (size_t i = 0; i < slots.size(); ++i) {
+      AnimationSlot &slot = slots[i];
+      if (slot.open)
+        continue;
+      uint32_t generation = slot.generation;
+      slot = AnimationSlot{};
+      slot.generation = generation;
+      slot.open = true;
+      slot.value = slot.target = initial;
+      slot.threshold = threshold > 0.0f ? threshold : 0.01f;
+      values[i] = initial;
+      return static_cast<int32_t>(i);
+    }
+    return -1;
+  }
+
+  void close_slot(int32_t index) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (AnimationSlot *slot = slot_at(index)) {
+      slot->open = slot->moving = slot->dirty = false;
+      slot->generation++;
+    }
+  }
+
+  // Watcher data for an emit into slot index, or nullptr if it is closed.
+  AnimatedWatcher *new_watcher(int32_t index) {
+    std::lock_guard<std::mutex> lock(mutex);
+    AnimationSlot *slot = slot_at(index);
+    if (slot == nullptr || !slot->open)
+      return nullptr;
+    return new AnimatedWatcher{static_cast<uint32_t>(index), slot->generation};
+  }
+
+  // Called from any thread with each emit of an animated watcher.
+  void retarget(const AnimatedWatcher &watcher, float target,
+                const WuiAnimation &animation) {
+    std::lock_guard<std::mutex> lock(mutex);
+    AnimationSlot *slot = slot_at(static_cast<int32_t>(watcher.slot));
+    if (slot == nullptr || slot->generation != watcher.generation)
+      return;
+    slot->target = target;
+    slot->curve = animation.tag;
+    if (animation.tag == WuiAnimation_None || !std::isfinite(target) ||
+        !std::isfinite(slot->value)) {
+      slot->value = target;
+      slot->velocity = 0.0f;
+      slot->moving = false;
+    } else if (animation.tag == WuiAnimation_Spring) {
+      // Like SpringAnimation, a retarget keeps the current velocity.
+      float stiffness = std::max(animation.spring.stiffness, 1.0f);
+      float ratio = std::min(
+          std::max(animation.spring.damping / (2.0f * std::sqrt(stiffness)),
+                   0.05f),
+          5.0f);
+      slot->stiffness = stiffness;
+      slot->damping = 2.0f * ratio * std::sqrt(stiffness);
+      slot->moving = true;
+      slot->startNanos = 0;
+    } else {
+      slot->from = slot->value;
+      slot->velocity = 0.0f;
+      slot->durationNanos = timed_duration_nanos(animation);
+      slot->moving = true;
+      slot->startNanos = 0;
+    }
+    slot->dirty = true;
+    schedule_locked();
+  }
+
+private:
+  AnimationSlot *slot_at(int32_t index) {
+    if (index < 0 || static_cast<size_t>(index) >= slots.size())
+      return nullptr;
+    return &slots[static_cast<size_t>(index)];
+  }
+
+  static int64_t timed_duration_nanos(const WuiAnimation &animation) {
+    uint64_t ms = 0;
+    switch (animation.tag) {
+    case WuiAnimation_Linear:
+      ms = animation.linear.duration_ms;
+      break;
+    case WuiAnimation_EaseIn:
+      ms = animation.ease_in.duration_ms;
+      break;
+    case WuiAnimation_EaseOut:
+      ms = animation.ease_out.duration_ms;
+      break;
+    case WuiAnimation_EaseInOut:
+      ms = animation.ease_in_out.duration_ms;
+      break;
+    default:
+      return kDefaultDurationNanos;
+    }
+    return static_cast<int64_t>(ms) * 1000000LL;
+  }
+
+  // Same curves as interpolatorFor() in ViewAnimations.kt.
+  static float ease(WuiAnimation_Tag curve, float t) {
+    switch (curve) {
+    case WuiAnimation_Linear:
+      return t;
+    case WuiAnimation_EaseIn: // AccelerateInterpolator(2)
+      return t * t * t * t;
+    case WuiAnimation_EaseOut: { // DecelerateInterpolator(2)
+      float u = 1.0f - t;
+      return 1.0f - u * u * u * u;
+    }
+    default: // AccelerateDecelerateInterpolator
+      return std::cos((t + 1.0f) * kPi) * 0.5f + 0.5f;
+    }
+  }
+
+  void step(AnimationSlot &slot, int64_t frameNanos) {
+    if (slot.startNanos == 0) {
+      slot.startNanos = slot.lastNanos = frameNanos;
+    }
+    if (slot.curve != WuiAnimation_Spring) {
+      int64_t elapsed = frameNanos - slot.startNanos;
+      if (slot.durationNanos <= 0 || elapsed >= slot.durationNanos) {
+        slot.value = slot.target;
+        slot.moving = false;
+        return;
+      }
+      float t = static_cast<float>(elapsed) /
+                static_cast<float>(slot.durationNanos);
+      slot.value = slot.from + (slot.target - slot.from) * ease(slot.curve, t);
+      return;
+    }
+
+    int64_t stepNanos =
+        std::min(std::max<int64_t>(frameNanos - slot.lastNanos, 0),
+                 kMaxStepNanos);
+    slot.lastNanos = frameNanos;
+    float remaining = static_cast<float>(stepNanos) * 1e-9f;
+    while (remaining > 0.0f) {
+      float dt = std::min(remaining, kSpringSubstepSeconds);
+      float accel = -slot.stiffness * (slot.value - slot.target) -
+                    slot.damping * slot.velocity;
+      slot.velocity += accel * dt;
+      slot.value += slot.velocity * dt;
+      remaining -= dt;
+    }
+    // SpringForce's settle thresholds for the slot's visible change.
+    float valueThreshold = slot.threshold * 0.75f;
+    if (std::fabs(slot.value - slot.target) < valueThreshold &&
+        std::fabs(slot.velocity) < valueThreshold * 62.5f) {
+      slot.value = slot.target;
+      slot.velocity = 0.0f;
+      slot.moving = false;
+    }
+  }
 
-static bool init_webview_callback_jni(JNIEnv *env) {
-  if (gNativeWebViewEventCallbackClass != nullptr &&
-      gNativeWebViewEventCallbackCtor != nullptr) {
-    return true;
+  void schedule_locked() {
+    if (frameScheduled)
+      return;
+    frameScheduled = true;
+    if (pthread_equal(pthread_self(), ownerThread)) {
+      post_frame();
+    } else {
+      char byte = 1;
+      // A full pipe already has a wakeup pending.
+      (void)write(wakeWrite, &byte, 1);
+    }
   }
 
-  jclass cls = find_app_class(
-      env, "dev/waterui/android/components/NativeWebViewEventCallback");
-  if (cls == nullptr) {
-    __android_log_print(ANDROID_LOG_ERROR, LOG_TAG,
-                        "Failed to find NativeWebViewEventCallback class");
-    return false;
+  void post_frame() {
+    const ChoreographerApi &api = choreographer_api();
+    if (api.postFrameCallback64 != nullptr) {
+      api.postFrameCallback64(choreographer, &AnimationEngine::on_frame64,
+                              this);
+    } else {
+      api.postFrameCallback(choreographer, &AnimationEngine::on_frame32, this);
+    }
   }
 
-  gNativeWebViewEventCallbackClass =
-      reinterpret_cast<jclass>(env->NewGlobalRef(cls));
-  env->DeleteLocalRef(cls);
+  static int on_wake(int fd, int, void *self) {
+    char drain[64];
+    while (read(fd, drain, sizeof(drain)) > 0) {
+    }
+    static_cast<AnimationEngine *>(self)->post_frame();
+    return 1;
+  }
+
+  static void on_frame64(int64_t frameTimeNanos, void *self) {
+    static_cast<AnimationEngine *>(self)->on_frame(frameTimeNanos);
+  }
+
+  static void on_frame32(long frameTimeNanos, void *self) {
+    static_cast<AnimationEngine *>(self)->on_frame(
+        static_cast<int64_t>(frameTimeNanos));
+  }
+
+  void on_frame(int64_t frameNanos) {
+    WUI_TRACE_SCOPE("WaterUI.animator.frame");
+    int32_t count = 0;
+    bool moving = false;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      for (size_t i = 0; i < slots.size(); ++i) {
+        AnimationSlot &slot = slots[i];
+        if (!slot.open || (!slot.moving && !slot.dirty))
+          continue;
+        if (slot.moving)
+          step(slot, frameNanos);
+        slot.dirty = false;
+        moving = moving || slot.moving;
+        values[i] = slot.value;
+        changed[count++] = static_cast<int32_t>(i);
+      }
+      frameScheduled = moving;
+      if (moving)
+        post_frame();
+    }
+    if (count == 0)
+      return;
+    ScopedEnv scoped;
+    if (scoped.env == nullptr)
+      return;
+    WUI_TRACE_UPCALL();
+    scoped.env->CallStaticVoidMethod(animatorClass, onFrameMethod, count);
+    clear_jni_exception(scoped.env, "delivering NativeAnimator.onFrame");
+  }
+
+  std::mutex mutex;
+  std::vector<AnimationSlot> slots; // guarded by mutex
+  bool frameScheduled = false;      // guarded by mutex
+  float *values = nullptr;   // Java buffer; written only by on_frame/open_slot
+  int32_t *changed = nullptr;
+  AChoreographer *choreographer = nullptr;
+  ALooper *looper = nullptr;
+  pthread_t ownerThread{};
+  jclass animatorClass = nullptr;
+  jmethodID onFrameMethod = nullptr;
+  int wakeRead = -1;
+  int wakeWrite = -1;
+};
 
-  gNativeWebViewEventCallbackCtor =
-      env->GetMethodID(gNativeWebViewEventCallbackClass, "<init>", "(J)V");
-  if (gNativeWebViewEventCallbackCtor == nullptr) {
-    clear_jni_exception(env, "resolving NativeWebViewEventCallback ctor");
-    __android_log_print(
-        ANDROID_LOG_ERROR, LOG_TAG,
-        "Failed to find NativeWebViewEventCallback constructor");
-    return false;
-  }
+// Created once by NativeAnimator and never freed: watcher data may outlive
+// any one view, and the engine is tied to the main thread for the process.
+std::atomic<AnimationEngine *> g_animation_engine{nullptr};
 
-  return true;
+void watcher_animated_float_call(const void *data, float value,
+                                 WuiWatcherMetadata *metadata) {
+  WUI_TRACE_SCOPE("WaterUI.watcher.animated_float");
+  WuiAnimation animation = g_sym.waterui_get_animation(metadata);
+  g_sym.waterui_drop_watcher_metadata(metadata);
+  AnimationEngine *engine = g_animation_engine.load(std::memory_order_acquire);
+  auto *watcher = static_cast<const AnimatedWatcher *>(data);
+  if (engine != nullptr && watcher != nullptr) {
+    engine->retarget(*watcher, value, animation);
+  }
 }
 
-static jobject create_webview_wrapper(JNIEnv *env) {
-  if (!init_webview_manager_jni(env)) {
-    return nullptr;
-  }
-  jobject wrapper =
-      env->CallStaticObjectMethod(gWebViewManagerClass, gWebViewManagerCreate);
-  if (env->ExceptionCheck()) {
-    clear_jni_exception(env, "creating WebViewWrapper");
-    return nullptr;
-  }
-  return wrapper;
+void watcher_animated_float_drop(void *data) {
+  delete static_cast<AnimatedWatcher *>(data);
 }
 
 } // namespace
@@ -1483,30 +4320,18 @@ JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM *vm, void *) {
     return global;
   };
 
-  gBooleanClass = init_class("java/lang/Boolean");
-  gIntegerClass = init_class("java/lang/Integer");
-  gDoubleClass = init_class("java/lang/Double");
-  gFloatClass = init_class("java/lang/Float");
+  gObjectClass = init_class("java/lang/Object");
   gLongClass = init_class("java/lang/Long");
   gMetadataClass =
       init_class("dev/waterui/android/reactive/WuiWatcherMetadata");
   gWatcherStructClass = init_class("dev/waterui/android/runtime/WatcherStruct");
   gTypeIdStructClass = init_class("dev/waterui/android/runtime/TypeIdStruct");
 
-  if (!gBooleanClass || !gIntegerClass || !gDoubleClass || !gFloatClass ||
-      !gLongClass || !gMetadataClass || !gWatcherStructClass ||
-      !gTypeIdStructClass) {
+  if (!gObjectClass || !gLongClass || !gMetadataClass ||
+      !gWatcherStructClass || !gTypeIdStructClass) {
     return JNI_ERR;
   }
 
-  gBooleanValueOf = env->GetStaticMethodID(gBooleanClass, "valueOf",
-                                           "(Z)Ljava/lang/Boolean;");
-  gIntegerValueOf = env->GetStaticMethodID(gIntegerClass, "valueOf",
-                                           "(I)Ljava/lang/Integer;");
-  gDoubleValueOf =
-      env->GetStaticMethodID(gDoubleClass, "valueOf", "(D)Ljava/lang/Double;");
-  gFloatValueOf =
-      env->GetStaticMethodID(gFloatClass, "valueOf", "(F)Ljava/lang/Float;");
   gLongValueOf =
       env->GetStaticMethodID(gLongClass, "valueOf", "(J)Ljava/lang/Long;");
   gMetadataCtor = env->GetMethodID(gMetadataClass, "<init>", "(J)V");
@@ -1514,9 +4339,8 @@ JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM *vm, void *) {
       env->GetMethodID(gWatcherStructClass, "<init>", "(JJJ)V");
   gTypeIdStructCtor = env->GetMethodID(gTypeIdStructClass, "<init>", "(JJ)V");
 
-  if (!gBooleanValueOf || !gIntegerValueOf || !gDoubleValueOf ||
-      !gFloatValueOf || !gLongValueOf || !gMetadataCtor ||
-      !gWatcherStructCtor || !gTypeIdStructCtor) {
+  if (!gLongValueOf || !gMetadataCtor || !gWatcherStructCtor ||
+      !gTypeIdStructCtor) {
     return JNI_ERR;
   }
 
@@ -1539,10 +4363,7 @@ JNIEXPORT void JNICALL JNI_OnUnload(JavaVM *, void *) {
       obj = nullptr;
     }
   };
-  release(gBooleanClass);
-  release(gIntegerClass);
-  release(gDoubleClass);
-  release(gFloatClass);
+  release(gObjectClass);
   release(gLongClass);
   release(gMetadataClass);
   release(gWatcherStructClass);
@@ -1551,10 +4372,8 @@ JNIEXPORT void JNICALL JNI_OnUnload(JavaVM *, void *) {
   release(gWebViewWrapperClass);
   release(gNativeWebViewEventCallbackClass);
   release_obj(gAppClassLoader);
-  gBooleanValueOf = nullptr;
-  gIntegerValueOf = nullptr;
-  gDoubleValueOf = nullptr;
-  gFloatValueOf = nullptr;
+  release_struct_classes(scoped.env);
+  release_watcher_dispatcher(scoped.env);
   gLongValueOf = nullptr;
   gMetadataCtor = nullptr;
   gWatcherStructCtor = nullptr;
@@ -1573,7 +4392,7 @@ JNIEXPORT void JNICALL JNI_OnUnload(JavaVM *, void *) {
   gWebViewWrapperInjectScript = nullptr;
   gWebViewWrapperSetEventCallback = nullptr;
   gWebViewWrapperRunJavaScript = nullptr;
-  gWebViewWrapperRelease = nullptr;
+  gWebViewWrapperDispose = nullptr;
   gNativeWebViewEventCallbackCtor = nullptr;
   gClassLoaderLoadClass = nullptr;
   gClassGetClassLoader = nullptr;
@@ -1592,10 +4411,14 @@ void waterui_present_media_picker(WuiMediaFilterType filter,
 void waterui_load_media(uint32_t id, MediaLoadCallback callback);
 static WuiWebViewHandle create_webview_handle();
 
-// Bootstrap - loads symbols from libwaterui_app.so
+// Bootstrap - loads the core symbols from libwaterui_app.so. Component groups
+// are resolved on first use (see ensure_symbol_group); their type ids are
+// cached up front.
 JNIEXPORT void JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_nativeInit(JNIEnv *env, jclass clazz) {
   init_app_class_loader(env, clazz);
+  init_struct_classes(env);
+  init_watcher_dispatcher(env);
   constexpr const char *so_name = "libwaterui_app.so";
 
   void *handle = dlopen(so_name, RTLD_NOW | RTLD_GLOBAL);
@@ -1608,7 +4431,9 @@ Java_dev_waterui_android_ffi_WatcherJni_nativeInit(JNIEnv *env, jclass clazz) {
     return;
   }
 
-  dlerror();
+  g_app_handle = handle;
+  if (!adopt_symbol_table(handle)) {
+    dlerror();
 #define LOAD_SYMBOL(name)                                                      \
   g_sym.name = reinterpret_cast<decltype(&::name)>(dlsym(handle, #name));      \
   if (g_sym.name == nullptr) {                                                 \
@@ -1619,33 +4444,72 @@ Java_dev_waterui_android_ffi_WatcherJni_nativeInit(JNIEnv *env, jclass clazz) {
     throw_unsatisfied(env, error);                                             \
     return;                                                                    \
   }
-  WATCHER_SYMBOL_LIST(LOAD_SYMBOL)
+    WATCHER_SYMBOL_LIST(LOAD_SYMBOL)
 #undef LOAD_SYMBOL
+    CORE_TYPE_ID_LIST(CACHE_TYPE_ID)
+    prefetch_group_type_ids(handle);
+  }
+  {
+    std::lock_guard<std::mutex> lock(g_symbol_group_mutex);
+    publish_component_kinds();
+  }
   g_symbols_ready = true;
   __android_log_print(ANDROID_LOG_INFO, LOG_TAG,
                       "Loaded watcher symbols from %s", so_name);
 }
 
+// Prefix used to name otherwise unnamed Rust threads when they are first
+// attached to the JVM ("<prefix>-<tid>", truncated to the 15-character pthread
+// limit). Only affects threads attached after the call.
+JNIEXPORT void JNICALL
+Java_dev_waterui_android_ffi_WatcherJni_setNativeThreadNamePrefix(
+    JNIEnv *env, jclass, jstring prefix) {
+  if (prefix == nullptr)
+    return;
+  const char *chars = env->GetStringUTFChars(prefix, nullptr);
+  if (chars == nullptr)
+    return;
+  {
+    std::lock_guard<std::mutex> lock(g_thread_name_mutex);
+    snprintf(g_thread_name_prefix, sizeof(g_thread_name_prefix), "%s", chars);
+  }
+  env->ReleaseStringUTFChars(prefix, chars);
+}
+
+// Called by WatcherDispatcher once per Choreographer frame on the main thread.
+// Hands every queued emit to Kotlin in one deliverBatch call.
+JNIEXPORT void JNICALL
+Java_dev_waterui_android_ffi_WatcherJni_flushWatcherQueue(JNIEnv *env, jclass) {
+  flush_watcher_queue(env);
+}
+
 // ========== Watcher Creation ==========
 
-#define DEFINE_WATCHER_CREATOR(JavaName, WatcherType, ValueType)               \
+#define DEFINE_WATCHER_CREATOR(JavaName, WatcherType, ValueType, ...)          \
   JNIEXPORT jobject JNICALL                                                    \
       Java_dev_waterui_android_ffi_WatcherJni_##JavaName(JNIEnv *env, jclass,  \
                                                          jobject callback) {   \
-    auto *state = create_watcher_state(env, callback);                         \
+    auto *state = create_watcher_state(env, callback, ##__VA_ARGS__);          \
+    WUI_TRACK_HANDLE(WatcherCallback, state);                                  \
     return new_watcher_struct(                                                 \
         env, ptr_to_jlong(state),                                              \
         ptr_to_jlong(reinterpret_cast<void *>(watcher_##ValueType##_call)),    \
         ptr_to_jlong(reinterpret_cast<void *>(watcher_##ValueType##_drop)));   \
   }
 
-DEFINE_WATCHER_CREATOR(createBoolWatcher, WuiWatcher_bool, bool)
-DEFINE_WATCHER_CREATOR(createIntWatcher, WuiWatcher_i32, int)
-DEFINE_WATCHER_CREATOR(createDoubleWatcher, WuiWatcher_f64, double)
-DEFINE_WATCHER_CREATOR(createFloatWatcher, WuiWatcher_f32, float)
+// Primitive watchers take the typed callback method name and signature
+DEFINE_WATCHER_CREATOR(createBoolWatcher, WuiWatcher_bool, bool, "onBool",
+                       "(ZJ)V")
+DEFINE_WATCHER_CREATOR(createIntWatcher, WuiWatcher_i32, int, "onInt", "(IJ)V")
+DEFINE_WATCHER_CREATOR(createDoubleWatcher, WuiWatcher_f64, double, "onDouble",
+                       "(DJ)V")
+DEFINE_WATCHER_CREATOR(createFloatWatcher, WuiWatcher_f32, float, "onFloat",
+                       "(FJ)V")
 DEFINE_WATCHER_CREATOR(createStringWatcher, WuiWatcher_Str, str)
 DEFINE_WATCHER_CREATOR(createAnyViewWatcher, WuiWatcher_AnyView, anyview)
 DEFINE_WATCHER_CREATOR(createStyledStrWatcher, WuiWatcher_StyledStr, styled_str)
+DEFINE_WATCHER_CREATOR(createFlatStyledStrWatcher, WuiWatcher_StyledStr,
+                       flat_styled_str)
 DEFINE_WATCHER_CREATOR(createResolvedColorWatcher, WuiWatcher_ResolvedColor,
                        resolved_color)
 DEFINE_WATCHER_CREATOR(createResolvedFontWatcher, WuiWatcher_ResolvedFont,
@@ -1655,6 +4519,20 @@ DEFINE_WATCHER_CREATOR(createPickerItemsWatcher, WuiWatcher_Vec_PickerItem_Id,
 
 #undef DEFINE_WATCHER_CREATOR
 
+// The diff watcher starts from an empty baseline; snapshotPickerItemsDiff
+// seeds it before the watcher is registered.
+JNIEXPORT jobject JNICALL
+Java_dev_waterui_android_ffi_WatcherJni_createPickerItemsDiffWatcher(
+    JNIEnv *env, jclass, jobject callback) {
+  auto *state = new PickerItemsDiffState();
+  state->watcher = create_watcher_state(env, callback);
+  WUI_TRACK_HANDLE(WatcherCallback, state->watcher);
+  return new_watcher_struct(
+      env, ptr_to_jlong(state),
+      ptr_to_jlong(reinterpret_cast<void *>(watcher_picker_items_diff_call)),
+      ptr_to_jlong(reinterpret_cast<void *>(watcher_picker_items_diff_drop)));
+}
+
 // ========== Watch Binding ==========
 
 JNIEXPORT jlong JNICALL
@@ -1665,7 +4543,8 @@ Java_dev_waterui_android_ffi_WatcherJni_watchBindingBool(JNIEnv *env, jclass,
   WatcherStructFields fields = watcher_struct_from_java(env, watcher);
   auto *w = create_watcher<WuiWatcher_bool, bool>(
       fields, g_sym.waterui_new_watcher_bool);
-  return ptr_to_jlong(g_sym.waterui_watch_binding_bool(binding, w));
+  return ptr_to_jlong(
+      WUI_TRACK_GUARD(g_sym.waterui_watch_binding_bool(binding, w)));
 }
 
 JNIEXPORT jlong JNICALL Java_dev_waterui_android_ffi_WatcherJni_watchBindingInt(
@@ -1674,7 +4553,8 @@ JNIEXPORT jlong JNICALL Java_dev_waterui_android_ffi_WatcherJni_watchBindingInt(
   WatcherStructFields fields = watcher_struct_from_java(env, watcher);
   auto *w = create_watcher<WuiWatcher_i32, int32_t>(
       fields, g_sym.waterui_new_watcher_i32);
-  return ptr_to_jlong(g_sym.waterui_watch_binding_i32(binding, w));
+  return ptr_to_jlong(
+      WUI_TRACK_GUARD(g_sym.waterui_watch_binding_i32(binding, w)));
 }
 
 JNIEXPORT jlong JNICALL
@@ -1685,7 +4565,8 @@ Java_dev_waterui_android_ffi_WatcherJni_watchBindingDouble(JNIEnv *env, jclass,
   WatcherStructFields fields = watcher_struct_from_java(env, watcher);
   auto *w = create_watcher<WuiWatcher_f64, double>(
       fields, g_sym.waterui_new_watcher_f64);
-  return ptr_to_jlong(g_sym.waterui_watch_binding_f64(binding, w));
+  return ptr_to_jlong(
+      WUI_TRACK_GUARD(g_sym.waterui_watch_binding_f64(binding, w)));
 }
 
 JNIEXPORT jlong JNICALL Java_dev_waterui_android_ffi_WatcherJni_watchBindingStr(
@@ -1694,7 +4575,8 @@ JNIEXPORT jlong JNICALL Java_dev_waterui_android_ffi_WatcherJni_watchBindingStr(
   WatcherStructFields fields = watcher_struct_from_java(env, watcher);
   auto *w = create_watcher<WuiWatcher_Str, WuiStr>(
       fields, g_sym.waterui_new_watcher_str);
-  return ptr_to_jlong(g_sym.waterui_watch_binding_str(binding, w));
+  return ptr_to_jlong(
+      WUI_TRACK_GUARD(g_sym.waterui_watch_binding_str(binding, w)));
 }
 
 // ========== Watch Computed ==========
@@ -1707,7 +4589,8 @@ Java_dev_waterui_android_ffi_WatcherJni_watchComputedF64(JNIEnv *env, jclass,
   WatcherStructFields fields = watcher_struct_from_java(env, watcher);
   auto *w = create_watcher<WuiWatcher_f64, double>(
       fields, g_sym.waterui_new_watcher_f64);
-  return ptr_to_jlong(g_sym.waterui_watch_computed_f64(computed, w));
+  return ptr_to_jlong(
+      WUI_TRACK_GUARD(g_sym.waterui_watch_computed_f64(computed, w)));
 }
 
 JNIEXPORT jlong JNICALL
@@ -1718,7 +4601,8 @@ Java_dev_waterui_android_ffi_WatcherJni_watchComputedF32(JNIEnv *env, jclass,
   WatcherStructFields fields = watcher_struct_from_java(env, watcher);
   auto *w = create_watcher<WuiWatcher_f32, float>(
       fields, g_sym.waterui_new_watcher_f32);
-  return ptr_to_jlong(g_sym.waterui_watch_computed_f32(computed, w));
+  return ptr_to_jlong(
+      WUI_TRACK_GUARD(g_sym.waterui_watch_computed_f32(computed, w)));
 }
 
 JNIEXPORT jlong JNICALL
@@ -1729,7 +4613,8 @@ Java_dev_waterui_android_ffi_WatcherJni_watchComputedI32(JNIEnv *env, jclass,
   WatcherStructFields fields = watcher_struct_from_java(env, watcher);
   auto *w = create_watcher<WuiWatcher_i32, int32_t>(
       fields, g_sym.waterui_new_watcher_i32);
-  return ptr_to_jlong(g_sym.waterui_watch_computed_i32(computed, w));
+  return ptr_to_jlong(
+      WUI_TRACK_GUARD(g_sym.waterui_watch_computed_i32(computed, w)));
 }
 
 JNIEXPORT jlong JNICALL
@@ -1739,7 +4624,8 @@ Java_dev_waterui_android_ffi_WatcherJni_watchComputedStyledStr(
   WatcherStructFields fields = watcher_struct_from_java(env, watcher);
   auto *w = create_watcher<WuiWatcher_StyledStr, WuiStyledStr>(
       fields, g_sym.waterui_new_watcher_styled_str);
-  return ptr_to_jlong(g_sym.waterui_watch_computed_styled_str(computed, w));
+  return ptr_to_jlong(
+      WUI_TRACK_GUARD(g_sym.waterui_watch_computed_styled_str(computed, w)));
 }
 
 JNIEXPORT jlong JNICALL
@@ -1749,7 +4635,8 @@ Java_dev_waterui_android_ffi_WatcherJni_watchComputedResolvedColor(
   WatcherStructFields fields = watcher_struct_from_java(env, watcher);
   auto *w = create_watcher<WuiWatcher_ResolvedColor, WuiResolvedColor>(
       fields, g_sym.waterui_new_watcher_resolved_color);
-  return ptr_to_jlong(g_sym.waterui_watch_computed_resolved_color(computed, w));
+  return ptr_to_jlong(WUI_TRACK_GUARD(
+      g_sym.waterui_watch_computed_resolved_color(computed, w)));
 }
 
 JNIEXPORT jlong JNICALL
@@ -1759,7 +4646,8 @@ Java_dev_waterui_android_ffi_WatcherJni_watchComputedResolvedFont(
   WatcherStructFields fields = watcher_struct_from_java(env, watcher);
   auto *w = create_watcher<WuiWatcher_ResolvedFont, WuiResolvedFont>(
       fields, g_sym.waterui_new_watcher_resolved_font);
-  return ptr_to_jlong(g_sym.waterui_watch_computed_resolved_font(computed, w));
+  return ptr_to_jlong(
+      WUI_TRACK_GUARD(g_sym.waterui_watch_computed_resolved_font(computed, w)));
 }
 
 JNIEXPORT jlong JNICALL
@@ -1770,7 +4658,8 @@ Java_dev_waterui_android_ffi_WatcherJni_watchComputedPickerItems(
   auto *w =
       create_watcher<WuiWatcher_Vec_PickerItem_Id, WuiArray_WuiPickerItem>(
           fields, g_sym.waterui_new_watcher_picker_items);
-  return ptr_to_jlong(g_sym.waterui_watch_computed_picker_items(computed, w));
+  return ptr_to_jlong(
+      WUI_TRACK_GUARD(g_sym.waterui_watch_computed_picker_items(computed, w)));
 }
 
 JNIEXPORT jlong JNICALL
@@ -1780,7 +4669,8 @@ Java_dev_waterui_android_ffi_WatcherJni_watchComputedColorScheme(
   WatcherStructFields fields = watcher_struct_from_java(env, watcher);
   auto *w = create_watcher<WuiWatcher_ColorScheme, WuiColorScheme>(
       fields, g_sym.waterui_new_watcher_color_scheme);
-  return ptr_to_jlong(g_sym.waterui_watch_computed_color_scheme(computed, w));
+  return ptr_to_jlong(
+      WUI_TRACK_GUARD(g_sym.waterui_watch_computed_color_scheme(computed, w)));
 }
 
 // ========== Dynamic Connect ==========
@@ -1801,8 +4691,8 @@ Java_dev_waterui_android_ffi_WatcherJni_createReactiveColorSchemeState(
     JNIEnv *, jclass, jint scheme) {
   if (!g_symbols_ready)
     return 0;
-  auto *state = new ReactiveColorSchemeState{};
-  state->scheme = static_cast<WuiColorScheme>(scheme);
+  auto *state = new ReactiveColorSchemeState();
+  state->scheme.store(static_cast<WuiColorScheme>(scheme));
   return ptr_to_jlong(state);
 }
 
@@ -1835,7 +4725,7 @@ Java_dev_waterui_android_ffi_WatcherJni_createReactiveColorState(JNIEnv *,
                                                                  jint argb) {
   if (!g_symbols_ready)
     return 0;
-  auto *state = new ReactiveColorState{};
+  auto *state = new ReactiveColorState();
   state->color = argb_to_resolved_color(argb);
   return ptr_to_jlong(state);
 }
@@ -1870,7 +4760,7 @@ Java_dev_waterui_android_ffi_WatcherJni_createReactiveFontState(JNIEnv *,
                                                                 jint weight) {
   if (!g_symbols_ready)
     return 0;
-  auto *state = new ReactiveFontState{};
+  auto *state = new ReactiveFontState();
   state->size = size;
   state->weight = static_cast<WuiFontWeight>(weight);
   return ptr_to_jlong(state);
@@ -1910,6 +4800,14 @@ Java_dev_waterui_android_ffi_WatcherJni_readComputedStyledStr(
   return new_styled_str(env, styled);
 }
 
+JNIEXPORT jobject JNICALL
+Java_dev_waterui_android_ffi_WatcherJni_readComputedStyledStrFlat(
+    JNIEnv *env, jclass, jlong computedPtr) {
+  auto *computed = jlong_to_ptr<WuiComputed_StyledStr>(computedPtr);
+  WuiStyledStr styled = g_sym.waterui_read_computed_styled_str(computed);
+  return new_flat_styled_str(env, styled);
+}
+
 JNIEXPORT jobjectArray JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_readComputedPickerItems(
     JNIEnv *env, jclass, jlong computedPtr) {
@@ -1919,6 +4817,22 @@ Java_dev_waterui_android_ffi_WatcherJni_readComputedPickerItems(
   return picker_items_to_java(env, items);
 }
 
+// Reads the computed's items as a change set against the diff watcher's
+// baseline and advances it, so the snapshot and the watcher's first change set
+// come from one read. Must run before the watcher is registered.
+JNIEXPORT jobject JNICALL
+Java_dev_waterui_android_ffi_WatcherJni_snapshotPickerItemsDiff(
+    JNIEnv *env, jclass, jlong computedPtr, jlong watcherData) {
+  auto *computed = jlong_to_ptr<WuiComputed_Vec_PickerItem_Id>(computedPtr);
+  auto *state = jlong_to_ptr<PickerItemsDiffState>(watcherData);
+  if (computed == nullptr || state == nullptr) {
+    return nullptr;
+  }
+  WuiArray_WuiPickerItem items =
+      g_sym.waterui_read_computed_picker_items(computed);
+  return picker_items_diff_to_java(env, items, state->baseline);
+}
+
 JNIEXPORT jbyteArray JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_readBindingStr(JNIEnv *env, jclass,
                                                        jlong bindingPtr) {
@@ -1929,6 +4843,7 @@ Java_dev_waterui_android_ffi_WatcherJni_readBindingStr(JNIEnv *env, jclass,
 
 JNIEXPORT void JNICALL Java_dev_waterui_android_ffi_WatcherJni_setBindingStr(
     JNIEnv *env, jclass, jlong bindingPtr, jbyteArray bytes) {
+  WatcherFlushScope flushOnReturn(env);
   auto *binding = jlong_to_ptr<WuiBinding_Str>(bindingPtr);
   WuiStr str = str_from_byte_array(env, bytes);
   g_sym.waterui_set_binding_str(binding, str);
@@ -1937,12 +4852,54 @@ JNIEXPORT void JNICALL Java_dev_waterui_android_ffi_WatcherJni_setBindingStr(
 
 JNIEXPORT void JNICALL Java_dev_waterui_android_ffi_WatcherJni_setBindingSecure(
     JNIEnv *env, jclass, jlong bindingPtr, jbyteArray bytes) {
+  WatcherFlushScope flushOnReturn(env);
   auto *binding = jlong_to_ptr<WuiBinding_Secure>(bindingPtr);
   WuiStr str = str_from_byte_array(env, bytes);
   g_sym.waterui_set_binding_secure(binding, str);
   str._0.vtable.drop(str._0.data);
 }
 
+// Direct variants: the UTF-8 bytes come from a direct ByteBuffer instead of a
+// new byte[]. Rust takes ownership of the value and may keep it, so the bytes
+// are copied into a holder it frees; the buffer is reused by the next write.
+JNIEXPORT void JNICALL
+Java_dev_waterui_android_ffi_WatcherJni_setBindingStrDirect(JNIEnv *env, jclass,
+                                                            jlong bindingPtr,
+                                                            jobject buffer,
+                                                            jint length) {
+  WatcherFlushScope flushOnReturn(env);
+  auto *binding = jlong_to_ptr<WuiBinding_Str>(bindingPtr);
+  BorrowedBytes borrowed{};
+  if (!borrow_direct_buffer(env, buffer, length, &borrowed)) {
+    __android_log_print(ANDROID_LOG_ERROR, LOG_TAG,
+                        "setBindingStrDirect: invalid buffer");
+    return;
+  }
+  ByteArrayHolder *holder = new_byte_holder(borrowed.len);
+  if (borrowed.len > 0) {
+    std::memcpy(holder->data, borrowed.data, borrowed.len);
+  }
+  g_sym.waterui_set_binding_str(binding, wui_str_from_holder(holder));
+}
+
+JNIEXPORT void JNICALL
+Java_dev_waterui_android_ffi_WatcherJni_setBindingSecureDirect(
+    JNIEnv *env, jclass, jlong bindingPtr, jobject buffer, jint length) {
+  WatcherFlushScope flushOnReturn(env);
+  auto *binding = jlong_to_ptr<WuiBinding_Secure>(bindingPtr);
+  BorrowedBytes borrowed{};
+  if (!borrow_direct_buffer(env, buffer, length, &borrowed)) {
+    __android_log_print(ANDROID_LOG_ERROR, LOG_TAG,
+                        "setBindingSecureDirect: invalid buffer");
+    return;
+  }
+  ByteArrayHolder *holder = new_byte_holder(borrowed.len);
+  if (borrowed.len > 0) {
+    std::memcpy(holder->data, borrowed.data, borrowed.len);
+  }
+  g_sym.waterui_set_binding_secure(binding, wui_str_from_holder(holder));
+}
+
 // ========== String Conversion ==========
 
 // NOTE: wuiStrToString was removed as it incorrectly used waterui_view_id.
@@ -1963,95 +4920,127 @@ JNIEXPORT jint JNICALL Java_dev_waterui_android_ffi_WatcherJni_viewStretchAxis(
 
 JNIEXPORT jobject JNICALL Java_dev_waterui_android_ffi_WatcherJni_forceAsPlain(
     JNIEnv *env, jclass, jlong viewPtr) {
+  WUI_TRACE_SCOPE("WaterUI.forceAsPlain");
   auto *view = jlong_to_ptr<WuiAnyView>(viewPtr);
   WuiStr str = g_sym.waterui_force_as_plain(view);
   jbyteArray bytes = wui_str_to_byte_array(env, str);
-  jclass cls = find_app_class(env, "dev/waterui/android/runtime/PlainStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "([B)V");
-  jobject obj = env->NewObject(cls, ctor, bytes);
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::PlainStruct, bytes);
   env->DeleteLocalRef(bytes);
   return obj;
 }
 
 // ========== Layout Functions ==========
 
+// Small per-subview memo of proposal -> size. Rust layouts probe the same
+// child several times with identical proposals (unspecified, constrained,
+// final); repeats are answered here without a JNI upcall. A memo lives for a
+// single layout call, so nothing global needs invalidating: a content change
+// bumps the container's generation in Kotlin, and the next pass starts from
+// an empty memo. Zero-initialized state is an empty cache.
+constexpr size_t kMeasureCacheSize = 4;
+
+struct MeasureCache {
+  WuiProposalSize proposals[kMeasureCacheSize];
+  WuiSize sizes[kMeasureCacheSize];
+  uint8_t count;
+  uint8_t next;
+};
+
+// Bit-exact key comparison, so NaN ("unspecified") proposals match each other.
+inline bool same_proposal_key(const WuiProposalSize &a,
+                              const WuiProposalSize &b) {
+  return std::memcmp(&a, &b, sizeof(WuiProposalSize)) == 0;
+}
+
+bool measure_cache_lookup(MeasureCache &cache, const WuiProposalSize &proposal,
+                          WuiSize *out) {
+  for (uint8_t i = 0; i < cache.count; ++i) {
+    if (same_proposal_key(cache.proposals[i], proposal)) {
+      *out = cache.sizes[i];
+      return true;
+    }
+  }
+  return false;
+}
+
+void measure_cache_store(MeasureCache &cache, const WuiProposalSize &proposal,
+                         const WuiSize &size) {
+  cache.proposals[cache.next] = proposal;
+  cache.sizes[cache.next] = size;
+  cache.next = static_cast<uint8_t>((cache.next + 1) % kMeasureCacheSize);
+  if (cache.count < kMeasureCacheSize) {
+    ++cache.count;
+  }
+}
+
 // Context for SubView callbacks - holds JNI references for measuring
 struct SubViewContext {
   JavaVM *jvm;
   jobject subviewRef;      // Global reference to the SubViewStruct
   jmethodID measureMethod; // Method to measure the view
-  jclass subviewClass;     // Global reference to the SubViewStruct class
+  MeasureCache cache;
 };
 
 // Measure callback - called by Rust to measure a child view
 WuiSize subview_measure(void *context, WuiProposalSize proposal) {
   auto *ctx = static_cast<SubViewContext *>(context);
-  JNIEnv *env = nullptr;
-  bool wasAttached = false;
+  WuiSize cached{};
+  if (measure_cache_lookup(ctx->cache, proposal, &cached)) {
+    return cached;
+  }
 
-  // Get JNI environment
-  jint result =
-      ctx->jvm->GetEnv(reinterpret_cast<void **>(&env), JNI_VERSION_1_6);
-  if (result == JNI_EDETACHED) {
-    ctx->jvm->AttachCurrentThread(&env, nullptr);
-    wasAttached = true;
+  ScopedEnv scoped(ctx->jvm);
+  JNIEnv *env = scoped.env;
+  if (env == nullptr) {
+    return WuiSize{};
   }
 
   // Call the measureForLayout method on the SubViewStruct
   // measureForLayout(float proposalWidth, float proposalHeight) returns
   // SizeStruct
+  WUI_TRACE_SCOPE("WaterUI.measureSubview");
+  WUI_TRACE_UPCALL();
   jobject sizeObj = env->CallObjectMethod(ctx->subviewRef, ctx->measureMethod,
                                           proposal.width, proposal.height);
+  if (env->ExceptionCheck()) {
+    clear_jni_exception(env, "measuring a subview");
+    return WuiSize{};
+  }
 
   WuiSize size{};
   if (sizeObj != nullptr) {
-    jclass sizeCls = env->GetObjectClass(sizeObj);
-    jfieldID widthField = env->GetFieldID(sizeCls, "width", "F");
-    jfieldID heightField = env->GetFieldID(sizeCls, "height", "F");
-    size.width = env->GetFloatField(sizeObj, widthField);
-    size.height = env->GetFloatField(sizeObj, heightField);
-    env->DeleteLocalRef(sizeCls);
+    size.width = env->GetFloatField(sizeObj, gSizeStructWidth);
+    size.height = env->GetFloatField(sizeObj, gSizeStructHeight);
     env->DeleteLocalRef(sizeObj);
-  }
-
-  if (wasAttached) {
-    ctx->jvm->DetachCurrentThread();
+    measure_cache_store(ctx->cache, proposal, size);
   }
 
   return size;
 }
 
-// Drop callback - cleans up JNI references
+// Drop callback - cleans up JNI references. The context itself lives in the
+// SubViewArrayHolder's block.
 void subview_drop(void *context) {
   auto *ctx = static_cast<SubViewContext *>(context);
   if (ctx == nullptr)
     return;
 
-  JNIEnv *env = nullptr;
-  bool wasAttached = false;
-  jint result =
-      ctx->jvm->GetEnv(reinterpret_cast<void **>(&env), JNI_VERSION_1_6);
-  if (result == JNI_EDETACHED) {
-    ctx->jvm->AttachCurrentThread(&env, nullptr);
-    wasAttached = true;
-  }
-
-  env->DeleteGlobalRef(ctx->subviewRef);
-  env->DeleteGlobalRef(ctx->subviewClass);
-
-  if (wasAttached) {
-    ctx->jvm->DetachCurrentThread();
+  WUI_TRACK_DROP_REQUEST(ctx);
+  ScopedEnv scoped(ctx->jvm);
+  if (scoped.env != nullptr) {
+    scoped.env->DeleteGlobalRef(ctx->subviewRef);
   }
-
-  delete ctx;
+  ctx->subviewRef = nullptr;
+  WUI_TRACK_FREE(SubviewRef, ctx);
 }
 
-// Holder for the SubView array
+// Holder for the SubView array. First object in a pooled block that also
+// holds the subviews and their contexts.
 struct SubViewArrayHolder {
   WuiSubView *data;
   size_t len;
   JavaVM *jvm; // Keep JVM reference for cleanup
+  uint8_t sizeClass;
 };
 
 WuiArraySlice_WuiSubView subview_slice(const void *opaque) {
@@ -2072,17 +5061,12 @@ void subview_array_drop(void *opaque) {
       holder->data[i].vtable.drop(holder->data[i].context);
     }
   }
-  std::free(holder->data);
-  delete holder;
+  g_block_pool.release(holder, holder->sizeClass);
 }
 
 WuiProposalSize proposal_from_java(JNIEnv *env, jobject proposal_obj) {
-  jclass cls = env->GetObjectClass(proposal_obj);
-  jmethodID getWidth = env->GetMethodID(cls, "getWidth", "()F");
-  jmethodID getHeight = env->GetMethodID(cls, "getHeight", "()F");
-  float width = env->CallFloatMethod(proposal_obj, getWidth);
-  float height = env->CallFloatMethod(proposal_obj, getHeight);
-  env->DeleteLocalRef(cls);
+  float width = env->CallFloatMethod(proposal_obj, gProposalStructGetWidth);
+  float height = env->CallFloatMethod(proposal_obj, gProposalStructGetHeight);
   WuiProposalSize proposal{};
   proposal.width = width;
   proposal.height = height;
@@ -2090,16 +5074,10 @@ WuiProposalSize proposal_from_java(JNIEnv *env, jobject proposal_obj) {
 }
 
 WuiRect rect_from_java(JNIEnv *env, jobject rect_obj) {
-  jclass cls = env->GetObjectClass(rect_obj);
-  jmethodID getX = env->GetMethodID(cls, "getX", "()F");
-  jmethodID getY = env->GetMethodID(cls, "getY", "()F");
-  jmethodID getWidth = env->GetMethodID(cls, "getWidth", "()F");
-  jmethodID getHeight = env->GetMethodID(cls, "getHeight", "()F");
-  float x = env->CallFloatMethod(rect_obj, getX);
-  float y = env->CallFloatMethod(rect_obj, getY);
-  float width = env->CallFloatMethod(rect_obj, getWidth);
-  float height = env->CallFloatMethod(rect_obj, getHeight);
-  env->DeleteLocalRef(cls);
+  float x = env->CallFloatMethod(rect_obj, gRectStructGetX);
+  float y = env->CallFloatMethod(rect_obj, gRectStructGetY);
+  float width = env->CallFloatMethod(rect_obj, gRectStructGetWidth);
+  float height = env->CallFloatMethod(rect_obj, gRectStructGetHeight);
   WuiRect rect{};
   rect.origin.x = x;
   rect.origin.y = y;
@@ -2111,34 +5089,23 @@ WuiRect rect_from_java(JNIEnv *env, jobject rect_obj) {
 // Create a WuiSubView from Java SubViewStruct
 // SubViewStruct contains: view (View), stretchAxis (StretchAxis), priority
 // (Int)
-WuiSubView subview_from_java(JNIEnv *env, JavaVM *jvm, jobject subviewObj) {
-  jclass cls = env->GetObjectClass(subviewObj);
-
+WuiSubView subview_from_java(JNIEnv *env, JavaVM *jvm, jobject subviewObj,
+                             SubViewContext *ctx) {
   // Get stretchAxis field
-  jfieldID stretchField = env->GetFieldID(
-      cls, "stretchAxis", "Ldev/waterui/android/runtime/StretchAxis;");
-  jobject stretchObj = env->GetObjectField(subviewObj, stretchField);
-  jclass stretchCls = env->GetObjectClass(stretchObj);
-  jmethodID getValueMethod = env->GetMethodID(stretchCls, "getValue", "()I");
-  jint stretchAxis = env->CallIntMethod(stretchObj, getValueMethod);
-  env->DeleteLocalRef(stretchCls);
+  jobject stretchObj =
+      env->GetObjectField(subviewObj, gSubViewStructStretchAxis);
+  jint stretchAxis = env->CallIntMethod(stretchObj, gStretchAxisGetValue);
   env->DeleteLocalRef(stretchObj);
 
   // Get priority field
-  jfieldID priorityField = env->GetFieldID(cls, "priority", "I");
-  jint priority = env->GetIntField(subviewObj, priorityField);
+  jint priority = env->GetIntField(subviewObj, gSubViewStructPriority);
 
-  // Create the context with global references to SubViewStruct
-  auto *ctx = new SubViewContext();
+  // Fill the context with a global reference to SubViewStruct
   ctx->jvm = jvm;
+  ctx->cache = MeasureCache{};
   ctx->subviewRef = env->NewGlobalRef(subviewObj);
-  ctx->subviewClass = static_cast<jclass>(env->NewGlobalRef(cls));
-
-  // Get the measureForLayout method from SubViewStruct
-  ctx->measureMethod = env->GetMethodID(
-      cls, "measureForLayout", "(FF)Ldev/waterui/android/runtime/SizeStruct;");
-
-  env->DeleteLocalRef(cls);
+  ctx->measureMethod = gSubViewStructMeasure;
+  WUI_TRACK_HANDLE(SubviewRef, ctx);
 
   WuiSubView subview{};
   subview.context = ctx;
@@ -2154,15 +5121,24 @@ WuiSubView subview_from_java(JNIEnv *env, JavaVM *jvm, jobject subviewObj) {
 WuiArray_WuiSubView subviews_from_java(JNIEnv *env, JavaVM *jvm,
                                        jobjectArray subviewsArr) {
   jsize len = env->GetArrayLength(subviewsArr);
-  auto *holder = new SubViewArrayHolder();
-  holder->len = static_cast<size_t>(len);
+  auto n = static_cast<size_t>(len);
+  size_t bytes = BumpAllocator::bytes_for<SubViewArrayHolder>(1) +
+                 BumpAllocator::bytes_for<WuiSubView>(n) +
+                 BumpAllocator::bytes_for<SubViewContext>(n);
+  uint8_t sizeClass = BlockPool::kUnpooled;
+  void *block = g_block_pool.acquire(bytes, &sizeClass);
+  BumpAllocator bump(block, bytes);
+
+  auto *holder = bump.alloc<SubViewArrayHolder>(1);
+  holder->len = n;
   holder->jvm = jvm;
-  holder->data =
-      static_cast<WuiSubView *>(std::calloc(holder->len, sizeof(WuiSubView)));
+  holder->sizeClass = sizeClass;
+  holder->data = bump.alloc<WuiSubView>(n);
+  auto *contexts = bump.alloc<SubViewContext>(n);
 
   for (jsize i = 0; i < len; ++i) {
     jobject subviewObj = env->GetObjectArrayElement(subviewsArr, i);
-    holder->data[i] = subview_from_java(env, jvm, subviewObj);
+    holder->data[i] = subview_from_java(env, jvm, subviewObj, &contexts[i]);
     env->DeleteLocalRef(subviewObj);
   }
 
@@ -2173,32 +5149,382 @@ WuiArray_WuiSubView subviews_from_java(JNIEnv *env, JavaVM *jvm,
   return array;
 }
 
+// ========== Bulk Layout ==========
+//
+// The bulk entry points take child metadata and pre-measured sizes as flat
+// primitive arrays instead of one SubViewStruct per child. No global refs are
+// created and no Java objects are allocated per child: the measure callback
+// answers from the pre-measured table and only calls back into the
+// SubViewMeasurer when Rust probes with a proposal that is not in the table.
+//
+// Layout of the arrays (n = child count, k = entries per child):
+//   childInfo:    [stretchAxis, priority] * n
+//   measurements: [proposalWidth, proposalHeight, width, height] * k * n
+//   placements:   [x, y, width, height] * n (output)
+
+constexpr jsize kBulkChildInfoStride = 2;
+constexpr jsize kBulkMeasurementStride = 4;
+constexpr jsize kBulkPlacementStride = 4;
+
+// State shared by every subview of a single bulk layout call. Lives on the
+// stack of the JNI entry point; Rust consumes the subview array before
+// waterui_layout_size_that_fits / waterui_layout_place return.
+struct BulkLayoutPass {
+  JNIEnv *env;
+  jobject measurer;        // Local reference, valid for the duration of the call
+  jmethodID measureMethod; // SubViewMeasurer.measureSubView(IFF)J
+  const jfloat *measurements; // Copied into the subview array's block
+  jsize entriesPerChild;
+  bool snapshot; // Off the UI thread: table misses are estimated, not measured
+  jint misses;   // Estimated probes in a snapshot pass
+  bool aborted;  // A measure upcall threw; later probes return zero sizes
+};
+
+struct BulkSubViewContext {
+  BulkLayoutPass *pass;
+  jint index;
+  MeasureCache cache; // Fallback probes only; the table is checked first
+};
+
+// First object in a pooled block that also holds the subviews, their
+// contexts, the child info and the measurement table.
+struct BulkSubViewArrayHolder {
+  WuiSubView *data;
+  size_t len;
+  uint8_t sizeClass;
+};
+
+// NaN and infinity both mean "unspecified" (see SubViewStruct.measureForLayout),
+// so they are treated as the same key.
+inline bool same_proposal_dimension(float a, float b) {
+  if (!std::isfinite(a) || !std::isfinite(b)) {
+    return !std::isfinite(a) && !std::isfinite(b);
+  }
+  return a == b;
+}
+
+WuiSize bulk_subview_measure(void *context, WuiProposalSize proposal) {
+  auto *ctx = static_cast<BulkSubViewContext *>(context);
+  BulkLayoutPass *pass = ctx->pass;
+
+  const jfloat *first =
+      pass->measurements +
+      static_cast<size_t>(ctx->index) * pass->entriesPerChild *
+          kBulkMeasurementStride;
+  const jfloat *entry = first;
+  for (jsize i = 0; i < pass->entriesPerChild;
+       ++i, entry += kBulkMeasurementStride) {
+    if (same_proposal_dimension(entry[0], proposal.width) &&
+        same_proposal_dimension(entry[1], proposal.height)) {
+      return WuiSize{entry[2], entry[3]};
+    }
+  }
+
+  WuiSize size{};
+  if (measure_cache_lookup(ctx->cache, proposal, &size)) {
+    return size;
+  }
+  if (pass->snapshot) {
+    // No UI thread to measure on: estimate from the child's first entry,
+    // clamped to the proposal, and count the miss so the caller can tell the
+    // result is not exact.
+    ++pass->misses;
+    if (pass->entriesPerChild > 0) {
+      size.width = std::isfinite(proposal.width)
+                       ? std::min(first[2], proposal.width)
+                       : first[2];
+      size.height = std::isfinite(proposal.height)
+                        ? std::min(first[3], proposal.height)
+                        : first[3];
+    }
+    return size;
+  }
+  if (pass->aborted || pass->measurer == nullptr ||
+      pass->measureMethod == nullptr) {
+    return size;
+  }
+  // Table miss: ask Kotlin. The size comes back packed into a jlong (width in
+  // the high 32 bits, height in the low 32 bits) so nothing is allocated.
+  WUI_TRACE_SCOPE("WaterUI.measureSubviewBulk");
+  WUI_TRACE_UPCALL();
+  jlong packed = pass->env->CallLongMethod(pass->measurer, pass->measureMethod,
+                                           ctx->index, proposal.width,
+                                           proposal.height);
+  if (pass->env->ExceptionCheck()) {
+    // Rust cannot be stopped mid-layout, so the pass runs to the end without
+    // further upcalls and its result is discarded by the entry point.
+    clear_jni_exception(pass->env, "measuring a bulk subview");
+    pass->aborted = true;
+    return size;
+  }
+  auto widthBits = static_cast<uint32_t>(static_cast<uint64_t>(packed) >> 32);
+  auto heightBits = static_cast<uint32_t>(static_cast<uint64_t>(packed));
+  std::memcpy(&size.width, &widthBits, sizeof(float));
+  std::memcpy(&size.height, &heightBits, sizeof(float));
+  measure_cache_store(ctx->cache, proposal, size);
+  return size;
+}
+
+void bulk_subview_drop(void *) {
+  // Contexts live in the BulkSubViewArrayHolder's block.
+}
+
+void bulk_subview_array_drop(void *opaque) {
+  auto *holder = static_cast<BulkSubViewArrayHolder *>(opaque);
+  if (holder == nullptr)
+    return;
+  g_block_pool.release(holder, holder->sizeClass);
+}
+
+WuiArraySlice_WuiSubView bulk_subview_slice(const void *opaque) {
+  const auto *holder = static_cast<const BulkSubViewArrayHolder *>(opaque);
+  WuiArraySlice_WuiSubView slice{};
+  slice.head = holder->data;
+  slice.len = holder->len;
+  return slice;
+}
+
+// Fill a BulkLayoutPass from the Java arrays. Returns the child count, or -1
+// if the arrays are inconsistent.
+jsize bulk_pass_from_java(JNIEnv *env, BulkLayoutPass &pass,
+                          jintArray childInfoArr, jfloatArray measurementsArr,
+                          jint entriesPerChild, jobject measurer) {
+  if (childInfoArr == nullptr || entriesPerChild < 0) {
+    return -1;
+  }
+  jsize count = env->GetArrayLength(childInfoArr) / kBulkChildInfoStride;
+  jsize measurementLen =
+      measurementsArr != nullptr ? env->GetArrayLength(measurementsArr) : 0;
+  if (measurementLen < count * entriesPerChild * kBulkMeasurementStride) {
+    __android_log_print(ANDROID_LOG_ERROR, LOG_TAG,
+                        "bulk layout: %d measurements for %d children x %d",
+                        measurementLen, count, entriesPerChild);
+    return -1;
+  }
+
+  pass.env = env;
+  pass.measurer = measurer;
+  pass.measureMethod = nullptr;
+  pass.measurements = nullptr;
+  pass.entriesPerChild = entriesPerChild;
+  pass.snapshot = false;
+  pass.misses = 0;
+  pass.aborted = false;
+  if (measurer != nullptr) {
+    jclass measurerClass = env->GetObjectClass(measurer);
+    pass.measureMethod =
+        env->GetMethodID(measurerClass, "measureSubView", "(IFF)J");
+    env->DeleteLocalRef(measurerClass);
+  }
+  return count;
+}
+
+// Builds the subview array in a single pooled block and points the pass at
+// its copy of the measurement table.
+WuiArray_WuiSubView bulk_subviews_from_java(JNIEnv *env, BulkLayoutPass &pass,
+                                            jintArray childInfoArr,
+                                            jfloatArray measurementsArr,
+                                            jsize count) {
+  auto n = static_cast<size_t>(count);
+  size_t infoLen = n * kBulkChildInfoStride;
+  size_t tableLen = n * pass.entriesPerChild * kBulkMeasurementStride;
+  size_t bytes = BumpAllocator::bytes_for<BulkSubViewArrayHolder>(1) +
+                 BumpAllocator::bytes_for<WuiSubView>(n) +
+                 BumpAllocator::bytes_for<BulkSubViewContext>(n) +
+                 BumpAllocator::bytes_for<jint>(infoLen) +
+                 BumpAllocator::bytes_for<jfloat>(tableLen);
+  uint8_t sizeClass = BlockPool::kUnpooled;
+  void *block = g_block_pool.acquire(bytes, &sizeClass);
+  BumpAllocator bump(block, bytes);
+
+  auto *holder = bump.alloc<BulkSubViewArrayHolder>(1);
+  holder->len = n;
+  holder->sizeClass = sizeClass;
+  holder->data = bump.alloc<WuiSubView>(n);
+  auto *contexts = bump.alloc<BulkSubViewContext>(n);
+  jint *childInfo = bump.alloc<jint>(infoLen);
+  jfloat *table = bump.alloc<jfloat>(tableLen);
+  if (infoLen > 0) {
+    env->GetIntArrayRegion(childInfoArr, 0, static_cast<jsize>(infoLen),
+                           childInfo);
+  }
+  if (tableLen > 0) {
+    env->GetFloatArrayRegion(measurementsArr, 0, static_cast<jsize>(tableLen),
+                             table);
+  }
+  pass.measurements = table;
+
+  for (jsize i = 0; i < count; ++i) {
+    BulkSubViewContext &ctx = contexts[i];
+    ctx.pass = &pass;
+    ctx.index = i;
+    ctx.cache = MeasureCache{};
+
+    WuiSubView &subview = holder->data[i];
+    subview.context = &ctx;
+    subview.vtable.measure = bulk_subview_measure;
+    subview.vtable.drop = bulk_subview_drop;
+    subview.stretch_axis =
+        static_cast<WuiStretchAxis>(childInfo[i * kBulkChildInfoStride]);
+    subview.priority =
+        static_cast<int32_t>(childInfo[i * kBulkChildInfoStride + 1]);
+  }
+
+  WuiArray_WuiSubView array{};
+  array.data = holder;
+  array.vtable.drop = bulk_subview_array_drop;
+  array.vtable.slice = bulk_subview_slice;
+  return array;
+}
+
 jobject proposal_to_java(JNIEnv *env, const WuiProposalSize &proposal) {
-  jclass cls =
-      find_app_class(env, "dev/waterui/android/runtime/ProposalStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(FF)V");
-  jobject obj = env->NewObject(cls, ctor, proposal.width, proposal.height);
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::ProposalStruct, proposal.width,
+                           proposal.height);
   return obj;
 }
 
 jobject size_to_java(JNIEnv *env, const WuiSize &size) {
-  jclass cls = find_app_class(env, "dev/waterui/android/runtime/SizeStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(FF)V");
-  jobject obj = env->NewObject(cls, ctor, size.width, size.height);
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::SizeStruct, size.width,
+                           size.height);
   return obj;
 }
 
 jobject rect_to_java(JNIEnv *env, const WuiRect &rect) {
-  jclass cls = find_app_class(env, "dev/waterui/android/runtime/RectStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(FFFF)V");
-  jobject obj = env->NewObject(cls, ctor, rect.origin.x, rect.origin.y,
-                               rect.size.width, rect.size.height);
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::RectStruct, rect.origin.x,
+                           rect.origin.y, rect.size.width, rect.size.height);
   return obj;
 }
 
+// ========== Layout Result Cache ==========
+//
+// Android measures a container several times per frame with the same specs,
+// and each bulk call otherwise rebuilds the subview array and reruns the Rust
+// layout. Results are cached per container under the caller's child
+// generation, which the caller bumps whenever a child requests layout; a
+// different generation empties the entry. A negative generation bypasses the
+// cache.
+//
+// Entries are keyed by a token the container mints once (never reused), not
+// by its WuiLayout address, which a later layout may get after a free. The
+// container erases its entry with releaseLayoutCache when it is disposed.
+
+constexpr size_t kLayoutCachedSizes = 4;
+
+struct LayoutResultCache {
+  jint generation = -1;
+  WuiProposalSize proposals[kLayoutCachedSizes]{};
+  WuiSize sizes[kLayoutCachedSizes]{};
+  size_t sizeCount = 0;
+  size_t nextSize = 0; // Round-robin slot to overwrite once full
+  bool hasPlacements = false;
+  jfloat boundsWidth = 0;
+  jfloat boundsHeight = 0;
+  std::vector<WuiRect> placements;
+};
+
+std::mutex g_layout_cache_mutex;
+std::unordered_map<jlong, LayoutResultCache> g_layout_caches;
+
+// Caller holds g_layout_cache_mutex.
+LayoutResultCache &layout_cache_for(jlong token, jint generation) {
+  LayoutResultCache &cache = g_layout_caches[token];
+  if (cache.generation != generation) {
+    cache = LayoutResultCache{};
+    cache.generation = generation;
+  }
+  return cache;
+}
+
+bool layout_cache_lookup_size(jlong token, jint generation,
+                              WuiProposalSize proposal, WuiSize *out) {
+  if (generation < 0) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(g_layout_cache_mutex);
+  auto it = g_layout_caches.find(token);
+  if (it == g_layout_caches.end() || it->second.generation != generation) {
+    return false;
+  }
+  const LayoutResultCache &cache = it->second;
+  for (size_t i = 0; i < cache.sizeCount; ++i) {
+    if (same_proposal_dimension(cache.proposals[i].width, proposal.width) &&
+        same_proposal_dimension(cache.proposals[i].height, proposal.height)) {
+      *out = cache.sizes[i];
+      return true;
+    }
+  }
+  return false;
+}
+
+void layout_cache_store_size(jlong token, jint generation,
+                             WuiProposalSize proposal, WuiSize size) {
+  if (generation < 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(g_layout_cache_mutex);
+  LayoutResultCache &cache = layout_cache_for(token, generation);
+  size_t slot = cache.sizeCount;
+  if (cache.sizeCount < kLayoutCachedSizes) {
+    ++cache.sizeCount;
+  } else {
+    slot = cache.nextSize;
+    cache.nextSize = (cache.nextSize + 1) % kLayoutCachedSizes;
+  }
+  cache.proposals[slot] = proposal;
+  cache.sizes[slot] = size;
+}
+
+void layout_cache_store_placements(jlong token, jint generation,
+                                   jfloat width, jfloat height,
+                                   const WuiRect *rects, size_t count) {
+  if (generation < 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(g_layout_cache_mutex);
+  LayoutResultCache &cache = layout_cache_for(token, generation);
+  cache.hasPlacements = true;
+  cache.boundsWidth = width;
+  cache.boundsHeight = height;
+  cache.placements.assign(rects, rects + count);
+}
+
+// Runs waterui_layout_place and writes as many rects as fit into
+// outPlacements; WuiRect is four packed floats in (x, y, width, height) order.
+// The full result is cached under token and generation (see "Layout Result
+// Cache"). Returns the number written, or -1 if a measure upcall of pass threw.
+jint bulk_place(JNIEnv *env, WuiLayout *layout, const BulkLayoutPass &pass,
+                jlong token, jint generation, jfloat x, jfloat y, jfloat width,
+                jfloat height, WuiArray_WuiSubView subviews,
+                jfloatArray outPlacements) {
+  WuiRect bounds{};
+  bounds.origin.x = x;
+  bounds.origin.y = y;
+  bounds.size.width = width;
+  bounds.size.height = height;
+  WuiArray_WuiRect result =
+      g_sym.waterui_layout_place(layout, bounds, subviews);
+  if (pass.aborted) {
+    result.vtable.drop(result.data);
+    return -1;
+  }
+  WuiArraySlice_WuiRect slice = result.vtable.slice(result.data);
+
+  jsize capacity = env->GetArrayLength(outPlacements) / kBulkPlacementStride;
+  jsize written = std::min(static_cast<jsize>(slice.len), capacity);
+  static_assert(sizeof(WuiRect) == sizeof(jfloat) * kBulkPlacementStride,
+                "WuiRect must be four packed floats");
+  if (written > 0) {
+    env->SetFloatArrayRegion(outPlacements, 0, written * kBulkPlacementStride,
+                             reinterpret_cast<const jfloat *>(slice.head));
+  }
+  if (x == 0 && y == 0) {
+    layout_cache_store_placements(token, generation, width, height,
+                                  slice.head, slice.len);
+  }
+  result.vtable.drop(result.data);
+  return static_cast<jint>(written);
+}
+
 // ========== Layout Functions ==========
 
 // Get JavaVM from JNIEnv for use in callbacks
@@ -2212,6 +5538,7 @@ JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_layoutSizeThatFits(
     JNIEnv *env, jclass, jlong layoutPtr, jobject proposalObj,
     jobjectArray subviewsArr) {
+  WUI_TRACE_SCOPE("WaterUI.layoutSizeThatFits");
   auto *layout = jlong_to_ptr<WuiLayout>(layoutPtr);
   WuiProposalSize proposal = proposal_from_java(env, proposalObj);
   JavaVM *jvm = get_java_vm(env);
@@ -2228,6 +5555,7 @@ Java_dev_waterui_android_ffi_WatcherJni_layoutPlace(JNIEnv *env, jclass,
                                                     jlong layoutPtr,
                                                     jobject boundsObj,
                                                     jobjectArray subviewsArr) {
+  WUI_TRACE_SCOPE("WaterUI.layoutPlace");
   auto *layout = jlong_to_ptr<WuiLayout>(layoutPtr);
   WuiRect bounds = rect_from_java(env, boundsObj);
   JavaVM *jvm = get_java_vm(env);
@@ -2237,16 +5565,179 @@ Java_dev_waterui_android_ffi_WatcherJni_layoutPlace(JNIEnv *env, jclass,
       g_sym.waterui_layout_place(layout, bounds, subviews);
   WuiArraySlice_WuiRect slice = result.vtable.slice(result.data);
 
-  jclass cls = find_app_class(env, "dev/waterui/android/runtime/RectStruct");
-  jobjectArray resultArr = env->NewObjectArray(slice.len, cls, nullptr);
-  for (uintptr_t i = 0; i < slice.len; ++i) {
-    jobject rectObj = rect_to_java(env, slice.head[i]);
-    env->SetObjectArrayElement(resultArr, static_cast<jsize>(i), rectObj);
-    env->DeleteLocalRef(rectObj);
+  jobjectArray resultArr = env->NewObjectArray(
+      slice.len, struct_class(StructClass::RectStruct), nullptr);
+  for (uintptr_t i = 0; i < slice.len; ++i) {
+    jobject rectObj = rect_to_java(env, slice.head[i]);
+    env->SetObjectArrayElement(resultArr, static_cast<jsize>(i), rectObj);
+    env->DeleteLocalRef(rectObj);
+  }
+  result.vtable.drop(result.data);
+  return resultArr;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_dev_waterui_android_ffi_WatcherJni_layoutSizeThatFitsBulk(
+    JNIEnv *env, jclass, jlong layoutPtr, jlong cacheToken, jint generation,
+    jfloat proposalWidth, jfloat proposalHeight, jintArray childInfoArr,
+    jfloatArray measurementsArr, jint entriesPerChild, jobject measurer,
+    jfloatArray outSize) {
+  WUI_TRACE_SCOPE("WaterUI.layoutSizeThatFitsBulk");
+  auto *layout = jlong_to_ptr<WuiLayout>(layoutPtr);
+  BulkLayoutPass pass{};
+  jsize count = bulk_pass_from_java(env, pass, childInfoArr, measurementsArr,
+                                    entriesPerChild, measurer);
+  if (count < 0 || outSize == nullptr || env->GetArrayLength(outSize) < 2) {
+    return JNI_FALSE;
+  }
+  WuiArray_WuiSubView subviews = bulk_subviews_from_java(
+      env, pass, childInfoArr, measurementsArr, count);
+
+  WuiProposalSize proposal{proposalWidth, proposalHeight};
+  WuiSize size =
+      g_sym.waterui_layout_size_that_fits(layout, proposal, subviews);
+  if (pass.aborted) {
+    return JNI_FALSE;
+  }
+  layout_cache_store_size(cacheToken, generation, proposal, size);
+
+  jfloat out[2] = {size.width, size.height};
+  env->SetFloatArrayRegion(outSize, 0, 2, out);
+  return JNI_TRUE;
+}
+
+JNIEXPORT jint JNICALL
+Java_dev_waterui_android_ffi_WatcherJni_layoutPlaceBulk(
+    JNIEnv *env, jclass, jlong layoutPtr, jlong cacheToken, jint generation,
+    jfloat x, jfloat y,
+    jfloat width, jfloat height, jintArray childInfoArr,
+    jfloatArray measurementsArr, jint entriesPerChild, jobject measurer,
+    jfloatArray outPlacements) {
+  WUI_TRACE_SCOPE("WaterUI.layoutPlaceBulk");
+  auto *layout = jlong_to_ptr<WuiLayout>(layoutPtr);
+  BulkLayoutPass pass{};
+  jsize count = bulk_pass_from_java(env, pass, childInfoArr, measurementsArr,
+                                    entriesPerChild, measurer);
+  if (count < 0 || outPlacements == nullptr) {
+    return -1;
+  }
+  WuiArray_WuiSubView subviews = bulk_subviews_from_java(
+      env, pass, childInfoArr, measurementsArr, count);
+
+  return bulk_place(env, layout, pass, cacheToken, generation, x, y, width,
+                    height, subviews, outPlacements);
+}
+
+// Cached result of layoutSizeThatFitsBulk for this proposal and generation.
+// Returns false on a miss, leaving outSize untouched.
+JNIEXPORT jboolean JNICALL
+Java_dev_waterui_android_ffi_WatcherJni_layoutCachedSize(
+    JNIEnv *env, jclass, jlong cacheToken, jint generation,
+    jfloat proposalWidth, jfloat proposalHeight, jfloatArray outSize) {
+  WuiSize size{};
+  if (outSize == nullptr || env->GetArrayLength(outSize) < 2 ||
+      !layout_cache_lookup_size(cacheToken, generation,
+                                WuiProposalSize{proposalWidth, proposalHeight},
+                                &size)) {
+    return JNI_FALSE;
+  }
+  jfloat out[2] = {size.width, size.height};
+  env->SetFloatArrayRegion(outSize, 0, 2, out);
+  return JNI_TRUE;
+}
+
+// Cached placements of layoutPlaceBulk for bounds of this size at the origin.
+// Returns the number of rects written, or -1 on a miss.
+JNIEXPORT jint JNICALL
+Java_dev_waterui_android_ffi_WatcherJni_layoutCachedPlacements(
+    JNIEnv *env, jclass, jlong cacheToken, jint generation, jfloat width,
+    jfloat height, jfloatArray outPlacements) {
+  if (generation < 0 || outPlacements == nullptr) {
+    return -1;
+  }
+  std::lock_guard<std::mutex> lock(g_layout_cache_mutex);
+  auto it = g_layout_caches.find(cacheToken);
+  if (it == g_layout_caches.end()) {
+    return -1;
+  }
+  const LayoutResultCache &cache = it->second;
+  if (cache.generation != generation || !cache.hasPlacements ||
+      cache.boundsWidth != width || cache.boundsHeight != height) {
+    return -1;
+  }
+  jsize capacity = env->GetArrayLength(outPlacements) / kBulkPlacementStride;
+  jsize written =
+      std::min(static_cast<jsize>(cache.placements.size()), capacity);
+  if (written > 0) {
+    env->SetFloatArrayRegion(
+        outPlacements, 0, written * kBulkPlacementStride,
+        reinterpret_cast<const jfloat *>(cache.placements.data()));
+  }
+  return written;
+}
+
+// Erases the cache entry of a disposed container.
+JNIEXPORT void JNICALL
+Java_dev_waterui_android_ffi_WatcherJni_releaseLayoutCache(JNIEnv *, jclass,
+                                                           jlong cacheToken) {
+  std::lock_guard<std::mutex> lock(g_layout_cache_mutex);
+  g_layout_caches.erase(cacheToken);
+}
+
+// ========== Snapshot Layout ==========
+//
+// The bulk entry points without a SubViewMeasurer, for computing a layout on a
+// background thread from a snapshot of child measurements. Nothing calls back
+// into Java; a probe the table cannot answer is estimated (see
+// bulk_subview_measure). Both return the number of estimated probes, so the
+// result is exact when it is zero, or -1 if the arrays are inconsistent.
+
+JNIEXPORT jint JNICALL
+Java_dev_waterui_android_ffi_WatcherJni_layoutSizeThatFitsSnapshot(
+    JNIEnv *env, jclass, jlong layoutPtr, jfloat proposalWidth,
+    jfloat proposalHeight, jintArray childInfoArr, jfloatArray measurementsArr,
+    jint entriesPerChild, jfloatArray outSize) {
+  WUI_TRACE_SCOPE("WaterUI.layoutSizeThatFitsSnapshot");
+  auto *layout = jlong_to_ptr<WuiLayout>(layoutPtr);
+  BulkLayoutPass pass{};
+  jsize count = bulk_pass_from_java(env, pass, childInfoArr, measurementsArr,
+                                    entriesPerChild, nullptr);
+  if (count < 0 || outSize == nullptr || env->GetArrayLength(outSize) < 2) {
+    return -1;
+  }
+  pass.snapshot = true;
+  WuiArray_WuiSubView subviews = bulk_subviews_from_java(
+      env, pass, childInfoArr, measurementsArr, count);
+
+  WuiProposalSize proposal{proposalWidth, proposalHeight};
+  WuiSize size =
+      g_sym.waterui_layout_size_that_fits(layout, proposal, subviews);
+
+  jfloat out[2] = {size.width, size.height};
+  env->SetFloatArrayRegion(outSize, 0, 2, out);
+  return pass.misses;
+}
+
+JNIEXPORT jint JNICALL
+Java_dev_waterui_android_ffi_WatcherJni_layoutPlaceSnapshot(
+    JNIEnv *env, jclass, jlong layoutPtr, jfloat width, jfloat height,
+    jintArray childInfoArr, jfloatArray measurementsArr, jint entriesPerChild,
+    jfloatArray outPlacements) {
+  WUI_TRACE_SCOPE("WaterUI.layoutPlaceSnapshot");
+  auto *layout = jlong_to_ptr<WuiLayout>(layoutPtr);
+  BulkLayoutPass pass{};
+  jsize count = bulk_pass_from_java(env, pass, childInfoArr, measurementsArr,
+                                    entriesPerChild, nullptr);
+  if (count < 0 || outPlacements == nullptr) {
+    return -1;
   }
-  env->DeleteLocalRef(cls);
-  result.vtable.drop(result.data);
-  return resultArr;
+  pass.snapshot = true;
+  WuiArray_WuiSubView subviews = bulk_subviews_from_java(
+      env, pass, childInfoArr, measurementsArr, count);
+
+  jint written = bulk_place(env, layout, pass, 0, -1, 0, 0, width, height,
+                            subviews, outPlacements);
+  return written < count ? -1 : pass.misses;
 }
 
 // ========== Type ID Functions ==========
@@ -2255,7 +5746,7 @@ Java_dev_waterui_android_ffi_WatcherJni_layoutPlace(JNIEnv *env, jclass,
   JNIEXPORT jobject JNICALL                                                    \
       Java_dev_waterui_android_ffi_WatcherJni_##javaName(JNIEnv *env,          \
                                                          jclass) {             \
-    WuiTypeId typeId = g_sym.cName();                                          \
+    WuiTypeId typeId = g_type_ids.cName;                                       \
     return new_type_id_struct(env, typeId);                                    \
   }
 
@@ -2327,32 +5818,28 @@ Java_dev_waterui_android_ffi_WatcherJni_app(JNIEnv *env, jclass, jlong envPtr) {
       wuiApp.windows.vtable.slice(wuiApp.windows.data);
 
   // Create WindowStruct class and array
-  jclass windowCls =
-      find_app_class(env, "dev/waterui/android/runtime/WindowStruct");
-  jmethodID windowCtor = env->GetMethodID(windowCls, "<init>", "(JZZJJJJI)V");
   jobjectArray windowArray =
-      env->NewObjectArray(static_cast<jsize>(slice.len), windowCls, nullptr);
+      env->NewObjectArray(static_cast<jsize>(slice.len),
+                          struct_class(StructClass::WindowStruct), nullptr);
 
   for (size_t i = 0; i < slice.len; i++) {
     WuiWindow *window = slice.head + i;
-    jobject windowObj = env->NewObject(
-        windowCls, windowCtor, ptr_to_jlong(window->title),
-        static_cast<jboolean>(window->closable),
-        static_cast<jboolean>(window->resizable), ptr_to_jlong(window->frame),
-        ptr_to_jlong(window->content), ptr_to_jlong(window->state),
-        ptr_to_jlong(window->toolbar), static_cast<jint>(window->style));
+    jobject windowObj = new_struct(env, StructClass::WindowStruct,
+                                   ptr_to_jlong(window->title),
+                                   static_cast<jboolean>(window->closable),
+                                   static_cast<jboolean>(window->resizable),
+                                   ptr_to_jlong(window->frame),
+                                   ptr_to_jlong(window->content),
+                                   ptr_to_jlong(window->state),
+                                   ptr_to_jlong(window->toolbar),
+                                   static_cast<jint>(window->style));
     env->SetObjectArrayElement(windowArray, static_cast<jsize>(i), windowObj);
     env->DeleteLocalRef(windowObj);
   }
-  env->DeleteLocalRef(windowCls);
 
   // Create AppStruct with env returned from the app
-  jclass appCls = find_app_class(env, "dev/waterui/android/runtime/AppStruct");
-  jmethodID appCtor = env->GetMethodID(
-      appCls, "<init>", "([Ldev/waterui/android/runtime/WindowStruct;J)V");
-  jobject appObj =
-      env->NewObject(appCls, appCtor, windowArray, ptr_to_jlong(wuiApp.env));
-  env->DeleteLocalRef(appCls);
+  jobject appObj = new_struct(env, StructClass::AppStruct, windowArray,
+                              ptr_to_jlong(wuiApp.env));
 
   return appObj;
 }
@@ -2378,6 +5865,7 @@ Java_dev_waterui_android_ffi_WatcherJni_envInstallWebViewController(
 
 JNIEXPORT jlong JNICALL Java_dev_waterui_android_ffi_WatcherJni_viewBody(
     JNIEnv *, jclass, jlong viewPtr, jlong envPtr) {
+  WUI_TRACE_SCOPE("WaterUI.viewBody");
   auto *view = jlong_to_ptr<WuiAnyView>(viewPtr);
   auto *env = jlong_to_ptr<WuiEnv>(envPtr);
   return ptr_to_jlong(g_sym.waterui_view_body(view, env));
@@ -2422,29 +5910,205 @@ Java_dev_waterui_android_ffi_WatcherJni_configureHotReloadDirectory(
                       "Hot reload directory configuration not yet implemented");
 }
 
+// ========== View Tree Walker ==========
+
+// Type ids a RenderRegistry can render, sorted so the walker can look them up
+// without calling back into Kotlin. Built once per registry and, like the
+// registry, never freed.
+struct ViewTypeEntry {
+  WuiTypeId id;
+  uint32_t flags;
+  int32_t kind; // see "Component Kinds"
+};
+
+struct ViewTypeSet {
+  std::vector<ViewTypeEntry> entries;
+};
+
+// ViewTypeEntry::flags, as passed to viewTypeSetCreate.
+constexpr uint32_t kViewTypeMetadata = 1u << 0;
+
+// Walker record: (int64 view, int64 id.low, int64 id.high, int32 stretch axis,
+// int32 flags, int32 component kind, int32 reserved) in native byte order.
+constexpr size_t kViewRecordSize = 40;
+constexpr int32_t kViewRecordResolved = 1 << 0;
+constexpr int32_t kViewRecordMetadata = 1 << 1;
+constexpr int32_t kViewRecordComponent = 1 << 2;
+
+const ViewTypeEntry *find_view_type(const ViewTypeSet *set, WuiTypeId id) {
+  auto it = std::lower_bound(
+      set->entries.begin(), set->entries.end(), id,
+      [](const ViewTypeEntry &entry, const WuiTypeId &key) {
+        return type_id_less(entry.id, key);
+      });
+  if (it == set->entries.end() || it->id.low != id.low ||
+      it->id.high != id.high) {
+    return nullptr;
+  }
+  return &*it;
+}
+
+// Expands view through its bodies until it reaches a type in set, writing one
+// record to out. Stretch axis is read before the renderer consumes the view,
+// and only for non-metadata types (metadata takes it from its content). A
+// native component outside set, such as a deferred one Kotlin has not
+// resolved, stops the expansion too and is recorded as kViewRecordComponent
+// with its kind, for Kotlin to resolve. A chain that ends without a
+// registered type is recorded with its last id, a null view and no flags.
+void resolve_view_record(const ViewTypeSet *set, WuiAnyView *view,
+                         WuiEnv *wuiEnv, uint8_t *out) {
+  WuiTypeId id = g_sym.waterui_view_id(view);
+  int32_t record[4] = {0, 0, kUnknownComponentKind, 0};
+  for (;;) {
+    const ViewTypeEntry *entry = find_view_type(set, id);
+    if (entry != nullptr) {
+      record[1] = kViewRecordResolved;
+      record[2] = entry->kind;
+      if (entry->flags & kViewTypeMetadata) {
+        record[1] |= kViewRecordMetadata;
+      } else {
+        record[0] = static_cast<int32_t>(g_sym.waterui_view_stretch_axis(view));
+      }
+      break;
+    }
+    int32_t kind = component_kind(id);
+    if (kind != kUnknownComponentKind) {
+      record[1] = kViewRecordComponent;
+      record[2] = kind;
+      break;
+    }
+    WuiAnyView *body = g_sym.waterui_view_body(view, wuiEnv);
+    if (body == nullptr) {
+      view = nullptr;
+      break;
+    }
+    view = body;
+    id = g_sym.waterui_view_id(view);
+  }
+  int64_t fields[3] = {ptr_to_jlong(view), static_cast<int64_t>(id.low),
+                       static_cast<int64_t>(id.high)};
+  std::memcpy(out, fields, sizeof(fields));
+  std::memcpy(out + sizeof(fields), record, sizeof(record));
+}
+
+// ids holds (low, high) pairs, flags one kViewType* mask per id. Returns 0 if
+// the arrays disagree in length.
+JNIEXPORT jlong JNICALL
+Java_dev_waterui_android_ffi_WatcherJni_viewTypeSetCreate(
+    JNIEnv *env, jclass, jlongArray ids, jintArray flags) {
+  jsize count = flags != nullptr ? env->GetArrayLength(flags) : 0;
+  if (ids == nullptr || env->GetArrayLength(ids) != count * 2) {
+    __android_log_print(ANDROID_LOG_ERROR, LOG_TAG,
+                        "viewTypeSetCreate: mismatched id and flag arrays");
+    return 0;
+  }
+  auto *set = new ViewTypeSet();
+  set->entries.resize(static_cast<size_t>(count));
+  std::vector<jlong> pairs(static_cast<size_t>(count) * 2);
+  std::vector<jint> masks(static_cast<size_t>(count));
+  env->GetLongArrayRegion(ids, 0, count * 2, pairs.data());
+  env->GetIntArrayRegion(flags, 0, count, masks.data());
+  for (jsize i = 0; i < count; ++i) {
+    ViewTypeEntry &entry = set->entries[static_cast<size_t>(i)];
+    entry.id.low = static_cast<uint64_t>(pairs[2 * i]);
+    entry.id.high = static_cast<uint64_t>(pairs[2 * i + 1]);
+    entry.flags = static_cast<uint32_t>(masks[static_cast<size_t>(i)]);
+    entry.kind = component_kind(entry.id);
+  }
+  std::sort(set->entries.begin(), set->entries.end(),
+            [](const ViewTypeEntry &a, const ViewTypeEntry &b) {
+              return type_id_less(a.id, b.id);
+            });
+  return ptr_to_jlong(set);
+}
+
+// Resolves every view in views against typeSet in one crossing, writing record
+// i at i * kViewRecordSize in out. Replaces the viewId / viewStretchAxis /
+// viewBody round trips inflateAnyView made per node. This covers one level:
+// views are usually a container's children, and each child's renderer makes
+// its own call for its children, so a tree costs one crossing per container
+// rather than one per node. Returns the number of records written, or -1 if
+// the buffer is not direct or too small.
+JNIEXPORT jint JNICALL Java_dev_waterui_android_ffi_WatcherJni_resolveViews(
+    JNIEnv *env, jclass, jlong typeSet, jlongArray views, jlong envPtr,
+    jobject out) {
+  WUI_TRACE_SCOPE("WaterUI.resolveViews");
+  auto *set = jlong_to_ptr<ViewTypeSet>(typeSet);
+  jsize count = views != nullptr ? env->GetArrayLength(views) : 0;
+  auto *base = out != nullptr
+                   ? static_cast<uint8_t *>(env->GetDirectBufferAddress(out))
+                   : nullptr;
+  if (set == nullptr || base == nullptr ||
+      env->GetDirectBufferCapacity(out) <
+          static_cast<jlong>(count) * static_cast<jlong>(kViewRecordSize)) {
+    __android_log_print(ANDROID_LOG_ERROR, LOG_TAG,
+                        "resolveViews: invalid type set or buffer");
+    return -1;
+  }
+  if (count == 0)
+    return 0;
+
+  size_t n = static_cast<size_t>(count);
+  size_t blockSize = BumpAllocator::bytes_for<jlong>(n);
+  uint8_t sizeClass = BlockPool::kUnpooled;
+  void *block = g_block_pool.acquire(blockSize, &sizeClass);
+  BumpAllocator bump(block, blockSize);
+  auto *viewPtrs = bump.alloc<jlong>(n);
+  env->GetLongArrayRegion(views, 0, count, viewPtrs);
+  auto *wuiEnv = jlong_to_ptr<WuiEnv>(envPtr);
+  for (size_t i = 0; i < n; ++i) {
+    resolve_view_record(set, jlong_to_ptr<WuiAnyView>(viewPtrs[i]), wuiEnv,
+                        base + i * kViewRecordSize);
+  }
+  g_block_pool.release(block, sizeClass);
+  return count;
+}
+
+JNIEXPORT jint JNICALL
+Java_dev_waterui_android_ffi_WatcherJni_componentKindCount(JNIEnv *, jclass) {
+  return kComponentKindCount;
+}
+
+// Dense tag for a type id (see "Component Kinds"), or -1 if it has none.
+JNIEXPORT jint JNICALL Java_dev_waterui_android_ffi_WatcherJni_typeIdKind(
+    JNIEnv *, jclass, jlong low, jlong high) {
+  WuiTypeId id{};
+  id.low = static_cast<uint64_t>(low);
+  id.high = static_cast<uint64_t>(high);
+  return component_kind(id);
+}
+
+// viewId without the TypeIdStruct: the view's dense tag, or -1.
+JNIEXPORT jint JNICALL Java_dev_waterui_android_ffi_WatcherJni_viewKind(
+    JNIEnv *, jclass, jlong viewPtr) {
+  return component_kind(
+      g_sym.waterui_view_id(jlong_to_ptr<WuiAnyView>(viewPtr)));
+}
+
 // ========== Force-As Functions ==========
 
 JNIEXPORT jlong JNICALL Java_dev_waterui_android_ffi_WatcherJni_forceAsText(
     JNIEnv *, jclass, jlong viewPtr) {
+  WUI_TRACE_SCOPE("WaterUI.forceAsText");
   auto text = g_sym.waterui_force_as_text(jlong_to_ptr<WuiAnyView>(viewPtr));
   return ptr_to_jlong(text.content);
 }
 
 JNIEXPORT jobject JNICALL Java_dev_waterui_android_ffi_WatcherJni_forceAsButton(
     JNIEnv *env, jclass, jlong viewPtr) {
+  WUI_TRACE_SCOPE("WaterUI.forceAsButton");
   auto button =
       g_sym.waterui_force_as_button(jlong_to_ptr<WuiAnyView>(viewPtr));
-  jclass cls = find_app_class(env, "dev/waterui/android/runtime/ButtonStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(JJI)V");
-  jobject obj = env->NewObject(cls, ctor, ptr_to_jlong(button.label),
-                               ptr_to_jlong(button.action),
-                               static_cast<jint>(button.style));
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::ButtonStruct,
+                           ptr_to_jlong(button.label),
+                           ptr_to_jlong(button.action),
+                           static_cast<jint>(button.style));
   return obj;
 }
 
 JNIEXPORT jlong JNICALL Java_dev_waterui_android_ffi_WatcherJni_forceAsColor(
     JNIEnv *, jclass, jlong viewPtr) {
+  WUI_TRACE_SCOPE("WaterUI.forceAsColor");
   auto color = g_sym.waterui_force_as_color(jlong_to_ptr<WuiAnyView>(viewPtr));
   return ptr_to_jlong(color);
 }
@@ -2452,180 +6116,153 @@ JNIEXPORT jlong JNICALL Java_dev_waterui_android_ffi_WatcherJni_forceAsColor(
 JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_forceAsTextField(JNIEnv *env, jclass,
                                                          jlong viewPtr) {
+  WUI_TRACE_SCOPE("WaterUI.forceAsTextField");
   auto field =
       g_sym.waterui_force_as_text_field(jlong_to_ptr<WuiAnyView>(viewPtr));
-  jclass cls =
-      find_app_class(env, "dev/waterui/android/runtime/TextFieldStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(JJJI)V");
-  jobject obj = env->NewObject(
-      cls, ctor, ptr_to_jlong(field.label), ptr_to_jlong(field.value),
-      ptr_to_jlong(field.prompt.content), static_cast<jint>(field.keyboard));
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::TextFieldStruct,
+                           ptr_to_jlong(field.label), ptr_to_jlong(field.value),
+                           ptr_to_jlong(field.prompt.content),
+                           static_cast<jint>(field.keyboard));
   return obj;
 }
 
 JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_forceAsSecureField(JNIEnv *env, jclass,
                                                            jlong viewPtr) {
+  WUI_TRACE_SCOPE("WaterUI.forceAsSecureField");
   auto field =
       g_sym.waterui_force_as_secure_field(jlong_to_ptr<WuiAnyView>(viewPtr));
-  jclass cls =
-      find_app_class(env, "dev/waterui/android/runtime/SecureFieldStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(JJ)V");
-  jobject obj = env->NewObject(cls, ctor, ptr_to_jlong(field.label),
-                               ptr_to_jlong(field.value));
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::SecureFieldStruct,
+                           ptr_to_jlong(field.label),
+                           ptr_to_jlong(field.value));
   return obj;
 }
 
 JNIEXPORT jobject JNICALL Java_dev_waterui_android_ffi_WatcherJni_forceAsToggle(
     JNIEnv *env, jclass, jlong viewPtr) {
+  WUI_TRACE_SCOPE("WaterUI.forceAsToggle");
   auto toggle =
       g_sym.waterui_force_as_toggle(jlong_to_ptr<WuiAnyView>(viewPtr));
-  jclass cls = find_app_class(env, "dev/waterui/android/runtime/ToggleStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(JJI)V");
-  jobject obj = env->NewObject(cls, ctor, ptr_to_jlong(toggle.label),
-                               ptr_to_jlong(toggle.toggle),
-                               static_cast<jint>(toggle.style));
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::ToggleStruct,
+                           ptr_to_jlong(toggle.label),
+                           ptr_to_jlong(toggle.toggle),
+                           static_cast<jint>(toggle.style));
   return obj;
 }
 
 JNIEXPORT jobject JNICALL Java_dev_waterui_android_ffi_WatcherJni_forceAsSlider(
     JNIEnv *env, jclass, jlong viewPtr) {
+  WUI_TRACE_SCOPE("WaterUI.forceAsSlider");
   auto slider =
       g_sym.waterui_force_as_slider(jlong_to_ptr<WuiAnyView>(viewPtr));
-  jclass cls = find_app_class(env, "dev/waterui/android/runtime/SliderStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(JJJDDJ)V");
-  jobject obj = env->NewObject(cls, ctor, ptr_to_jlong(slider.label),
-                               ptr_to_jlong(slider.min_value_label),
-                               ptr_to_jlong(slider.max_value_label),
-                               static_cast<jdouble>(slider.range.start),
-                               static_cast<jdouble>(slider.range.end),
-                               ptr_to_jlong(slider.value));
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::SliderStruct,
+                           ptr_to_jlong(slider.label),
+                           ptr_to_jlong(slider.min_value_label),
+                           ptr_to_jlong(slider.max_value_label),
+                           static_cast<jdouble>(slider.range.start),
+                           static_cast<jdouble>(slider.range.end),
+                           ptr_to_jlong(slider.value));
   return obj;
 }
 
 JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_forceAsStepper(JNIEnv *env, jclass,
                                                        jlong viewPtr) {
+  WUI_TRACE_SCOPE("WaterUI.forceAsStepper");
   auto stepper =
       g_sym.waterui_force_as_stepper(jlong_to_ptr<WuiAnyView>(viewPtr));
-  jclass cls = find_app_class(env, "dev/waterui/android/runtime/StepperStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(JJJII)V");
-  jobject obj = env->NewObject(
-      cls, ctor, ptr_to_jlong(stepper.value), ptr_to_jlong(stepper.step),
-      ptr_to_jlong(stepper.label), static_cast<jint>(stepper.range.start),
-      static_cast<jint>(stepper.range.end));
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::StepperStruct,
+                           ptr_to_jlong(stepper.value),
+                           ptr_to_jlong(stepper.step),
+                           ptr_to_jlong(stepper.label),
+                           static_cast<jint>(stepper.range.start),
+                           static_cast<jint>(stepper.range.end));
   return obj;
 }
 
 JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_forceAsDatePicker(JNIEnv *env, jclass,
                                                           jlong viewPtr) {
+  WUI_TRACE_SCOPE("WaterUI.forceAsDatePicker");
   auto picker =
       g_sym.waterui_force_as_date_picker(jlong_to_ptr<WuiAnyView>(viewPtr));
 
   // Create DateStruct for start
-  jclass dateStructCls =
-      find_app_class(env, "dev/waterui/android/runtime/DateStruct");
-  jmethodID dateStructCtor =
-      env->GetMethodID(dateStructCls, "<init>", "(III)V");
-  jobject startDate = env->NewObject(
-      dateStructCls, dateStructCtor, static_cast<jint>(picker.range.start.year),
-      static_cast<jint>(picker.range.start.month),
-      static_cast<jint>(picker.range.start.day));
-  jobject endDate = env->NewObject(dateStructCls, dateStructCtor,
-                                   static_cast<jint>(picker.range.end.year),
-                                   static_cast<jint>(picker.range.end.month),
-                                   static_cast<jint>(picker.range.end.day));
+  jobject startDate = new_struct(env, StructClass::DateStruct,
+                                 static_cast<jint>(picker.range.start.year),
+                                 static_cast<jint>(picker.range.start.month),
+                                 static_cast<jint>(picker.range.start.day));
+  jobject endDate = new_struct(env, StructClass::DateStruct,
+                               static_cast<jint>(picker.range.end.year),
+                               static_cast<jint>(picker.range.end.month),
+                               static_cast<jint>(picker.range.end.day));
 
   // Create DateRangeStruct
-  jclass dateRangeStructCls =
-      find_app_class(env, "dev/waterui/android/runtime/DateRangeStruct");
-  jmethodID dateRangeStructCtor =
-      env->GetMethodID(dateRangeStructCls, "<init>",
-                       "(Ldev/waterui/android/runtime/DateStruct;Ldev/waterui/"
-                       "android/runtime/DateStruct;)V");
-  jobject range = env->NewObject(dateRangeStructCls, dateRangeStructCtor,
-                                 startDate, endDate);
+  jobject range = new_struct(env, StructClass::DateRangeStruct, startDate,
+                             endDate);
 
   // Create DatePickerStruct
-  jclass cls =
-      find_app_class(env, "dev/waterui/android/runtime/DatePickerStruct");
-  jmethodID ctor = env->GetMethodID(
-      cls, "<init>", "(JJLdev/waterui/android/runtime/DateRangeStruct;I)V");
-  jobject obj = env->NewObject(cls, ctor, ptr_to_jlong(picker.label),
-                               ptr_to_jlong(picker.value), range,
-                               static_cast<jint>(picker.ty));
-
-  env->DeleteLocalRef(dateStructCls);
+  jobject obj = new_struct(env, StructClass::DatePickerStruct,
+                           ptr_to_jlong(picker.label),
+                           ptr_to_jlong(picker.value), range,
+                           static_cast<jint>(picker.ty));
+
   env->DeleteLocalRef(startDate);
   env->DeleteLocalRef(endDate);
-  env->DeleteLocalRef(dateRangeStructCls);
   env->DeleteLocalRef(range);
-  env->DeleteLocalRef(cls);
   return obj;
 }
 
 JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_forceAsColorPicker(JNIEnv *env, jclass,
                                                            jlong viewPtr) {
+  WUI_TRACE_SCOPE("WaterUI.forceAsColorPicker");
   auto picker =
       g_sym.waterui_force_as_color_picker(jlong_to_ptr<WuiAnyView>(viewPtr));
 
-  jclass cls =
-      find_app_class(env, "dev/waterui/android/runtime/ColorPickerStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(JJZZ)V");
-  jobject obj = env->NewObject(cls, ctor, ptr_to_jlong(picker.label),
-                               ptr_to_jlong(picker.value),
-                               static_cast<jboolean>(picker.support_alpha),
-                               static_cast<jboolean>(picker.support_hdr));
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::ColorPickerStruct,
+                           ptr_to_jlong(picker.label),
+                           ptr_to_jlong(picker.value),
+                           static_cast<jboolean>(picker.support_alpha),
+                           static_cast<jboolean>(picker.support_hdr));
   return obj;
 }
 
 JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_forceAsProgress(JNIEnv *env, jclass,
                                                         jlong viewPtr) {
+  WUI_TRACE_SCOPE("WaterUI.forceAsProgress");
   auto progress =
       g_sym.waterui_force_as_progress(jlong_to_ptr<WuiAnyView>(viewPtr));
-  jclass cls =
-      find_app_class(env, "dev/waterui/android/runtime/ProgressStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(JJJI)V");
-  jobject obj = env->NewObject(cls, ctor, ptr_to_jlong(progress.label),
-                               ptr_to_jlong(progress.value_label),
-                               ptr_to_jlong(progress.value),
-                               static_cast<jint>(progress.style));
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::ProgressStruct,
+                           ptr_to_jlong(progress.label),
+                           ptr_to_jlong(progress.value_label),
+                           ptr_to_jlong(progress.value),
+                           static_cast<jint>(progress.style));
   return obj;
 }
 
 JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_forceAsScrollView(JNIEnv *env, jclass,
                                                           jlong viewPtr) {
+  WUI_TRACE_SCOPE("WaterUI.forceAsScrollView");
   auto scroll =
       g_sym.waterui_force_as_scroll_view(jlong_to_ptr<WuiAnyView>(viewPtr));
-  jclass cls = find_app_class(env, "dev/waterui/android/runtime/ScrollStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(IJ)V");
-  jobject obj = env->NewObject(cls, ctor, static_cast<jint>(scroll.axis),
-                               ptr_to_jlong(scroll.content));
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::ScrollStruct,
+                           static_cast<jint>(scroll.axis),
+                           ptr_to_jlong(scroll.content));
   return obj;
 }
 
 JNIEXPORT jobject JNICALL Java_dev_waterui_android_ffi_WatcherJni_forceAsPicker(
     JNIEnv *env, jclass, jlong viewPtr) {
+  WUI_TRACE_SCOPE("WaterUI.forceAsPicker");
   auto picker =
       g_sym.waterui_force_as_picker(jlong_to_ptr<WuiAnyView>(viewPtr));
-  jclass cls = find_app_class(env, "dev/waterui/android/runtime/PickerStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(JJI)V");
-  jobject obj = env->NewObject(cls, ctor, ptr_to_jlong(picker.items),
-                               ptr_to_jlong(picker.selection),
-                               static_cast<jint>(picker.style));
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::PickerStruct,
+                           ptr_to_jlong(picker.items),
+                           ptr_to_jlong(picker.selection),
+                           static_cast<jint>(picker.style));
   return obj;
 }
 
@@ -2633,14 +6270,12 @@ JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_forceAsLayoutContainer(JNIEnv *env,
                                                                jclass,
                                                                jlong viewPtr) {
+  WUI_TRACE_SCOPE("WaterUI.forceAsLayoutContainer");
   auto container = g_sym.waterui_force_as_layout_container(
       jlong_to_ptr<WuiAnyView>(viewPtr));
-  jclass cls =
-      find_app_class(env, "dev/waterui/android/runtime/LayoutContainerStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(JJ)V");
-  jobject obj = env->NewObject(cls, ctor, ptr_to_jlong(container.layout),
-                               ptr_to_jlong(container.contents));
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::LayoutContainerStruct,
+                           ptr_to_jlong(container.layout),
+                           ptr_to_jlong(container.contents));
   return obj;
 }
 
@@ -2648,6 +6283,7 @@ JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_forceAsFixedContainer(JNIEnv *env,
                                                               jclass,
                                                               jlong viewPtr) {
+  WUI_TRACE_SCOPE("WaterUI.forceAsFixedContainer");
   auto container =
       g_sym.waterui_force_as_fixed_container(jlong_to_ptr<WuiAnyView>(viewPtr));
   // Use the vtable to access the array contents
@@ -2659,12 +6295,8 @@ Java_dev_waterui_android_ffi_WatcherJni_forceAsFixedContainer(JNIEnv *env,
     jlong ptr = ptr_to_jlong(slice.head[i]);
     env->SetLongArrayRegion(childPointers, static_cast<jsize>(i), 1, &ptr);
   }
-  jclass cls =
-      find_app_class(env, "dev/waterui/android/runtime/FixedContainerStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(J[J)V");
-  jobject obj =
-      env->NewObject(cls, ctor, ptr_to_jlong(container.layout), childPointers);
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::FixedContainerStruct,
+                           ptr_to_jlong(container.layout), childPointers);
   env->DeleteLocalRef(childPointers);
   // Don't drop the array here - it's owned by the view
   return obj;
@@ -2672,6 +6304,7 @@ Java_dev_waterui_android_ffi_WatcherJni_forceAsFixedContainer(JNIEnv *env,
 
 JNIEXPORT jlong JNICALL Java_dev_waterui_android_ffi_WatcherJni_forceAsDynamic(
     JNIEnv *, jclass, jlong viewPtr) {
+  WUI_TRACE_SCOPE("WaterUI.forceAsDynamic");
   auto dynamic =
       g_sym.waterui_force_as_dynamic(jlong_to_ptr<WuiAnyView>(viewPtr));
   return ptr_to_jlong(dynamic);
@@ -2680,14 +6313,12 @@ JNIEXPORT jlong JNICALL Java_dev_waterui_android_ffi_WatcherJni_forceAsDynamic(
 JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_forceAsMetadataEnv(JNIEnv *env, jclass,
                                                            jlong viewPtr) {
+  WUI_TRACE_SCOPE("WaterUI.forceAsMetadataEnv");
   auto metadata =
       g_sym.waterui_force_as_metadata_env(jlong_to_ptr<WuiAnyView>(viewPtr));
-  jclass cls =
-      find_app_class(env, "dev/waterui/android/runtime/MetadataEnvStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(JJ)V");
-  jobject obj = env->NewObject(cls, ctor, ptr_to_jlong(metadata.content),
-                               ptr_to_jlong(metadata.value));
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::MetadataEnvStruct,
+                           ptr_to_jlong(metadata.content),
+                           ptr_to_jlong(metadata.value));
   return obj;
 }
 
@@ -2695,39 +6326,33 @@ JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_forceAsMetadataSecure(JNIEnv *env,
                                                               jclass,
                                                               jlong viewPtr) {
+  WUI_TRACE_SCOPE("WaterUI.forceAsMetadataSecure");
   auto metadata =
       g_sym.waterui_force_as_metadata_secure(jlong_to_ptr<WuiAnyView>(viewPtr));
-  jclass cls =
-      find_app_class(env, "dev/waterui/android/runtime/MetadataSecureStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(J)V");
-  jobject obj = env->NewObject(cls, ctor, ptr_to_jlong(metadata.content));
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::MetadataSecureStruct,
+                           ptr_to_jlong(metadata.content));
   return obj;
 }
 
 JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_forceAsMetadataStandardDynamicRange(
     JNIEnv *env, jclass, jlong viewPtr) {
+  WUI_TRACE_SCOPE("WaterUI.forceAsMetadataStandardDynamicRange");
   auto metadata = g_sym.waterui_force_as_metadata_standard_dynamic_range(
       jlong_to_ptr<WuiAnyView>(viewPtr));
-  jclass cls = find_app_class(
-      env, "dev/waterui/android/runtime/MetadataStandardDynamicRangeStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(J)V");
-  jobject obj = env->NewObject(cls, ctor, ptr_to_jlong(metadata.content));
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::MetadataStandardDynamicRangeStruct,
+                           ptr_to_jlong(metadata.content));
   return obj;
 }
 
 JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_forceAsMetadataHighDynamicRange(
     JNIEnv *env, jclass, jlong viewPtr) {
+  WUI_TRACE_SCOPE("WaterUI.forceAsMetadataHighDynamicRange");
   auto metadata = g_sym.waterui_force_as_metadata_high_dynamic_range(
       jlong_to_ptr<WuiAnyView>(viewPtr));
-  jclass cls = find_app_class(
-      env, "dev/waterui/android/runtime/MetadataHighDynamicRangeStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(J)V");
-  jobject obj = env->NewObject(cls, ctor, ptr_to_jlong(metadata.content));
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::MetadataHighDynamicRangeStruct,
+                           ptr_to_jlong(metadata.content));
   return obj;
 }
 
@@ -2735,14 +6360,11 @@ JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_forceAsMetadataGesture(JNIEnv *env,
                                                                jclass,
                                                                jlong viewPtr) {
+  WUI_TRACE_SCOPE("WaterUI.forceAsMetadataGesture");
   auto metadata = g_sym.waterui_force_as_metadata_gesture(
       jlong_to_ptr<WuiAnyView>(viewPtr));
 
   // Create GestureDataStruct
-  jclass gestureDataCls =
-      find_app_class(env, "dev/waterui/android/runtime/GestureDataStruct");
-  jmethodID gestureDataCtor =
-      env->GetMethodID(gestureDataCls, "<init>", "(IIFFFJJ)V");
 
   // Extract gesture data based on tag
   int tapCount = 1;
@@ -2776,38 +6398,31 @@ Java_dev_waterui_android_ffi_WatcherJni_forceAsMetadataGesture(JNIEnv *env,
     break;
   }
 
-  jobject gestureData = env->NewObject(
-      gestureDataCls, gestureDataCtor, tapCount, longPressDuration,
-      dragMinDistance, magnificationInitialScale, rotationInitialAngle,
-      thenFirstPtr, thenSecondPtr);
+  jobject gestureData = new_struct(env, StructClass::GestureDataStruct,
+                                   tapCount, longPressDuration, dragMinDistance,
+                                   magnificationInitialScale,
+                                   rotationInitialAngle, thenFirstPtr,
+                                   thenSecondPtr);
 
   // Create MetadataGestureStruct
-  jclass cls =
-      find_app_class(env, "dev/waterui/android/runtime/MetadataGestureStruct");
-  jmethodID ctor = env->GetMethodID(
-      cls, "<init>", "(JILdev/waterui/android/runtime/GestureDataStruct;J)V");
-  jobject obj =
-      env->NewObject(cls, ctor, ptr_to_jlong(metadata.content),
-                     static_cast<jint>(metadata.value.gesture.tag), gestureData,
-                     ptr_to_jlong(metadata.value.action));
-  env->DeleteLocalRef(gestureDataCls);
+  jobject obj = new_struct(env, StructClass::MetadataGestureStruct,
+                           ptr_to_jlong(metadata.content),
+                           static_cast<jint>(metadata.value.gesture.tag),
+                           gestureData, ptr_to_jlong(metadata.value.action));
   env->DeleteLocalRef(gestureData);
-  env->DeleteLocalRef(cls);
   return obj;
 }
 
 JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_forceAsMetadataLifeCycleHook(
     JNIEnv *env, jclass, jlong viewPtr) {
+  WUI_TRACE_SCOPE("WaterUI.forceAsMetadataLifeCycleHook");
   auto metadata = g_sym.waterui_force_as_metadata_lifecycle_hook(
       jlong_to_ptr<WuiAnyView>(viewPtr));
-  jclass cls = find_app_class(
-      env, "dev/waterui/android/runtime/MetadataLifeCycleHookStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(JIJ)V");
-  jobject obj = env->NewObject(cls, ctor, ptr_to_jlong(metadata.content),
-                               static_cast<jint>(metadata.value.lifecycle),
-                               ptr_to_jlong(metadata.value.handler));
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::MetadataLifeCycleHookStruct,
+                           ptr_to_jlong(metadata.content),
+                           static_cast<jint>(metadata.value.lifecycle),
+                           ptr_to_jlong(metadata.value.handler));
   return obj;
 }
 
@@ -2815,15 +6430,13 @@ JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_forceAsMetadataOnEvent(JNIEnv *env,
                                                                jclass,
                                                                jlong viewPtr) {
+  WUI_TRACE_SCOPE("WaterUI.forceAsMetadataOnEvent");
   auto metadata = g_sym.waterui_force_as_metadata_on_event(
       jlong_to_ptr<WuiAnyView>(viewPtr));
-  jclass cls =
-      find_app_class(env, "dev/waterui/android/runtime/MetadataOnEventStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(JIJ)V");
-  jobject obj = env->NewObject(cls, ctor, ptr_to_jlong(metadata.content),
-                               static_cast<jint>(metadata.value.event),
-                               ptr_to_jlong(metadata.value.handler));
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::MetadataOnEventStruct,
+                           ptr_to_jlong(metadata.content),
+                           static_cast<jint>(metadata.value.event),
+                           ptr_to_jlong(metadata.value.handler));
   return obj;
 }
 
@@ -2831,14 +6444,12 @@ JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_forceAsMetadataCursor(JNIEnv *env,
                                                               jclass,
                                                               jlong viewPtr) {
+  WUI_TRACE_SCOPE("WaterUI.forceAsMetadataCursor");
   auto metadata =
       g_sym.waterui_force_as_metadata_cursor(jlong_to_ptr<WuiAnyView>(viewPtr));
-  jclass cls =
-      find_app_class(env, "dev/waterui/android/runtime/MetadataCursorStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(JJ)V");
-  jobject obj = env->NewObject(cls, ctor, ptr_to_jlong(metadata.content),
-                               ptr_to_jlong(metadata.value.style));
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::MetadataCursorStruct,
+                           ptr_to_jlong(metadata.content),
+                           ptr_to_jlong(metadata.value.style));
   return obj;
 }
 
@@ -2846,16 +6457,14 @@ JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_forceAsMetadataShadow(JNIEnv *env,
                                                               jclass,
                                                               jlong viewPtr) {
+  WUI_TRACE_SCOPE("WaterUI.forceAsMetadataShadow");
   auto metadata =
       g_sym.waterui_force_as_metadata_shadow(jlong_to_ptr<WuiAnyView>(viewPtr));
-  jclass cls =
-      find_app_class(env, "dev/waterui/android/runtime/MetadataShadowStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(JJFFF)V");
-  jobject obj = env->NewObject(cls, ctor, ptr_to_jlong(metadata.content),
-                               ptr_to_jlong(metadata.value.color),
-                               metadata.value.offset_x, metadata.value.offset_y,
-                               metadata.value.radius);
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::MetadataShadowStruct,
+                           ptr_to_jlong(metadata.content),
+                           ptr_to_jlong(metadata.value.color),
+                           metadata.value.offset_x, metadata.value.offset_y,
+                           metadata.value.radius);
   return obj;
 }
 
@@ -2863,25 +6472,24 @@ JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_forceAsMetadataBorder(JNIEnv *env,
                                                               jclass,
                                                               jlong viewPtr) {
+  WUI_TRACE_SCOPE("WaterUI.forceAsMetadataBorder");
   auto metadata =
       g_sym.waterui_force_as_metadata_border(jlong_to_ptr<WuiAnyView>(viewPtr));
-  jclass cls =
-      find_app_class(env, "dev/waterui/android/runtime/MetadataBorderStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(JJFFZZZZ)V");
-  jobject obj = env->NewObject(cls, ctor, ptr_to_jlong(metadata.content),
-                               ptr_to_jlong(metadata.value.color),
-                               metadata.value.width, metadata.value.corner_radius,
-                               static_cast<jboolean>(metadata.value.edges.top),
-                               static_cast<jboolean>(metadata.value.edges.leading),
-                               static_cast<jboolean>(metadata.value.edges.bottom),
-                               static_cast<jboolean>(metadata.value.edges.trailing));
-  env->DeleteLocalRef(cls);
+  jobject obj =
+      new_struct(env, StructClass::MetadataBorderStruct,
+                 ptr_to_jlong(metadata.content),
+                 ptr_to_jlong(metadata.value.color), metadata.value.width,
+                 metadata.value.corner_radius,
+                 static_cast<jboolean>(metadata.value.edges.top),
+                 static_cast<jboolean>(metadata.value.edges.leading),
+                 static_cast<jboolean>(metadata.value.edges.bottom),
+                 static_cast<jboolean>(metadata.value.edges.trailing));
   return obj;
 }
 
 JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_metadataBorderId(JNIEnv *env, jclass) {
-  auto id = g_sym.waterui_metadata_border_id();
+  auto id = g_type_ids.waterui_metadata_border_id;
   return new_type_id_struct(env, id);
 }
 
@@ -2889,32 +6497,28 @@ JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_forceAsMetadataFocused(JNIEnv *env,
                                                                jclass,
                                                                jlong viewPtr) {
+  WUI_TRACE_SCOPE("WaterUI.forceAsMetadataFocused");
   auto metadata = g_sym.waterui_force_as_metadata_focused(
       jlong_to_ptr<WuiAnyView>(viewPtr));
-  jclass cls =
-      find_app_class(env, "dev/waterui/android/runtime/MetadataFocusedStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(JJ)V");
-  jobject obj = env->NewObject(cls, ctor, ptr_to_jlong(metadata.content),
-                               ptr_to_jlong(metadata.value.binding));
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::MetadataFocusedStruct,
+                           ptr_to_jlong(metadata.content),
+                           ptr_to_jlong(metadata.value.binding));
   return obj;
 }
 
 JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_forceAsMetadataIgnoreSafeArea(
     JNIEnv *env, jclass, jlong viewPtr) {
+  WUI_TRACE_SCOPE("WaterUI.forceAsMetadataIgnoreSafeArea");
   auto metadata = g_sym.waterui_force_as_metadata_ignore_safe_area(
       jlong_to_ptr<WuiAnyView>(viewPtr));
-  jclass cls = find_app_class(
-      env, "dev/waterui/android/runtime/MetadataIgnoreSafeAreaStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(JZZZZ)V");
   jobject obj =
-      env->NewObject(cls, ctor, ptr_to_jlong(metadata.content),
-                     static_cast<jboolean>(metadata.value.edges.top),
-                     static_cast<jboolean>(metadata.value.edges.bottom),
-                     static_cast<jboolean>(metadata.value.edges.leading),
-                     static_cast<jboolean>(metadata.value.edges.trailing));
-  env->DeleteLocalRef(cls);
+      new_struct(env, StructClass::MetadataIgnoreSafeAreaStruct,
+                 ptr_to_jlong(metadata.content),
+                 static_cast<jboolean>(metadata.value.edges.top),
+                 static_cast<jboolean>(metadata.value.edges.bottom),
+                 static_cast<jboolean>(metadata.value.edges.leading),
+                 static_cast<jboolean>(metadata.value.edges.trailing));
   return obj;
 }
 
@@ -2922,14 +6526,12 @@ JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_forceAsMetadataRetain(JNIEnv *env,
                                                               jclass,
                                                               jlong viewPtr) {
+  WUI_TRACE_SCOPE("WaterUI.forceAsMetadataRetain");
   auto metadata =
       g_sym.waterui_force_as_metadata_retain(jlong_to_ptr<WuiAnyView>(viewPtr));
-  jclass cls =
-      find_app_class(env, "dev/waterui/android/runtime/MetadataRetainStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(JJ)V");
-  jobject obj = env->NewObject(cls, ctor, ptr_to_jlong(metadata.content),
-                               ptr_to_jlong(metadata.value._opaque));
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::MetadataRetainStruct,
+                           ptr_to_jlong(metadata.content),
+                           ptr_to_jlong(metadata.value._opaque));
   return obj;
 }
 
@@ -2937,16 +6539,14 @@ JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_forceAsMetadataScale(JNIEnv *env,
                                                              jclass,
                                                              jlong viewPtr) {
+  WUI_TRACE_SCOPE("WaterUI.forceAsMetadataScale");
   auto metadata =
       g_sym.waterui_force_as_metadata_scale(jlong_to_ptr<WuiAnyView>(viewPtr));
-  jclass cls =
-      find_app_class(env, "dev/waterui/android/runtime/MetadataScaleStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(JJJFF)V");
-  jobject obj = env->NewObject(
-      cls, ctor, ptr_to_jlong(metadata.content), ptr_to_jlong(metadata.value.x),
-      ptr_to_jlong(metadata.value.y), metadata.value.anchor.x,
-      metadata.value.anchor.y);
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::MetadataScaleStruct,
+                           ptr_to_jlong(metadata.content),
+                           ptr_to_jlong(metadata.value.x),
+                           ptr_to_jlong(metadata.value.y),
+                           metadata.value.anchor.x, metadata.value.anchor.y);
   return obj;
 }
 
@@ -2954,16 +6554,13 @@ JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_forceAsMetadataRotation(JNIEnv *env,
                                                                 jclass,
                                                                 jlong viewPtr) {
+  WUI_TRACE_SCOPE("WaterUI.forceAsMetadataRotation");
   auto metadata = g_sym.waterui_force_as_metadata_rotation(
       jlong_to_ptr<WuiAnyView>(viewPtr));
-  jclass cls =
-      find_app_class(env, "dev/waterui/android/runtime/MetadataRotationStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(JJFF)V");
-  jobject obj =
-      env->NewObject(cls, ctor, ptr_to_jlong(metadata.content),
-                     ptr_to_jlong(metadata.value.angle),
-                     metadata.value.anchor.x, metadata.value.anchor.y);
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::MetadataRotationStruct,
+                           ptr_to_jlong(metadata.content),
+                           ptr_to_jlong(metadata.value.angle),
+                           metadata.value.anchor.x, metadata.value.anchor.y);
   return obj;
 }
 
@@ -2971,15 +6568,13 @@ JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_forceAsMetadataOffset(JNIEnv *env,
                                                               jclass,
                                                               jlong viewPtr) {
+  WUI_TRACE_SCOPE("WaterUI.forceAsMetadataOffset");
   auto metadata =
       g_sym.waterui_force_as_metadata_offset(jlong_to_ptr<WuiAnyView>(viewPtr));
-  jclass cls =
-      find_app_class(env, "dev/waterui/android/runtime/MetadataOffsetStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(JJJ)V");
-  jobject obj = env->NewObject(cls, ctor, ptr_to_jlong(metadata.content),
-                               ptr_to_jlong(metadata.value.x),
-                               ptr_to_jlong(metadata.value.y));
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::MetadataOffsetStruct,
+                           ptr_to_jlong(metadata.content),
+                           ptr_to_jlong(metadata.value.x),
+                           ptr_to_jlong(metadata.value.y));
   return obj;
 }
 
@@ -2988,42 +6583,36 @@ Java_dev_waterui_android_ffi_WatcherJni_forceAsMetadataOffset(JNIEnv *env,
 JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_forceAsMetadataBlur(JNIEnv *env, jclass,
                                                             jlong viewPtr) {
+  WUI_TRACE_SCOPE("WaterUI.forceAsMetadataBlur");
   auto metadata =
       g_sym.waterui_force_as_metadata_blur(jlong_to_ptr<WuiAnyView>(viewPtr));
-  jclass cls =
-      find_app_class(env, "dev/waterui/android/runtime/MetadataBlurStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(JJ)V");
-  jobject obj = env->NewObject(cls, ctor, ptr_to_jlong(metadata.content),
-                               ptr_to_jlong(metadata.value.radius));
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::MetadataBlurStruct,
+                           ptr_to_jlong(metadata.content),
+                           ptr_to_jlong(metadata.value.radius));
   return obj;
 }
 
 JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_forceAsMetadataBrightness(
     JNIEnv *env, jclass, jlong viewPtr) {
+  WUI_TRACE_SCOPE("WaterUI.forceAsMetadataBrightness");
   auto metadata = g_sym.waterui_force_as_metadata_brightness(
       jlong_to_ptr<WuiAnyView>(viewPtr));
-  jclass cls = find_app_class(
-      env, "dev/waterui/android/runtime/MetadataBrightnessStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(JJ)V");
-  jobject obj = env->NewObject(cls, ctor, ptr_to_jlong(metadata.content),
-                               ptr_to_jlong(metadata.value.amount));
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::MetadataBrightnessStruct,
+                           ptr_to_jlong(metadata.content),
+                           ptr_to_jlong(metadata.value.amount));
   return obj;
 }
 
 JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_forceAsMetadataSaturation(
     JNIEnv *env, jclass, jlong viewPtr) {
+  WUI_TRACE_SCOPE("WaterUI.forceAsMetadataSaturation");
   auto metadata = g_sym.waterui_force_as_metadata_saturation(
       jlong_to_ptr<WuiAnyView>(viewPtr));
-  jclass cls = find_app_class(
-      env, "dev/waterui/android/runtime/MetadataSaturationStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(JJ)V");
-  jobject obj = env->NewObject(cls, ctor, ptr_to_jlong(metadata.content),
-                               ptr_to_jlong(metadata.value.amount));
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::MetadataSaturationStruct,
+                           ptr_to_jlong(metadata.content),
+                           ptr_to_jlong(metadata.value.amount));
   return obj;
 }
 
@@ -3031,42 +6620,36 @@ JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_forceAsMetadataContrast(JNIEnv *env,
                                                                 jclass,
                                                                 jlong viewPtr) {
+  WUI_TRACE_SCOPE("WaterUI.forceAsMetadataContrast");
   auto metadata = g_sym.waterui_force_as_metadata_contrast(
       jlong_to_ptr<WuiAnyView>(viewPtr));
-  jclass cls =
-      find_app_class(env, "dev/waterui/android/runtime/MetadataContrastStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(JJ)V");
-  jobject obj = env->NewObject(cls, ctor, ptr_to_jlong(metadata.content),
-                               ptr_to_jlong(metadata.value.amount));
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::MetadataContrastStruct,
+                           ptr_to_jlong(metadata.content),
+                           ptr_to_jlong(metadata.value.amount));
   return obj;
 }
 
 JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_forceAsMetadataHueRotation(
     JNIEnv *env, jclass, jlong viewPtr) {
+  WUI_TRACE_SCOPE("WaterUI.forceAsMetadataHueRotation");
   auto metadata = g_sym.waterui_force_as_metadata_hue_rotation(
       jlong_to_ptr<WuiAnyView>(viewPtr));
-  jclass cls = find_app_class(
-      env, "dev/waterui/android/runtime/MetadataHueRotationStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(JJ)V");
-  jobject obj = env->NewObject(cls, ctor, ptr_to_jlong(metadata.content),
-                               ptr_to_jlong(metadata.value.angle));
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::MetadataHueRotationStruct,
+                           ptr_to_jlong(metadata.content),
+                           ptr_to_jlong(metadata.value.angle));
   return obj;
 }
 
 JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_forceAsMetadataGrayscale(
     JNIEnv *env, jclass, jlong viewPtr) {
+  WUI_TRACE_SCOPE("WaterUI.forceAsMetadataGrayscale");
   auto metadata = g_sym.waterui_force_as_metadata_grayscale(
       jlong_to_ptr<WuiAnyView>(viewPtr));
-  jclass cls = find_app_class(
-      env, "dev/waterui/android/runtime/MetadataGrayscaleStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(JJ)V");
-  jobject obj = env->NewObject(cls, ctor, ptr_to_jlong(metadata.content),
-                               ptr_to_jlong(metadata.value.intensity));
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::MetadataGrayscaleStruct,
+                           ptr_to_jlong(metadata.content),
+                           ptr_to_jlong(metadata.value.intensity));
   return obj;
 }
 
@@ -3074,20 +6657,19 @@ JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_forceAsMetadataOpacity(JNIEnv *env,
                                                                jclass,
                                                                jlong viewPtr) {
+  WUI_TRACE_SCOPE("WaterUI.forceAsMetadataOpacity");
   auto metadata = g_sym.waterui_force_as_metadata_opacity(
       jlong_to_ptr<WuiAnyView>(viewPtr));
-  jclass cls =
-      find_app_class(env, "dev/waterui/android/runtime/MetadataOpacityStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(JJ)V");
-  jobject obj = env->NewObject(cls, ctor, ptr_to_jlong(metadata.content),
-                               ptr_to_jlong(metadata.value.value));
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::MetadataOpacityStruct,
+                           ptr_to_jlong(metadata.content),
+                           ptr_to_jlong(metadata.value.value));
   return obj;
 }
 
 JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_forceAsMetadataClipShape(
     JNIEnv *env, jclass, jlong viewPtr) {
+  WUI_TRACE_SCOPE("WaterUI.forceAsMetadataClipShape");
   auto metadata = g_sym.waterui_force_as_metadata_clip_shape(
       jlong_to_ptr<WuiAnyView>(viewPtr));
 
@@ -3096,13 +6678,12 @@ Java_dev_waterui_android_ffi_WatcherJni_forceAsMetadataClipShape(
       metadata.value.commands.vtable.slice(metadata.value.commands.data);
 
   // Create PathCommandStruct class and array
-  jclass cmdCls =
-      find_app_class(env, "dev/waterui/android/runtime/PathCommandStruct");
   // Constructor: (tag, x, y, cx, cy, c1x, c1y, c2x, c2y, rx, ry, start, sweep)
-  jmethodID cmdCtor = env->GetMethodID(cmdCls, "<init>", "(IFFFFFFFFFFFF)V");
 
   jobjectArray cmdArray =
-      env->NewObjectArray(static_cast<jsize>(slice.len), cmdCls, nullptr);
+      env->NewObjectArray(static_cast<jsize>(slice.len),
+                          struct_class(StructClass::PathCommandStruct),
+                          nullptr);
 
   for (size_t i = 0; i < slice.len; i++) {
     WuiPathCommand cmd = slice.head[i];
@@ -3145,24 +6726,18 @@ Java_dev_waterui_android_ffi_WatcherJni_forceAsMetadataClipShape(
       break;
     }
 
-    jobject cmdObj =
-        env->NewObject(cmdCls, cmdCtor, static_cast<jint>(cmd.tag), x, y, cx,
-                       cy, c1x, c1y, c2x, c2y, rx, ry, start, sweep);
+    jobject cmdObj = new_struct(env, StructClass::PathCommandStruct,
+                                static_cast<jint>(cmd.tag), x, y, cx, cy, c1x,
+                                c1y, c2x, c2y, rx, ry, start, sweep);
     env->SetObjectArrayElement(cmdArray, static_cast<jsize>(i), cmdObj);
     env->DeleteLocalRef(cmdObj);
   }
 
   // Create MetadataClipShapeStruct
-  jclass cls = find_app_class(
-      env, "dev/waterui/android/runtime/MetadataClipShapeStruct");
-  jmethodID ctor = env->GetMethodID(
-      cls, "<init>", "(J[Ldev/waterui/android/runtime/PathCommandStruct;)V");
-  jobject obj =
-      env->NewObject(cls, ctor, ptr_to_jlong(metadata.content), cmdArray);
+  jobject obj = new_struct(env, StructClass::MetadataClipShapeStruct,
+                           ptr_to_jlong(metadata.content), cmdArray);
 
-  env->DeleteLocalRef(cmdCls);
   env->DeleteLocalRef(cmdArray);
-  env->DeleteLocalRef(cls);
 
   return obj;
 }
@@ -3170,29 +6745,25 @@ Java_dev_waterui_android_ffi_WatcherJni_forceAsMetadataClipShape(
 JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_forceAsMetadataContextMenu(
     JNIEnv *env, jclass, jlong viewPtr) {
+  WUI_TRACE_SCOPE("WaterUI.forceAsMetadataContextMenu");
   auto metadata = g_sym.waterui_force_as_metadata_context_menu(
       jlong_to_ptr<WuiAnyView>(viewPtr));
 
   // Create MetadataContextMenuStruct
-  jclass cls = find_app_class(
-      env, "dev/waterui/android/runtime/MetadataContextMenuStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(JJ)V");
-  jobject obj = env->NewObject(cls, ctor, ptr_to_jlong(metadata.content),
-                               ptr_to_jlong(metadata.value.items));
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::MetadataContextMenuStruct,
+                           ptr_to_jlong(metadata.content),
+                           ptr_to_jlong(metadata.value.items));
   return obj;
 }
 
 JNIEXPORT jobject JNICALL Java_dev_waterui_android_ffi_WatcherJni_forceAsMenu(
     JNIEnv *env, jclass, jlong viewPtr) {
+  WUI_TRACE_SCOPE("WaterUI.forceAsMenu");
   auto menu = g_sym.waterui_force_as_menu(jlong_to_ptr<WuiAnyView>(viewPtr));
 
   // Create MenuStruct
-  jclass cls = find_app_class(env, "dev/waterui/android/runtime/MenuStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(JJ)V");
-  jobject obj = env->NewObject(cls, ctor, ptr_to_jlong(menu.label),
-                               ptr_to_jlong(menu.items));
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::MenuStruct,
+                           ptr_to_jlong(menu.label), ptr_to_jlong(menu.items));
   return obj;
 }
 
@@ -3206,22 +6777,19 @@ Java_dev_waterui_android_ffi_WatcherJni_readComputedMenuItems(
   auto slice = items.vtable.slice(items.data);
 
   // Create MenuItemStruct class and array
-  jclass itemCls =
-      find_app_class(env, "dev/waterui/android/runtime/MenuItemStruct");
-  jmethodID itemCtor = env->GetMethodID(itemCls, "<init>", "(JJ)V");
   jobjectArray itemArray =
-      env->NewObjectArray(static_cast<jsize>(slice.len), itemCls, nullptr);
+      env->NewObjectArray(static_cast<jsize>(slice.len),
+                          struct_class(StructClass::MenuItemStruct), nullptr);
 
   for (size_t i = 0; i < slice.len; i++) {
     WuiMenuItem item = slice.head[i];
-    jobject itemObj =
-        env->NewObject(itemCls, itemCtor, ptr_to_jlong(item.label.content),
-                       ptr_to_jlong(item.action));
+    jobject itemObj = new_struct(env, StructClass::MenuItemStruct,
+                                 ptr_to_jlong(item.label.content),
+                                 ptr_to_jlong(item.action));
     env->SetObjectArrayElement(itemArray, static_cast<jsize>(i), itemObj);
     env->DeleteLocalRef(itemObj);
   }
 
-  env->DeleteLocalRef(itemCls);
   return itemArray;
 }
 
@@ -3233,7 +6801,8 @@ Java_dev_waterui_android_ffi_WatcherJni_dropComputedMenuItems(
 }
 
 JNIEXPORT void JNICALL Java_dev_waterui_android_ffi_WatcherJni_callSharedAction(
-    JNIEnv *, jclass, jlong actionPtr, jlong envPtr) {
+    JNIEnv *env, jclass, jlong actionPtr, jlong envPtr) {
+  WatcherFlushScope flushOnReturn(env);
   g_sym.waterui_call_shared_action(jlong_to_ptr<WuiSharedAction>(actionPtr),
                                    jlong_to_ptr<WuiEnv>(envPtr));
 }
@@ -3243,6 +6812,96 @@ JNIEXPORT void JNICALL Java_dev_waterui_android_ffi_WatcherJni_dropSharedAction(
   g_sym.waterui_drop_shared_action(jlong_to_ptr<WuiSharedAction>(actionPtr));
 }
 
+// ========== Metadata Chain ==========
+
+// Must match MetadataChain.KIND_* in Kotlin.
+enum class MetadataChainKind : int32_t {
+  Blur = 0,
+  Brightness = 1,
+  Saturation = 2,
+  Contrast = 3,
+  HueRotation = 4,
+  Grayscale = 5,
+  Opacity = 6,
+};
+
+// peelMetadataChain layout: a header of (int64 content, int32 count, int32
+// reserved), then count records of (int32 kind, int32 reserved, int64 value
+// computed pointer), outermost layer first.
+constexpr size_t kMetadataChainHeaderSize = 16;
+constexpr size_t kMetadataChainRecordSize = 16;
+
+bool same_type_id(const WuiTypeId &a, const WuiTypeId &b) {
+  return a.low == b.low && a.high == b.high;
+}
+
+// Consumes view if it is a filter or opacity layer, returning its content and
+// filling kind and value; returns nullptr and leaves view intact otherwise.
+WuiAnyView *peel_metadata_layer(WuiAnyView *view, MetadataChainKind *kind,
+                                void **value) {
+  WuiTypeId id = g_sym.waterui_view_id(view);
+#define PEEL_METADATA_LAYER(Kind, name, field)                                 \
+  if (same_type_id(id, g_type_ids.waterui_metadata_##name##_id)) {            \
+    auto metadata = g_sym.waterui_force_as_metadata_##name(view);              \
+    *kind = MetadataChainKind::Kind;                                           \
+    *value = metadata.value.field;                                             \
+    return metadata.content;                                                   \
+  }
+  PEEL_METADATA_LAYER(Blur, blur, radius)
+  PEEL_METADATA_LAYER(Brightness, brightness, amount)
+  PEEL_METADATA_LAYER(Saturation, saturation, amount)
+  PEEL_METADATA_LAYER(Contrast, contrast, amount)
+  PEEL_METADATA_LAYER(HueRotation, hue_rotation, angle)
+  PEEL_METADATA_LAYER(Grayscale, grayscale, intensity)
+  PEEL_METADATA_LAYER(Opacity, opacity, value)
+#undef PEEL_METADATA_LAYER
+  return nullptr;
+}
+
+// Unwraps the run of filter and opacity layers at the top of viewPtr in one
+// call, instead of a viewId/forceAs round trip and struct per layer. The
+// first non-chain view (or the one left when out is full) is written as the
+// content and is not consumed. Returns the layer count, or -1 if out cannot
+// hold the header.
+JNIEXPORT jint JNICALL
+Java_dev_waterui_android_ffi_WatcherJni_peelMetadataChain(JNIEnv *env, jclass,
+                                                          jlong viewPtr,
+                                                          jobject out) {
+  WUI_TRACE_SCOPE("WaterUI.peelMetadataChain");
+  auto *data = out != nullptr
+                   ? static_cast<uint8_t *>(env->GetDirectBufferAddress(out))
+                   : nullptr;
+  jlong length = data != nullptr ? env->GetDirectBufferCapacity(out) : 0;
+  if (data == nullptr ||
+      length < static_cast<jlong>(kMetadataChainHeaderSize)) {
+    return -1;
+  }
+  size_t capacity = (static_cast<size_t>(length) - kMetadataChainHeaderSize) /
+                    kMetadataChainRecordSize;
+  auto *view = jlong_to_ptr<WuiAnyView>(viewPtr);
+  int32_t count = 0;
+  while (view != nullptr && static_cast<size_t>(count) < capacity) {
+    MetadataChainKind kind;
+    void *value = nullptr;
+    WuiAnyView *content = peel_metadata_layer(view, &kind, &value);
+    if (content == nullptr)
+      break;
+    int32_t tag[2] = {static_cast<int32_t>(kind), 0};
+    int64_t pointer = ptr_to_jlong(value);
+    uint8_t *record = data + kMetadataChainHeaderSize +
+                      static_cast<size_t>(count) * kMetadataChainRecordSize;
+    std::memcpy(record, tag, sizeof(tag));
+    std::memcpy(record + sizeof(tag), &pointer, sizeof(pointer));
+    view = content;
+    count++;
+  }
+  int64_t contentPtr = ptr_to_jlong(view);
+  int32_t header[2] = {count, 0};
+  std::memcpy(data, &contentPtr, sizeof(contentPtr));
+  std::memcpy(data + sizeof(contentPtr), header, sizeof(header));
+  return count;
+}
+
 // ========== OnEvent Handler Functions ==========
 
 JNIEXPORT void JNICALL
@@ -3262,7 +6921,8 @@ Java_dev_waterui_android_ffi_WatcherJni_dropLifeCycleHook(JNIEnv *, jclass,
 }
 
 JNIEXPORT void JNICALL Java_dev_waterui_android_ffi_WatcherJni_callOnEvent(
-    JNIEnv *, jclass, jlong handlerPtr, jlong envPtr) {
+    JNIEnv *env, jclass, jlong handlerPtr, jlong envPtr) {
+  WatcherFlushScope flushOnReturn(env);
   g_sym.waterui_call_on_event(jlong_to_ptr<WuiOnEventHandler>(handlerPtr),
                               jlong_to_ptr<WuiEnv>(envPtr));
 }
@@ -3289,7 +6949,7 @@ Java_dev_waterui_android_ffi_WatcherJni_watchComputedCursorStyle(
       fields, g_sym.waterui_new_watcher_cursor_style);
   auto guard = g_sym.waterui_watch_computed_cursor_style(
       jlong_to_ptr<WuiComputed_CursorStyle>(computedPtr), w);
-  return ptr_to_jlong(guard);
+  return ptr_to_jlong(WUI_TRACK_GUARD(guard));
 }
 
 JNIEXPORT void JNICALL
@@ -3302,7 +6962,8 @@ Java_dev_waterui_android_ffi_WatcherJni_dropComputedCursorStyle(
 JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_createCursorStyleWatcher(
     JNIEnv *env, jclass, jobject callback) {
-  auto *state = create_watcher_state(env, callback);
+  auto *state = create_watcher_state(env, callback, "onInt", "(IJ)V");
+  WUI_TRACK_HANDLE(WatcherCallback, state);
   return new_watcher_struct(
       env, ptr_to_jlong(state),
       ptr_to_jlong(reinterpret_cast<void *>(watcher_cursor_style_call)),
@@ -3344,6 +7005,115 @@ JNIEXPORT jint JNICALL Java_dev_waterui_android_ffi_WatcherJni_anyViewsGetId(
           .inner);
 }
 
+// Clamps the window [start, start + count) to the collection length.
+size_t any_views_window(WuiAnyViews *views, jint start, jint count) {
+  if (views == nullptr || start < 0 || count <= 0)
+    return 0;
+  size_t len = g_sym.waterui_anyviews_len(views);
+  size_t first = static_cast<size_t>(start);
+  if (first >= len)
+    return 0;
+  return std::min(len - first, static_cast<size_t>(count));
+}
+
+// Copies view pointers (and ids, when outIds is non-null) for a window of the
+// collection in one crossing. Returns the number of entries written, or -1
+// if an output array is too small.
+JNIEXPORT jint JNICALL Java_dev_waterui_android_ffi_WatcherJni_anyViewsSnapshot(
+    JNIEnv *env, jclass, jlong handle, jint start, jint count,
+    jlongArray outViews, jintArray outIds) {
+  auto *views = jlong_to_ptr<WuiAnyViews>(handle);
+  if (outViews == nullptr || env->GetArrayLength(outViews) < count ||
+      (outIds != nullptr && env->GetArrayLength(outIds) < count)) {
+    __android_log_print(ANDROID_LOG_ERROR, LOG_TAG,
+                        "anyViewsSnapshot: output arrays too small");
+    return -1;
+  }
+  size_t n = any_views_window(views, start, count);
+  if (n == 0)
+    return 0;
+
+  size_t blockSize = BumpAllocator::bytes_for<jlong>(n) +
+                     BumpAllocator::bytes_for<jint>(n);
+  uint8_t sizeClass = BlockPool::kUnpooled;
+  void *block = g_block_pool.acquire(blockSize, &sizeClass);
+  BumpAllocator bump(block, blockSize);
+  auto *viewPtrs = bump.alloc<jlong>(n);
+  auto *ids = bump.alloc<jint>(n);
+  for (size_t i = 0; i < n; ++i) {
+    size_t index = static_cast<size_t>(start) + i;
+    viewPtrs[i] = ptr_to_jlong(g_sym.waterui_anyviews_get_view(views, index));
+    if (outIds != nullptr) {
+      ids[i] = g_sym.waterui_anyviews_get_id(views, index).inner;
+    }
+  }
+  env->SetLongArrayRegion(outViews, 0, static_cast<jsize>(n), viewPtrs);
+  if (outIds != nullptr) {
+    env->SetIntArrayRegion(outIds, 0, static_cast<jsize>(n), ids);
+  }
+  g_block_pool.release(block, sizeClass);
+  return static_cast<jint>(n);
+}
+
+// Direct-buffer variant of anyViewsSnapshot: entry i is written at
+// i * kAnyViewsRecordSize as (int64 view, int32 id, int32 reserved) in native
+// byte order. Returns the number of entries written, or -1 if the buffer is
+// not direct or too small.
+constexpr size_t kAnyViewsRecordSize = 16;
+
+JNIEXPORT jint JNICALL
+Java_dev_waterui_android_ffi_WatcherJni_anyViewsSnapshotDirect(
+    JNIEnv *env, jclass, jlong handle, jint start, jint count, jobject out) {
+  auto *views = jlong_to_ptr<WuiAnyViews>(handle);
+  auto *base = out != nullptr
+                   ? static_cast<uint8_t *>(env->GetDirectBufferAddress(out))
+                   : nullptr;
+  if (base == nullptr || count < 0 ||
+      env->GetDirectBufferCapacity(out) <
+          static_cast<jlong>(count) * static_cast<jlong>(kAnyViewsRecordSize)) {
+    __android_log_print(ANDROID_LOG_ERROR, LOG_TAG,
+                        "anyViewsSnapshotDirect: invalid buffer");
+    return -1;
+  }
+  size_t n = any_views_window(views, start, count);
+  for (size_t i = 0; i < n; ++i) {
+    size_t index = static_cast<size_t>(start) + i;
+    int64_t view =
+        ptr_to_jlong(g_sym.waterui_anyviews_get_view(views, index));
+    int32_t record[2] = {g_sym.waterui_anyviews_get_id(views, index).inner, 0};
+    uint8_t *entry = base + i * kAnyViewsRecordSize;
+    std::memcpy(entry, &view, sizeof(view));
+    std::memcpy(entry + sizeof(view), record, sizeof(record));
+  }
+  return static_cast<jint>(n);
+}
+
+// Change set (see "Keyed Diff") from previousIds to the ids currently in the
+// collection. A view's content can't be compared, so a row that keeps its id
+// may still render differently: every retained row gets an Update op, and
+// the structural ops only decide which rows animate in, out or across.
+JNIEXPORT jintArray JNICALL Java_dev_waterui_android_ffi_WatcherJni_anyViewsDiff(
+    JNIEnv *env, jclass, jlong handle, jintArray previousIds) {
+  auto *views = jlong_to_ptr<WuiAnyViews>(handle);
+  size_t count = views != nullptr ? g_sym.waterui_anyviews_len(views) : 0;
+  std::vector<int32_t> ids(count);
+  for (size_t i = 0; i < count; ++i) {
+    ids[i] = g_sym.waterui_anyviews_get_id(views, i).inner;
+  }
+
+  jsize previousLen =
+      previousIds != nullptr ? env->GetArrayLength(previousIds) : 0;
+  std::vector<int32_t> previous(static_cast<size_t>(previousLen));
+  if (previousLen > 0) {
+    env->GetIntArrayRegion(previousIds, 0, previousLen, previous.data());
+  }
+
+  std::vector<jint> ops;
+  keyed_diff(previous.data(), previous.size(), ids.data(), count, ops,
+             nullptr, nullptr, true);
+  return new_int_array(env, ops.data(), ops.size());
+}
+
 JNIEXPORT void JNICALL Java_dev_waterui_android_ffi_WatcherJni_dropAnyViews(
     JNIEnv *, jclass, jlong handle) {
   g_sym.waterui_drop_anyviews(jlong_to_ptr<WuiAnyViews>(handle));
@@ -3381,25 +7151,29 @@ Java_dev_waterui_android_ffi_WatcherJni_readBindingColor(JNIEnv *, jclass,
 }
 
 JNIEXPORT void JNICALL Java_dev_waterui_android_ffi_WatcherJni_setBindingBool(
-    JNIEnv *, jclass, jlong bindingPtr, jboolean value) {
+    JNIEnv *env, jclass, jlong bindingPtr, jboolean value) {
+  WatcherFlushScope flushOnReturn(env);
   g_sym.waterui_set_binding_bool(jlong_to_ptr<WuiBinding_bool>(bindingPtr),
                                  value == JNI_TRUE);
 }
 
 JNIEXPORT void JNICALL Java_dev_waterui_android_ffi_WatcherJni_setBindingInt(
-    JNIEnv *, jclass, jlong bindingPtr, jint value) {
+    JNIEnv *env, jclass, jlong bindingPtr, jint value) {
+  WatcherFlushScope flushOnReturn(env);
   g_sym.waterui_set_binding_i32(jlong_to_ptr<WuiBinding_i32>(bindingPtr),
                                 value);
 }
 
 JNIEXPORT void JNICALL Java_dev_waterui_android_ffi_WatcherJni_setBindingDouble(
-    JNIEnv *, jclass, jlong bindingPtr, jdouble value) {
+    JNIEnv *env, jclass, jlong bindingPtr, jdouble value) {
+  WatcherFlushScope flushOnReturn(env);
   g_sym.waterui_set_binding_f64(jlong_to_ptr<WuiBinding_f64>(bindingPtr),
                                 value);
 }
 
 JNIEXPORT void JNICALL Java_dev_waterui_android_ffi_WatcherJni_setBindingColor(
-    JNIEnv *, jclass, jlong bindingPtr, jlong colorPtr) {
+    JNIEnv *env, jclass, jlong bindingPtr, jlong colorPtr) {
+  WatcherFlushScope flushOnReturn(env);
   g_sym.waterui_set_binding_color(jlong_to_ptr<WuiBinding_Color>(bindingPtr),
                                   jlong_to_ptr<WuiColor>(colorPtr));
 }
@@ -3524,7 +7298,8 @@ JNIEXPORT void JNICALL Java_dev_waterui_android_ffi_WatcherJni_dropAction(
 }
 
 JNIEXPORT void JNICALL Java_dev_waterui_android_ffi_WatcherJni_callAction(
-    JNIEnv *, jclass, jlong actionPtr, jlong envPtr) {
+    JNIEnv *env, jclass, jlong actionPtr, jlong envPtr) {
+  WatcherFlushScope flushOnReturn(env);
   g_sym.waterui_call_action(jlong_to_ptr<WuiAction>(actionPtr),
                             jlong_to_ptr<WuiEnv>(envPtr));
 }
@@ -3535,7 +7310,8 @@ JNIEXPORT void JNICALL Java_dev_waterui_android_ffi_WatcherJni_dropIndexAction(
 }
 
 JNIEXPORT void JNICALL Java_dev_waterui_android_ffi_WatcherJni_callIndexAction(
-    JNIEnv *, jclass, jlong actionPtr, jlong envPtr, jlong index) {
+    JNIEnv *env, jclass, jlong actionPtr, jlong envPtr, jlong index) {
+  WatcherFlushScope flushOnReturn(env);
   g_sym.waterui_call_index_action(jlong_to_ptr<WuiIndexAction>(actionPtr),
                                   jlong_to_ptr<WuiEnv>(envPtr),
                                   static_cast<uintptr_t>(index));
@@ -3547,8 +7323,9 @@ JNIEXPORT void JNICALL Java_dev_waterui_android_ffi_WatcherJni_dropMoveAction(
 }
 
 JNIEXPORT void JNICALL Java_dev_waterui_android_ffi_WatcherJni_callMoveAction(
-    JNIEnv *, jclass, jlong actionPtr, jlong envPtr, jlong fromIndex,
+    JNIEnv *env, jclass, jlong actionPtr, jlong envPtr, jlong fromIndex,
     jlong toIndex) {
+  WatcherFlushScope flushOnReturn(env);
   g_sym.waterui_call_move_action(
       jlong_to_ptr<WuiMoveAction>(actionPtr), jlong_to_ptr<WuiEnv>(envPtr),
       static_cast<uintptr_t>(fromIndex), static_cast<uintptr_t>(toIndex));
@@ -3603,7 +7380,23 @@ JNIEXPORT jlong JNICALL Java_dev_waterui_android_ffi_WatcherJni_resolveFont(
 
 JNIEXPORT void JNICALL Java_dev_waterui_android_ffi_WatcherJni_dropWatcherGuard(
     JNIEnv *, jclass, jlong guardPtr) {
-  g_sym.waterui_drop_box_watcher_guard(jlong_to_ptr<WuiWatcherGuard>(guardPtr));
+  auto *guard = jlong_to_ptr<WuiWatcherGuard>(guardPtr);
+  WUI_TRACK_DROP_REQUEST(guard);
+  g_sym.waterui_drop_box_watcher_guard(guard);
+  WUI_TRACK_FREE(WatcherGuard, guard);
+}
+
+// Report of live bridge handles; null unless built with
+// WATERUI_JNI_HANDLE_TRACKING. See "Handle Tracking".
+JNIEXPORT jstring JNICALL
+Java_dev_waterui_android_ffi_WatcherJni_handleTrackerDump(JNIEnv *env, jclass) {
+#ifdef WATERUI_JNI_HANDLE_TRACKING
+  std::string report = g_handle_tracker.dump();
+  return env->NewStringUTF(report.c_str());
+#else
+  (void)env;
+  return nullptr;
+#endif
 }
 
 // Legacy getAnimation - returns tag as int (deprecated)
@@ -3666,6 +7459,61 @@ Java_dev_waterui_android_ffi_WatcherJni_getAnimationDamping(JNIEnv *, jclass,
   return 0.0f;
 }
 
+// ========== Animation Engine Functions ==========
+
+// Starts the native animation engine on the calling (main) thread. buffer
+// must be a direct buffer of capacity floats followed by capacity ints.
+JNIEXPORT jboolean JNICALL
+Java_dev_waterui_android_ffi_WatcherJni_animatorInit(JNIEnv *env, jclass,
+                                                     jobject buffer,
+                                                     jint capacity) {
+  if (g_animation_engine.load(std::memory_order_acquire) != nullptr) {
+    return JNI_TRUE;
+  }
+  AnimationEngine *engine = AnimationEngine::create(env, buffer, capacity);
+  if (engine == nullptr) {
+    __android_log_print(ANDROID_LOG_WARN, LOG_TAG,
+                        "Native animation engine unavailable");
+    return JNI_FALSE;
+  }
+  g_animation_engine.store(engine, std::memory_order_release);
+  return JNI_TRUE;
+}
+
+JNIEXPORT jint JNICALL
+Java_dev_waterui_android_ffi_WatcherJni_animatorOpenSlot(JNIEnv *, jclass,
+                                                         jfloat initial,
+                                                         jfloat threshold) {
+  AnimationEngine *engine = g_animation_engine.load(std::memory_order_acquire);
+  return engine != nullptr ? engine->open_slot(initial, threshold) : -1;
+}
+
+JNIEXPORT void JNICALL
+Java_dev_waterui_android_ffi_WatcherJni_animatorCloseSlot(JNIEnv *, jclass,
+                                                          jint slot) {
+  AnimationEngine *engine = g_animation_engine.load(std::memory_order_acquire);
+  if (engine != nullptr) {
+    engine->close_slot(slot);
+  }
+}
+
+// An f32 watcher whose emits animate the slot natively instead of reaching
+// Kotlin. Returns null if the slot is not open.
+JNIEXPORT jobject JNICALL
+Java_dev_waterui_android_ffi_WatcherJni_createAnimatedFloatWatcher(
+    JNIEnv *env, jclass, jint slot) {
+  AnimationEngine *engine = g_animation_engine.load(std::memory_order_acquire);
+  AnimatedWatcher *watcher =
+      engine != nullptr ? engine->new_watcher(slot) : nullptr;
+  if (watcher == nullptr) {
+    return nullptr;
+  }
+  return new_watcher_struct(
+      env, ptr_to_jlong(watcher),
+      ptr_to_jlong(reinterpret_cast<void *>(watcher_animated_float_call)),
+      ptr_to_jlong(reinterpret_cast<void *>(watcher_animated_float_drop)));
+}
+
 // ========== Theme Functions ==========
 
 #define DEFINE_THEME_COLOR_FN(javaName, cName)                                 \
@@ -3719,6 +7567,103 @@ Java_dev_waterui_android_ffi_WatcherJni_themeInstallColorScheme(
       jlong_to_ptr<WuiComputed_ColorScheme>(signalPtr));
 }
 
+// Installs a reactive scheme, argb[i] into color slot colorSlots[i] and a
+// fontSizes[i]/fontWeights[i] font into font slot fontSlots[i] with one call.
+// Returns the palette for themeUpdatePalette, or 0 on failure.
+JNIEXPORT jlong JNICALL
+Java_dev_waterui_android_ffi_WatcherJni_themeInstallPalette(
+    JNIEnv *env, jclass, jlong envPtr, jint scheme, jintArray colorSlots,
+    jintArray argb, jintArray fontSlots, jfloatArray fontSizes,
+    jintArray fontWeights) {
+  WUI_TRACE_SCOPE("WaterUI.themeInstallPalette");
+  auto *wuiEnv = jlong_to_ptr<WuiEnv>(envPtr);
+  if (!g_symbols_ready || wuiEnv == nullptr)
+    return 0;
+  size_t colorCount =
+      colorSlots != nullptr
+          ? static_cast<size_t>(env->GetArrayLength(colorSlots))
+          : 0;
+  size_t fontCount =
+      fontSlots != nullptr ? static_cast<size_t>(env->GetArrayLength(fontSlots))
+                           : 0;
+  ThemePaletteValues values;
+  if (!values.read(env, argb, fontSizes, fontWeights, colorCount, fontCount))
+    return 0;
+  std::vector<jint> colorSlotValues(colorCount);
+  std::vector<jint> fontSlotValues(fontCount);
+  if (colorCount > 0) {
+    env->GetIntArrayRegion(colorSlots, 0, static_cast<jsize>(colorCount),
+                           colorSlotValues.data());
+  }
+  if (fontCount > 0) {
+    env->GetIntArrayRegion(fontSlots, 0, static_cast<jsize>(fontCount),
+                           fontSlotValues.data());
+  }
+
+  auto *palette = new ThemePalette();
+  palette->scheme = new ReactiveColorSchemeState();
+  palette->scheme->scheme.store(static_cast<WuiColorScheme>(scheme));
+  palette->scheme->retain();
+  g_sym.waterui_theme_install_color_scheme(
+      wuiEnv, g_sym.waterui_new_computed_color_scheme(
+                  palette->scheme, reactive_color_scheme_get,
+                  reactive_color_scheme_watch, reactive_color_scheme_drop));
+
+  palette->colors.reserve(colorCount);
+  for (size_t i = 0; i < colorCount; ++i) {
+    auto *state = new ReactiveColorState();
+    state->color = argb_to_resolved_color(values.argb[i]);
+    state->retain();
+    palette->colors.push_back(state);
+    g_sym.waterui_theme_install_color(
+        wuiEnv, static_cast<WuiColorSlot>(colorSlotValues[i]),
+        g_sym.waterui_new_computed_resolved_color(state, reactive_color_get,
+                                                  reactive_color_watch,
+                                                  reactive_color_drop));
+  }
+
+  palette->fonts.reserve(fontCount);
+  for (size_t i = 0; i < fontCount; ++i) {
+    auto *state = new ReactiveFontState();
+    state->size = values.fontSizes[i];
+    state->weight = static_cast<WuiFontWeight>(values.fontWeights[i]);
+    state->retain();
+    palette->fonts.push_back(state);
+    g_sym.waterui_theme_install_font(
+        wuiEnv, static_cast<WuiFontSlot>(fontSlotValues[i]),
+        g_sym.waterui_new_computed_resolved_font(state, reactive_font_get,
+                                                 reactive_font_watch,
+                                                 reactive_font_drop));
+  }
+  return ptr_to_jlong(palette);
+}
+
+// Switches an installed palette to new values, given in the order its slots
+// were installed. Every value is stored before any watcher runs.
+JNIEXPORT void JNICALL
+Java_dev_waterui_android_ffi_WatcherJni_themeUpdatePalette(
+    JNIEnv *env, jclass, jlong palettePtr, jint scheme, jintArray argb,
+    jfloatArray fontSizes, jintArray fontWeights) {
+  WUI_TRACE_SCOPE("WaterUI.themeUpdatePalette");
+  auto *palette = jlong_to_ptr<ThemePalette>(palettePtr);
+  if (palette == nullptr)
+    return;
+  ThemePaletteValues values;
+  if (!values.read(env, argb, fontSizes, fontWeights, palette->colors.size(),
+                   palette->fonts.size()))
+    return;
+  palette->update(static_cast<WuiColorScheme>(scheme), values.argb.data(),
+                  values.fontSizes.data(), values.fontWeights.data());
+}
+
+// Releases Kotlin's hold on the palette. Installed slots keep their states
+// alive until the environment drops them.
+JNIEXPORT void JNICALL
+Java_dev_waterui_android_ffi_WatcherJni_themeDropPalette(JNIEnv *, jclass,
+                                                         jlong palettePtr) {
+  delete jlong_to_ptr<ThemePalette>(palettePtr);
+}
+
 JNIEXPORT jlong JNICALL Java_dev_waterui_android_ffi_WatcherJni_themeColor(
     JNIEnv *, jclass, jlong envPtr, jint slot) {
   return ptr_to_jlong(g_sym.waterui_theme_color(
@@ -3763,18 +7708,22 @@ Java_dev_waterui_android_ffi_WatcherJni_dropComputedColorScheme(
 
 JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_photoId(JNIEnv *env, jclass) {
-  auto id = g_sym.waterui_photo_id();
+  const WuiTypeId &id = g_type_ids.waterui_photo_id;
+  if (!group_type_id_ready(env, SymbolGroup::Media, id)) {
+    return nullptr;
+  }
   return new_type_id_struct(env, id);
 }
 
 JNIEXPORT jobject JNICALL Java_dev_waterui_android_ffi_WatcherJni_forceAsPhoto(
     JNIEnv *env, jclass, jlong viewPtr) {
+  if (!ensure_symbol_group(env, SymbolGroup::Media)) {
+    return nullptr;
+  }
+  WUI_TRACE_SCOPE("WaterUI.forceAsPhoto");
   auto photo = g_sym.waterui_force_as_photo(jlong_to_ptr<WuiAnyView>(viewPtr));
-  jclass cls = find_app_class(env, "dev/waterui/android/runtime/PhotoStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(Ljava/lang/String;)V");
   jstring sourceStr = wui_str_to_jstring(env, photo.source);
-  jobject obj = env->NewObject(cls, ctor, sourceStr);
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::PhotoStruct, sourceStr);
   env->DeleteLocalRef(sourceStr);
   return obj;
 }
@@ -3783,20 +7732,25 @@ JNIEXPORT jobject JNICALL Java_dev_waterui_android_ffi_WatcherJni_forceAsPhoto(
 
 JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_videoId(JNIEnv *env, jclass) {
-  auto id = g_sym.waterui_video_id();
+  const WuiTypeId &id = g_type_ids.waterui_video_id;
+  if (!group_type_id_ready(env, SymbolGroup::Video, id)) {
+    return nullptr;
+  }
   return new_type_id_struct(env, id);
 }
 
 JNIEXPORT jobject JNICALL Java_dev_waterui_android_ffi_WatcherJni_forceAsVideo(
     JNIEnv *env, jclass, jlong viewPtr) {
+  if (!ensure_symbol_group(env, SymbolGroup::Video)) {
+    return nullptr;
+  }
+  WUI_TRACE_SCOPE("WaterUI.forceAsVideo");
   auto video = g_sym.waterui_force_as_video(jlong_to_ptr<WuiAnyView>(viewPtr));
-  jclass cls = find_app_class(env, "dev/waterui/android/runtime/VideoStruct2");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(JJIZZ)V");
-  jobject obj = env->NewObject(
-      cls, ctor, ptr_to_jlong(video.source), ptr_to_jlong(video.volume),
-      static_cast<jint>(video.aspect_ratio), static_cast<jboolean>(video.loops),
+  jobject obj = new_struct(
+      env, StructClass::VideoStruct2, ptr_to_jlong(video.source),
+      ptr_to_jlong(video.volume), static_cast<jint>(video.aspect_ratio),
+      static_cast<jboolean>(video.loops),
       static_cast<jboolean>(false)); // show_controls = false for raw video
-  env->DeleteLocalRef(cls);
   return obj;
 }
 
@@ -3804,102 +7758,175 @@ JNIEXPORT jobject JNICALL Java_dev_waterui_android_ffi_WatcherJni_forceAsVideo(
 
 JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_videoPlayerId(JNIEnv *env, jclass) {
-  auto id = g_sym.waterui_video_player_id();
+  const WuiTypeId &id = g_type_ids.waterui_video_player_id;
+  if (!group_type_id_ready(env, SymbolGroup::Video, id)) {
+    return nullptr;
+  }
   return new_type_id_struct(env, id);
 }
 
 JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_forceAsVideoPlayer(JNIEnv *env, jclass,
                                                            jlong viewPtr) {
+  if (!ensure_symbol_group(env, SymbolGroup::Video)) {
+    return nullptr;
+  }
+  WUI_TRACE_SCOPE("WaterUI.forceAsVideoPlayer");
   auto vp =
       g_sym.waterui_force_as_video_player(jlong_to_ptr<WuiAnyView>(viewPtr));
-  jclass cls =
-      find_app_class(env, "dev/waterui/android/runtime/VideoPlayerStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(JJIZ)V");
-  jobject obj = env->NewObject(cls, ctor, ptr_to_jlong(vp.source),
-                               ptr_to_jlong(vp.volume),
-                               static_cast<jint>(vp.aspect_ratio),
-                               static_cast<jboolean>(vp.show_controls));
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::VideoPlayerStruct,
+                           ptr_to_jlong(vp.source), ptr_to_jlong(vp.volume),
+                           static_cast<jint>(vp.aspect_ratio),
+                           static_cast<jboolean>(vp.show_controls));
   return obj;
 }
 
 // ========== WebView Functions ==========
+//
+// A WebViewHandleContext only exists once create_webview_handle has resolved
+// the wrapper's JNI ids, so the callbacks below need nothing but an env.
 
 static void drop_wui_str(WuiStr value) { value._0.vtable.drop(value._0.data); }
 
+// Pending run_javascript completions. Kotlin holds a token, (generation << 32)
+// | index, instead of the callback's raw pointers; slots are reused, and a
+// stale or repeated completion finds its generation gone and is ignored.
+class JsCallbackTable {
+public:
+  jlong add(WuiJsCallback callback) {
+    std::lock_guard<std::mutex> lock(mutex);
+    uint32_t index;
+    if (!freeSlots.empty()) {
+      index = freeSlots.back();
+      freeSlots.pop_back();
+    } else {
+      index = static_cast<uint32_t>(slots.size());
+      slots.push_back(Slot{});
+    }
+    Slot &slot = slots[index];
+    slot.callback = callback;
+    slot.live = true;
+    return static_cast<jlong>((static_cast<uint64_t>(slot.generation) << 32) |
+                              index);
+  }
+
+  // Removes the callback for token into *out. False if it is not pending.
+  bool take(jlong token, WuiJsCallback *out) {
+    auto index = static_cast<uint32_t>(static_cast<uint64_t>(token));
+    auto generation =
+        static_cast<uint32_t>(static_cast<uint64_t>(token) >> 32);
+    std::lock_guard<std::mutex> lock(mutex);
+    if (index >= slots.size()) {
+      return false;
+    }
+    Slot &slot = slots[index];
+    if (!slot.live || slot.generation != generation) {
+      return false;
+    }
+    *out = slot.callback;
+    slot.live = false;
+    ++slot.generation;
+    freeSlots.push_back(index);
+    return true;
+  }
+
+private:
+  struct Slot {
+    WuiJsCallback callback{};
+    uint32_t generation = 0;
+    bool live = false;
+  };
+
+  std::mutex mutex;
+  std::vector<Slot> slots;
+  std::vector<uint32_t> freeSlots;
+};
+
+JsCallbackTable g_js_callbacks;
+
 static void webview_go_back(void *data) {
+  WUI_TRACE_SCOPE("WaterUI.webView.go_back");
+  WUI_TRACE_UPCALL();
   auto *ctx = static_cast<WebViewHandleContext *>(data);
   if (ctx == nullptr || ctx->wrapper == nullptr) {
     return;
   }
   ScopedEnv scoped;
-  if (scoped.env == nullptr || !init_webview_wrapper_jni(scoped.env)) {
+  if (scoped.env == nullptr) {
     return;
   }
   scoped.env->CallVoidMethod(ctx->wrapper, gWebViewWrapperGoBack);
 }
 
 static void webview_go_forward(void *data) {
+  WUI_TRACE_SCOPE("WaterUI.webView.go_forward");
+  WUI_TRACE_UPCALL();
   auto *ctx = static_cast<WebViewHandleContext *>(data);
   if (ctx == nullptr || ctx->wrapper == nullptr) {
     return;
   }
   ScopedEnv scoped;
-  if (scoped.env == nullptr || !init_webview_wrapper_jni(scoped.env)) {
+  if (scoped.env == nullptr) {
     return;
   }
   scoped.env->CallVoidMethod(ctx->wrapper, gWebViewWrapperGoForward);
 }
 
 static void webview_go_to(void *data, WuiStr url) {
+  WUI_TRACE_SCOPE("WaterUI.webView.go_to");
+  WUI_TRACE_UPCALL();
   auto *ctx = static_cast<WebViewHandleContext *>(data);
   if (ctx == nullptr || ctx->wrapper == nullptr) {
     drop_wui_str(url);
     return;
   }
   ScopedEnv scoped;
-  if (scoped.env == nullptr || !init_webview_wrapper_jni(scoped.env)) {
+  if (scoped.env == nullptr) {
     drop_wui_str(url);
     return;
   }
-  std::string url_str = wui_str_to_std_string(url);
-  jstring jurl = scoped.env->NewStringUTF(url_str.c_str());
+  jstring jurl = wui_str_to_jstring(scoped.env, url);
   scoped.env->CallVoidMethod(ctx->wrapper, gWebViewWrapperGoTo, jurl);
   scoped.env->DeleteLocalRef(jurl);
 }
 
 static void webview_stop(void *data) {
+  WUI_TRACE_SCOPE("WaterUI.webView.stop");
+  WUI_TRACE_UPCALL();
   auto *ctx = static_cast<WebViewHandleContext *>(data);
   if (ctx == nullptr || ctx->wrapper == nullptr) {
     return;
   }
   ScopedEnv scoped;
-  if (scoped.env == nullptr || !init_webview_wrapper_jni(scoped.env)) {
+  if (scoped.env == nullptr) {
     return;
   }
   scoped.env->CallVoidMethod(ctx->wrapper, gWebViewWrapperStop);
 }
 
 static void webview_refresh(void *data) {
+  WUI_TRACE_SCOPE("WaterUI.webView.refresh");
+  WUI_TRACE_UPCALL();
   auto *ctx = static_cast<WebViewHandleContext *>(data);
   if (ctx == nullptr || ctx->wrapper == nullptr) {
     return;
   }
   ScopedEnv scoped;
-  if (scoped.env == nullptr || !init_webview_wrapper_jni(scoped.env)) {
+  if (scoped.env == nullptr) {
     return;
   }
   scoped.env->CallVoidMethod(ctx->wrapper, gWebViewWrapperRefresh);
 }
 
 static bool webview_can_go_back(const void *data) {
+  WUI_TRACE_SCOPE("WaterUI.webView.can_go_back");
+  WUI_TRACE_UPCALL();
   auto *ctx = static_cast<const WebViewHandleContext *>(data);
   if (ctx == nullptr || ctx->wrapper == nullptr) {
     return false;
   }
   ScopedEnv scoped;
-  if (scoped.env == nullptr || !init_webview_wrapper_jni(scoped.env)) {
+  if (scoped.env == nullptr) {
     return false;
   }
   return scoped.env->CallBooleanMethod(ctx->wrapper,
@@ -3907,12 +7934,14 @@ static bool webview_can_go_back(const void *data) {
 }
 
 static bool webview_can_go_forward(const void *data) {
+  WUI_TRACE_SCOPE("WaterUI.webView.can_go_forward");
+  WUI_TRACE_UPCALL();
   auto *ctx = static_cast<const WebViewHandleContext *>(data);
   if (ctx == nullptr || ctx->wrapper == nullptr) {
     return false;
   }
   ScopedEnv scoped;
-  if (scoped.env == nullptr || !init_webview_wrapper_jni(scoped.env)) {
+  if (scoped.env == nullptr) {
     return false;
   }
   return scoped.env->CallBooleanMethod(ctx->wrapper,
@@ -3920,29 +7949,32 @@ static bool webview_can_go_forward(const void *data) {
 }
 
 static void webview_set_user_agent(void *data, WuiStr user_agent) {
+  WUI_TRACE_SCOPE("WaterUI.webView.set_user_agent");
+  WUI_TRACE_UPCALL();
   auto *ctx = static_cast<WebViewHandleContext *>(data);
   if (ctx == nullptr || ctx->wrapper == nullptr) {
     drop_wui_str(user_agent);
     return;
   }
   ScopedEnv scoped;
-  if (scoped.env == nullptr || !init_webview_wrapper_jni(scoped.env)) {
+  if (scoped.env == nullptr) {
     drop_wui_str(user_agent);
     return;
   }
-  std::string ua = wui_str_to_std_string(user_agent);
-  jstring jua = scoped.env->NewStringUTF(ua.c_str());
+  jstring jua = wui_str_to_jstring(scoped.env, user_agent);
   scoped.env->CallVoidMethod(ctx->wrapper, gWebViewWrapperSetUserAgent, jua);
   scoped.env->DeleteLocalRef(jua);
 }
 
 static void webview_set_redirects_enabled(void *data, bool enabled) {
+  WUI_TRACE_SCOPE("WaterUI.webView.set_redirects_enabled");
+  WUI_TRACE_UPCALL();
   auto *ctx = static_cast<WebViewHandleContext *>(data);
   if (ctx == nullptr || ctx->wrapper == nullptr) {
     return;
   }
   ScopedEnv scoped;
-  if (scoped.env == nullptr || !init_webview_wrapper_jni(scoped.env)) {
+  if (scoped.env == nullptr) {
     return;
   }
   scoped.env->CallVoidMethod(ctx->wrapper, gWebViewWrapperSetRedirectsEnabled,
@@ -3951,32 +7983,34 @@ static void webview_set_redirects_enabled(void *data, bool enabled) {
 
 static void webview_inject_script(void *data, WuiStr script,
                                   WuiScriptInjectionTime time) {
+  WUI_TRACE_SCOPE("WaterUI.webView.inject_script");
+  WUI_TRACE_UPCALL();
   auto *ctx = static_cast<WebViewHandleContext *>(data);
   if (ctx == nullptr || ctx->wrapper == nullptr) {
     drop_wui_str(script);
     return;
   }
   ScopedEnv scoped;
-  if (scoped.env == nullptr || !init_webview_wrapper_jni(scoped.env)) {
+  if (scoped.env == nullptr) {
     drop_wui_str(script);
     return;
   }
-  std::string script_str = wui_str_to_std_string(script);
-  jstring jscript = scoped.env->NewStringUTF(script_str.c_str());
+  jstring jscript = wui_str_to_jstring(scoped.env, script);
   scoped.env->CallVoidMethod(ctx->wrapper, gWebViewWrapperInjectScript, jscript,
                              static_cast<jint>(time));
   scoped.env->DeleteLocalRef(jscript);
 }
 
 static void webview_watch(void *data, WuiFn_WuiWebViewEvent callback) {
+  WUI_TRACE_SCOPE("WaterUI.webView.watch");
+  WUI_TRACE_UPCALL();
   auto *ctx = static_cast<WebViewHandleContext *>(data);
   if (ctx == nullptr || ctx->wrapper == nullptr) {
     callback.drop(callback.data);
     return;
   }
   ScopedEnv scoped;
-  if (scoped.env == nullptr || !init_webview_wrapper_jni(scoped.env) ||
-      !init_webview_callback_jni(scoped.env)) {
+  if (scoped.env == nullptr || !init_webview_callback_jni(scoped.env)) {
     callback.drop(callback.data);
     return;
   }
@@ -4005,45 +8039,69 @@ static void webview_watch(void *data, WuiFn_WuiWebViewEvent callback) {
 
 static void webview_run_javascript(void *data, WuiStr script,
                                    WuiJsCallback callback) {
+  WUI_TRACE_SCOPE("WaterUI.webView.run_javascript");
+  WUI_TRACE_UPCALL();
   auto *ctx = static_cast<WebViewHandleContext *>(data);
   if (ctx == nullptr || ctx->wrapper == nullptr) {
     drop_wui_str(script);
     return;
   }
   ScopedEnv scoped;
-  if (scoped.env == nullptr || !init_webview_wrapper_jni(scoped.env)) {
+  if (scoped.env == nullptr) {
     drop_wui_str(script);
     return;
   }
-  std::string script_str = wui_str_to_std_string(script);
-  jstring jscript = scoped.env->NewStringUTF(script_str.c_str());
-  scoped.env->CallVoidMethod(ctx->wrapper, gWebViewWrapperRunJavaScript,
-                             jscript, reinterpret_cast<jlong>(callback.data),
-                             reinterpret_cast<jlong>(callback.call));
-  scoped.env->DeleteLocalRef(jscript);
+  jlong token = g_js_callbacks.add(callback);
+  jstring jscript = wui_str_to_jstring(scoped.env, script);
+  scoped.env->CallVoidMethod(ctx->wrapper, gWebViewWrapperRunJavaScript,
+                             jscript, token);
+  scoped.env->DeleteLocalRef(jscript);
+  if (scoped.env->ExceptionCheck()) {
+    // Kotlin never saw the token: complete here so the caller is not left
+    // waiting.
+    scoped.env->ExceptionClear();
+    WuiJsCallback pending{};
+    if (g_js_callbacks.take(token, &pending)) {
+      pending.call(pending.data, false,
+                   wui_str_from_holder(new_byte_holder(0)));
+    }
+  }
+}
+
+static void free_webview_context(JNIEnv *env, WebViewHandleContext *ctx) {
+  if (env != nullptr && ctx->wrapper != nullptr) {
+    env->DeleteGlobalRef(ctx->wrapper);
+  }
+  if (ctx->has_watcher) {
+    ctx->watcher.drop(ctx->watcher.data);
+  }
+
+  WUI_TRACK_FREE(WebViewContext, ctx);
+  delete ctx;
 }
 
 static void webview_drop(void *data) {
+  WUI_TRACE_SCOPE("WaterUI.webView.drop");
   auto *ctx = static_cast<WebViewHandleContext *>(data);
   if (ctx == nullptr) {
     return;
   }
+  WUI_TRACK_DROP_REQUEST(ctx);
 
+  // The wrapper closes its event callback and destroys the WebView on the UI
+  // thread and only then calls nativeDisposeHandle, so a flush already posted
+  // there still finds ctx alive. On the main thread this all runs inline.
   ScopedEnv scoped;
-  if (scoped.env != nullptr && init_webview_wrapper_jni(scoped.env)) {
-    if (ctx->wrapper != nullptr) {
-      scoped.env->CallVoidMethod(ctx->wrapper, gWebViewWrapperSetEventCallback,
-                                 nullptr);
-      scoped.env->CallVoidMethod(ctx->wrapper, gWebViewWrapperRelease);
-      scoped.env->DeleteGlobalRef(ctx->wrapper);
+  if (scoped.env != nullptr && ctx->wrapper != nullptr) {
+    scoped.env->CallVoidMethod(ctx->wrapper, gWebViewWrapperDispose,
+                               ptr_to_jlong(ctx));
+    if (!scoped.env->ExceptionCheck()) {
+      return;
     }
+    // dispose threw before scheduling anything; free here instead.
+    clear_jni_exception(scoped.env, "disposing WebViewWrapper");
   }
-
-  if (ctx->has_watcher) {
-    ctx->watcher.drop(ctx->watcher.data);
-  }
-
-  delete ctx;
+  free_webview_context(scoped.env, ctx);
 }
 
 static WuiWebViewHandle create_webview_handle() {
@@ -4076,26 +8134,37 @@ static WuiWebViewHandle create_webview_handle() {
   auto *ctx =
       new WebViewHandleContext{scoped.env->NewGlobalRef(wrapper), {}, false};
   scoped.env->DeleteLocalRef(wrapper);
+  WUI_TRACK_HANDLE(WebViewContext, ctx);
   handle.data = ctx;
   return handle;
 }
 
 JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_webviewId(JNIEnv *env, jclass) {
-  auto id = g_sym.waterui_webview_id();
+  const WuiTypeId &id = g_type_ids.waterui_webview_id;
+  if (!group_type_id_ready(env, SymbolGroup::WebView, id)) {
+    return nullptr;
+  }
   return new_type_id_struct(env, id);
 }
 
 JNIEXPORT jlong JNICALL Java_dev_waterui_android_ffi_WatcherJni_forceAsWebView(
-    JNIEnv *, jclass, jlong viewPtr) {
+    JNIEnv *env, jclass, jlong viewPtr) {
+  if (!ensure_symbol_group(env, SymbolGroup::WebView)) {
+    return 0;
+  }
+  WUI_TRACE_SCOPE("WaterUI.forceAsWebView");
   auto webview =
       g_sym.waterui_force_as_webview(jlong_to_ptr<WuiAnyView>(viewPtr));
   return ptr_to_jlong(webview);
 }
 
 JNIEXPORT jlong JNICALL
-Java_dev_waterui_android_ffi_WatcherJni_webviewNativeHandle(JNIEnv *, jclass,
+Java_dev_waterui_android_ffi_WatcherJni_webviewNativeHandle(JNIEnv *env, jclass,
                                                             jlong webviewPtr) {
+  if (!ensure_symbol_group(env, SymbolGroup::WebView)) {
+    return 0;
+  }
   return ptr_to_jlong(g_sym.waterui_webview_native_handle(
       jlong_to_ptr<WuiWebView>(webviewPtr)));
 }
@@ -4114,43 +8183,102 @@ Java_dev_waterui_android_ffi_WatcherJni_webviewNativeView(JNIEnv *env, jclass,
 }
 
 JNIEXPORT void JNICALL Java_dev_waterui_android_ffi_WatcherJni_dropWebView(
-    JNIEnv *, jclass, jlong webviewPtr) {
+    JNIEnv *env, jclass, jlong webviewPtr) {
+  if (!ensure_symbol_group(env, SymbolGroup::WebView)) {
+    return;
+  }
   g_sym.waterui_drop_web_view(jlong_to_ptr<WuiWebView>(webviewPtr));
 }
 
+// Event batch written by NativeWebViewEventCallback, in native byte order.
+// Each record is a header (int32 type, float progress, int32 flags, then the
+// UTF-8 byte lengths of url, url2 and message as int32) followed by the three
+// strings' bytes, padded to a multiple of 4.
+constexpr size_t kWebViewEventHeaderSize = 24;
+constexpr int32_t kWebViewEventCanGoBack = 1 << 0;
+constexpr int32_t kWebViewEventCanGoForward = 1 << 1;
+
+// Copies length bytes into a string Rust owns; the batch buffer is reused.
+WuiStr webview_event_str(const uint8_t *data, int32_t length) {
+  ByteArrayHolder *holder = new_byte_holder(static_cast<size_t>(length));
+  if (length > 0) {
+    std::memcpy(holder->data, data, static_cast<size_t>(length));
+  }
+  return wui_str_from_holder(holder);
+}
+
+// Delivers every event in the first length bytes of buffer, in order, in one
+// crossing. Stops at the first malformed record.
 JNIEXPORT void JNICALL
-Java_dev_waterui_android_components_NativeWebViewEventCallback_nativeOnEvent(
-    JNIEnv *env, jobject, jlong nativePtr, jint eventType, jstring url,
-    jstring url2, jstring message, jfloat progress, jboolean canGoBack,
-    jboolean canGoForward) {
+Java_dev_waterui_android_components_NativeWebViewEventCallback_nativeOnEvents(
+    JNIEnv *env, jobject, jlong nativePtr, jobject buffer, jint length) {
+  WUI_TRACE_SCOPE("WaterUI.webView.onEvents");
   auto *ctx = jlong_to_ptr<WebViewHandleContext>(nativePtr);
   if (ctx == nullptr || !ctx->has_watcher) {
     return;
   }
+  BorrowedBytes batch{};
+  if (!borrow_direct_buffer(env, buffer, length, &batch)) {
+    __android_log_print(ANDROID_LOG_ERROR, LOG_TAG,
+                        "webView.onEvents: invalid buffer");
+    return;
+  }
+  WUI_TRACE_BYTES(batch.len);
+
+  size_t offset = 0;
+  while (offset + kWebViewEventHeaderSize <= batch.len) {
+    const uint8_t *record = batch.data + offset;
+    int32_t header[6];
+    std::memcpy(header, record, sizeof(header));
+    float progress;
+    std::memcpy(&progress, record + sizeof(int32_t), sizeof(progress));
+    int32_t urlLen = header[3];
+    int32_t url2Len = header[4];
+    int32_t messageLen = header[5];
+    if (urlLen < 0 || url2Len < 0 || messageLen < 0) {
+      break;
+    }
+    size_t payload = static_cast<size_t>(urlLen) +
+                     static_cast<size_t>(url2Len) +
+                     static_cast<size_t>(messageLen);
+    size_t recordSize = (kWebViewEventHeaderSize + payload + 3) & ~size_t{3};
+    if (offset + kWebViewEventHeaderSize + payload > batch.len) {
+      break;
+    }
+    const uint8_t *text = record + kWebViewEventHeaderSize;
 
-  WuiWebViewEvent event{};
-  event.event_type = static_cast<WuiWebViewEventType>(eventType);
-  event.url = str_from_jstring(env, url);
-  event.url2 = str_from_jstring(env, url2);
-  event.message = str_from_jstring(env, message);
-  event.progress = progress;
-  event.can_go_back = (canGoBack == JNI_TRUE);
-  event.can_go_forward = (canGoForward == JNI_TRUE);
+    WuiWebViewEvent event{};
+    event.event_type = static_cast<WuiWebViewEventType>(header[0]);
+    event.url = webview_event_str(text, urlLen);
+    event.url2 = webview_event_str(text + urlLen, url2Len);
+    event.message = webview_event_str(text + urlLen + url2Len, messageLen);
+    event.progress = progress;
+    event.can_go_back = (header[2] & kWebViewEventCanGoBack) != 0;
+    event.can_go_forward = (header[2] & kWebViewEventCanGoForward) != 0;
+    ctx->watcher.call(ctx->watcher.data, event);
+    offset += recordSize;
+  }
+}
 
-  ctx->watcher.call(ctx->watcher.data, event);
+JNIEXPORT void JNICALL
+Java_dev_waterui_android_components_WebViewWrapper_nativeDisposeHandle(
+    JNIEnv *env, jobject, jlong nativePtr) {
+  auto *ctx = jlong_to_ptr<WebViewHandleContext>(nativePtr);
+  if (ctx != nullptr) {
+    free_webview_context(env, ctx);
+  }
 }
 
 JNIEXPORT void JNICALL
 Java_dev_waterui_android_components_WebViewWrapper_nativeCompleteJsResult(
-    JNIEnv *env, jobject, jlong callbackData, jlong callbackFn,
-    jboolean success, jstring result) {
-  auto call_fn = reinterpret_cast<void (*)(void *, bool, WuiStr)>(callbackFn);
-  if (call_fn == nullptr) {
+    JNIEnv *env, jobject, jlong token, jboolean success, jstring result) {
+  WUI_TRACE_SCOPE("WaterUI.webView.completeJsResult");
+  WuiJsCallback callback{};
+  if (!g_js_callbacks.take(token, &callback) || callback.call == nullptr) {
     return;
   }
   WuiStr result_str = str_from_jstring(env, result);
-  call_fn(reinterpret_cast<void *>(callbackData), success == JNI_TRUE,
-          result_str);
+  callback.call(callback.data, success == JNI_TRUE, result_str);
 }
 
 // ========== MediaPicker Functions ==========
@@ -4168,7 +8296,8 @@ Java_dev_waterui_android_ffi_WatcherJni_readBindingFloat(JNIEnv *, jclass,
 }
 
 JNIEXPORT void JNICALL Java_dev_waterui_android_ffi_WatcherJni_setBindingFloat(
-    JNIEnv *, jclass, jlong bindingPtr, jfloat value) {
+    JNIEnv *env, jclass, jlong bindingPtr, jfloat value) {
+  WatcherFlushScope flushOnReturn(env);
   g_sym.waterui_set_binding_f32(jlong_to_ptr<WuiBinding_f32>(bindingPtr),
                                 value);
 }
@@ -4186,7 +8315,8 @@ Java_dev_waterui_android_ffi_WatcherJni_watchBindingFloat(JNIEnv *env, jclass,
   WatcherStructFields fields = watcher_struct_from_java(env, watcher);
   auto *w = create_watcher<WuiWatcher_f32, float>(
       fields, g_sym.waterui_new_watcher_f32);
-  return ptr_to_jlong(g_sym.waterui_watch_binding_f32(binding, w));
+  return ptr_to_jlong(
+      WUI_TRACK_GUARD(g_sym.waterui_watch_binding_f32(binding, w)));
 }
 
 // ========== Date Binding Functions ==========
@@ -4196,17 +8326,16 @@ Java_dev_waterui_android_ffi_WatcherJni_readBindingDate(JNIEnv *env, jclass,
                                                         jlong bindingPtr) {
   auto date = g_sym.waterui_read_binding_date(
       jlong_to_ptr<WuiBinding_Date>(bindingPtr));
-  jclass cls = find_app_class(env, "dev/waterui/android/runtime/DateStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(III)V");
-  jobject obj = env->NewObject(cls, ctor, static_cast<jint>(date.year),
-                               static_cast<jint>(date.month),
-                               static_cast<jint>(date.day));
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::DateStruct,
+                           static_cast<jint>(date.year),
+                           static_cast<jint>(date.month),
+                           static_cast<jint>(date.day));
   return obj;
 }
 
 JNIEXPORT void JNICALL Java_dev_waterui_android_ffi_WatcherJni_setBindingDate(
-    JNIEnv *, jclass, jlong bindingPtr, jint year, jint month, jint day) {
+    JNIEnv *env, jclass, jlong bindingPtr, jint year, jint month, jint day) {
+  WatcherFlushScope flushOnReturn(env);
   WuiDate date;
   date.year = year;
   date.month = static_cast<uint8_t>(month);
@@ -4228,22 +8357,19 @@ static void date_watcher_call(const void *data, WuiDate value,
     return;
   }
   auto *state = static_cast<WatcherCallbackState const *>(data);
-  jclass dateStructCls =
-      find_app_class(scoped.env, "dev/waterui/android/runtime/DateStruct");
-  jmethodID dateStructCtor =
-      scoped.env->GetMethodID(dateStructCls, "<init>", "(III)V");
-  jobject dateObj = scoped.env->NewObject(
-      dateStructCls, dateStructCtor, static_cast<jint>(value.year),
-      static_cast<jint>(value.month), static_cast<jint>(value.day));
-  invoke_watcher(scoped.env, const_cast<WatcherCallbackState *>(state), dateObj,
-                 metadata);
-  scoped.env->DeleteLocalRef(dateStructCls);
+  jobject dateObj = new_struct(scoped.env, StructClass::DateStruct,
+                               static_cast<jint>(value.year),
+                               static_cast<jint>(value.month),
+                               static_cast<jint>(value.day));
+  enqueue_object_emit(scoped.env, const_cast<WatcherCallbackState *>(state),
+                      dateObj, metadata);
   scoped.env->DeleteLocalRef(dateObj);
 }
 
 static void date_watcher_drop(void *data) {
   ScopedEnv scoped;
-  drop_watcher_state(scoped.env, static_cast<WatcherCallbackState *>(data));
+  drop_queued_watcher_state(scoped.env,
+                            static_cast<WatcherCallbackState *>(data));
 }
 
 JNIEXPORT jlong JNICALL
@@ -4254,13 +8380,15 @@ Java_dev_waterui_android_ffi_WatcherJni_watchBindingDate(JNIEnv *env, jclass,
   WatcherStructFields fields = watcher_struct_from_java(env, watcher);
   auto *w = create_watcher<WuiWatcher_Date, WuiDate>(
       fields, g_sym.waterui_new_watcher_date);
-  return ptr_to_jlong(g_sym.waterui_watch_binding_date(binding, w));
+  return ptr_to_jlong(
+      WUI_TRACK_GUARD(g_sym.waterui_watch_binding_date(binding, w)));
 }
 
 JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_createDateWatcher(JNIEnv *env, jclass,
                                                           jobject callback) {
   auto *state = create_watcher_state(env, callback);
+  WUI_TRACK_HANDLE(WatcherCallback, state);
   return new_watcher_struct(
       env, ptr_to_jlong(state),
       ptr_to_jlong(reinterpret_cast<void *>(date_watcher_call)),
@@ -4285,7 +8413,8 @@ Java_dev_waterui_android_ffi_WatcherJni_watchComputedStr(JNIEnv *env, jclass,
   WatcherStructFields fields = watcher_struct_from_java(env, watcher);
   auto *w = create_watcher<WuiWatcher_Str, WuiStr>(
       fields, g_sym.waterui_new_watcher_str);
-  return ptr_to_jlong(g_sym.waterui_watch_computed_str(computed, w));
+  return ptr_to_jlong(
+      WUI_TRACK_GUARD(g_sym.waterui_watch_computed_str(computed, w)));
 }
 
 JNIEXPORT void JNICALL Java_dev_waterui_android_ffi_WatcherJni_dropComputedStr(
@@ -4298,15 +8427,15 @@ JNIEXPORT void JNICALL Java_dev_waterui_android_ffi_WatcherJni_dropComputedStr(
 JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_readComputedVideo(JNIEnv *env, jclass,
                                                           jlong computedPtr) {
+  if (!ensure_symbol_group(env, SymbolGroup::Video)) {
+    return nullptr;
+  }
   auto video = g_sym.waterui_read_computed_video(
       jlong_to_ptr<WuiComputed_Video>(computedPtr));
   // Convert WuiVideo to VideoStruct
-  jclass cls = find_app_class(env, "dev/waterui/android/runtime/VideoStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(Ljava/lang/String;)V");
   // Convert WuiStr (url) to Java String using proper helper
   jstring urlStr = wui_str_to_jstring(env, video.url);
-  jobject obj = env->NewObject(cls, ctor, urlStr);
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::VideoStruct, urlStr);
   env->DeleteLocalRef(urlStr);
   return obj;
 }
@@ -4320,8 +8449,11 @@ Java_dev_waterui_android_ffi_WatcherJni_watchComputedVideo(JNIEnv *, jclass,
 }
 
 JNIEXPORT void JNICALL
-Java_dev_waterui_android_ffi_WatcherJni_dropComputedVideo(JNIEnv *, jclass,
+Java_dev_waterui_android_ffi_WatcherJni_dropComputedVideo(JNIEnv *env, jclass,
                                                           jlong computedPtr) {
+  if (!ensure_symbol_group(env, SymbolGroup::Video)) {
+    return;
+  }
   g_sym.waterui_drop_computed_video(
       jlong_to_ptr<WuiComputed_Video>(computedPtr));
 }
@@ -4330,30 +8462,26 @@ JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_createVideoWatcher(JNIEnv *env, jclass,
                                                            jobject callback) {
   // Not implemented yet - would require Video watcher callback infrastructure
-  jclass cls = find_app_class(env, "dev/waterui/android/runtime/WatcherStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(JJJ)V");
-  jobject obj = env->NewObject(cls, ctor, 0L, 0L, 0L);
-  env->DeleteLocalRef(cls);
-  return obj;
+  return new_watcher_struct(env, 0, 0, 0);
 }
 
 // ========== Navigation Functions ==========
 
 JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_navigationStackId(JNIEnv *env, jclass) {
-  auto id = g_sym.waterui_navigation_stack_id();
+  auto id = g_type_ids.waterui_navigation_stack_id;
   return new_type_id_struct(env, id);
 }
 
 JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_navigationViewId(JNIEnv *env, jclass) {
-  auto id = g_sym.waterui_navigation_view_id();
+  auto id = g_type_ids.waterui_navigation_view_id;
   return new_type_id_struct(env, id);
 }
 
 JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_tabsId(JNIEnv *env, jclass) {
-  auto id = g_sym.waterui_tabs_id();
+  auto id = g_type_ids.waterui_tabs_id;
   return new_type_id_struct(env, id);
 }
 
@@ -4361,13 +8489,11 @@ JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_forceAsNavigationStack(JNIEnv *env,
                                                                jclass,
                                                                jlong viewPtr) {
+  WUI_TRACE_SCOPE("WaterUI.forceAsNavigationStack");
   WuiNavigationStack navStack = g_sym.waterui_force_as_navigation_stack(
       jlong_to_ptr<WuiAnyView>(viewPtr));
-  jclass cls =
-      find_app_class(env, "dev/waterui/android/runtime/NavigationStackStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(J)V");
-  jobject obj = env->NewObject(cls, ctor, ptr_to_jlong(navStack.root));
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::NavigationStackStruct,
+                           ptr_to_jlong(navStack.root));
   return obj;
 }
 
@@ -4375,30 +8501,25 @@ JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_forceAsNavigationView(JNIEnv *env,
                                                               jclass,
                                                               jlong viewPtr) {
+  WUI_TRACE_SCOPE("WaterUI.forceAsNavigationView");
   WuiNavigationView navView =
       g_sym.waterui_force_as_navigation_view(jlong_to_ptr<WuiAnyView>(viewPtr));
 
   // Create BarStruct
-  jclass barCls = find_app_class(env, "dev/waterui/android/runtime/BarStruct");
-  jmethodID barCtor = env->GetMethodID(barCls, "<init>", "(JJJ)V");
-  jobject barObj = env->NewObject(
-      barCls, barCtor, ptr_to_jlong(navView.bar.title.content),
-      ptr_to_jlong(navView.bar.color), ptr_to_jlong(navView.bar.hidden));
-  env->DeleteLocalRef(barCls);
+  jobject barObj = new_struct(env, StructClass::BarStruct,
+                              ptr_to_jlong(navView.bar.title.content),
+                              ptr_to_jlong(navView.bar.color),
+                              ptr_to_jlong(navView.bar.hidden));
 
   // Create NavigationViewStruct
-  jclass cls =
-      find_app_class(env, "dev/waterui/android/runtime/NavigationViewStruct");
-  jmethodID ctor = env->GetMethodID(
-      cls, "<init>", "(Ldev/waterui/android/runtime/BarStruct;J)V");
-  jobject obj =
-      env->NewObject(cls, ctor, barObj, ptr_to_jlong(navView.content));
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::NavigationViewStruct, barObj,
+                           ptr_to_jlong(navView.content));
   return obj;
 }
 
 JNIEXPORT jobject JNICALL Java_dev_waterui_android_ffi_WatcherJni_forceAsTabs(
     JNIEnv *env, jclass, jlong viewPtr) {
+  WUI_TRACE_SCOPE("WaterUI.forceAsTabs");
   WuiTabs tabsData =
       g_sym.waterui_force_as_tabs(jlong_to_ptr<WuiAnyView>(viewPtr));
 
@@ -4406,28 +8527,24 @@ JNIEXPORT jobject JNICALL Java_dev_waterui_android_ffi_WatcherJni_forceAsTabs(
   WuiArraySlice_WuiTab slice = tabsData.tabs.vtable.slice(tabsData.tabs.data);
 
   // Create TabStruct array
-  jclass tabCls = find_app_class(env, "dev/waterui/android/runtime/TabStruct");
-  jmethodID tabCtor = env->GetMethodID(tabCls, "<init>", "(JJJ)V");
   jobjectArray tabArray =
-      env->NewObjectArray(static_cast<jsize>(slice.len), tabCls, nullptr);
+      env->NewObjectArray(static_cast<jsize>(slice.len),
+                          struct_class(StructClass::TabStruct), nullptr);
 
   for (size_t i = 0; i < slice.len; i++) {
     WuiTab *tab = slice.head + i;
-    jobject tabObj =
-        env->NewObject(tabCls, tabCtor, static_cast<jlong>(tab->id),
-                       ptr_to_jlong(tab->label), ptr_to_jlong(tab->content));
+    jobject tabObj = new_struct(env, StructClass::TabStruct,
+                                static_cast<jlong>(tab->id),
+                                ptr_to_jlong(tab->label),
+                                ptr_to_jlong(tab->content));
     env->SetObjectArrayElement(tabArray, static_cast<jsize>(i), tabObj);
     env->DeleteLocalRef(tabObj);
   }
-  env->DeleteLocalRef(tabCls);
 
   // Create TabsStruct
-  jclass cls = find_app_class(env, "dev/waterui/android/runtime/TabsStruct");
-  jmethodID ctor = env->GetMethodID(
-      cls, "<init>", "(J[Ldev/waterui/android/runtime/TabStruct;I)V");
-  jobject obj = env->NewObject(cls, ctor, ptr_to_jlong(tabsData.selection),
-                               tabArray, static_cast<jint>(tabsData.position));
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::TabsStruct,
+                           ptr_to_jlong(tabsData.selection), tabArray,
+                           static_cast<jint>(tabsData.position));
   return obj;
 }
 
@@ -4437,21 +8554,14 @@ JNIEXPORT jobject JNICALL Java_dev_waterui_android_ffi_WatcherJni_tabContent(
       g_sym.waterui_tab_content(jlong_to_ptr<WuiTabContent>(contentPtr));
 
   // Create BarStruct
-  jclass barCls = find_app_class(env, "dev/waterui/android/runtime/BarStruct");
-  jmethodID barCtor = env->GetMethodID(barCls, "<init>", "(JJJ)V");
-  jobject barObj = env->NewObject(
-      barCls, barCtor, ptr_to_jlong(navView.bar.title.content),
-      ptr_to_jlong(navView.bar.color), ptr_to_jlong(navView.bar.hidden));
-  env->DeleteLocalRef(barCls);
+  jobject barObj = new_struct(env, StructClass::BarStruct,
+                              ptr_to_jlong(navView.bar.title.content),
+                              ptr_to_jlong(navView.bar.color),
+                              ptr_to_jlong(navView.bar.hidden));
 
   // Create NavigationViewStruct
-  jclass cls =
-      find_app_class(env, "dev/waterui/android/runtime/NavigationViewStruct");
-  jmethodID ctor = env->GetMethodID(
-      cls, "<init>", "(Ldev/waterui/android/runtime/BarStruct;J)V");
-  jobject obj =
-      env->NewObject(cls, ctor, barObj, ptr_to_jlong(navView.content));
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::NavigationViewStruct, barObj,
+                           ptr_to_jlong(navView.content));
   return obj;
 }
 
@@ -4465,35 +8575,22 @@ struct NavigationControllerContext {
 
 // C callback that forwards to Kotlin
 static void navigation_push_callback(void *data, WuiNavigationView navView) {
+  WUI_TRACE_SCOPE("WaterUI.navigation.push");
+  WUI_TRACE_UPCALL();
   auto *ctx = static_cast<NavigationControllerContext *>(data);
-  JNIEnv *env = nullptr;
-  bool attached = false;
-
-  jint result =
-      ctx->jvm->GetEnv(reinterpret_cast<void **>(&env), JNI_VERSION_1_6);
-  if (result == JNI_EDETACHED) {
-    ctx->jvm->AttachCurrentThread(&env, nullptr);
-    attached = true;
-  }
+  ScopedEnv scoped(ctx->jvm);
+  JNIEnv *env = scoped.env;
 
   if (env != nullptr) {
     // Create BarStruct
-    jclass barCls =
-        find_app_class(env, "dev/waterui/android/runtime/BarStruct");
-    jmethodID barCtor = env->GetMethodID(barCls, "<init>", "(JJJ)V");
-    jobject barObj = env->NewObject(
-        barCls, barCtor, ptr_to_jlong(navView.bar.title.content),
-        ptr_to_jlong(navView.bar.color), ptr_to_jlong(navView.bar.hidden));
-    env->DeleteLocalRef(barCls);
+    jobject barObj = new_struct(env, StructClass::BarStruct,
+                                ptr_to_jlong(navView.bar.title.content),
+                                ptr_to_jlong(navView.bar.color),
+                                ptr_to_jlong(navView.bar.hidden));
 
     // Create NavigationViewStruct
-    jclass navViewCls =
-        find_app_class(env, "dev/waterui/android/runtime/NavigationViewStruct");
-    jmethodID navViewCtor = env->GetMethodID(
-        navViewCls, "<init>", "(Ldev/waterui/android/runtime/BarStruct;J)V");
-    jobject navViewObj = env->NewObject(navViewCls, navViewCtor, barObj,
-                                        ptr_to_jlong(navView.content));
-    env->DeleteLocalRef(navViewCls);
+    jobject navViewObj = new_struct(env, StructClass::NavigationViewStruct,
+                                    barObj, ptr_to_jlong(navView.content));
 
     // Call Kotlin callback
     jclass callbackCls = env->GetObjectClass(ctx->callback);
@@ -4505,23 +8602,14 @@ static void navigation_push_callback(void *data, WuiNavigationView navView) {
     env->DeleteLocalRef(navViewObj);
     env->DeleteLocalRef(barObj);
   }
-
-  if (attached) {
-    ctx->jvm->DetachCurrentThread();
-  }
 }
 
 static void navigation_pop_callback(void *data) {
+  WUI_TRACE_SCOPE("WaterUI.navigation.pop");
+  WUI_TRACE_UPCALL();
   auto *ctx = static_cast<NavigationControllerContext *>(data);
-  JNIEnv *env = nullptr;
-  bool attached = false;
-
-  jint result =
-      ctx->jvm->GetEnv(reinterpret_cast<void **>(&env), JNI_VERSION_1_6);
-  if (result == JNI_EDETACHED) {
-    ctx->jvm->AttachCurrentThread(&env, nullptr);
-    attached = true;
-  }
+  ScopedEnv scoped(ctx->jvm);
+  JNIEnv *env = scoped.env;
 
   if (env != nullptr) {
     jclass callbackCls = env->GetObjectClass(ctx->callback);
@@ -4529,32 +8617,17 @@ static void navigation_pop_callback(void *data) {
     env->CallVoidMethod(ctx->callback, popMethod);
     env->DeleteLocalRef(callbackCls);
   }
-
-  if (attached) {
-    ctx->jvm->DetachCurrentThread();
-  }
 }
 
 static void navigation_drop_callback(void *data) {
   auto *ctx = static_cast<NavigationControllerContext *>(data);
-  JNIEnv *env = nullptr;
-  bool attached = false;
-
-  jint result =
-      ctx->jvm->GetEnv(reinterpret_cast<void **>(&env), JNI_VERSION_1_6);
-  if (result == JNI_EDETACHED) {
-    ctx->jvm->AttachCurrentThread(&env, nullptr);
-    attached = true;
-  }
+  ScopedEnv scoped(ctx->jvm);
+  JNIEnv *env = scoped.env;
 
   if (env != nullptr) {
     env->DeleteGlobalRef(ctx->callback);
   }
 
-  if (attached) {
-    ctx->jvm->DetachCurrentThread();
-  }
-
   delete ctx;
 }
 
@@ -4591,26 +8664,33 @@ Java_dev_waterui_android_ffi_WatcherJni_dropNavigationController(JNIEnv *,
 
 JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_gpuSurfaceId(JNIEnv *env, jclass) {
-  auto id = g_sym.waterui_gpu_surface_id();
+  const WuiTypeId &id = g_type_ids.waterui_gpu_surface_id;
+  if (!group_type_id_ready(env, SymbolGroup::GpuSurface, id)) {
+    return nullptr;
+  }
   return new_type_id_struct(env, id);
 }
 
 JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_forceAsGpuSurface(JNIEnv *env, jclass,
                                                           jlong viewPtr) {
+  if (!ensure_symbol_group(env, SymbolGroup::GpuSurface)) {
+    return nullptr;
+  }
+  WUI_TRACE_SCOPE("WaterUI.forceAsGpuSurface");
   WuiGpuSurface gpuSurface =
       g_sym.waterui_force_as_gpu_surface(jlong_to_ptr<WuiAnyView>(viewPtr));
-  jclass cls =
-      find_app_class(env, "dev/waterui/android/runtime/GpuSurfaceStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(J)V");
-  jobject obj = env->NewObject(cls, ctor, ptr_to_jlong(gpuSurface.renderer));
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::GpuSurfaceStruct,
+                           ptr_to_jlong(gpuSurface.renderer));
   return obj;
 }
 
 JNIEXPORT jlong JNICALL Java_dev_waterui_android_ffi_WatcherJni_gpuSurfaceInit(
     JNIEnv *env, jclass, jlong rendererPtr, jobject javaSurface, jint width,
     jint height) {
+  if (!ensure_symbol_group(env, SymbolGroup::GpuSurface)) {
+    return 0;
+  }
   if (javaSurface == nullptr || rendererPtr == 0) {
     return 0;
   }
@@ -4638,10 +8718,14 @@ JNIEXPORT jlong JNICALL Java_dev_waterui_android_ffi_WatcherJni_gpuSurfaceInit(
 }
 
 JNIEXPORT jboolean JNICALL
-Java_dev_waterui_android_ffi_WatcherJni_gpuSurfaceRender(JNIEnv *, jclass,
+Java_dev_waterui_android_ffi_WatcherJni_gpuSurfaceRender(JNIEnv *env, jclass,
                                                          jlong statePtr,
                                                          jint width,
                                                          jint height) {
+  if (!ensure_symbol_group(env, SymbolGroup::GpuSurface)) {
+    return JNI_FALSE;
+  }
+  WUI_TRACE_SCOPE("WaterUI.gpuSurface.render");
   bool result = g_sym.waterui_gpu_surface_render(
       jlong_to_ptr<WuiGpuSurfaceState>(statePtr), static_cast<uint32_t>(width),
       static_cast<uint32_t>(height));
@@ -4649,60 +8733,164 @@ Java_dev_waterui_android_ffi_WatcherJni_gpuSurfaceRender(JNIEnv *, jclass,
 }
 
 JNIEXPORT void JNICALL Java_dev_waterui_android_ffi_WatcherJni_gpuSurfaceDrop(
-    JNIEnv *, jclass, jlong statePtr) {
+    JNIEnv *env, jclass, jlong statePtr) {
+  if (!ensure_symbol_group(env, SymbolGroup::GpuSurface)) {
+    return;
+  }
   g_sym.waterui_gpu_surface_drop(jlong_to_ptr<WuiGpuSurfaceState>(statePtr));
 }
 
+// Frame-paced variant of gpuSurfaceInit/Render/Drop: the surface is owned and
+// rendered by a GpuRenderDriver thread. Returns the driver handle, or 0.
+JNIEXPORT jlong JNICALL
+Java_dev_waterui_android_ffi_WatcherJni_gpuSurfaceStartDriver(
+    JNIEnv *env, jclass, jlong rendererPtr, jobject javaSurface, jint width,
+    jint height) {
+  if (!ensure_symbol_group(env, SymbolGroup::GpuSurface)) {
+    return 0;
+  }
+  if (javaSurface == nullptr || rendererPtr == 0) {
+    return 0;
+  }
+  ANativeWindow *nativeWindow = ANativeWindow_fromSurface(env, javaSurface);
+  if (nativeWindow == nullptr) {
+    __android_log_print(ANDROID_LOG_ERROR, LOG_TAG,
+                        "Failed to get ANativeWindow from Surface");
+    return 0;
+  }
+  auto *driver = new GpuRenderDriver(nativeWindow,
+                                     jlong_to_ptr<void>(rendererPtr),
+                                     static_cast<uint32_t>(width),
+                                     static_cast<uint32_t>(height));
+  if (!driver->start()) {
+    delete driver;
+    return 0;
+  }
+  return ptr_to_jlong(driver);
+}
+
+JNIEXPORT void JNICALL
+Java_dev_waterui_android_ffi_WatcherJni_gpuSurfaceDriverResize(
+    JNIEnv *, jclass, jlong driverPtr, jint width, jint height) {
+  auto *driver = jlong_to_ptr<GpuRenderDriver>(driverPtr);
+  if (driver != nullptr) {
+    driver->resize(static_cast<uint32_t>(width), static_cast<uint32_t>(height));
+  }
+}
+
+JNIEXPORT void JNICALL
+Java_dev_waterui_android_ffi_WatcherJni_gpuSurfaceDriverSetPaused(
+    JNIEnv *, jclass, jlong driverPtr, jboolean paused) {
+  auto *driver = jlong_to_ptr<GpuRenderDriver>(driverPtr);
+  if (driver != nullptr) {
+    driver->set_paused(paused == JNI_TRUE);
+  }
+}
+
+// Copies the driver's frame statistics into out (see GpuFrameStats for the
+// layout) and returns the number of longs written, or -1 if out is too small.
+JNIEXPORT jint JNICALL Java_dev_waterui_android_ffi_WatcherJni_gpuSurfaceStats(
+    JNIEnv *env, jclass, jlong driverPtr, jlongArray out) {
+  auto *driver = jlong_to_ptr<GpuRenderDriver>(driverPtr);
+  jsize capacity = out != nullptr ? env->GetArrayLength(out) : 0;
+  if (driver == nullptr ||
+      capacity < static_cast<jsize>(GpuFrameStats::kHeaderSize)) {
+    return -1;
+  }
+  size_t maxLongs = std::min<size_t>(
+      static_cast<size_t>(capacity),
+      GpuFrameStats::kHeaderSize +
+          GpuFrameStats::kCapacity * GpuFrameStats::kRecordStride);
+  jlong buffer[GpuFrameStats::kHeaderSize +
+               GpuFrameStats::kCapacity * GpuFrameStats::kRecordStride];
+  size_t written = driver->frame_stats().copy_to(buffer, maxLongs);
+  env->SetLongArrayRegion(out, 0, static_cast<jsize>(written), buffer);
+  return static_cast<jint>(written);
+}
+
+// Blocks until the render thread has dropped the surface state, so the
+// Surface may be released as soon as this returns.
+JNIEXPORT void JNICALL
+Java_dev_waterui_android_ffi_WatcherJni_gpuSurfaceStopDriver(JNIEnv *, jclass,
+                                                             jlong driverPtr) {
+  auto *driver = jlong_to_ptr<GpuRenderDriver>(driverPtr);
+  if (driver != nullptr) {
+    driver->stop();
+    delete driver;
+  }
+}
+
 // ========== List Functions ==========
 
 JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_listId(JNIEnv *env, jclass) {
-  auto id = g_sym.waterui_list_id();
+  auto id = g_type_ids.waterui_list_id;
   return new_type_id_struct(env, id);
 }
 
 JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_listItemId(JNIEnv *env, jclass) {
-  auto id = g_sym.waterui_list_item_id();
+  auto id = g_type_ids.waterui_list_item_id;
   return new_type_id_struct(env, id);
 }
 
 JNIEXPORT jobject JNICALL Java_dev_waterui_android_ffi_WatcherJni_forceAsList(
     JNIEnv *env, jclass, jlong viewPtr) {
+  WUI_TRACE_SCOPE("WaterUI.forceAsList");
   WuiList list = g_sym.waterui_force_as_list(jlong_to_ptr<WuiAnyView>(viewPtr));
-  jclass cls = find_app_class(env, "dev/waterui/android/runtime/ListStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(JJJJ)V");
-  jobject obj = env->NewObject(
-      cls, ctor, ptr_to_jlong(list.contents), ptr_to_jlong(list.editing),
-      ptr_to_jlong(list.on_delete), ptr_to_jlong(list.on_move));
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::ListStruct,
+                           ptr_to_jlong(list.contents),
+                           ptr_to_jlong(list.editing),
+                           ptr_to_jlong(list.on_delete),
+                           ptr_to_jlong(list.on_move));
   return obj;
 }
 
 JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_forceAsListItem(JNIEnv *env, jclass,
                                                         jlong viewPtr) {
+  WUI_TRACE_SCOPE("WaterUI.forceAsListItem");
   WuiListItem item =
       g_sym.waterui_force_as_list_item(jlong_to_ptr<WuiAnyView>(viewPtr));
-  jclass cls =
-      find_app_class(env, "dev/waterui/android/runtime/ListItemStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(JJ)V");
-  jobject obj = env->NewObject(cls, ctor, ptr_to_jlong(item.content),
-                               ptr_to_jlong(item.deletable));
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::ListItemStruct,
+                           ptr_to_jlong(item.content),
+                           ptr_to_jlong(item.deletable));
   return obj;
 }
 
 // ============================================================================
 // Media Loading
 // ============================================================================
-
-// ============================================================================
-// Media Loading Types
-// ============================================================================
-// These types must match the Rust definitions in waterui_media::media_picker
+//
+// waterui_load_media only queues the request: MediaLoader.loadMedia hands it
+// to a small worker pool and returns, so the calling Rust thread never waits
+// on a content:// copy. The worker completes the request
+// through nativeCompleteMediaLoad or nativeFailMediaLoad.
+//
+// A request owns the Rust callback, which must be consumed exactly once.
+// Kotlin guarantees one completion per handle; a failed or cancelled load
+// completes with an empty result rather than aborting the process. URL
+// pointers are never null, even when empty, so Rust can always build a slice
+// from them.
+//
+// MediaLoadResult has no status field, so a failure is only distinguishable
+// as the one result with url_len == 0 (a successful load always carries an
+// image URL). Rust code that ignores url_len sees an empty success until
+// generate_header.rs gains a status field.
 
 // MediaLoadResult and MediaLoadCallback are defined in waterui.h
+constexpr uint8_t kEmptyMediaUrl[1] = {0};
+
+static MediaLoadResult empty_media_result() {
+  MediaLoadResult result{};
+  result.url_ptr = kEmptyMediaUrl;
+  result.video_url_ptr = kEmptyMediaUrl;
+  return result;
+}
+
+struct MediaLoadRequest {
+  MediaLoadCallback callback;
+};
 
 // Cache for MediaLoader class and method
 static jclass gMediaLoaderClass = nullptr;
@@ -4729,7 +8917,7 @@ static bool initMediaLoaderJni(JNIEnv *env) {
   env->DeleteLocalRef(localClass);
 
   gMediaLoaderLoadMethod =
-      env->GetStaticMethodID(gMediaLoaderClass, "loadMedia", "(IJJ)V");
+      env->GetStaticMethodID(gMediaLoaderClass, "loadMedia", "(IJ)V");
   if (gMediaLoaderLoadMethod == nullptr) {
     __android_log_print(ANDROID_LOG_ERROR, LOG_TAG,
                         "Failed to find MediaLoader.loadMedia method");
@@ -4739,10 +8927,20 @@ static bool initMediaLoaderJni(JNIEnv *env) {
   return true;
 }
 
-/**
- * C function called by Rust when Selected::load() is invoked.
- * This is the implementation of the extern "C" fn waterui_load_media.
- */
+// Consumes the request, handing result to Rust.
+static void complete_media_request(MediaLoadRequest *request,
+                                   MediaLoadResult result) {
+  MediaLoadCallback callback = request->callback;
+  delete request;
+  callback.call(callback.data, result);
+}
+
+static void fail_media_request(MediaLoadRequest *request, const char *reason) {
+  __android_log_print(ANDROID_LOG_WARN, LOG_TAG, "Media load failed: %s",
+                      reason);
+  complete_media_request(request, empty_media_result());
+}
+
 // MediaPickerManager JNI globals
 static jclass gMediaPickerManagerClass = nullptr;
 static jmethodID gMediaPickerPresentMethod = nullptr;
@@ -4774,29 +8972,36 @@ static bool initMediaPickerManagerJni(JNIEnv *env) {
   return true;
 }
 
-// Present media picker - calls into Kotlin MediaPickerManager
+// Present media picker - calls into Kotlin MediaPickerManager. If the picker
+// cannot be reached the request is dropped, as when the user dismisses it.
 void waterui_present_media_picker(WuiMediaFilterType filter,
                                   MediaPickerPresentCallback callback) {
   ScopedEnv scoped;
   JNIEnv *env = scoped.env;
   if (env == nullptr) {
-    __android_log_print(ANDROID_LOG_FATAL, LOG_TAG,
+    __android_log_print(ANDROID_LOG_ERROR, LOG_TAG,
                         "waterui_present_media_picker: failed to get JNIEnv");
-    std::abort();
+    return;
   }
 
   if (!initMediaPickerManagerJni(env)) {
     __android_log_print(
-        ANDROID_LOG_FATAL, LOG_TAG,
+        ANDROID_LOG_ERROR, LOG_TAG,
         "waterui_present_media_picker: failed to init MediaPickerManager JNI");
-    std::abort();
+    return;
   }
 
   // Call MediaPickerManager.presentPicker(filter, callbackData, callFnPtr)
+  WUI_TRACE_SCOPE("WaterUI.media.presentPicker");
+  WUI_TRACE_UPCALL();
   env->CallStaticVoidMethod(gMediaPickerManagerClass, gMediaPickerPresentMethod,
                             static_cast<jint>(filter),
                             reinterpret_cast<jlong>(callback.data),
                             reinterpret_cast<jlong>(callback.call));
+  if (env->ExceptionCheck()) {
+    env->ExceptionDescribe();
+    env->ExceptionClear();
+  }
 }
 
 /**
@@ -4806,6 +9011,7 @@ void waterui_present_media_picker(WuiMediaFilterType filter,
 JNIEXPORT void JNICALL
 Java_dev_waterui_android_runtime_MediaPickerManager_nativeCompletePresentCallback(
     JNIEnv *, jclass, jlong callbackData, jlong callbackFn, jint selectedId) {
+  WUI_TRACE_SCOPE("WaterUI.media.completePresent");
   // Get the callback function pointer - SelectedId is uint32_t
   auto callFn = reinterpret_cast<void (*)(void *, SelectedId)>(callbackFn);
   void *data = reinterpret_cast<void *>(callbackData);
@@ -4815,96 +9021,93 @@ Java_dev_waterui_android_runtime_MediaPickerManager_nativeCompletePresentCallbac
   callFn(data, selected);
 }
 
+/**
+ * C function called by Rust when Selected::load() is invoked.
+ * This is the implementation of the extern "C" fn waterui_load_media.
+ */
 void waterui_load_media(uint32_t id, MediaLoadCallback callback) {
+  auto *request = new MediaLoadRequest{callback};
+
   ScopedEnv scoped;
   JNIEnv *env = scoped.env;
   if (env == nullptr) {
-    __android_log_print(ANDROID_LOG_FATAL, LOG_TAG,
-                        "waterui_load_media: failed to get JNIEnv");
-    std::abort();
+    fail_media_request(request, "failed to get JNIEnv");
+    return;
   }
-
   if (!initMediaLoaderJni(env)) {
-    __android_log_print(ANDROID_LOG_FATAL, LOG_TAG,
-                        "waterui_load_media: failed to init MediaLoader JNI");
-    std::abort();
+    fail_media_request(request, "failed to init MediaLoader JNI");
+    return;
   }
 
-  // Call MediaLoader.loadMedia(id, callbackData, callFnPtr)
-  // We pass the callback data and function pointer separately
+  // MediaLoader.loadMedia(id, request) queues the load and returns; from here
+  // on Kotlin owns the request until it completes it.
+  WUI_TRACE_SCOPE("WaterUI.media.load");
+  WUI_TRACE_UPCALL();
   env->CallStaticVoidMethod(gMediaLoaderClass, gMediaLoaderLoadMethod,
-                            static_cast<jint>(id),
-                            reinterpret_cast<jlong>(callback.data),
-                            reinterpret_cast<jlong>(callback.call));
+                            static_cast<jint>(id), ptr_to_jlong(request));
+  if (env->ExceptionCheck()) {
+    env->ExceptionDescribe();
+    env->ExceptionClear();
+    fail_media_request(request, "MediaLoader.loadMedia threw");
+  }
 }
 
 /**
  * JNI function called by MediaLoader.kt when media loading completes.
- * Invokes the Rust callback with the file URL(s).
+ * Invokes the Rust callback with the file URL(s), encoded as standard UTF-8
+ * with explicit lengths.
  *
  * For Motion Photos / Live Photos, both imageUrl and videoUrl are provided.
  * For regular images/videos, videoUrl is null.
  */
 JNIEXPORT void JNICALL
 Java_dev_waterui_android_runtime_MediaLoader_nativeCompleteMediaLoad(
-    JNIEnv *env, jclass, jlong callbackData, jlong callFnPtr, jstring imageUrl,
-    jstring videoUrl, jbyte mediaType) {
-  // Get the callback function pointer
-  auto callFn = reinterpret_cast<void (*)(void *, MediaLoadResult)>(callFnPtr);
-  void *data = reinterpret_cast<void *>(callbackData);
-
-  // Convert Java strings to C strings
-  const char *imageCStr = env->GetStringUTFChars(imageUrl, nullptr);
-  if (imageCStr == nullptr) {
-    __android_log_print(ANDROID_LOG_FATAL, LOG_TAG,
-                        "nativeCompleteMediaLoad: imageUrl is null");
-    std::abort();
-  }
-  size_t imageLen = strlen(imageCStr);
-  if (imageLen == 0) {
-    __android_log_print(ANDROID_LOG_FATAL, LOG_TAG,
-                        "nativeCompleteMediaLoad: imageUrl is empty");
-    env->ReleaseStringUTFChars(imageUrl, imageCStr);
-    std::abort();
+    JNIEnv *env, jclass, jlong requestPtr, jstring imageUrl, jstring videoUrl,
+    jbyte mediaType) {
+  WUI_TRACE_SCOPE("WaterUI.media.completeLoad");
+  auto *request = jlong_to_ptr<MediaLoadRequest>(requestPtr);
+  if (request == nullptr) {
+    return;
   }
 
-  const char *videoCStr = nullptr;
-  size_t videoLen = 0;
-  if (videoUrl != nullptr) {
-    videoCStr = env->GetStringUTFChars(videoUrl, nullptr);
-    if (videoCStr != nullptr) {
-      videoLen = strlen(videoCStr);
+  ByteArrayHolder *image = utf8_holder_from_jstring(env, imageUrl);
+  ByteArrayHolder *video =
+      videoUrl != nullptr ? utf8_holder_from_jstring(env, videoUrl) : nullptr;
+  if (image->len == 0) {
+    fail_media_request(request, "empty image URL");
+  } else if (mediaType == 2 && (video == nullptr || video->len == 0)) {
+    fail_media_request(request, "Motion Photo without a video URL");
+  } else {
+    MediaLoadResult result = empty_media_result();
+    result.url_ptr = image->data;
+    result.url_len = image->len;
+    if (video != nullptr) {
+      result.video_url_ptr = video->data;
+      result.video_url_len = video->len;
     }
+    result.media_type = static_cast<uint8_t>(mediaType);
+    complete_media_request(request, result);
   }
+  byte_drop(image);
+  byte_drop(video);
+}
 
-  // For motion photos, video URL is required
-  if (mediaType == 2 && (videoCStr == nullptr || videoLen == 0)) {
-    __android_log_print(
-        ANDROID_LOG_FATAL, LOG_TAG,
-        "nativeCompleteMediaLoad: videoUrl is null/empty for Motion Photo");
-    env->ReleaseStringUTFChars(imageUrl, imageCStr);
-    if (videoCStr != nullptr) {
-      env->ReleaseStringUTFChars(videoUrl, videoCStr);
-    }
-    std::abort();
+/**
+ * JNI function called by MediaLoader.kt when a load fails or is cancelled.
+ * Completes the Rust callback with an empty result (url_len == 0).
+ */
+JNIEXPORT void JNICALL
+Java_dev_waterui_android_runtime_MediaLoader_nativeFailMediaLoad(
+    JNIEnv *env, jclass, jlong requestPtr, jstring message) {
+  auto *request = jlong_to_ptr<MediaLoadRequest>(requestPtr);
+  if (request == nullptr) {
+    return;
   }
-
-  // Create result
-  MediaLoadResult result{};
-  result.url_ptr = reinterpret_cast<const uint8_t *>(imageCStr);
-  result.url_len = imageLen;
-  result.video_url_ptr =
-      videoCStr ? reinterpret_cast<const uint8_t *>(videoCStr) : nullptr;
-  result.video_url_len = videoLen;
-  result.media_type = static_cast<uint8_t>(mediaType);
-
-  // Call the Rust callback
-  callFn(data, result);
-
-  // Release the strings
-  env->ReleaseStringUTFChars(imageUrl, imageCStr);
-  if (videoCStr != nullptr) {
-    env->ReleaseStringUTFChars(videoUrl, videoCStr);
+  const char *chars =
+      message != nullptr ? env->GetStringUTFChars(message, nullptr) : nullptr;
+  fail_media_request(request, chars != nullptr ? chars : "unknown error");
+  if (chars != nullptr) {
+    env->ReleaseStringUTFChars(message, chars);
   }
 }
 
@@ -4927,50 +9130,61 @@ Java_dev_waterui_android_runtime_NativeBindings_callOnSelection(
 JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_metadataDraggableId(JNIEnv *env,
                                                             jclass) {
-  auto id = g_sym.waterui_metadata_draggable_id();
+  const WuiTypeId &id = g_type_ids.waterui_metadata_draggable_id;
+  if (!group_type_id_ready(env, SymbolGroup::DragDrop, id)) {
+    return nullptr;
+  }
   return new_type_id_struct(env, id);
 }
 
 JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_metadataDropDestinationId(JNIEnv *env,
                                                                   jclass) {
-  auto id = g_sym.waterui_metadata_drop_destination_id();
+  const WuiTypeId &id = g_type_ids.waterui_metadata_drop_destination_id;
+  if (!group_type_id_ready(env, SymbolGroup::DragDrop, id)) {
+    return nullptr;
+  }
   return new_type_id_struct(env, id);
 }
 
 JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_forceAsMetadataDraggable(
     JNIEnv *env, jclass, jlong viewPtr) {
+  if (!ensure_symbol_group(env, SymbolGroup::DragDrop)) {
+    return nullptr;
+  }
+  WUI_TRACE_SCOPE("WaterUI.forceAsMetadataDraggable");
   auto metadata = g_sym.waterui_force_as_metadata_draggable(
       jlong_to_ptr<WuiAnyView>(viewPtr));
-  jclass cls = find_app_class(
-      env, "dev/waterui/android/components/MetadataDraggableStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(JJ)V");
-  jobject obj = env->NewObject(cls, ctor, ptr_to_jlong(metadata.content),
-                               ptr_to_jlong(metadata.value.inner));
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::MetadataDraggableStruct,
+                           ptr_to_jlong(metadata.content),
+                           ptr_to_jlong(metadata.value.inner));
   return obj;
 }
 
 JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_forceAsMetadataDropDestination(
     JNIEnv *env, jclass, jlong viewPtr) {
+  if (!ensure_symbol_group(env, SymbolGroup::DragDrop)) {
+    return nullptr;
+  }
+  WUI_TRACE_SCOPE("WaterUI.forceAsMetadataDropDestination");
   auto metadata = g_sym.waterui_force_as_metadata_drop_destination(
       jlong_to_ptr<WuiAnyView>(viewPtr));
-  jclass cls = find_app_class(
-      env, "dev/waterui/android/components/MetadataDropDestinationStruct");
-  jmethodID ctor = env->GetMethodID(cls, "<init>", "(JJ)V");
   // The drop destination has on_drop, on_enter, on_exit handlers - we pass the
   // whole struct as opaque pointer
-  jobject obj = env->NewObject(cls, ctor, ptr_to_jlong(metadata.content),
-                               reinterpret_cast<jlong>(&metadata.value));
-  env->DeleteLocalRef(cls);
+  jobject obj = new_struct(env, StructClass::MetadataDropDestinationStruct,
+                           ptr_to_jlong(metadata.content),
+                           reinterpret_cast<jlong>(&metadata.value));
   return obj;
 }
 
 JNIEXPORT jobject JNICALL
 Java_dev_waterui_android_ffi_WatcherJni_draggableGetData(JNIEnv *env, jclass,
                                                          jlong draggablePtr) {
+  if (!ensure_symbol_group(env, SymbolGroup::DragDrop)) {
+    return nullptr;
+  }
   auto *draggable = jlong_to_ptr<WuiDraggable>(draggablePtr);
   WuiDragData data = g_sym.waterui_draggable_get_data(draggable);
 
@@ -4987,30 +9201,30 @@ Java_dev_waterui_android_ffi_WatcherJni_draggableGetData(JNIEnv *env, jclass,
   // Convert value string
   jstring value = wui_str_to_jstring(env, data.value);
 
-  jclass cls =
-      find_app_class(env, "dev/waterui/android/components/DragDataStruct");
-  jmethodID ctor = env->GetMethodID(
-      cls, "<init>",
-      "(Ldev/waterui/android/components/DragDataTag;Ljava/lang/String;)V");
-  jobject obj = env->NewObject(cls, ctor, tagObj, value);
+  jobject obj = new_struct(env, StructClass::DragDataStruct, tagObj, value);
 
   env->DeleteLocalRef(tagCls);
   env->DeleteLocalRef(tags);
   env->DeleteLocalRef(tagObj);
   env->DeleteLocalRef(value);
-  env->DeleteLocalRef(cls);
   return obj;
 }
 
 JNIEXPORT void JNICALL Java_dev_waterui_android_ffi_WatcherJni_dropDraggable(
-    JNIEnv *, jclass, jlong draggablePtr) {
+    JNIEnv *env, jclass, jlong draggablePtr) {
+  if (!ensure_symbol_group(env, SymbolGroup::DragDrop)) {
+    return;
+  }
   auto *draggable = jlong_to_ptr<WuiDraggable>(draggablePtr);
   g_sym.waterui_drop_draggable(draggable);
 }
 
 JNIEXPORT void JNICALL
-Java_dev_waterui_android_ffi_WatcherJni_dropDropDestination(JNIEnv *, jclass,
+Java_dev_waterui_android_ffi_WatcherJni_dropDropDestination(JNIEnv *env, jclass,
                                                             jlong dropDestPtr) {
+  if (!ensure_symbol_group(env, SymbolGroup::DragDrop)) {
+    return;
+  }
   auto *dropDest = jlong_to_ptr<WuiDropDestination>(dropDestPtr);
   g_sym.waterui_drop_drop_destination(dropDest);
 }
@@ -5018,6 +9232,9 @@ Java_dev_waterui_android_ffi_WatcherJni_dropDropDestination(JNIEnv *, jclass,
 JNIEXPORT void JNICALL Java_dev_waterui_android_ffi_WatcherJni_callDropHandler(
     JNIEnv *env, jclass, jlong dropDestPtr, jlong envPtr, jint dataTag,
     jstring dataValue) {
+  if (!ensure_symbol_group(env, SymbolGroup::DragDrop)) {
+    return;
+  }
   auto *dropDest = jlong_to_ptr<WuiDropDestination>(dropDestPtr);
   auto *wuiEnv = jlong_to_ptr<WuiEnv>(envPtr);
 
@@ -5028,21 +9245,304 @@ JNIEXPORT void JNICALL Java_dev_waterui_android_ffi_WatcherJni_callDropHandler(
 }
 
 JNIEXPORT void JNICALL
-Java_dev_waterui_android_ffi_WatcherJni_callDropEnterHandler(JNIEnv *, jclass,
+Java_dev_waterui_android_ffi_WatcherJni_callDropEnterHandler(JNIEnv *env,
+                                                             jclass,
                                                              jlong dropDestPtr,
                                                              jlong envPtr) {
+  if (!ensure_symbol_group(env, SymbolGroup::DragDrop)) {
+    return;
+  }
   auto *dropDest = jlong_to_ptr<WuiDropDestination>(dropDestPtr);
   auto *wuiEnv = jlong_to_ptr<WuiEnv>(envPtr);
   g_sym.waterui_call_drop_enter_handler(dropDest, wuiEnv);
 }
 
 JNIEXPORT void JNICALL
-Java_dev_waterui_android_ffi_WatcherJni_callDropExitHandler(JNIEnv *, jclass,
+Java_dev_waterui_android_ffi_WatcherJni_callDropExitHandler(JNIEnv *env, jclass,
                                                             jlong dropDestPtr,
                                                             jlong envPtr) {
+  if (!ensure_symbol_group(env, SymbolGroup::DragDrop)) {
+    return;
+  }
   auto *dropDest = jlong_to_ptr<WuiDropDestination>(dropDestPtr);
   auto *wuiEnv = jlong_to_ptr<WuiEnv>(envPtr);
   g_sym.waterui_call_drop_exit_handler(dropDest, wuiEnv);
 }
 
+#ifdef WATERUI_JNI_BENCHMARKS
+// ========== Bridge Benchmarks ==========
+//
+// Built only with -DWATERUI_JNI_BENCHMARKS=ON. Runs a bridge hot path in a
+// loop over canned native data, so it needs neither libwaterui_app.so nor a
+// Rust view tree, and returns the elapsed nanoseconds. Paths that go through
+// JNI entry points run against stub symbols (see BenchSymbols). Java
+// allocation counts are taken on the Kotlin side (see BridgeBenchmarkTest).
+// Path ids must match BridgeBenchmarks.PATH_* in the androidTest sources.
+
+enum BenchPath : jint {
+  kBenchStrToJString = 0,
+  kBenchStyledStr = 1,
+  kBenchPrimitiveWatcher = 2,
+  kBenchBulkMeasure = 3,
+  kBenchSizeStruct = 4,
+  kBenchFlatStyledStr = 5,
+  kBenchPickerItems = 6,
+  kBenchLayoutBulk = 7,
+  kBenchForceAsButton = 8,
+};
+
+constexpr char kBenchText[] = "WaterUI bench \xE2\x80\x94 \xF0\x9F\x92\xA7 text";
+constexpr size_t kBenchChunks = 16;
+constexpr jsize kBenchChildren = 200;
+constexpr size_t kBenchWatchers = 16;
+constexpr size_t kBenchPickerCount = 8;
+constexpr jint kBenchEntries = 2;
+
+WuiStr bench_str() {
+  size_t len = sizeof(kBenchText) - 1;
+  ByteArrayHolder *holder = new_byte_holder(len);
+  std::memcpy(holder->data, kBenchText, len);
+  return wui_str_from_holder(holder);
+}
+
+struct BenchChunks {
+  WuiStyledChunk chunks[kBenchChunks];
+};
+
+WuiArraySlice_WuiStyledChunk bench_chunk_slice(const void *opaque) {
+  auto *bench = static_cast<BenchChunks *>(const_cast<void *>(opaque));
+  return WuiArraySlice_WuiStyledChunk{bench->chunks, kBenchChunks};
+}
+
+void bench_chunk_drop(void *) {}
+
+// Styled string over fresh chunk text, which new_styled_str consumes.
+WuiStyledStr bench_styled_str(BenchChunks &bench) {
+  for (auto &chunk : bench.chunks) {
+    chunk.text = bench_str();
+  }
+  WuiStyledStr styled{};
+  styled.chunks.data = &bench;
+  styled.chunks.vtable.slice = bench_chunk_slice;
+  styled.chunks.vtable.drop = bench_chunk_drop;
+  return styled;
+}
+
+BenchChunks g_bench_label{};
+WuiPickerItem g_bench_picker_items[kBenchPickerCount]{};
+std::vector<WuiRect> g_bench_rects;
+
+WuiArraySlice_WuiPickerItem bench_picker_slice(const void *) {
+  return WuiArraySlice_WuiPickerItem{g_bench_picker_items, kBenchPickerCount};
+}
+
+WuiArraySlice_WuiRect bench_rect_slice(const void *) {
+  return WuiArraySlice_WuiRect{g_bench_rects.data(), g_bench_rects.size()};
+}
+
+// Measures every child once at an unspecified proposal, as a stack's first
+// pass would, then releases the subviews like the Rust side does.
+void bench_measure_all(WuiArray_WuiSubView subviews) {
+  WuiArraySlice_WuiSubView slice = subviews.vtable.slice(subviews.data);
+  for (uintptr_t c = 0; c < slice.len; ++c) {
+    slice.head[c].vtable.measure(slice.head[c].context,
+                                 WuiProposalSize{NAN, NAN});
+  }
+  subviews.vtable.drop(subviews.data);
+}
+
+// Swaps in stub Rust symbols for one run and restores the previous table, so
+// the JNI entry points themselves are measured without libwaterui_app.so.
+// Benchmarks must not run alongside a live UI.
+struct BenchSymbols {
+  WatcherSymbols saved = g_sym;
+
+  BenchSymbols() {
+    g_sym.waterui_drop_watcher_metadata = [](WuiWatcherMetadata *) {};
+    g_sym.waterui_read_computed_styled_str =
+        [](const WuiComputed_StyledStr *) {
+          return bench_styled_str(g_bench_label);
+        };
+    g_sym.waterui_layout_size_that_fits =
+        [](WuiLayout *, WuiProposalSize, WuiArray_WuiSubView subviews) {
+          bench_measure_all(subviews);
+          return WuiSize{1.0f, 2.0f};
+        };
+    g_sym.waterui_layout_place = [](WuiLayout *, WuiRect,
+                                    WuiArray_WuiSubView subviews) {
+      bench_measure_all(subviews);
+      WuiArray_WuiRect rects{};
+      rects.vtable.slice = bench_rect_slice;
+      rects.vtable.drop = bench_chunk_drop;
+      return rects;
+    };
+    g_sym.waterui_force_as_button = [](WuiAnyView *) { return WuiButton{}; };
+  }
+  ~BenchSymbols() { g_sym = saved; }
+};
+
+// Child info and an all-hit measurement table for kBenchChildren children.
+struct BenchLayoutArrays {
+  JNIEnv *env;
+  jintArray info;
+  jfloatArray table;
+
+  explicit BenchLayoutArrays(JNIEnv *env) : env(env) {
+    info = env->NewIntArray(kBenchChildren * kBulkChildInfoStride);
+    table = env->NewFloatArray(kBenchChildren * kBenchEntries *
+                               kBulkMeasurementStride);
+    std::vector<jfloat> entries(
+        static_cast<size_t>(kBenchChildren * kBenchEntries *
+                            kBulkMeasurementStride),
+        NAN);
+    env->SetFloatArrayRegion(table, 0, static_cast<jsize>(entries.size()),
+                             entries.data());
+  }
+  ~BenchLayoutArrays() {
+    env->DeleteLocalRef(info);
+    env->DeleteLocalRef(table);
+  }
+};
+
+jlong bench_now_ns() {
+  timespec ts{};
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<jlong>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+JNIEXPORT jlong JNICALL Java_dev_waterui_android_ffi_BridgeBenchmarks_nativeRun(
+    JNIEnv *env, jclass clazz, jint path, jint iterations, jobject callback) {
+  init_app_class_loader(env, clazz);
+  init_struct_classes(env);
+
+  jlong start = 0;
+  switch (path) {
+  case kBenchStrToJString: {
+    start = bench_now_ns();
+    for (jint i = 0; i < iterations; ++i) {
+      jstring str = wui_str_to_jstring(env, bench_str());
+      env->DeleteLocalRef(str);
+    }
+    break;
+  }
+  case kBenchStyledStr:
+  case kBenchFlatStyledStr: {
+    BenchChunks bench{};
+    start = bench_now_ns();
+    for (jint i = 0; i < iterations; ++i) {
+      WuiStyledStr styled = bench_styled_str(bench);
+      jobject obj = path == kBenchFlatStyledStr
+                        ? new_flat_styled_str(env, styled)
+                        : new_styled_str(env, styled);
+      env->DeleteLocalRef(obj);
+    }
+    break;
+  }
+  case kBenchPrimitiveWatcher: {
+    // Emits through the call pointer Rust invokes, queued and handed to
+    // WatcherDispatcher.deliverBatch one frame's worth at a time.
+    if (callback == nullptr)
+      return -1;
+    init_watcher_dispatcher(env);
+    BenchSymbols symbols;
+    WatcherCallbackState *states[kBenchWatchers];
+    for (auto &state : states) {
+      state = create_watcher_state(env, callback, "onFloat", "(FJ)V");
+      WUI_TRACK_HANDLE(WatcherCallback, state);
+    }
+    start = bench_now_ns();
+    for (jint i = 0; i < iterations; ++i) {
+      auto slot = static_cast<size_t>(i) % kBenchWatchers;
+      watcher_float_call(states[slot], static_cast<float>(i), nullptr);
+      if (slot == kBenchWatchers - 1) {
+        Java_dev_waterui_android_ffi_WatcherJni_flushWatcherQueue(env, nullptr);
+      }
+    }
+    Java_dev_waterui_android_ffi_WatcherJni_flushWatcherQueue(env, nullptr);
+    jlong elapsed = bench_now_ns() - start;
+    for (auto *state : states) {
+      watcher_float_drop(state);
+    }
+    return elapsed;
+  }
+  case kBenchBulkMeasure: {
+    // One size_that_fits worth of table-hit probes over 200 children, as a
+    // stack layout would issue them.
+    BulkLayoutPass pass{};
+    pass.env = env;
+    pass.entriesPerChild = kBenchEntries;
+    BenchLayoutArrays arrays(env);
+    start = bench_now_ns();
+    for (jint i = 0; i < iterations; ++i) {
+      bench_measure_all(bulk_subviews_from_java(env, pass, arrays.info,
+                                                arrays.table, kBenchChildren));
+    }
+    break;
+  }
+  case kBenchPickerItems: {
+    BenchSymbols symbols;
+    start = bench_now_ns();
+    for (jint i = 0; i < iterations; ++i) {
+      WuiArray_WuiPickerItem items{};
+      items.vtable.slice = bench_picker_slice;
+      items.vtable.drop = bench_chunk_drop;
+      jobjectArray array = picker_items_to_java(env, items);
+      env->DeleteLocalRef(array);
+    }
+    break;
+  }
+  case kBenchLayoutBulk: {
+    // A RustLayoutViewGroup measure and layout pass over 200 children whose
+    // probes all hit the table, including the layout result cache writes.
+    BenchSymbols symbols;
+    BenchLayoutArrays arrays(env);
+    g_bench_rects.assign(static_cast<size_t>(kBenchChildren), WuiRect{});
+    jfloatArray outSize = env->NewFloatArray(2);
+    jfloatArray outPlacements =
+        env->NewFloatArray(kBenchChildren * kBulkPlacementStride);
+    WuiLayout *layout = reinterpret_cast<WuiLayout *>(&arrays);
+    // Containers mint positive tokens, so this one cannot collide.
+    constexpr jlong kBenchCacheToken = -1;
+    start = bench_now_ns();
+    for (jint i = 0; i < iterations; ++i) {
+      Java_dev_waterui_android_ffi_WatcherJni_layoutSizeThatFitsBulk(
+          env, nullptr, ptr_to_jlong(layout), kBenchCacheToken, 0, 100.0f, NAN,
+          arrays.info, arrays.table, kBenchEntries, nullptr, outSize);
+      Java_dev_waterui_android_ffi_WatcherJni_layoutPlaceBulk(
+          env, nullptr, ptr_to_jlong(layout), kBenchCacheToken, 0, 0, 0,
+          100.0f, 100.0f, arrays.info, arrays.table, kBenchEntries, nullptr,
+          outPlacements);
+    }
+    jlong elapsed = bench_now_ns() - start;
+    Java_dev_waterui_android_ffi_WatcherJni_releaseLayoutCache(
+        env, nullptr, kBenchCacheToken);
+    env->DeleteLocalRef(outSize);
+    env->DeleteLocalRef(outPlacements);
+    return elapsed;
+  }
+  case kBenchForceAsButton: {
+    BenchSymbols symbols;
+    start = bench_now_ns();
+    for (jint i = 0; i < iterations; ++i) {
+      jobject obj = Java_dev_waterui_android_ffi_WatcherJni_forceAsButton(
+          env, nullptr, 0);
+      env->DeleteLocalRef(obj);
+    }
+    break;
+  }
+  case kBenchSizeStruct: {
+    start = bench_now_ns();
+    for (jint i = 0; i < iterations; ++i) {
+      jobject obj = size_to_java(env, WuiSize{1.0f, 2.0f});
+      env->DeleteLocalRef(obj);
+    }
+    break;
+  }
+  default:
+    return -1;
+  }
+  return bench_now_ns() - start;
+}
+#endif // WATERUI_JNI_BENCHMARKS
+
 } // extern "C"
@@ -0,0 +1,442 @@
+/**
+ * Symbol table shared by the WaterUI JNI bridge and libwaterui_app.so.
+ *
+ * waterui_get_symbol_table() hands the bridge every function pointer and
+ * type id it uses in one call. Both sides build WuiSymbolTable from the lists
+ * below, so its layout has a single definition: the pointers in
+ * ALL_SYMBOL_LIST order, then the ids in ALL_TYPE_ID_LIST order. Any change
+ * to a list must bump WUI_SYMBOL_TABLE_ABI_VERSION; the bridge ignores a
+ * table whose version or size differs and falls back to dlsym.
+ *
+ * Include after waterui.h.
+ */
+
+#ifndef WATERUI_SYMBOL_TABLE_H
+#define WATERUI_SYMBOL_TABLE_H
+
+#include <stdint.h>
+
+#define WUI_SYMBOL_TABLE_ABI_VERSION 1
+
+// Core symbols, resolved by nativeInit.
+#define WATCHER_SYMBOL_LIST(X)                                                 \
+  X(waterui_drop_watcher_metadata)                                             \
+  X(waterui_new_watcher_guard)                                                 \
+  X(waterui_new_watcher_any_view)                                              \
+  X(waterui_new_watcher_bool)                                                  \
+  X(waterui_new_watcher_f64)                                                   \
+  X(waterui_new_watcher_i32)                                                   \
+  X(waterui_new_watcher_picker_items)                                          \
+  X(waterui_new_watcher_resolved_color)                                        \
+  X(waterui_new_watcher_resolved_font)                                         \
+  X(waterui_new_watcher_str)                                                   \
+  X(waterui_new_watcher_styled_str)                                            \
+  X(waterui_watch_binding_bool)                                                \
+  X(waterui_watch_binding_f64)                                                 \
+  X(waterui_watch_binding_i32)                                                 \
+  X(waterui_watch_binding_str)                                                 \
+  X(waterui_watch_computed_f64)                                                \
+  X(waterui_watch_computed_i32)                                                \
+  X(waterui_watch_computed_resolved_font)                                      \
+  X(waterui_watch_computed_resolved_color)                                     \
+  X(waterui_watch_computed_styled_str)                                         \
+  X(waterui_watch_computed_picker_items)                                       \
+  X(waterui_watch_computed_color_scheme)                                       \
+  X(waterui_new_watcher_color_scheme)                                          \
+  X(waterui_call_watcher_color_scheme)                                         \
+  X(waterui_drop_watcher_color_scheme)                                         \
+  X(waterui_dynamic_connect)                                                   \
+  X(waterui_read_computed_styled_str)                                          \
+  X(waterui_read_computed_picker_items)                                        \
+  X(waterui_read_binding_str)                                                  \
+  X(waterui_set_binding_str)                                                   \
+  X(waterui_set_binding_secure)                                                \
+  X(waterui_secure_field_id)                                                   \
+  X(waterui_force_as_secure_field)                                             \
+  X(waterui_call_watcher_resolved_color)                                       \
+  X(waterui_call_watcher_resolved_font)                                        \
+  X(waterui_drop_watcher_resolved_color)                                       \
+  X(waterui_drop_watcher_resolved_font)                                        \
+  X(waterui_new_computed_resolved_color)                                       \
+  X(waterui_new_computed_resolved_font)                                        \
+  X(waterui_new_computed_color_scheme)                                         \
+  X(waterui_layout_size_that_fits)                                             \
+  X(waterui_layout_place)                                                      \
+  X(waterui_view_id)                                                           \
+  X(waterui_view_stretch_axis)                                                 \
+  X(waterui_force_as_plain)                                                    \
+  X(waterui_empty_id)                                                          \
+  X(waterui_text_id)                                                           \
+  X(waterui_plain_id)                                                          \
+  X(waterui_button_id)                                                         \
+  X(waterui_color_id)                                                          \
+  X(waterui_text_field_id)                                                     \
+  X(waterui_stepper_id)                                                        \
+  X(waterui_date_picker_id)                                                    \
+  X(waterui_color_picker_id)                                                   \
+  X(waterui_progress_id)                                                       \
+  X(waterui_dynamic_id)                                                        \
+  X(waterui_scroll_view_id)                                                    \
+  X(waterui_spacer_id)                                                         \
+  X(waterui_toggle_id)                                                         \
+  X(waterui_slider_id)                                                         \
+  X(waterui_fixed_container_id)                                                \
+  X(waterui_picker_id)                                                         \
+  X(waterui_layout_container_id)                                               \
+  X(waterui_init)                                                              \
+  X(waterui_app)                                                               \
+  X(waterui_view_body)                                                         \
+  X(waterui_clone_env)                                                         \
+  X(waterui_drop_env)                                                          \
+  X(waterui_drop_anyview)                                                      \
+  X(waterui_force_as_button)                                                   \
+  X(waterui_force_as_text)                                                     \
+  X(waterui_force_as_color)                                                    \
+  X(waterui_force_as_text_field)                                               \
+  X(waterui_force_as_toggle)                                                   \
+  X(waterui_force_as_slider)                                                   \
+  X(waterui_force_as_stepper)                                                  \
+  X(waterui_force_as_date_picker)                                              \
+  X(waterui_force_as_color_picker)                                             \
+  X(waterui_force_as_progress)                                                 \
+  X(waterui_force_as_scroll_view)                                              \
+  X(waterui_force_as_picker)                                                   \
+  X(waterui_force_as_layout_container)                                         \
+  X(waterui_force_as_fixed_container)                                          \
+  X(waterui_force_as_dynamic)                                                  \
+  X(waterui_drop_layout)                                                       \
+  X(waterui_drop_action)                                                       \
+  X(waterui_call_action)                                                       \
+  X(waterui_drop_index_action)                                                 \
+  X(waterui_call_index_action)                                                 \
+  X(waterui_drop_move_action)                                                  \
+  X(waterui_call_move_action)                                                  \
+  X(waterui_drop_dynamic)                                                      \
+  X(waterui_drop_color)                                                        \
+  X(waterui_color_from_srgba)                                                  \
+  X(waterui_color_from_linear_rgba_headroom)                                   \
+  X(waterui_drop_font)                                                         \
+  X(waterui_resolve_color)                                                     \
+  X(waterui_resolve_font)                                                      \
+  X(waterui_resolved_font_new)                                                 \
+  X(waterui_drop_box_watcher_guard)                                            \
+  X(waterui_get_animation)                                                     \
+  X(waterui_anyviews_len)                                                      \
+  X(waterui_anyviews_get_view)                                                 \
+  X(waterui_anyviews_get_id)                                                   \
+  X(waterui_drop_anyviews)                                                     \
+  X(waterui_read_binding_bool)                                                 \
+  X(waterui_read_binding_color)                                                \
+  X(waterui_read_binding_f64)                                                  \
+  X(waterui_read_binding_i32)                                                  \
+  X(waterui_set_binding_bool)                                                  \
+  X(waterui_set_binding_color)                                                 \
+  X(waterui_set_binding_f64)                                                   \
+  X(waterui_set_binding_i32)                                                   \
+  X(waterui_drop_binding_bool)                                                 \
+  X(waterui_drop_binding_color)                                                \
+  X(waterui_drop_binding_f64)                                                  \
+  X(waterui_drop_binding_i32)                                                  \
+  X(waterui_drop_binding_str)                                                  \
+  X(waterui_read_binding_date)                                                 \
+  X(waterui_set_binding_date)                                                  \
+  X(waterui_drop_binding_date)                                                 \
+  X(waterui_watch_binding_date)                                                \
+  X(waterui_new_watcher_date)                                                  \
+  X(waterui_read_computed_f64)                                                 \
+  X(waterui_read_computed_i32)                                                 \
+  X(waterui_read_computed_resolved_color)                                      \
+  X(waterui_read_computed_resolved_font)                                       \
+  X(waterui_drop_computed_f64)                                                 \
+  X(waterui_drop_computed_i32)                                                 \
+  X(waterui_drop_computed_resolved_color)                                      \
+  X(waterui_drop_computed_resolved_font)                                       \
+  X(waterui_drop_computed_styled_str)                                          \
+  X(waterui_drop_computed_picker_items)                                        \
+  X(waterui_theme_color_background)                                            \
+  X(waterui_theme_color_surface)                                               \
+  X(waterui_theme_color_surface_variant)                                       \
+  X(waterui_theme_color_border)                                                \
+  X(waterui_theme_color_foreground)                                            \
+  X(waterui_theme_color_muted_foreground)                                      \
+  X(waterui_theme_color_accent)                                                \
+  X(waterui_theme_color_accent_foreground)                                     \
+  X(waterui_theme_font_body)                                                   \
+  X(waterui_theme_font_title)                                                  \
+  X(waterui_theme_font_headline)                                               \
+  X(waterui_theme_font_subheadline)                                            \
+  X(waterui_theme_font_caption)                                                \
+  X(waterui_theme_font_footnote)                                               \
+  X(waterui_theme_install_color)                                               \
+  X(waterui_theme_install_font)                                                \
+  X(waterui_theme_install_color_scheme)                                        \
+  X(waterui_theme_color)                                                       \
+  X(waterui_theme_font)                                                        \
+  X(waterui_theme_color_scheme)                                                \
+  X(waterui_computed_color_scheme_constant)                                    \
+  X(waterui_read_computed_color_scheme)                                        \
+  X(waterui_drop_computed_color_scheme)                                        \
+  X(waterui_metadata_env_id)                                                   \
+  X(waterui_force_as_metadata_env)                                             \
+  X(waterui_metadata_secure_id)                                                \
+  X(waterui_force_as_metadata_secure)                                          \
+  X(waterui_metadata_standard_dynamic_range_id)                                \
+  X(waterui_force_as_metadata_standard_dynamic_range)                          \
+  X(waterui_metadata_high_dynamic_range_id)                                    \
+  X(waterui_force_as_metadata_high_dynamic_range)                              \
+  X(waterui_metadata_gesture_id)                                               \
+  X(waterui_force_as_metadata_gesture)                                         \
+  X(waterui_metadata_lifecycle_hook_id)                                        \
+  X(waterui_force_as_metadata_lifecycle_hook)                                  \
+  X(waterui_metadata_on_event_id)                                              \
+  X(waterui_force_as_metadata_on_event)                                        \
+  X(waterui_metadata_cursor_id)                                                \
+  X(waterui_force_as_metadata_cursor)                                          \
+  X(waterui_metadata_foreground_id)                                            \
+  X(waterui_force_as_metadata_foreground)                                      \
+  X(waterui_metadata_shadow_id)                                                \
+  X(waterui_force_as_metadata_shadow)                                          \
+  X(waterui_metadata_border_id)                                                \
+  X(waterui_force_as_metadata_border)                                          \
+  X(waterui_metadata_focused_id)                                               \
+  X(waterui_force_as_metadata_focused)                                         \
+  X(waterui_metadata_ignore_safe_area_id)                                      \
+  X(waterui_force_as_metadata_ignore_safe_area)                                \
+  X(waterui_metadata_retain_id)                                                \
+  X(waterui_force_as_metadata_retain)                                          \
+  X(waterui_drop_retain)                                                       \
+  X(waterui_metadata_scale_id)                                                 \
+  X(waterui_force_as_metadata_scale)                                           \
+  X(waterui_metadata_rotation_id)                                              \
+  X(waterui_force_as_metadata_rotation)                                        \
+  X(waterui_metadata_offset_id)                                                \
+  X(waterui_force_as_metadata_offset)                                          \
+  X(waterui_metadata_blur_id)                                                  \
+  X(waterui_force_as_metadata_blur)                                            \
+  X(waterui_metadata_brightness_id)                                            \
+  X(waterui_force_as_metadata_brightness)                                      \
+  X(waterui_metadata_saturation_id)                                            \
+  X(waterui_force_as_metadata_saturation)                                      \
+  X(waterui_metadata_contrast_id)                                              \
+  X(waterui_force_as_metadata_contrast)                                        \
+  X(waterui_metadata_hue_rotation_id)                                          \
+  X(waterui_force_as_metadata_hue_rotation)                                    \
+  X(waterui_metadata_grayscale_id)                                             \
+  X(waterui_force_as_metadata_grayscale)                                       \
+  X(waterui_metadata_opacity_id)                                               \
+  X(waterui_force_as_metadata_opacity)                                         \
+  X(waterui_call_lifecycle_hook)                                               \
+  X(waterui_drop_lifecycle_hook)                                               \
+  X(waterui_call_on_event)                                                     \
+  X(waterui_drop_on_event)                                                     \
+  X(waterui_read_computed_cursor_style)                                        \
+  X(waterui_watch_computed_cursor_style)                                       \
+  X(waterui_drop_computed_cursor_style)                                        \
+  X(waterui_new_watcher_cursor_style)                                          \
+  X(waterui_read_computed_color)                                               \
+  X(waterui_read_binding_f32)                                                  \
+  X(waterui_set_binding_f32)                                                   \
+  X(waterui_drop_binding_f32)                                                  \
+  X(waterui_new_watcher_f32)                                                   \
+  X(waterui_watch_binding_f32)                                                 \
+  X(waterui_read_computed_f32)                                                 \
+  X(waterui_watch_computed_f32)                                                \
+  X(waterui_drop_computed_f32)                                                 \
+  X(waterui_read_computed_str)                                                 \
+  X(waterui_watch_computed_str)                                                \
+  X(waterui_drop_computed_str)                                                 \
+  X(waterui_navigation_stack_id)                                               \
+  X(waterui_navigation_view_id)                                                \
+  X(waterui_tabs_id)                                                           \
+  X(waterui_force_as_navigation_stack)                                         \
+  X(waterui_force_as_navigation_view)                                          \
+  X(waterui_force_as_tabs)                                                     \
+  X(waterui_tab_content)                                                       \
+  X(waterui_navigation_controller_new)                                         \
+  X(waterui_env_install_navigation_controller)                                 \
+  X(waterui_drop_navigation_controller)                                        \
+  X(waterui_env_install_webview_controller)                                    \
+  X(waterui_list_id)                                                           \
+  X(waterui_list_item_id)                                                      \
+  X(waterui_force_as_list)                                                     \
+  X(waterui_force_as_list_item)                                                \
+  X(waterui_env_install_media_picker_manager)                                  \
+  X(waterui_metadata_clip_shape_id)                                            \
+  X(waterui_force_as_metadata_clip_shape)                                      \
+  X(waterui_metadata_context_menu_id)                                          \
+  X(waterui_force_as_metadata_context_menu)                                    \
+  X(waterui_read_computed_menu_items)                                          \
+  X(waterui_drop_computed_menu_items)                                          \
+  X(waterui_call_shared_action)                                                \
+  X(waterui_drop_shared_action)                                                \
+  X(waterui_menu_id)                                                           \
+  X(waterui_force_as_menu)
+
+// Component groups, resolved on first use by the JNI bridge; a library built
+// without a component leaves its entries null.
+#define WEBVIEW_SYMBOL_LIST(X)                                                 \
+  X(waterui_webview_id)                                                        \
+  X(waterui_force_as_webview)                                                  \
+  X(waterui_webview_native_handle)                                             \
+  X(waterui_drop_web_view)
+
+#define VIDEO_SYMBOL_LIST(X)                                                   \
+  X(waterui_video_id)                                                          \
+  X(waterui_force_as_video)                                                    \
+  X(waterui_video_player_id)                                                   \
+  X(waterui_force_as_video_player)                                             \
+  X(waterui_read_computed_video)                                               \
+  X(waterui_watch_computed_video)                                              \
+  X(waterui_drop_computed_video)                                               \
+  X(waterui_new_watcher_video)
+
+#define MEDIA_SYMBOL_LIST(X)                                                   \
+  X(waterui_photo_id)                                                          \
+  X(waterui_force_as_photo)
+
+#define GPU_SURFACE_SYMBOL_LIST(X)                                             \
+  X(waterui_gpu_surface_id)                                                    \
+  X(waterui_force_as_gpu_surface)                                              \
+  X(waterui_gpu_surface_init)                                                  \
+  X(waterui_gpu_surface_render)                                                \
+  X(waterui_gpu_surface_drop)
+
+#define DRAG_DROP_SYMBOL_LIST(X)                                               \
+  X(waterui_metadata_draggable_id)                                             \
+  X(waterui_force_as_metadata_draggable)                                       \
+  X(waterui_metadata_drop_destination_id)                                      \
+  X(waterui_force_as_metadata_drop_destination)                                \
+  X(waterui_draggable_get_data)                                                \
+  X(waterui_drop_draggable)                                                    \
+  X(waterui_drop_drop_destination)                                             \
+  X(waterui_call_drop_handler)                                                 \
+  X(waterui_call_drop_enter_handler)                                           \
+  X(waterui_call_drop_exit_handler)
+
+#define ALL_SYMBOL_LIST(X)                                                     \
+  WATCHER_SYMBOL_LIST(X)                                                       \
+  WEBVIEW_SYMBOL_LIST(X)                                                       \
+  VIDEO_SYMBOL_LIST(X)                                                         \
+  MEDIA_SYMBOL_LIST(X)                                                         \
+  GPU_SURFACE_SYMBOL_LIST(X)                                                   \
+  DRAG_DROP_SYMBOL_LIST(X)
+
+// Type-id functions return constants, so the table carries their values.
+#define CORE_TYPE_ID_LIST(X)                                                   \
+  X(waterui_secure_field_id)                                                   \
+  X(waterui_empty_id)                                                          \
+  X(waterui_text_id)                                                           \
+  X(waterui_plain_id)                                                          \
+  X(waterui_button_id)                                                         \
+  X(waterui_color_id)                                                          \
+  X(waterui_text_field_id)                                                     \
+  X(waterui_stepper_id)                                                        \
+  X(waterui_date_picker_id)                                                    \
+  X(waterui_color_picker_id)                                                   \
+  X(waterui_progress_id)                                                       \
+  X(waterui_dynamic_id)                                                        \
+  X(waterui_scroll_view_id)                                                    \
+  X(waterui_spacer_id)                                                         \
+  X(waterui_toggle_id)                                                         \
+  X(waterui_slider_id)                                                         \
+  X(waterui_fixed_container_id)                                                \
+  X(waterui_picker_id)                                                         \
+  X(waterui_layout_container_id)                                               \
+  X(waterui_metadata_env_id)                                                   \
+  X(waterui_metadata_secure_id)                                                \
+  X(waterui_metadata_standard_dynamic_range_id)                                \
+  X(waterui_metadata_high_dynamic_range_id)                                    \
+  X(waterui_metadata_gesture_id)                                               \
+  X(waterui_metadata_lifecycle_hook_id)                                        \
+  X(waterui_metadata_on_event_id)                                              \
+  X(waterui_metadata_cursor_id)                                                \
+  X(waterui_metadata_foreground_id)                                            \
+  X(waterui_metadata_shadow_id)                                                \
+  X(waterui_metadata_border_id)                                                \
+  X(waterui_metadata_focused_id)                                               \
+  X(waterui_metadata_ignore_safe_area_id)                                      \
+  X(waterui_metadata_retain_id)                                                \
+  X(waterui_metadata_scale_id)                                                 \
+  X(waterui_metadata_rotation_id)                                              \
+  X(waterui_metadata_offset_id)                                                \
+  X(waterui_metadata_blur_id)                                                  \
+  X(waterui_metadata_brightness_id)                                            \
+  X(waterui_metadata_saturation_id)                                            \
+  X(waterui_metadata_contrast_id)                                              \
+  X(waterui_metadata_hue_rotation_id)                                          \
+  X(waterui_metadata_grayscale_id)                                             \
+  X(waterui_metadata_opacity_id)                                               \
+  X(waterui_navigation_stack_id)                                               \
+  X(waterui_navigation_view_id)                                                \
+  X(waterui_tabs_id)                                                           \
+  X(waterui_list_id)                                                           \
+  X(waterui_list_item_id)                                                      \
+  X(waterui_metadata_clip_shape_id)                                            \
+  X(waterui_metadata_context_menu_id)                                          \
+  X(waterui_menu_id)
+
+#define WEBVIEW_TYPE_ID_LIST(X)                                                \
+  X(waterui_webview_id)
+
+#define VIDEO_TYPE_ID_LIST(X)                                                  \
+  X(waterui_video_id)                                                          \
+  X(waterui_video_player_id)
+
+#define MEDIA_TYPE_ID_LIST(X)                                                  \
+  X(waterui_photo_id)
+
+#define GPU_SURFACE_TYPE_ID_LIST(X)                                            \
+  X(waterui_gpu_surface_id)
+
+#define DRAG_DROP_TYPE_ID_LIST(X)                                              \
+  X(waterui_metadata_draggable_id)                                             \
+  X(waterui_metadata_drop_destination_id)
+
+#define ALL_TYPE_ID_LIST(X)                                                    \
+  CORE_TYPE_ID_LIST(X)                                                         \
+  WEBVIEW_TYPE_ID_LIST(X)                                                      \
+  VIDEO_TYPE_ID_LIST(X)                                                        \
+  MEDIA_TYPE_ID_LIST(X)                                                        \
+  GPU_SURFACE_TYPE_ID_LIST(X)                                                  \
+  DRAG_DROP_TYPE_ID_LIST(X)
+
+#ifdef __cplusplus
+#define WUI_SYMBOL_TYPE(name) decltype(&::name)
+#else
+#define WUI_SYMBOL_TYPE(name) __typeof__(&name)
+#endif
+
+#define WUI_DECLARE_SYMBOL(name) WUI_SYMBOL_TYPE(name) name;
+#define WUI_DECLARE_TYPE_ID(name) struct WuiTypeId name;
+
+typedef struct WuiSymbols {
+  ALL_SYMBOL_LIST(WUI_DECLARE_SYMBOL)
+} WuiSymbols;
+
+typedef struct WuiTypeIds {
+  ALL_TYPE_ID_LIST(WUI_DECLARE_TYPE_ID)
+} WuiTypeIds;
+
+#undef WUI_DECLARE_SYMBOL
+#undef WUI_DECLARE_TYPE_ID
+#undef WUI_SYMBOL_TYPE
+
+typedef struct WuiSymbolTable {
+  uint32_t abi_version; // WUI_SYMBOL_TABLE_ABI_VERSION
+  uint32_t size;        // sizeof(WuiSymbolTable) as built by the library
+  WuiSymbols symbols;
+  WuiTypeIds type_ids;
+} WuiSymbolTable;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Exported by libwaterui_app.so; optional, resolved with dlsym.
+const WuiSymbolTable *waterui_get_symbol_table(void);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // WATERUI_SYMBOL_TABLE_H
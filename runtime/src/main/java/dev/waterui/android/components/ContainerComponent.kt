@@ -1,5 +1,6 @@
 package dev.waterui.android.components
 
+import android.view.View
 import dev.waterui.android.layout.ChildDescriptor
 import dev.waterui.android.layout.RustLayoutViewGroup
 import dev.waterui.android.runtime.NativeAnyViews
@@ -7,8 +8,9 @@ import dev.waterui.android.runtime.NativeBindings
 import dev.waterui.android.runtime.RegistryBuilder
 import dev.waterui.android.runtime.WuiRenderer
 import dev.waterui.android.runtime.WuiTypeId
+import dev.waterui.android.runtime.disposeWith
 import dev.waterui.android.runtime.getWuiStretchAxis
-import dev.waterui.android.runtime.inflateAnyView
+import dev.waterui.android.runtime.inflateAnyViews
 
 import dev.waterui.android.runtime.usePointer
 
@@ -23,7 +25,7 @@ private val fixedContainerTypeId: WuiTypeId by lazy {
 private val layoutContainerRenderer = WuiRenderer { context, node, env, registry ->
     val struct = NativeBindings.waterui_force_as_layout_container(node.rawPtr)
 
-    if (struct.childrenPtr == 0L) {
+    val container = if (struct.childrenPtr == 0L) {
         RustLayoutViewGroup(context, layoutPtr = struct.layoutPtr, descriptors = emptyList())
     } else {
         // IMPORTANT: All operations using child pointers must happen inside usePointer
@@ -32,9 +34,7 @@ private val layoutContainerRenderer = WuiRenderer { context, node, env, registry
             val childPointers = nativeViews.toList()
             // Inflate children first - this resolves composite views to native views
             // and stores stretch axis on each inflated view
-            val inflatedChildren = childPointers.map { childPtr ->
-                inflateAnyView(context, childPtr, env, registry)
-            }
+            val inflatedChildren = inflateAnyViews(context, childPointers.toLongArray(), env, registry)
             // Create descriptors from inflated children's stretch axes
             val descriptors = inflatedChildren.map { child ->
                 ChildDescriptor(
@@ -46,19 +46,20 @@ private val layoutContainerRenderer = WuiRenderer { context, node, env, registry
             inflatedChildren.forEach { child ->
                 group.addView(child)
             }
+            group.asyncLayout = inflatedChildren.prefersAsyncLayout()
             group
         }
     }
+    // force_as handed the layout over with the AnyView; the group is its only owner
+    container.disposeWith { container.releaseLayout() }
+    container
 }
 
 private val fixedContainerRenderer = WuiRenderer { context, node, env, registry ->
     val struct = NativeBindings.waterui_force_as_fixed_container(node.rawPtr)
-    val childPointers = struct.childPointers.toList()
     // Inflate children first - this resolves composite views to native views
     // and stores stretch axis on each inflated view
-    val inflatedChildren = childPointers.map { childPtr ->
-        inflateAnyView(context, childPtr, env, registry)
-    }
+    val inflatedChildren = inflateAnyViews(context, struct.childPointers, env, registry)
     // Create descriptors from inflated children's stretch axes
     val descriptors = inflatedChildren.map { child ->
         ChildDescriptor(
@@ -70,9 +71,19 @@ private val fixedContainerRenderer = WuiRenderer { context, node, env, registry
     inflatedChildren.forEach { child ->
         group.addView(child)
     }
+    group.asyncLayout = inflatedChildren.prefersAsyncLayout()
+    // As above: the layout is owned by the group from here on
+    group.disposeWith { group.releaseLayout() }
     group
 }
 
+/**
+ * Containers of nested Rust layouts answer the same probes frame after frame,
+ * so their own layout can move off the UI thread (see [RustLayoutViewGroup.asyncLayout]).
+ */
+private fun List<View>.prefersAsyncLayout(): Boolean =
+    isNotEmpty() && all { it is RustLayoutViewGroup }
+
 internal fun RegistryBuilder.registerWuiContainers() {
     register({ layoutContainerTypeId }, layoutContainerRenderer)
     register({ fixedContainerTypeId }, fixedContainerRenderer)
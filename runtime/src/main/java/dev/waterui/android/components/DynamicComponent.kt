@@ -18,6 +18,12 @@ private val dynamicRenderer = WuiRenderer { context, node, env, registry ->
 
     val watcher = WatcherStructFactory.anyView { pointer, _ ->
         container.post {
+            // A list re-rendered in place keeps its scroll position and view
+            // holders; rows are moved, inserted or rebound, not rebuilt.
+            val current = if (container.childCount == 1) container.getChildAt(0) else null
+            if (pointer != 0L && current != null && updateListInPlace(current, pointer)) {
+                return@post
+            }
             // Remove old views - their resources are cleaned up via disposeWith callbacks
             // when they're detached from the window
             container.removeAllViews()
@@ -1,10 +1,12 @@
 package dev.waterui.android.components
 
 import android.content.Context
-import android.view.Choreographer
+import android.os.Build
 import android.view.SurfaceHolder
+import android.view.View
 import android.view.SurfaceView
 import android.view.ViewGroup
+import dev.waterui.android.runtime.GpuSurfaceStats
 import dev.waterui.android.runtime.GpuSurfaceStruct
 import dev.waterui.android.runtime.NativeBindings
 import dev.waterui.android.runtime.RegistryBuilder
@@ -17,14 +19,15 @@ private val gpuSurfaceTypeId: WuiTypeId by lazy { NativeBindings.waterui_gpu_sur
 /**
  * GpuSurface component renderer.
  *
- * Uses Android's SurfaceView with Choreographer for high-performance GPU rendering
- * at display refresh rates (60-120fps). The actual GPU rendering is performed by
- * the Rust wgpu backend.
+ * Uses Android's SurfaceView for high-performance GPU rendering at display
+ * refresh rates (60-120fps). The actual GPU rendering is performed by the Rust
+ * wgpu backend.
  *
  * # Architecture
  *
  * - SurfaceView provides an ANativeWindow for zero-copy GPU access
- * - Choreographer provides VSync-aligned frame callbacks
+ * - A native render thread owns the wgpu state and renders from its own
+ *   AChoreographer callbacks, so frames do not depend on the UI thread
  * - Rust owns wgpu Device/Queue/Surface and calls user's GpuRenderer
  *
  * # HDR Support
@@ -40,22 +43,26 @@ private val gpuSurfaceRenderer = WuiRenderer { context, node, env, registry ->
 }
 
 /**
- * Custom SurfaceView that handles GPU surface lifecycle and frame rendering.
+ * Custom SurfaceView that hands its surface to the native render driver.
  */
 private class GpuSurfaceView(
     context: Context,
     private val gpuSurfaceData: GpuSurfaceStruct
-) : SurfaceView(context), SurfaceHolder.Callback, Choreographer.FrameCallback {
-
-    /** Opaque pointer to WuiGpuSurfaceState (owns wgpu resources) */
-    private var gpuState: Long = 0L
-
-    /** Whether we're actively rendering frames */
-    private var isRendering = false
-
-    /** Current surface dimensions in pixels */
-    private var surfaceWidth: Int = 0
-    private var surfaceHeight: Int = 0
+) : SurfaceView(context), SurfaceHolder.Callback {
+
+    /** Opaque pointer to the native render driver (owns wgpu resources) */
+    private var driver: Long = 0L
+
+    /**
+     * The renderer is consumed by the first driver; it cannot be restarted.
+     *
+     * Known limitation: the wgpu state is bound to the ANativeWindow it was
+     * created with, and the Rust API has no way to move it to a new one. Once
+     * the surface is destroyed, the view stays blank. On API 34+ the surface
+     * follows attachment instead of visibility, so only a detach loses it;
+     * below that, hiding the window (e.g. backgrounding the app) does too.
+     */
+    private var rendererConsumed = false
 
     init {
         // Set layout params to fill parent
@@ -64,6 +71,11 @@ private class GpuSurfaceView(
             ViewGroup.LayoutParams.MATCH_PARENT
         )
 
+        // Keep the surface (and so the wgpu state) while the window is merely hidden
+        if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.UPSIDE_DOWN_CAKE) {
+            setSurfaceLifecycle(SURFACE_LIFECYCLE_FOLLOWS_ATTACHMENT)
+        }
+
         // Register for surface callbacks
         holder.addCallback(this)
     }
@@ -75,54 +87,34 @@ private class GpuSurfaceView(
     }
 
     override fun surfaceChanged(holder: SurfaceHolder, format: Int, width: Int, height: Int) {
-        surfaceWidth = width
-        surfaceHeight = height
-
-        if (gpuState == 0L && gpuSurfaceData.rendererPtr != 0L) {
-            // Initialize GPU resources with the native surface
-            // The JNI layer extracts ANativeWindow from the Surface via ANativeWindow_fromSurface
-            gpuState = NativeBindings.waterui_gpu_surface_init(
-                gpuSurfaceData.rendererPtr,
-                holder.surface,
-                width,
-                height
-            )
-
-            if (gpuState != 0L) {
-                // Start rendering loop
-                isRendering = true
-                Choreographer.getInstance().postFrameCallback(this)
-            }
+        if (driver != 0L) {
+            NativeBindings.waterui_gpu_surface_driver_resize(driver, width, height)
+            return
         }
-    }
-
-    override fun surfaceDestroyed(holder: SurfaceHolder) {
-        // Stop rendering and clean up
-        isRendering = false
-
-        if (gpuState != 0L) {
-            NativeBindings.waterui_gpu_surface_drop(gpuState)
-            gpuState = 0L
+        if (rendererConsumed || gpuSurfaceData.rendererPtr == 0L) return
+
+        // The driver extracts ANativeWindow from the Surface and initializes
+        // wgpu on its render thread
+        rendererConsumed = true
+        driver = NativeBindings.waterui_gpu_surface_start_driver(
+            gpuSurfaceData.rendererPtr,
+            holder.surface,
+            width,
+            height
+        )
+        if (driver != 0L && !isAttachedToWindow) {
+            NativeBindings.waterui_gpu_surface_driver_set_paused(driver, true)
         }
     }
 
-    // ========== Choreographer.FrameCallback ==========
-
-    override fun doFrame(frameTimeNanos: Long) {
-        if (!isRendering || gpuState == 0L) {
-            return
-        }
-
-        // Render frame with current dimensions
-        NativeBindings.waterui_gpu_surface_render(
-            gpuState,
-            surfaceWidth,
-            surfaceHeight
-        )
+    /** Frame timing from the render driver, or null when it is not running. */
+    fun frameStats(): GpuSurfaceStats? = if (driver != 0L) GpuSurfaceStats.read(driver) else null
 
-        // Schedule next frame if still rendering
-        if (isRendering) {
-            Choreographer.getInstance().postFrameCallback(this)
+    override fun surfaceDestroyed(holder: SurfaceHolder) {
+        // Joins the render thread; the surface must not be touched afterwards
+        if (driver != 0L) {
+            NativeBindings.waterui_gpu_surface_stop_driver(driver)
+            driver = 0L
         }
     }
 
@@ -150,10 +142,19 @@ private class GpuSurfaceView(
         setMeasuredDimension(measuredWidth, measuredHeight)
     }
 
+    override fun onAttachedToWindow() {
+        super.onAttachedToWindow()
+        if (driver != 0L) {
+            NativeBindings.waterui_gpu_surface_driver_set_paused(driver, false)
+        }
+    }
+
     override fun onDetachedFromWindow() {
         super.onDetachedFromWindow()
-        // Stop rendering when detached
-        isRendering = false
+        // Pause rendering while detached
+        if (driver != 0L) {
+            NativeBindings.waterui_gpu_surface_driver_set_paused(driver, true)
+        }
     }
 
     companion object {
@@ -161,6 +162,14 @@ private class GpuSurfaceView(
     }
 }
 
+/**
+ * Frame timing of a GpuSurface's render driver, for debug overlays and jank
+ * reports. Null when this view is not a GpuSurface or its driver is not running.
+ * In builds with WATERUI_JNI_TRACING, system traces also show per-frame latency,
+ * CPU time and skips as WaterUI.gpuSurface.* counters.
+ */
+fun View.gpuSurfaceFrameStats(): GpuSurfaceStats? = (this as? GpuSurfaceView)?.frameStats()
+
 internal fun RegistryBuilder.registerWuiGpuSurface() {
-    register({ gpuSurfaceTypeId }, gpuSurfaceRenderer)
+    registerDeferred({ gpuSurfaceTypeId }, gpuSurfaceRenderer)
 }
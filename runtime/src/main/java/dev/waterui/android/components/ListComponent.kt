@@ -4,13 +4,19 @@ import android.content.Context
 import android.graphics.Canvas
 import android.graphics.Color
 import android.graphics.drawable.ColorDrawable
+import android.view.View
 import android.view.ViewGroup
 import android.widget.FrameLayout
 import androidx.recyclerview.widget.ItemTouchHelper
 import androidx.recyclerview.widget.LinearLayoutManager
 import androidx.recyclerview.widget.RecyclerView
 import dev.waterui.android.reactive.WuiComputedBool
+import dev.waterui.android.runtime.DecodedImageCache
+import dev.waterui.android.runtime.KeyedDiffListener
+import dev.waterui.android.runtime.applyKeyedDiff
+import dev.waterui.android.runtime.keyedDiffPayloadMask
 import dev.waterui.android.runtime.disposeWith
+import dev.waterui.android.runtime.ListStruct
 import dev.waterui.android.runtime.NativeBindings
 import dev.waterui.android.runtime.RegistryBuilder
 import dev.waterui.android.runtime.WuiEnvironment
@@ -39,174 +45,237 @@ private val listRenderer = WuiRenderer { context, node, env, registry ->
 
     // Load items from WuiAnyViews
     val items = mutableListOf<ListItemData>()
-    val contentsPtr = struct.contentsPtr
-    if (contentsPtr != 0L) {
-        val count = NativeBindings.waterui_any_views_len(contentsPtr)
-        for (i in 0 until count) {
-            val id = NativeBindings.waterui_any_views_get_id(contentsPtr, i)
-            val viewPtr = NativeBindings.waterui_any_views_get_view(contentsPtr, i)
-            if (viewPtr != 0L) {
-                // Get the ListItem and extract its content
-                val listItem = NativeBindings.waterui_force_as_list_item(viewPtr)
-
-                // Create deletable computed if pointer exists
-                val deletableComputed = if (listItem.deletablePtr != 0L) {
-                    WuiComputedBool(listItem.deletablePtr)
-                } else null
-
-                items.add(ListItemData(id, listItem.contentPtr, deletableComputed))
-            }
-        }
-    }
-
-    val adapter = WuiListAdapter(context, items, env, registry)
+    val prefetcher = PhotoPrefetcher(recyclerView)
+    val adapter = WuiListAdapter(context, items, env, registry, prefetcher)
+    val handles = ListHandles(adapter, struct)
     recyclerView.adapter = adapter
+    recyclerView.setTag(TAG_LIST_HANDLES, handles)
+
+    // Setup ItemTouchHelper for swipe-to-delete and drag-to-reorder. Both
+    // directions are registered up front because a re-rendered list may add
+    // callbacks; the per-holder overrides check the current handles.
+    val touchCallback = object : ItemTouchHelper.SimpleCallback(
+        ItemTouchHelper.UP or ItemTouchHelper.DOWN,
+        ItemTouchHelper.START or ItemTouchHelper.END
+    ) {
+        override fun onMove(
+            recyclerView: RecyclerView,
+            viewHolder: RecyclerView.ViewHolder,
+            target: RecyclerView.ViewHolder
+        ): Boolean {
+            val onMovePtr = handles.onMovePtr
+            if (onMovePtr == 0L) return false
+
+            val fromPosition = viewHolder.adapterPosition
+            val toPosition = target.adapterPosition
+
+            // Update local list
+            val item = items.removeAt(fromPosition)
+            items.add(toPosition, item)
+            adapter.notifyItemMoved(fromPosition, toPosition)
+
+            // Call Rust callback
+            NativeBindings.waterui_call_move_action(
+                onMovePtr,
+                env.raw(),
+                fromPosition.toLong(),
+                toPosition.toLong()
+            )
 
-    // Setup editing state watcher if provided
-    val editingComputed = if (struct.editingPtr != 0L) {
-        WuiComputedBool(struct.editingPtr)
-    } else null
+            return true
+        }
 
-    // Setup ItemTouchHelper for swipe-to-delete and drag-to-reorder
-    val onDeletePtr = struct.onDeletePtr
-    val onMovePtr = struct.onMovePtr
+        override fun onSwiped(viewHolder: RecyclerView.ViewHolder, direction: Int) {
+            val onDeletePtr = handles.onDeletePtr
+            if (onDeletePtr == 0L) return
 
-    if (onDeletePtr != 0L || onMovePtr != 0L) {
-        val touchCallback = object : ItemTouchHelper.SimpleCallback(
-            if (onMovePtr != 0L) ItemTouchHelper.UP or ItemTouchHelper.DOWN else 0,
-            if (onDeletePtr != 0L) ItemTouchHelper.START or ItemTouchHelper.END else 0
-        ) {
-            override fun onMove(
-                recyclerView: RecyclerView,
-                viewHolder: RecyclerView.ViewHolder,
-                target: RecyclerView.ViewHolder
-            ): Boolean {
-                if (onMovePtr == 0L) return false
-
-                val fromPosition = viewHolder.adapterPosition
-                val toPosition = target.adapterPosition
-
-                // Update local list
-                val item = items.removeAt(fromPosition)
-                items.add(toPosition, item)
-                adapter.notifyItemMoved(fromPosition, toPosition)
-
-                // Call Rust callback
-                NativeBindings.waterui_call_move_action(
-                    onMovePtr,
-                    env.raw(),
-                    fromPosition.toLong(),
-                    toPosition.toLong()
-                )
-
-                return true
-            }
+            val position = viewHolder.adapterPosition
+            val item = items[position]
 
-            override fun onSwiped(viewHolder: RecyclerView.ViewHolder, direction: Int) {
-                if (onDeletePtr == 0L) return
+            // Check if item is deletable
+            val isDeletable = item.deletable?.value ?: true
+            if (!isDeletable) {
+                // Restore the item if not deletable
+                adapter.notifyItemChanged(position)
+                return
+            }
 
-                val position = viewHolder.adapterPosition
-                val item = items[position]
+            // Remove from local list
+            items.removeAt(position)
+            adapter.notifyItemRemoved(position)
 
-                // Check if item is deletable
-                val isDeletable = item.deletable?.value ?: true
-                if (!isDeletable) {
-                    // Restore the item if not deletable
-                    adapter.notifyItemChanged(position)
-                    return
-                }
+            // Call Rust callback
+            NativeBindings.waterui_call_index_action(
+                onDeletePtr,
+                env.raw(),
+                position.toLong()
+            )
+        }
 
-                // Remove from local list
-                items.removeAt(position)
-                adapter.notifyItemRemoved(position)
+        override fun getSwipeDirs(
+            recyclerView: RecyclerView,
+            viewHolder: RecyclerView.ViewHolder
+        ): Int {
+            if (handles.onDeletePtr == 0L) return 0
 
-                // Call Rust callback
-                NativeBindings.waterui_call_index_action(
-                    onDeletePtr,
-                    env.raw(),
-                    position.toLong()
-                )
-            }
+            val position = viewHolder.adapterPosition
+            if (position < 0 || position >= items.size) return 0
 
-            override fun getSwipeDirs(
-                recyclerView: RecyclerView,
-                viewHolder: RecyclerView.ViewHolder
-            ): Int {
-                if (onDeletePtr == 0L) return 0
+            val item = items[position]
+            val isDeletable = item.deletable?.value ?: true
+            return if (isDeletable) super.getSwipeDirs(recyclerView, viewHolder) else 0
+        }
 
-                val position = viewHolder.adapterPosition
-                if (position < 0 || position >= items.size) return 0
+        override fun getDragDirs(
+            recyclerView: RecyclerView,
+            viewHolder: RecyclerView.ViewHolder
+        ): Int {
+            return if (handles.onMovePtr != 0L) super.getDragDirs(recyclerView, viewHolder) else 0
+        }
 
-                val item = items[position]
-                val isDeletable = item.deletable?.value ?: true
-                return if (isDeletable) super.getSwipeDirs(recyclerView, viewHolder) else 0
-            }
+        override fun isLongPressDragEnabled(): Boolean {
+            // Only enable drag if editing mode is on or if there's no editing state
+            return handles.onMovePtr != 0L && (handles.editing?.value ?: true)
+        }
 
-            override fun isLongPressDragEnabled(): Boolean {
-                // Only enable drag if editing mode is on or if there's no editing state
-                return onMovePtr != 0L && (editingComputed?.value ?: true)
+        override fun onChildDraw(
+            c: Canvas,
+            recyclerView: RecyclerView,
+            viewHolder: RecyclerView.ViewHolder,
+            dX: Float,
+            dY: Float,
+            actionState: Int,
+            isCurrentlyActive: Boolean
+        ) {
+            // Draw red background when swiping to delete
+            if (actionState == ItemTouchHelper.ACTION_STATE_SWIPE) {
+                val itemView = viewHolder.itemView
+                val background = ColorDrawable(Color.RED)
+
+                if (dX > 0) {
+                    background.setBounds(
+                        itemView.left,
+                        itemView.top,
+                        itemView.left + dX.toInt(),
+                        itemView.bottom
+                    )
+                } else {
+                    background.setBounds(
+                        itemView.right + dX.toInt(),
+                        itemView.top,
+                        itemView.right,
+                        itemView.bottom
+                    )
+                }
+                background.draw(c)
             }
 
-            override fun onChildDraw(
-                c: Canvas,
-                recyclerView: RecyclerView,
-                viewHolder: RecyclerView.ViewHolder,
-                dX: Float,
-                dY: Float,
-                actionState: Int,
-                isCurrentlyActive: Boolean
-            ) {
-                // Draw red background when swiping to delete
-                if (actionState == ItemTouchHelper.ACTION_STATE_SWIPE) {
-                    val itemView = viewHolder.itemView
-                    val background = ColorDrawable(Color.RED)
-
-                    if (dX > 0) {
-                        background.setBounds(
-                            itemView.left,
-                            itemView.top,
-                            itemView.left + dX.toInt(),
-                            itemView.bottom
-                        )
-                    } else {
-                        background.setBounds(
-                            itemView.right + dX.toInt(),
-                            itemView.top,
-                            itemView.right,
-                            itemView.bottom
-                        )
-                    }
-                    background.draw(c)
-                }
+            super.onChildDraw(c, recyclerView, viewHolder, dX, dY, actionState, isCurrentlyActive)
+        }
+    }
+    ItemTouchHelper(touchCallback).attachToRecyclerView(recyclerView)
 
-                super.onChildDraw(c, recyclerView, viewHolder, dX, dY, actionState, isCurrentlyActive)
-            }
+    recyclerView.disposeWith {
+        handles.release()
+        // Drop deletable computeds
+        items.forEach { item ->
+            item.deletable?.dispose()
         }
+    }
+
+    recyclerView
+}
+
+/**
+ * Tag key for the [ListHandles] of a list's [RecyclerView].
+ */
+private const val TAG_LIST_HANDLES = 0x57554903 // "WUI\x03"
+
+/**
+ * Applies a re-rendered list to [view] in place when [view] is a list this
+ * renderer created: the rows are diffed against the new contents, so
+ * RecyclerView gets ranged updates and keeps its scroll position. Returns
+ * false, leaving [pointer] untouched, when the caller must inflate it.
+ */
+internal fun updateListInPlace(view: View, pointer: Long): Boolean {
+    val handles = view.getTag(TAG_LIST_HANDLES) as? ListHandles ?: return false
+    if (NativeBindings.waterui_view_id(pointer).toTypeId() != listTypeId) return false
+    handles.update(NativeBindings.waterui_force_as_list(pointer))
+    return true
+}
 
-        val touchHelper = ItemTouchHelper(touchCallback)
-        touchHelper.attachToRecyclerView(recyclerView)
+/**
+ * Native handles of the list currently shown. [update] swaps them for a
+ * re-rendered list's, submitting its contents to the adapter first.
+ */
+private class ListHandles(private val adapter: WuiListAdapter, struct: ListStruct) {
+    private var contentsPtr = 0L
+    var editing: WuiComputedBool? = null
+        private set
+    var onDeletePtr = 0L
+        private set
+    var onMovePtr = 0L
+        private set
+
+    init {
+        update(struct)
     }
 
-    recyclerView.disposeWith {
+    fun update(next: ListStruct) {
+        adapter.submit(next.contentsPtr)
+        release()
+        contentsPtr = next.contentsPtr
+        editing = if (next.editingPtr != 0L) WuiComputedBool(next.editingPtr) else null
+        onDeletePtr = next.onDeletePtr
+        onMovePtr = next.onMovePtr
+    }
+
+    fun release() {
         if (contentsPtr != 0L) {
             NativeBindings.waterui_drop_any_views(contentsPtr)
+            contentsPtr = 0L
         }
-        if (struct.editingPtr != 0L) {
-            NativeBindings.waterui_drop_binding_bool(struct.editingPtr)
-        }
+        editing?.dispose()
+        editing = null
         if (onDeletePtr != 0L) {
             NativeBindings.waterui_drop_index_action(onDeletePtr)
+            onDeletePtr = 0L
         }
         if (onMovePtr != 0L) {
             NativeBindings.waterui_drop_move_action(onMovePtr)
-        }
-        // Drop deletable computeds
-        items.forEach { item ->
-            item.deletable?.dispose()
+            onMovePtr = 0L
         }
     }
+}
 
-    recyclerView
+/**
+ * Starts decoding the photos of rows as RecyclerView binds them.
+ *
+ * RecyclerView binds the next row ahead of time while scrolling, and a row's
+ * photo sources are only known once it has been inflated, so warming up at
+ * bind time is as early as the sources can be known. Photos are prefetched at
+ * the size photos in the laid-out rows were given; until one has been laid
+ * out there is nothing to size them by and the row is left to load itself.
+ */
+private class PhotoPrefetcher(private val recyclerView: RecyclerView) {
+    private var widthPx = 0
+    private var heightPx = 0
+
+    fun onBound(row: View) {
+        val sources = mutableListOf<String>()
+        collectPhotoSources(row, sources)
+        if (sources.isEmpty()) return
+
+        val sample = (0 until recyclerView.childCount)
+            .firstNotNullOfOrNull { findLaidOutPhoto(recyclerView.getChildAt(it)) }
+        if (sample != null) {
+            widthPx = sample.width
+            heightPx = sample.height
+        }
+        if (widthPx > 0 && heightPx > 0) {
+            DecodedImageCache.prefetch(sources, widthPx, heightPx)
+        }
+    }
 }
 
 /**
@@ -225,8 +294,9 @@ private class WuiListAdapter(
     private val context: Context,
     private val items: MutableList<ListItemData>,
     private val env: WuiEnvironment,
-    private val registry: RenderRegistry
-) : RecyclerView.Adapter<WuiListAdapter.ViewHolder>() {
+    private val registry: RenderRegistry,
+    private val prefetcher: PhotoPrefetcher
+) : RecyclerView.Adapter<WuiListAdapter.ViewHolder>(), KeyedDiffListener {
 
     class ViewHolder(val container: FrameLayout) : RecyclerView.ViewHolder(container)
 
@@ -250,12 +320,103 @@ private class WuiListAdapter(
                 ViewGroup.LayoutParams.MATCH_PARENT,
                 ViewGroup.LayoutParams.WRAP_CONTENT
             ))
+            prefetcher.onBound(contentView)
         }
     }
 
     override fun getItemCount(): Int = items.size
 
     override fun getItemId(position: Int): Long = items[position].id.toLong()
+
+    /**
+     * Brings [items] in line with [contentsPtr] using the bridge's keyed diff,
+     * so RecyclerView gets ranged updates and keeps its scroll position.
+     * Retained rows come back as updates carrying their new content, since a
+     * row can keep its id while rendering differently; only bound rows are
+     * rebound. A null [contentsPtr] empties the list.
+     */
+    fun submit(contentsPtr: Long) {
+        if (contentsPtr == 0L) {
+            val count = items.size
+            items.forEach { it.deletable?.dispose() }
+            items.clear()
+            notifyItemRangeRemoved(0, count)
+            return
+        }
+        val previousIds = IntArray(items.size) { items[it].id }
+        val ops = NativeBindings.waterui_any_views_diff(contentsPtr, previousIds)
+        val count = NativeBindings.waterui_any_views_len(contentsPtr)
+
+        val views = LongArray(count)
+        val ids = IntArray(count)
+        val mask = keyedDiffPayloadMask(ops, count)
+        fetchRuns(contentsPtr, mask, true, views, ids)
+
+        // Rows without a view are kept out of the list. The diff positions
+        // assume every row is present, so rebuild the list instead.
+        if ((0 until count).any { mask[it] && views[it] == 0L }) {
+            fetchRuns(contentsPtr, mask, false, views, ids)
+            items.forEach { it.deletable?.dispose() }
+            items.clear()
+            for (position in 0 until count) {
+                if (views[position] != 0L) items.add(loadItem(ids[position], views[position]))
+            }
+            onReloaded(items.size)
+            return
+        }
+
+        items.applyKeyedDiff(
+            ops,
+            payload = { position -> loadItem(ids[position], views[position]) },
+            discard = { it.deletable?.dispose() },
+            listener = this
+        )
+    }
+
+    /**
+     * Fetches every contiguous run of positions whose [mask] entry equals
+     * [selected] with one snapshot call each.
+     */
+    private fun fetchRuns(contentsPtr: Long, mask: BooleanArray, selected: Boolean, views: LongArray, ids: IntArray) {
+        var index = 0
+        while (index < mask.size) {
+            if (mask[index] != selected) {
+                index++
+                continue
+            }
+            var end = index
+            while (end < mask.size && mask[end] == selected) end++
+            val runViews = LongArray(end - index)
+            val runIds = IntArray(end - index)
+            val written = NativeBindings.waterui_any_views_snapshot(contentsPtr, index, end - index, runViews, runIds)
+            runViews.copyInto(views, index, 0, written.coerceAtLeast(0))
+            runIds.copyInto(ids, index, 0, written.coerceAtLeast(0))
+            index = end
+        }
+    }
+
+    private fun loadItem(id: Int, viewPtr: Long): ListItemData {
+        // Get the ListItem and extract its content
+        val listItem = NativeBindings.waterui_force_as_list_item(viewPtr)
+
+        // Create deletable computed if pointer exists
+        val deletableComputed = if (listItem.deletablePtr != 0L) {
+            WuiComputedBool(listItem.deletablePtr)
+        } else null
+
+        return ListItemData(id, listItem.contentPtr, deletableComputed)
+    }
+
+    override fun onRemoved(position: Int, count: Int) = notifyItemRangeRemoved(position, count)
+
+    override fun onInserted(position: Int, count: Int) = notifyItemRangeInserted(position, count)
+
+    override fun onMoved(from: Int, to: Int) = notifyItemMoved(from, to)
+
+    override fun onUpdated(position: Int, count: Int) = notifyItemRangeChanged(position, count)
+
+    @Suppress("NotifyDataSetChanged")
+    override fun onReloaded(count: Int) = notifyDataSetChanged()
 }
 
 /**
@@ -16,6 +16,7 @@ import dev.waterui.android.runtime.NativeBindings
 import dev.waterui.android.runtime.RegistryBuilder
 import dev.waterui.android.runtime.WuiRenderer
 import dev.waterui.android.runtime.WuiTypeId
+import dev.waterui.android.runtime.disposeWith
 
 private val mediaPickerTypeId: WuiTypeId by lazy { NativeBindings.waterui_media_picker_id().toTypeId() }
 
@@ -25,6 +26,11 @@ private val mediaPickerTypeId: WuiTypeId by lazy { NativeBindings.waterui_media_
 private var currentOnSelectionPtr: Long = 0
 private var currentOnSelectionDataPtr: Long = 0
 
+/**
+ * MediaLoader owner of the picker that launched the current session.
+ */
+private var currentOwner: Int = MediaLoader.NO_OWNER
+
 /**
  * MediaPicker component renderer.
  *
@@ -38,6 +44,7 @@ private val mediaPickerRenderer = WuiRenderer { context, node, env, registry ->
 
     // Initialize MediaLoader with context
     MediaLoader.init(context)
+    val owner = MediaLoader.newOwner()
 
     // Create a Material 3 button to launch the picker
     val button = MaterialButton(context).apply {
@@ -59,12 +66,12 @@ private val mediaPickerRenderer = WuiRenderer { context, node, env, registry ->
     if (activity is ComponentActivity) {
         // Set up click listener to launch the picker
         button.setOnClickListener {
-            launchPickerFallback(activity, filterType, struct)
+            launchPickerFallback(activity, filterType, struct, owner)
         }
     } else if (activity != null) {
         // Regular Activity - use fallback
         button.setOnClickListener {
-            launchPickerFallback(activity, filterType, struct)
+            launchPickerFallback(activity, filterType, struct, owner)
         }
     } else {
         // No activity found - disable button
@@ -72,6 +79,14 @@ private val mediaPickerRenderer = WuiRenderer { context, node, env, registry ->
         button.text = "Media Picker (No Activity)"
     }
 
+    // Loads still running for this picker's selections are cancelled with it
+    button.disposeWith {
+        if (currentOwner == owner) {
+            currentOwner = MediaLoader.NO_OWNER
+        }
+        MediaLoader.release(owner)
+    }
+
     button
 }
 
@@ -81,7 +96,8 @@ private val mediaPickerRenderer = WuiRenderer { context, node, env, registry ->
 private fun launchPickerFallback(
     activity: Activity,
     filterType: MediaFilterType,
-    struct: MediaPickerStruct
+    struct: MediaPickerStruct,
+    owner: Int
 ) {
     val mimeType = when (filterType) {
         MediaFilterType.IMAGE -> "image/*"
@@ -93,6 +109,7 @@ private fun launchPickerFallback(
     // Store callback info for onActivityResult
     currentOnSelectionPtr = struct.onSelectionCallPtr()
     currentOnSelectionDataPtr = struct.onSelectionDataPtr()
+    currentOwner = owner
 
     val intent = Intent(Intent.ACTION_GET_CONTENT).apply {
         type = mimeType
@@ -126,7 +143,7 @@ fun handleMediaPickerResult(requestCode: Int, resultCode: Int, data: Intent?): B
         val mimeType = data.type
 
         // Register the URI and get ID
-        val id = MediaLoader.register(uri, mimeType)
+        val id = MediaLoader.register(uri, mimeType, currentOwner)
 
         // Notify Rust of selection
         if (currentOnSelectionPtr != 0L && currentOnSelectionDataPtr != 0L) {
@@ -137,6 +154,7 @@ fun handleMediaPickerResult(requestCode: Int, resultCode: Int, data: Intent?): B
     // Clear stored callback
     currentOnSelectionPtr = 0
     currentOnSelectionDataPtr = 0
+    currentOwner = MediaLoader.NO_OWNER
     return true
 }
 
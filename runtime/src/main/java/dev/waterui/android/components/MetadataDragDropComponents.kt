@@ -223,9 +223,13 @@ data class MetadataDropDestinationStruct(
 // ========== Registration ==========
 
 internal fun RegistryBuilder.registerWuiDraggable() {
-    registerMetadata({ metadataDraggableTypeId }, metadataDraggableRenderer)
+    registerDeferred({ metadataDraggableTypeId }, metadataDraggableRenderer, metadata = true)
 }
 
 internal fun RegistryBuilder.registerWuiDropDestination() {
-    registerMetadata({ metadataDropDestinationTypeId }, metadataDropDestinationRenderer)
+    registerDeferred(
+        { metadataDropDestinationTypeId },
+        metadataDropDestinationRenderer,
+        metadata = true
+    )
 }
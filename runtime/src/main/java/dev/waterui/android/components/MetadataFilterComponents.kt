@@ -5,429 +5,197 @@ import android.graphics.ColorMatrixColorFilter
 import android.graphics.RenderEffect
 import android.graphics.Shader
 import android.os.Build
+import android.util.Log
 import android.view.View
+import androidx.annotation.RequiresApi
 import dev.waterui.android.layout.PassThroughFrameLayout
+import dev.waterui.android.reactive.watcherAnimation
 import dev.waterui.android.runtime.AnimatedFloat
+import dev.waterui.android.runtime.MetadataChain
+import dev.waterui.android.runtime.NativeAnimator
 import dev.waterui.android.runtime.NativeBindings
 import dev.waterui.android.runtime.RegistryBuilder
 import dev.waterui.android.runtime.TAG_STRETCH_AXIS
-import dev.waterui.android.runtime.WuiAnimation
 import dev.waterui.android.runtime.WuiRenderer
 import dev.waterui.android.runtime.WuiTypeId
 import dev.waterui.android.runtime.disposeWith
 import dev.waterui.android.runtime.getWuiStretchAxis
 import dev.waterui.android.runtime.inflateAnyView
-import dev.waterui.android.runtime.withRustAnimator
 
-// ========== Blur Filter ==========
+// ========== Type IDs ==========
 
 private val metadataBlurTypeId: WuiTypeId by lazy {
     NativeBindings.waterui_metadata_blur_id().toTypeId()
 }
 
-private val metadataBlurRenderer = WuiRenderer { context, node, env, registry ->
-    val metadata = NativeBindings.waterui_force_as_metadata_blur(node.rawPtr)
-
-    val container = PassThroughFrameLayout(context)
-    var currentRadius = 0f
-
-    if (metadata.radiusPtr != 0L) {
-        currentRadius = NativeBindings.waterui_read_computed_f32(metadata.radiusPtr)
-    }
-
-    var blurAnimator: AnimatedFloat? = null
-    if (metadata.contentPtr != 0L) {
-        val child = inflateAnyView(context, metadata.contentPtr, env, registry)
-        container.addView(child)
-        container.setTag(TAG_STRETCH_AXIS, child.getWuiStretchAxis())
-        blurAnimator = AnimatedFloat(currentRadius) { radius ->
-            if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.S) {
-                val clamped = radius.coerceAtLeast(0f)
-                if (clamped > 0f) {
-                    val effect = RenderEffect.createBlurEffect(
-                        clamped, clamped,
-                        Shader.TileMode.CLAMP
-                    )
-                    child.setRenderEffect(effect)
-                } else {
-                    child.setRenderEffect(null)
-                }
-            }
-        }
-    }
-
-    fun applyBlur(animation: WuiAnimation) {
-        blurAnimator?.apply(currentRadius, animation)
-    }
-
-    applyBlur(WuiAnimation.None)
-
-    val watcherGuards = mutableListOf<Long>()
-
-    if (metadata.radiusPtr != 0L) {
-        val watcher = NativeBindings.waterui_create_float_watcher { value, watcherMetadata ->
-            currentRadius = value
-            applyBlur(watcherMetadata.animation)
-        }
-        val guard = NativeBindings.waterui_watch_computed_f32(metadata.radiusPtr, watcher)
-        if (guard != 0L) watcherGuards.add(guard)
-    }
-
-    container.disposeWith {
-        watcherGuards.forEach { NativeBindings.waterui_drop_watcher_guard(it) }
-        blurAnimator?.cancel()
-        if (metadata.radiusPtr != 0L) NativeBindings.waterui_drop_computed_f32(metadata.radiusPtr)
-    }
-
-    container
-}
-
-// ========== Opacity Filter ==========
-
 private val metadataOpacityTypeId: WuiTypeId by lazy {
     NativeBindings.waterui_metadata_opacity_id().toTypeId()
 }
 
-private val metadataOpacityRenderer = WuiRenderer { context, node, env, registry ->
-    val metadata = NativeBindings.waterui_force_as_metadata_opacity(node.rawPtr)
-
-    val container = PassThroughFrameLayout(context)
-    var currentOpacity = 1f
-
-    if (metadata.valuePtr != 0L) {
-        currentOpacity = NativeBindings.waterui_read_computed_f32(metadata.valuePtr)
-    }
-
-    var opacityAnimator: AnimatedFloat? = null
-    if (metadata.contentPtr != 0L) {
-        val child = inflateAnyView(context, metadata.contentPtr, env, registry)
-        container.addView(child)
-        container.setTag(TAG_STRETCH_AXIS, child.getWuiStretchAxis())
-        opacityAnimator = AnimatedFloat(currentOpacity) { opacity ->
-            child.alpha = opacity.coerceIn(0f, 1f)
-        }
-    }
-
-    fun applyOpacity(animation: WuiAnimation) {
-        opacityAnimator?.apply(currentOpacity, animation)
-    }
-
-    applyOpacity(WuiAnimation.None)
-
-    val watcherGuards = mutableListOf<Long>()
-
-    if (metadata.valuePtr != 0L) {
-        val watcher = NativeBindings.waterui_create_float_watcher { value, watcherMetadata ->
-            currentOpacity = value
-            applyOpacity(watcherMetadata.animation)
-        }
-        val guard = NativeBindings.waterui_watch_computed_f32(metadata.valuePtr, watcher)
-        if (guard != 0L) watcherGuards.add(guard)
-    }
-
-    container.disposeWith {
-        watcherGuards.forEach { NativeBindings.waterui_drop_watcher_guard(it) }
-        opacityAnimator?.cancel()
-        if (metadata.valuePtr != 0L) NativeBindings.waterui_drop_computed_f32(metadata.valuePtr)
-    }
-
-    container
-}
-
-// ========== Brightness Filter ==========
-
 private val metadataBrightnessTypeId: WuiTypeId by lazy {
     NativeBindings.waterui_metadata_brightness_id().toTypeId()
 }
 
-private val metadataBrightnessRenderer = WuiRenderer { context, node, env, registry ->
-    val metadata = NativeBindings.waterui_force_as_metadata_brightness(node.rawPtr)
-
-    val container = PassThroughFrameLayout(context)
-    var currentBrightness = 0f
-
-    if (metadata.amountPtr != 0L) {
-        currentBrightness = NativeBindings.waterui_read_computed_f32(metadata.amountPtr)
-    }
-
-    var brightnessAnimator: AnimatedFloat? = null
-    if (metadata.contentPtr != 0L) {
-        val child = inflateAnyView(context, metadata.contentPtr, env, registry)
-        container.addView(child)
-        container.setTag(TAG_STRETCH_AXIS, child.getWuiStretchAxis())
-        brightnessAnimator = AnimatedFloat(currentBrightness) { amount ->
-            if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.S) {
-                val brightnessValue = amount * 255f
-                val colorMatrix = ColorMatrix(floatArrayOf(
-                    1f, 0f, 0f, 0f, brightnessValue,
-                    0f, 1f, 0f, 0f, brightnessValue,
-                    0f, 0f, 1f, 0f, brightnessValue,
-                    0f, 0f, 0f, 1f, 0f
-                ))
-                val effect = RenderEffect.createColorFilterEffect(ColorMatrixColorFilter(colorMatrix))
-                child.setRenderEffect(effect)
-            }
-        }
-    }
-
-    fun applyBrightness(animation: WuiAnimation) {
-        brightnessAnimator?.apply(currentBrightness, animation)
-    }
-
-    applyBrightness(WuiAnimation.None)
-
-    val watcherGuards = mutableListOf<Long>()
-
-    if (metadata.amountPtr != 0L) {
-        val watcher = NativeBindings.waterui_create_float_watcher { value, watcherMetadata ->
-            currentBrightness = value
-            applyBrightness(watcherMetadata.animation)
-        }
-        val guard = NativeBindings.waterui_watch_computed_f32(metadata.amountPtr, watcher)
-        if (guard != 0L) watcherGuards.add(guard)
-    }
-
-    container.disposeWith {
-        watcherGuards.forEach { NativeBindings.waterui_drop_watcher_guard(it) }
-        brightnessAnimator?.cancel()
-        if (metadata.amountPtr != 0L) NativeBindings.waterui_drop_computed_f32(metadata.amountPtr)
-    }
-
-    container
-}
-
-// ========== Saturation Filter ==========
-
 private val metadataSaturationTypeId: WuiTypeId by lazy {
     NativeBindings.waterui_metadata_saturation_id().toTypeId()
 }
 
-private val metadataSaturationRenderer = WuiRenderer { context, node, env, registry ->
-    val metadata = NativeBindings.waterui_force_as_metadata_saturation(node.rawPtr)
-
-    val container = PassThroughFrameLayout(context)
-    var currentSaturation = 1f
-
-    if (metadata.amountPtr != 0L) {
-        currentSaturation = NativeBindings.waterui_read_computed_f32(metadata.amountPtr)
-    }
-
-    var saturationAnimator: AnimatedFloat? = null
-    if (metadata.contentPtr != 0L) {
-        val child = inflateAnyView(context, metadata.contentPtr, env, registry)
-        container.addView(child)
-        container.setTag(TAG_STRETCH_AXIS, child.getWuiStretchAxis())
-        saturationAnimator = AnimatedFloat(currentSaturation) { amount ->
-            if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.S) {
-                val colorMatrix = ColorMatrix()
-                colorMatrix.setSaturation(amount)
-                val effect = RenderEffect.createColorFilterEffect(ColorMatrixColorFilter(colorMatrix))
-                child.setRenderEffect(effect)
-            }
-        }
-    }
-
-    fun applySaturation(animation: WuiAnimation) {
-        saturationAnimator?.apply(currentSaturation, animation)
-    }
-
-    applySaturation(WuiAnimation.None)
-
-    val watcherGuards = mutableListOf<Long>()
-
-    if (metadata.amountPtr != 0L) {
-        val watcher = NativeBindings.waterui_create_float_watcher { value, watcherMetadata ->
-            currentSaturation = value
-            applySaturation(watcherMetadata.animation)
-        }
-        val guard = NativeBindings.waterui_watch_computed_f32(metadata.amountPtr, watcher)
-        if (guard != 0L) watcherGuards.add(guard)
-    }
-
-    container.disposeWith {
-        watcherGuards.forEach { NativeBindings.waterui_drop_watcher_guard(it) }
-        saturationAnimator?.cancel()
-        if (metadata.amountPtr != 0L) NativeBindings.waterui_drop_computed_f32(metadata.amountPtr)
-    }
-
-    container
+private val metadataContrastTypeId: WuiTypeId by lazy {
+    NativeBindings.waterui_metadata_contrast_id().toTypeId()
 }
 
-// ========== Contrast Filter ==========
+private val metadataHueRotationTypeId: WuiTypeId by lazy {
+    NativeBindings.waterui_metadata_hue_rotation_id().toTypeId()
+}
 
-private val metadataContrastTypeId: WuiTypeId by lazy {
-    NativeBindings.waterui_metadata_contrast_id().toTypeId()
+private val metadataGrayscaleTypeId: WuiTypeId by lazy {
+    NativeBindings.waterui_metadata_grayscale_id().toTypeId()
 }
 
-private val metadataContrastRenderer = WuiRenderer { context, node, env, registry ->
-    val metadata = NativeBindings.waterui_force_as_metadata_contrast(node.rawPtr)
+// ========== Filter Chain ==========
 
-    val container = PassThroughFrameLayout(context)
-    var currentContrast = 1f
+private const val TAG = "WaterUI.Filters"
 
-    if (metadata.amountPtr != 0L) {
-        currentContrast = NativeBindings.waterui_read_computed_f32(metadata.amountPtr)
-    }
+/**
+ * One filter or opacity layer of a [MetadataChain] and its current value.
+ */
+private class FilterStage(val kind: Int, val valuePtr: Long) {
+    var value: Float = if (valuePtr != 0L) NativeBindings.waterui_read_computed_f32(valuePtr) else identity(kind)
+
+    /** Smallest change of [value] worth a new frame when animated natively. */
+    val minVisibleChange: Float
+        get() = when (kind) {
+            MetadataChain.KIND_OPACITY -> NativeAnimator.MIN_VISIBLE_CHANGE_ALPHA
+            MetadataChain.KIND_BLUR, MetadataChain.KIND_HUE_ROTATION -> 0.1f
+            else -> NativeAnimator.MIN_VISIBLE_CHANGE_SCALE
+        }
 
-    var contrastAnimator: AnimatedFloat? = null
-    if (metadata.contentPtr != 0L) {
-        val child = inflateAnyView(context, metadata.contentPtr, env, registry)
-        container.addView(child)
-        container.setTag(TAG_STRETCH_AXIS, child.getWuiStretchAxis())
-        contrastAnimator = AnimatedFloat(currentContrast) { amount ->
-            if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.S) {
-                val scale = amount
+    /** This layer's effect alone, or null if it draws nothing (or is opacity). */
+    @RequiresApi(Build.VERSION_CODES.S)
+    fun renderEffect(): RenderEffect? {
+        if (kind == MetadataChain.KIND_BLUR) {
+            val radius = value.coerceAtLeast(0f)
+            return if (radius > 0f) RenderEffect.createBlurEffect(radius, radius, Shader.TileMode.CLAMP) else null
+        }
+        val colorMatrix = when (kind) {
+            MetadataChain.KIND_BRIGHTNESS -> {
+                val brightnessValue = value * 255f
+                ColorMatrix(floatArrayOf(
+                    1f, 0f, 0f, 0f, brightnessValue,
+                    0f, 1f, 0f, 0f, brightnessValue,
+                    0f, 0f, 1f, 0f, brightnessValue,
+                    0f, 0f, 0f, 1f, 0f
+                ))
+            }
+            MetadataChain.KIND_SATURATION -> ColorMatrix().apply { setSaturation(value) }
+            MetadataChain.KIND_CONTRAST -> {
+                val scale = value
                 val translate = (1f - scale) * 0.5f * 255f
-                val colorMatrix = ColorMatrix(floatArrayOf(
+                ColorMatrix(floatArrayOf(
                     scale, 0f, 0f, 0f, translate,
                     0f, scale, 0f, 0f, translate,
                     0f, 0f, scale, 0f, translate,
                     0f, 0f, 0f, 1f, 0f
                 ))
-                val effect = RenderEffect.createColorFilterEffect(ColorMatrixColorFilter(colorMatrix))
-                child.setRenderEffect(effect)
             }
-        }
-    }
-
-    fun applyContrast(animation: WuiAnimation) {
-        contrastAnimator?.apply(currentContrast, animation)
-    }
-
-    applyContrast(WuiAnimation.None)
-
-    val watcherGuards = mutableListOf<Long>()
-
-    if (metadata.amountPtr != 0L) {
-        val watcher = NativeBindings.waterui_create_float_watcher { value, watcherMetadata ->
-            currentContrast = value
-            applyContrast(watcherMetadata.animation)
-        }
-        val guard = NativeBindings.waterui_watch_computed_f32(metadata.amountPtr, watcher)
-        if (guard != 0L) watcherGuards.add(guard)
-    }
-
-    container.disposeWith {
-        watcherGuards.forEach { NativeBindings.waterui_drop_watcher_guard(it) }
-        contrastAnimator?.cancel()
-        if (metadata.amountPtr != 0L) NativeBindings.waterui_drop_computed_f32(metadata.amountPtr)
-    }
-
-    container
-}
-
-// ========== Hue Rotation Filter ==========
-
-private val metadataHueRotationTypeId: WuiTypeId by lazy {
-    NativeBindings.waterui_metadata_hue_rotation_id().toTypeId()
-}
-
-private val metadataHueRotationRenderer = WuiRenderer { context, node, env, registry ->
-    val metadata = NativeBindings.waterui_force_as_metadata_hue_rotation(node.rawPtr)
-
-    val container = PassThroughFrameLayout(context)
-    var currentAngle = 0f
-
-    if (metadata.anglePtr != 0L) {
-        currentAngle = NativeBindings.waterui_read_computed_f32(metadata.anglePtr)
-    }
-
-    var hueAnimator: AnimatedFloat? = null
-    if (metadata.contentPtr != 0L) {
-        val child = inflateAnyView(context, metadata.contentPtr, env, registry)
-        container.addView(child)
-        container.setTag(TAG_STRETCH_AXIS, child.getWuiStretchAxis())
-        hueAnimator = AnimatedFloat(currentAngle) { angle ->
-            if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.S) {
-                val colorMatrix = ColorMatrix()
-                colorMatrix.setRotate(0, angle)
-                colorMatrix.setRotate(1, angle)
-                colorMatrix.setRotate(2, angle)
-                val effect = RenderEffect.createColorFilterEffect(ColorMatrixColorFilter(colorMatrix))
-                child.setRenderEffect(effect)
+            MetadataChain.KIND_HUE_ROTATION -> ColorMatrix().apply {
+                setRotate(0, value)
+                setRotate(1, value)
+                setRotate(2, value)
             }
+            MetadataChain.KIND_GRAYSCALE -> ColorMatrix().apply { setSaturation(1f - value.coerceIn(0f, 1f)) }
+            else -> return null
         }
+        return RenderEffect.createColorFilterEffect(ColorMatrixColorFilter(colorMatrix))
     }
 
-    fun applyHueRotation(animation: WuiAnimation) {
-        hueAnimator?.apply(currentAngle, animation)
-    }
-
-    applyHueRotation(WuiAnimation.None)
-
-    val watcherGuards = mutableListOf<Long>()
-
-    if (metadata.anglePtr != 0L) {
-        val watcher = NativeBindings.waterui_create_float_watcher { value, watcherMetadata ->
-            currentAngle = value
-            applyHueRotation(watcherMetadata.animation)
+    companion object {
+        fun identity(kind: Int): Float = when (kind) {
+            MetadataChain.KIND_SATURATION, MetadataChain.KIND_CONTRAST, MetadataChain.KIND_OPACITY -> 1f
+            else -> 0f
         }
-        val guard = NativeBindings.waterui_watch_computed_f32(metadata.anglePtr, watcher)
-        if (guard != 0L) watcherGuards.add(guard)
     }
-
-    container.disposeWith {
-        watcherGuards.forEach { NativeBindings.waterui_drop_watcher_guard(it) }
-        hueAnimator?.cancel()
-        if (metadata.anglePtr != 0L) NativeBindings.waterui_drop_computed_f32(metadata.anglePtr)
-    }
-
-    container
-}
-
-// ========== Grayscale Filter ==========
-
-private val metadataGrayscaleTypeId: WuiTypeId by lazy {
-    NativeBindings.waterui_metadata_grayscale_id().toTypeId()
 }
 
-private val metadataGrayscaleRenderer = WuiRenderer { context, node, env, registry ->
-    val metadata = NativeBindings.waterui_force_as_metadata_grayscale(node.rawPtr)
-
+/**
+ * Renderer for every filter (blur, brightness, saturation, contrast, hue
+ * rotation, grayscale) and opacity modifier.
+ *
+ * The whole run of such modifiers wrapping a view is peeled in one native
+ * call, and all of them are applied to the innermost content with a single
+ * container: opacities multiply into the child's alpha and the filters chain,
+ * innermost first, into one RenderEffect. Each layer's value is animated
+ * natively when [NativeAnimator] is available, and rebuilds the effect.
+ */
+private val metadataFilterChainRenderer = WuiRenderer { context, node, env, registry ->
     val container = PassThroughFrameLayout(context)
-    var currentIntensity = 0f
-
-    if (metadata.intensityPtr != 0L) {
-        currentIntensity = NativeBindings.waterui_read_computed_f32(metadata.intensityPtr)
-    }
-
-    var grayscaleAnimator: AnimatedFloat? = null
-    if (metadata.contentPtr != 0L) {
-        val child = inflateAnyView(context, metadata.contentPtr, env, registry)
-        container.addView(child)
-        container.setTag(TAG_STRETCH_AXIS, child.getWuiStretchAxis())
-        grayscaleAnimator = AnimatedFloat(currentIntensity) { intensity ->
-            if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.S) {
-                val clamped = intensity.coerceIn(0f, 1f)
-                val colorMatrix = ColorMatrix()
-                colorMatrix.setSaturation(1f - clamped)
-                val effect = RenderEffect.createColorFilterEffect(ColorMatrixColorFilter(colorMatrix))
-                child.setRenderEffect(effect)
+    val chain = MetadataChain.peel(node.rawPtr)?.takeIf { it.size > 0 }
+    if (chain == null) {
+        Log.w(TAG, "Could not unwrap filter modifiers of ${node.typeId}")
+        return@WuiRenderer container
+    }
+    val stages = List(chain.size) { FilterStage(chain.kinds[it], chain.valuePtrs[it]) }
+
+    var child: View? = null
+    if (chain.contentPtr != 0L) {
+        val view = inflateAnyView(context, chain.contentPtr, env, registry)
+        container.addView(view)
+        container.setTag(TAG_STRETCH_AXIS, view.getWuiStretchAxis())
+        child = view
+    }
+
+    fun applyEffects() {
+        val view = child ?: return
+        var alpha = 1f
+        for (stage in stages) {
+            if (stage.kind == MetadataChain.KIND_OPACITY) alpha *= stage.value.coerceIn(0f, 1f)
+        }
+        view.alpha = alpha
+        if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.S) {
+            var effect: RenderEffect? = null
+            for (stage in stages.asReversed()) {
+                val outer = stage.renderEffect() ?: continue
+                effect = effect?.let { RenderEffect.createChainEffect(outer, it) } ?: outer
             }
+            view.setRenderEffect(effect)
         }
     }
 
-    fun applyGrayscale(animation: WuiAnimation) {
-        grayscaleAnimator?.apply(currentIntensity, animation)
-    }
-
-    applyGrayscale(WuiAnimation.None)
+    applyEffects()
 
+    val nativeBindings = mutableListOf<NativeAnimator.Binding>()
+    val animators = mutableListOf<AnimatedFloat>()
     val watcherGuards = mutableListOf<Long>()
 
-    if (metadata.intensityPtr != 0L) {
-        val watcher = NativeBindings.waterui_create_float_watcher { value, watcherMetadata ->
-            currentIntensity = value
-            applyGrayscale(watcherMetadata.animation)
+    if (child != null) {
+        for (stage in stages) {
+            if (stage.valuePtr == 0L) continue
+            val apply = { value: Float ->
+                stage.value = value
+                applyEffects()
+            }
+            val native = NativeAnimator.watch(stage.valuePtr, stage.value, stage.minVisibleChange, apply)
+            if (native != null) {
+                nativeBindings.add(native)
+                continue
+            }
+            val animator = AnimatedFloat(stage.value, apply)
+            animators.add(animator)
+            val watcher = NativeBindings.waterui_create_float_watcher { value, watcherMetadata ->
+                animator.apply(value, watcherAnimation(watcherMetadata))
+            }
+            val guard = NativeBindings.waterui_watch_computed_f32(stage.valuePtr, watcher)
+            if (guard != 0L) watcherGuards.add(guard)
         }
-        val guard = NativeBindings.waterui_watch_computed_f32(metadata.intensityPtr, watcher)
-        if (guard != 0L) watcherGuards.add(guard)
     }
 
     container.disposeWith {
+        nativeBindings.forEach { it.close() }
         watcherGuards.forEach { NativeBindings.waterui_drop_watcher_guard(it) }
-        grayscaleAnimator?.cancel()
-        if (metadata.intensityPtr != 0L) NativeBindings.waterui_drop_computed_f32(metadata.intensityPtr)
+        animators.forEach { it.cancel() }
+        stages.forEach { stage ->
+            if (stage.valuePtr != 0L) NativeBindings.waterui_drop_computed_f32(stage.valuePtr)
+        }
     }
 
     container
@@ -436,29 +204,29 @@ private val metadataGrayscaleRenderer = WuiRenderer { context, node, env, regist
 // ========== Registration Functions ==========
 
 internal fun RegistryBuilder.registerWuiBlur() {
-    registerMetadata({ metadataBlurTypeId }, metadataBlurRenderer)
+    registerMetadata({ metadataBlurTypeId }, metadataFilterChainRenderer)
 }
 
 internal fun RegistryBuilder.registerWuiOpacity() {
-    registerMetadata({ metadataOpacityTypeId }, metadataOpacityRenderer)
+    registerMetadata({ metadataOpacityTypeId }, metadataFilterChainRenderer)
 }
 
 internal fun RegistryBuilder.registerWuiBrightness() {
-    registerMetadata({ metadataBrightnessTypeId }, metadataBrightnessRenderer)
+    registerMetadata({ metadataBrightnessTypeId }, metadataFilterChainRenderer)
 }
 
 internal fun RegistryBuilder.registerWuiSaturation() {
-    registerMetadata({ metadataSaturationTypeId }, metadataSaturationRenderer)
+    registerMetadata({ metadataSaturationTypeId }, metadataFilterChainRenderer)
 }
 
 internal fun RegistryBuilder.registerWuiContrast() {
-    registerMetadata({ metadataContrastTypeId }, metadataContrastRenderer)
+    registerMetadata({ metadataContrastTypeId }, metadataFilterChainRenderer)
 }
 
 internal fun RegistryBuilder.registerWuiHueRotation() {
-    registerMetadata({ metadataHueRotationTypeId }, metadataHueRotationRenderer)
+    registerMetadata({ metadataHueRotationTypeId }, metadataFilterChainRenderer)
 }
 
 internal fun RegistryBuilder.registerWuiGrayscale() {
-    registerMetadata({ metadataGrayscaleTypeId }, metadataGrayscaleRenderer)
+    registerMetadata({ metadataGrayscaleTypeId }, metadataFilterChainRenderer)
 }
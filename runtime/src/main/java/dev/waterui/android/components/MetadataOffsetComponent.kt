@@ -5,6 +5,8 @@ import androidx.dynamicanimation.animation.DynamicAnimation
 import androidx.dynamicanimation.animation.SpringAnimation
 import androidx.dynamicanimation.animation.SpringForce
 import dev.waterui.android.layout.PassThroughFrameLayout
+import dev.waterui.android.reactive.watcherAnimation
+import dev.waterui.android.runtime.NativeAnimator
 import dev.waterui.android.runtime.NativeBindings
 import dev.waterui.android.runtime.RegistryBuilder
 import dev.waterui.android.runtime.TAG_STRETCH_AXIS
@@ -88,21 +90,30 @@ private val metadataOffsetRenderer = WuiRenderer { context, node, env, registry
 
     applyOffset(WuiAnimation.None)
 
+    val nativeOffset = childView?.let { view ->
+        val density = context.resources.displayMetrics.density
+        NativeAnimator.watchAll(
+            NativeAnimator.MIN_VISIBLE_CHANGE_DP,
+            NativeAnimator.Target(metadata.offsetXPtr, currentOffsetX) { view.translationX = it * density },
+            NativeAnimator.Target(metadata.offsetYPtr, currentOffsetY) { view.translationY = it * density }
+        )
+    }
+
     val watcherGuards = mutableListOf<Long>()
 
-    if (metadata.offsetXPtr != 0L) {
+    if (metadata.offsetXPtr != 0L && nativeOffset == null) {
         val watcher = NativeBindings.waterui_create_float_watcher { value, watcherMetadata ->
             currentOffsetX = value
-            applyOffset(watcherMetadata.animation)
+            applyOffset(watcherAnimation(watcherMetadata))
         }
         val guard = NativeBindings.waterui_watch_computed_f32(metadata.offsetXPtr, watcher)
         if (guard != 0L) watcherGuards.add(guard)
     }
 
-    if (metadata.offsetYPtr != 0L) {
+    if (metadata.offsetYPtr != 0L && nativeOffset == null) {
         val watcher = NativeBindings.waterui_create_float_watcher { value, watcherMetadata ->
             currentOffsetY = value
-            applyOffset(watcherMetadata.animation)
+            applyOffset(watcherAnimation(watcherMetadata))
         }
         val guard = NativeBindings.waterui_watch_computed_f32(metadata.offsetYPtr, watcher)
         if (guard != 0L) watcherGuards.add(guard)
@@ -111,6 +122,7 @@ private val metadataOffsetRenderer = WuiRenderer { context, node, env, registry
     container.disposeWith {
         translateXSpring?.cancel()
         translateYSpring?.cancel()
+        nativeOffset?.forEach { it.close() }
         watcherGuards.forEach { guard ->
             NativeBindings.waterui_drop_watcher_guard(guard)
         }
@@ -5,6 +5,7 @@ import androidx.dynamicanimation.animation.DynamicAnimation
 import androidx.dynamicanimation.animation.SpringAnimation
 import androidx.dynamicanimation.animation.SpringForce
 import dev.waterui.android.layout.PassThroughFrameLayout
+import dev.waterui.android.reactive.watcherAnimation
 import dev.waterui.android.runtime.NativeBindings
 import dev.waterui.android.runtime.RegistryBuilder
 import dev.waterui.android.runtime.TAG_STRETCH_AXIS
@@ -87,7 +88,7 @@ private val metadataRotationRenderer = WuiRenderer { context, node, env, registr
     if (metadata.anglePtr != 0L) {
         val watcher = NativeBindings.waterui_create_float_watcher { value, watcherMetadata ->
             currentRotation = value
-            applyRotation(watcherMetadata.animation)
+            applyRotation(watcherAnimation(watcherMetadata))
         }
         val guard = NativeBindings.waterui_watch_computed_f32(metadata.anglePtr, watcher)
         if (guard != 0L) watcherGuards.add(guard)
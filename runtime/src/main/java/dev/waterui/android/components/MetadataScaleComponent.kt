@@ -5,6 +5,8 @@ import androidx.dynamicanimation.animation.DynamicAnimation
 import androidx.dynamicanimation.animation.SpringAnimation
 import androidx.dynamicanimation.animation.SpringForce
 import dev.waterui.android.layout.PassThroughFrameLayout
+import dev.waterui.android.reactive.watcherAnimation
+import dev.waterui.android.runtime.NativeAnimator
 import dev.waterui.android.runtime.NativeBindings
 import dev.waterui.android.runtime.RegistryBuilder
 import dev.waterui.android.runtime.TAG_STRETCH_AXIS
@@ -96,21 +98,29 @@ private val metadataScaleRenderer = WuiRenderer { context, node, env, registry -
 
     applyScale(WuiAnimation.None)
 
+    val nativeScale = childView?.let { view ->
+        NativeAnimator.watchAll(
+            NativeAnimator.MIN_VISIBLE_CHANGE_SCALE,
+            NativeAnimator.Target(metadata.scaleXPtr, currentScaleX) { view.scaleX = it },
+            NativeAnimator.Target(metadata.scaleYPtr, currentScaleY) { view.scaleY = it }
+        )
+    }
+
     val watcherGuards = mutableListOf<Long>()
 
-    if (metadata.scaleXPtr != 0L) {
+    if (metadata.scaleXPtr != 0L && nativeScale == null) {
         val watcher = NativeBindings.waterui_create_float_watcher { value, watcherMetadata ->
             currentScaleX = value
-            applyScale(watcherMetadata.animation)
+            applyScale(watcherAnimation(watcherMetadata))
         }
         val guard = NativeBindings.waterui_watch_computed_f32(metadata.scaleXPtr, watcher)
         if (guard != 0L) watcherGuards.add(guard)
     }
 
-    if (metadata.scaleYPtr != 0L) {
+    if (metadata.scaleYPtr != 0L && nativeScale == null) {
         val watcher = NativeBindings.waterui_create_float_watcher { value, watcherMetadata ->
             currentScaleY = value
-            applyScale(watcherMetadata.animation)
+            applyScale(watcherAnimation(watcherMetadata))
         }
         val guard = NativeBindings.waterui_watch_computed_f32(metadata.scaleYPtr, watcher)
         if (guard != 0L) watcherGuards.add(guard)
@@ -122,6 +132,7 @@ private val metadataScaleRenderer = WuiRenderer { context, node, env, registry -
         }
         scaleXSpring?.cancel()
         scaleYSpring?.cancel()
+        nativeScale?.forEach { it.close() }
         watcherGuards.forEach { guard ->
             NativeBindings.waterui_drop_watcher_guard(guard)
         }
@@ -1,8 +1,9 @@
 package dev.waterui.android.components
 
-import android.graphics.BitmapFactory
+import android.view.View
 import android.view.ViewGroup
 import android.widget.ImageView
+import dev.waterui.android.runtime.DecodedImageCache
 import dev.waterui.android.runtime.NativeBindings
 import dev.waterui.android.runtime.RegistryBuilder
 import dev.waterui.android.runtime.WuiRenderer
@@ -12,60 +13,75 @@ import kotlinx.coroutines.CoroutineScope
 import kotlinx.coroutines.Dispatchers
 import kotlinx.coroutines.Job
 import kotlinx.coroutines.launch
-import kotlinx.coroutines.withContext
-import java.net.URL
 
 private val photoTypeId: WuiTypeId by lazy { NativeBindings.waterui_photo_id().toTypeId() }
 
+/**
+ * Tag key for the source URL of a photo view, read by list prefetching.
+ */
+private const val TAG_PHOTO_SOURCE = 0x57554904 // "WUI\x04"
+
 /**
  * Photo component renderer.
  *
  * Displays an image from a URL using Android's ImageView.
- * Loads the image asynchronously and displays it when ready.
+ * Loads the image asynchronously at the view's size through
+ * [DecodedImageCache] and displays it when ready.
  */
 private val photoRenderer = WuiRenderer { context, node, env, registry ->
     val struct = NativeBindings.waterui_force_as_photo(node.rawPtr)
 
+    DecodedImageCache.init(context)
     val imageView = object : ImageView(context) {
         private var loadJob: Job? = null
+        private var loadedKey: DecodedImageCache.Key? = null
         private val defaultSizePx: Int = 200f.dp(context).toInt()
 
         init {
+            setTag(TAG_PHOTO_SOURCE, struct.source)
             scaleType = ScaleType.FIT_CENTER
             layoutParams = ViewGroup.LayoutParams(
                 ViewGroup.LayoutParams.MATCH_PARENT,
                 ViewGroup.LayoutParams.MATCH_PARENT
             )
-
-            // Start loading the image
-            loadImage(struct.source)
         }
 
-        private fun loadImage(url: String) {
+        // Decoded at the laid-out size, through the shared cache.
+        private fun loadImage(url: String, widthPx: Int, heightPx: Int) {
+            val key = DecodedImageCache.keyFor(url, widthPx, heightPx)
+            if (key == loadedKey) return
             loadJob?.cancel()
-            loadJob = CoroutineScope(Dispatchers.IO).launch {
-                try {
-                    val connection = URL(url).openConnection()
-                    connection.connectTimeout = 10000
-                    connection.readTimeout = 10000
-                    val inputStream = connection.getInputStream()
-                    val bitmap = BitmapFactory.decodeStream(inputStream)
-                    inputStream.close()
-
-                    withContext(Dispatchers.Main) {
-                        if (bitmap != null) {
-                            setImageBitmap(bitmap)
-                            // TODO: Emit Loaded event
-                        } else {
-                            // TODO: Emit Error event
-                        }
-                    }
-                } catch (e: Exception) {
-                    // TODO: Emit Error event with message
+            DecodedImageCache.peek(key)?.let { bitmap ->
+                loadedKey = key
+                setImageBitmap(bitmap)
+                return
+            }
+            loadJob = CoroutineScope(Dispatchers.Main).launch {
+                val bitmap = DecodedImageCache.load(key)
+                if (bitmap != null) {
+                    loadedKey = key
+                    setImageBitmap(bitmap)
+                    // TODO: Emit Loaded event
+                } else {
+                    // TODO: Emit Error event
                 }
             }
         }
 
+        override fun onSizeChanged(w: Int, h: Int, oldw: Int, oldh: Int) {
+            super.onSizeChanged(w, h, oldw, oldh)
+            if (w > 0 && h > 0) {
+                loadImage(struct.source, w, h)
+            }
+        }
+
+        override fun onAttachedToWindow() {
+            super.onAttachedToWindow()
+            if (loadedKey == null && width > 0 && height > 0) {
+                loadImage(struct.source, width, height)
+            }
+        }
+
         override fun onDetachedFromWindow() {
             super.onDetachedFromWindow()
             loadJob?.cancel()
@@ -94,6 +110,27 @@ private val photoRenderer = WuiRenderer { context, node, env, registry ->
     imageView
 }
 
+/**
+ * Adds the source of every photo in [view]'s subtree to [out].
+ */
+internal fun collectPhotoSources(view: View, out: MutableList<String>) {
+    (view.getTag(TAG_PHOTO_SOURCE) as? String)?.let { out.add(it) }
+    if (view is ViewGroup) {
+        for (i in 0 until view.childCount) collectPhotoSources(view.getChildAt(i), out)
+    }
+}
+
+/**
+ * The first photo in [view]'s subtree that has been laid out, or null.
+ */
+internal fun findLaidOutPhoto(view: View): View? {
+    if (view.getTag(TAG_PHOTO_SOURCE) is String && view.width > 0 && view.height > 0) return view
+    if (view is ViewGroup) {
+        for (i in 0 until view.childCount) findLaidOutPhoto(view.getChildAt(i))?.let { return it }
+    }
+    return null
+}
+
 internal fun RegistryBuilder.registerWuiPhoto() {
-    register({ photoTypeId }, photoRenderer)
+    registerDeferred({ photoTypeId }, photoRenderer)
 }
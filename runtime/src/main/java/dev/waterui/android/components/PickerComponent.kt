@@ -9,14 +9,16 @@ import android.widget.RadioButton
 import android.widget.RadioGroup
 import android.widget.Spinner
 import dev.waterui.android.reactive.WuiBinding
-import dev.waterui.android.reactive.WuiComputed
+import dev.waterui.android.reactive.WuiPickerItemsDiff
+import dev.waterui.android.runtime.KeyedDiffListener
 import dev.waterui.android.runtime.NativeBindings
-import dev.waterui.android.runtime.PickerItemStruct
+import dev.waterui.android.runtime.PickerItemsDiffStruct
 import dev.waterui.android.runtime.RegistryBuilder
 import dev.waterui.android.runtime.WuiRenderer
 import dev.waterui.android.runtime.WuiTypeId
+import dev.waterui.android.runtime.applyKeyedDiff
 import dev.waterui.android.runtime.disposeWith
-
+import dev.waterui.android.runtime.keyedDiffPayloadMask
 import dev.waterui.android.runtime.toModel
 
 private val pickerTypeId: WuiTypeId by lazy { NativeBindings.waterui_picker_id().toTypeId() }
@@ -35,16 +37,23 @@ private object PickerStyle {
 private val pickerRenderer = WuiRenderer { context, node, env, _ ->
     val struct = NativeBindings.waterui_force_as_picker(node.rawPtr)
     val binding = WuiBinding.int(struct.selectionPtr, env)
-    val itemsComputed = WuiComputed.pickerItems(struct.itemsPtr, env)
+    val itemsComputed = WuiPickerItemsDiff(struct.itemsPtr)
 
     val options = mutableListOf<PickerOption>()
     var suppressSelectionEvent = false
 
-    fun PickerItemStruct.resolve(): PickerOption {
-        val styled = label.toModel()
-        val text = styled.toCharSequence(env)
-        styled.close()
-        return PickerOption(tag, text)
+    // Resolves the labels carried by a change set, indexed by new position.
+    fun PickerItemsDiffStruct.resolve(): Array<PickerOption?> {
+        val resolved = arrayOfNulls<PickerOption>(tags.size)
+        val mask = keyedDiffPayloadMask(ops, tags.size)
+        var next = 0
+        for (index in tags.indices) {
+            if (!mask[index]) continue
+            val styled = labels[next++].toModel()
+            resolved[index] = PickerOption(tags[index], styled.toCharSequence(env))
+            styled.close()
+        }
+        return resolved
     }
 
     when (struct.style) {
@@ -59,11 +68,11 @@ private val pickerRenderer = WuiRenderer { context, node, env, _ ->
 private fun createSpinnerPicker(
     context: Context,
     binding: WuiBinding<Int>,
-    itemsComputed: WuiComputed<List<PickerItemStruct>>,
+    itemsComputed: WuiPickerItemsDiff,
     options: MutableList<PickerOption>,
     getSuppressEvent: () -> Boolean,
     setSuppressEvent: (Boolean) -> Unit,
-    resolve: PickerItemStruct.() -> PickerOption
+    resolve: PickerItemsDiffStruct.() -> Array<PickerOption?>
 ): View {
     val spinner = Spinner(context)
     val adapter = ArrayAdapter<CharSequence>(
@@ -75,15 +84,13 @@ private fun createSpinnerPicker(
     }
     spinner.adapter = adapter
 
-    itemsComputed.observe { items ->
+    itemsComputed.observe { diff ->
         val previousSelection = binding.current()
-        options.clear()
+        val resolved = diff.resolve()
+        options.applyKeyedDiff(diff.ops, payload = { resolved[it]!! })
+        adapter.setNotifyOnChange(false)
         adapter.clear()
-        items.forEach { item ->
-            val option = item.resolve()
-            options += option
-            adapter.add(option.label)
-        }
+        adapter.addAll(options.map { it.label })
         adapter.notifyDataSetChanged()
         val index = options.indexOfFirst { it.tag == previousSelection }
         if (index >= 0) {
@@ -123,11 +130,11 @@ private fun createSpinnerPicker(
 private fun createRadioPicker(
     context: Context,
     binding: WuiBinding<Int>,
-    itemsComputed: WuiComputed<List<PickerItemStruct>>,
+    itemsComputed: WuiPickerItemsDiff,
     options: MutableList<PickerOption>,
     getSuppressEvent: () -> Boolean,
     setSuppressEvent: (Boolean) -> Unit,
-    resolve: PickerItemStruct.() -> PickerOption
+    resolve: PickerItemsDiffStruct.() -> Array<PickerOption?>
 ): View {
     val radioGroup = RadioGroup(context).apply {
         orientation = LinearLayout.VERTICAL
@@ -136,30 +143,61 @@ private fun createRadioPicker(
     // Map from option tag to radio button ID
     val tagToButtonId = mutableMapOf<Int, Int>()
 
-    itemsComputed.observe { items ->
-        val previousSelection = binding.current()
-        options.clear()
-        radioGroup.removeAllViews()
-        tagToButtonId.clear()
-
-        items.forEachIndexed { index, item ->
-            val option = item.resolve()
-            options += option
-
-            val radioButton = RadioButton(context).apply {
-                id = View.generateViewId()
-                text = option.label
-                tag = option.tag
-            }
-            tagToButtonId[option.tag] = radioButton.id
-            radioGroup.addView(radioButton)
+    fun addButton(position: Int) {
+        val option = options[position]
+        val radioButton = RadioButton(context).apply {
+            id = View.generateViewId()
+            text = option.label
+            tag = option.tag
+        }
+        tagToButtonId[option.tag] = radioButton.id
+        radioGroup.addView(radioButton, position)
+    }
+
+    fun removeButtons(position: Int, count: Int) {
+        for (index in position until position + count) {
+            (radioGroup.getChildAt(index)?.tag as? Int)?.let(tagToButtonId::remove)
+        }
+        radioGroup.removeViews(position, count)
+    }
+
+    // Mirrors each change onto the radio buttons instead of rebuilding them.
+    val buttonUpdater = object : KeyedDiffListener {
+        override fun onRemoved(position: Int, count: Int) = removeButtons(position, count)
+
+        override fun onInserted(position: Int, count: Int) {
+            for (index in position until position + count) addButton(index)
+        }
 
-            // Restore selection if this was the previously selected item
-            if (option.tag == previousSelection) {
-                setSuppressEvent(true)
-                radioButton.isChecked = true
+        override fun onMoved(from: Int, to: Int) {
+            val button = radioGroup.getChildAt(from)
+            radioGroup.removeViewAt(from)
+            radioGroup.addView(button, to)
+        }
+
+        override fun onUpdated(position: Int, count: Int) {
+            for (index in position until position + count) {
+                (radioGroup.getChildAt(index) as? RadioButton)?.text = options[index].label
             }
         }
+
+        override fun onReloaded(count: Int) {
+            removeButtons(0, radioGroup.childCount)
+            for (index in 0 until count) addButton(index)
+        }
+    }
+
+    itemsComputed.observe { diff ->
+        val previousSelection = binding.current()
+        val resolved = diff.resolve()
+        options.applyKeyedDiff(diff.ops, payload = { resolved[it]!! }, listener = buttonUpdater)
+
+        // Restore selection if the previously selected item is (still) present
+        val buttonId = tagToButtonId[previousSelection]
+        if (buttonId != null && radioGroup.checkedRadioButtonId != buttonId) {
+            setSuppressEvent(true)
+            radioGroup.check(buttonId)
+        }
     }
 
     binding.observe { value ->
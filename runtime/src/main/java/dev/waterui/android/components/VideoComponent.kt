@@ -71,5 +71,5 @@ private val videoRenderer = WuiRenderer { context, node, env, registry ->
 }
 
 internal fun RegistryBuilder.registerWuiVideo() {
-    register({ videoTypeId }, videoRenderer)
+    registerDeferred({ videoTypeId }, videoRenderer)
 }
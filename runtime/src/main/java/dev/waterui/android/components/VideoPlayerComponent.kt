@@ -68,5 +68,5 @@ private val videoPlayerRenderer = WuiRenderer { context, node, env, registry ->
 }
 
 internal fun RegistryBuilder.registerWuiVideoPlayer() {
-    register({ videoPlayerTypeId }, videoPlayerRenderer)
+    registerDeferred({ videoPlayerTypeId }, videoPlayerRenderer)
 }
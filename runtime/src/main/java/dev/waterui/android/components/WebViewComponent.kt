@@ -5,6 +5,7 @@ import android.content.Context
 import android.graphics.Bitmap
 import android.net.http.SslError
 import android.os.Build
+import android.os.Handler
 import android.os.Looper
 import android.view.ViewGroup
 import android.widget.TextView
@@ -21,6 +22,10 @@ import dev.waterui.android.runtime.WuiRenderer
 import dev.waterui.android.runtime.WuiTypeId
 import dev.waterui.android.runtime.disposeWith
 import java.lang.ref.WeakReference
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+import java.nio.CharBuffer
+import java.nio.charset.CodingErrorAction
 import java.nio.charset.StandardCharsets
 import org.json.JSONTokener
 
@@ -76,7 +81,31 @@ interface JsResultCallback {
     fun onResult(success: Boolean, result: String)
 }
 
+/**
+ * Forwards events to the native watcher in batches.
+ *
+ * Events are encoded into a direct buffer and delivered with one JNI call per
+ * main-looper turn, or sooner once [FLUSH_BYTES] are pending, instead of one
+ * call (and three string conversions) per event. A progress event replaces a
+ * progress event still pending, and a state change matching the pending one
+ * is dropped, so a page streaming progress does not flood the bridge.
+ * Called on the main thread only.
+ */
 internal class NativeWebViewEventCallback(private val nativePtr: Long) : WebViewEventCallback {
+    private var buffer: ByteBuffer = ByteBuffer.allocateDirect(INITIAL_CAPACITY).order(ByteOrder.nativeOrder())
+    private val encoder = StandardCharsets.UTF_8.newEncoder()
+        .onMalformedInput(CodingErrorAction.REPLACE)
+        .onUnmappableCharacter(CodingErrorAction.REPLACE)
+    private val handler = Handler(Looper.getMainLooper())
+    private val flushTask = Runnable { flush() }
+    private var flushPosted = false
+    private var closed = false
+
+    // Offset and type of the last pending record, for coalescing.
+    private var lastOffset = -1
+    private var lastType = -1
+    private var lastFlags = 0
+
     override fun onEvent(
         eventType: Int,
         url: String,
@@ -86,19 +115,93 @@ internal class NativeWebViewEventCallback(private val nativePtr: Long) : WebView
         canGoBack: Boolean,
         canGoForward: Boolean
     ) {
-        nativeOnEvent(nativePtr, eventType, url, url2, message, progress, canGoBack, canGoForward)
+        if (closed) return
+        val flags = (if (canGoBack) CAN_GO_BACK else 0) or (if (canGoForward) CAN_GO_FORWARD else 0)
+        if (lastOffset >= 0 && eventType == lastType) {
+            if (eventType == WebViewEventType.LOADING.value) {
+                buffer.putFloat(lastOffset + 4, progress)
+                buffer.putInt(lastOffset + 8, flags)
+                lastFlags = flags
+                return
+            }
+            if (eventType == WebViewEventType.STATE_CHANGED.value && flags == lastFlags) {
+                return
+            }
+        }
+
+        ensureCapacity(HEADER_SIZE + (url.length + url2.length + message.length) * 3 + 3)
+        val offset = buffer.position()
+        buffer.position(offset + HEADER_SIZE)
+        val urlLen = encode(url)
+        val url2Len = encode(url2)
+        val messageLen = encode(message)
+        buffer.putInt(offset, eventType)
+        buffer.putFloat(offset + 4, progress)
+        buffer.putInt(offset + 8, flags)
+        buffer.putInt(offset + 12, urlLen)
+        buffer.putInt(offset + 16, url2Len)
+        buffer.putInt(offset + 20, messageLen)
+        buffer.position((buffer.position() + 3) and 3.inv())
+        lastOffset = offset
+        lastType = eventType
+        lastFlags = flags
+
+        if (buffer.position() >= FLUSH_BYTES) {
+            flush()
+        } else if (!flushPosted) {
+            flushPosted = true
+            handler.post(flushTask)
+        }
     }
 
-    private external fun nativeOnEvent(
-        nativePtr: Long,
-        eventType: Int,
-        url: String,
-        url2: String,
-        message: String,
-        progress: Float,
-        canGoBack: Boolean,
-        canGoForward: Boolean
-    )
+    /** Delivers pending events now. */
+    fun flush() {
+        handler.removeCallbacks(flushTask)
+        flushPosted = false
+        val length = buffer.position()
+        lastOffset = -1
+        lastType = -1
+        if (length == 0 || closed) return
+        nativeOnEvents(nativePtr, buffer, length)
+        buffer.clear()
+    }
+
+    /** Drops pending events; the native watcher is going away. */
+    fun close() {
+        closed = true
+        handler.removeCallbacks(flushTask)
+        buffer.clear()
+    }
+
+    private fun encode(value: String): Int {
+        val start = buffer.position()
+        if (value.isNotEmpty()) {
+            encoder.reset()
+            encoder.encode(CharBuffer.wrap(value), buffer, true)
+            encoder.flush(buffer)
+        }
+        return buffer.position() - start
+    }
+
+    private fun ensureCapacity(extra: Int) {
+        if (buffer.remaining() >= extra) return
+        val grown = ByteBuffer.allocateDirect(Integer.highestOneBit(buffer.position() + extra) shl 1)
+            .order(ByteOrder.nativeOrder())
+        buffer.flip()
+        grown.put(buffer)
+        buffer = grown
+    }
+
+    private external fun nativeOnEvents(nativePtr: Long, buffer: ByteBuffer, length: Int)
+
+    private companion object {
+        /** Record header; mirrors kWebViewEventHeaderSize in waterui_jni.cpp. */
+        const val HEADER_SIZE = 24
+        const val CAN_GO_BACK = 1
+        const val CAN_GO_FORWARD = 2
+        const val INITIAL_CAPACITY = 4096
+        const val FLUSH_BYTES = 64 * 1024
+    }
 }
 
 object WebViewManager {
@@ -225,7 +328,10 @@ class WebViewWrapper(context: Context) {
     // ========== Event Watching ==========
 
     fun setEventCallback(callback: WebViewEventCallback?) {
-        runOnUiThread { eventCallback = callback }
+        runOnUiThread {
+            (eventCallback as? NativeWebViewEventCallback)?.close()
+            eventCallback = callback
+        }
     }
 
     private fun emitEvent(
@@ -270,10 +376,13 @@ class WebViewWrapper(context: Context) {
         }
     }
 
-    fun runJavaScript(script: String, callbackData: Long, callbackFn: Long) {
+    /** Runs [script] for native code; [token] names the pending native callback. */
+    fun runJavaScript(script: String, token: Long) {
         runJavaScript(script, object : JsResultCallback {
             override fun onResult(success: Boolean, result: String) {
-                nativeCompleteJsResult(callbackData, callbackFn, success, result)
+                // Events emitted before the result must reach the watcher first
+                (eventCallback as? NativeWebViewEventCallback)?.flush()
+                nativeCompleteJsResult(token, success, result)
             }
         })
     }
@@ -314,6 +423,26 @@ class WebViewWrapper(context: Context) {
         }
     }
 
+    /**
+     * Called by native code when Rust drops the handle. The event callback is closed
+     * and the WebView released on the main thread before [nativePtr] is freed, so a
+     * flush already queued there never sees a freed handle. Posts to the main looper
+     * rather than the view, which never runs its queue once detached.
+     */
+    fun dispose(nativePtr: Long) {
+        val action = {
+            (eventCallback as? NativeWebViewEventCallback)?.close()
+            eventCallback = null
+            release()
+            nativeDisposeHandle(nativePtr)
+        }
+        if (Looper.myLooper() == Looper.getMainLooper()) {
+            action()
+        } else {
+            Handler(Looper.getMainLooper()).post(action)
+        }
+    }
+
     private fun runOnUiThread(action: () -> Unit) {
         if (Looper.myLooper() == Looper.getMainLooper()) {
             action()
@@ -453,9 +582,10 @@ class WebViewWrapper(context: Context) {
         }
     }
 
+    private external fun nativeDisposeHandle(nativePtr: Long)
+
     private external fun nativeCompleteJsResult(
-        callbackData: Long,
-        callbackFn: Long,
+        token: Long,
         success: Boolean,
         result: String
     )
@@ -483,5 +613,5 @@ private val webViewRenderer = WuiRenderer { context, node, _, _ ->
 }
 
 internal fun RegistryBuilder.registerWuiWebView() {
-    register({ webViewTypeId }, webViewRenderer)
+    registerDeferred({ webViewTypeId }, webViewRenderer)
 }
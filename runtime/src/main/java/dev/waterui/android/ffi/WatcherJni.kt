@@ -1,5 +1,9 @@
 package dev.waterui.android.ffi
 
+import dev.waterui.android.reactive.BoolWatcherCallback
+import dev.waterui.android.reactive.DoubleWatcherCallback
+import dev.waterui.android.reactive.FloatWatcherCallback
+import dev.waterui.android.reactive.IntWatcherCallback
 import dev.waterui.android.reactive.WatcherCallback
 import dev.waterui.android.runtime.*
 
@@ -19,6 +23,15 @@ object WatcherJni {
     @JvmStatic
     private external fun nativeInit()
 
+    /**
+     * Sets the prefix used to name unnamed native threads ("<prefix>-<tid>") when
+     * they are first attached to the JVM, so they are identifiable in traces.
+     */
+    @JvmStatic external fun setNativeThreadNamePrefix(prefix: String)
+
+    /** Drains the native watcher dispatch queue; see [dev.waterui.android.reactive.WatcherDispatcher]. */
+    @JvmStatic external fun flushWatcherQueue()
+
     // ========== Core Functions ==========
 
     @JvmStatic external fun init(): Long
@@ -28,6 +41,12 @@ object WatcherJni {
     @JvmStatic external fun viewBody(viewPtr: Long, envPtr: Long): Long
     @JvmStatic external fun viewId(viewPtr: Long): dev.waterui.android.runtime.TypeIdStruct
     @JvmStatic external fun viewStretchAxis(viewPtr: Long): Int
+    @JvmStatic external fun viewTypeSetCreate(ids: LongArray, flags: IntArray): Long
+    @JvmStatic external fun resolveViews(typeSet: Long, views: LongArray, envPtr: Long, out: java.nio.ByteBuffer): Int
+    @JvmStatic external fun peelMetadataChain(viewPtr: Long, out: java.nio.ByteBuffer): Int
+    @JvmStatic external fun componentKindCount(): Int
+    @JvmStatic external fun typeIdKind(low: Long, high: Long): Int
+    @JvmStatic external fun viewKind(viewPtr: Long): Int
     @JvmStatic external fun cloneEnv(envPtr: Long): Long
     @JvmStatic external fun dropEnv(envPtr: Long)
     @JvmStatic external fun dropAnyview(viewPtr: Long)
@@ -117,6 +136,12 @@ object WatcherJni {
     @JvmStatic external fun resolveFont(fontPtr: Long, envPtr: Long): Long
     @JvmStatic external fun dropWatcherGuard(guardPtr: Long)
 
+    /**
+     * Report of live bridge handles per kind and creating function, or null
+     * unless the library was built with -Pwaterui.handleTracking=true.
+     */
+    @JvmStatic external fun handleTrackerDump(): String?
+
     // ========== Animation Functions ==========
 
     /** Get animation tag from metadata (matches WuiAnimation_Tag enum values) */
@@ -131,6 +156,13 @@ object WatcherJni {
     /** Get spring damping (for spring animations) */
     @JvmStatic external fun getAnimationDamping(metadataPtr: Long): Float
 
+    // ========== Native Animation Engine ==========
+
+    @JvmStatic external fun animatorInit(buffer: java.nio.ByteBuffer, capacity: Int): Boolean
+    @JvmStatic external fun animatorOpenSlot(initial: Float, minVisibleChange: Float): Int
+    @JvmStatic external fun animatorCloseSlot(slot: Int)
+    @JvmStatic external fun createAnimatedFloatWatcher(slot: Int): WatcherStruct?
+
     /** Legacy: Get animation type as int (deprecated, use getAnimationTag instead) */
     @Deprecated("Use getAnimationTag instead for full animation support")
     @JvmStatic external fun getAnimation(metadataPtr: Long): Int
@@ -140,6 +172,9 @@ object WatcherJni {
     @JvmStatic external fun anyViewsLen(handle: Long): Int
     @JvmStatic external fun anyViewsGetView(handle: Long, index: Int): Long
     @JvmStatic external fun anyViewsGetId(handle: Long, index: Int): Int
+    @JvmStatic external fun anyViewsDiff(handle: Long, previousIds: IntArray): IntArray
+    @JvmStatic external fun anyViewsSnapshot(handle: Long, start: Int, count: Int, outViews: LongArray, outIds: IntArray?): Int
+    @JvmStatic external fun anyViewsSnapshotDirect(handle: Long, start: Int, count: Int, out: java.nio.ByteBuffer): Int
     @JvmStatic external fun dropAnyViews(handle: Long)
 
     // ========== Binding Read/Write/Drop ==========
@@ -154,6 +189,8 @@ object WatcherJni {
     @JvmStatic external fun setBindingDouble(bindingPtr: Long, value: Double)
     @JvmStatic external fun setBindingStr(bindingPtr: Long, bytes: ByteArray)
     @JvmStatic external fun setBindingSecure(bindingPtr: Long, bytes: ByteArray)
+    @JvmStatic external fun setBindingStrDirect(bindingPtr: Long, buffer: java.nio.ByteBuffer, length: Int)
+    @JvmStatic external fun setBindingSecureDirect(bindingPtr: Long, buffer: java.nio.ByteBuffer, length: Int)
     @JvmStatic external fun setBindingColor(bindingPtr: Long, colorPtr: Long)
     @JvmStatic external fun dropBindingBool(bindingPtr: Long)
     @JvmStatic external fun dropBindingInt(bindingPtr: Long)
@@ -177,7 +214,9 @@ object WatcherJni {
     @JvmStatic external fun readComputedResolvedColor(computedPtr: Long): ResolvedColorStruct
     @JvmStatic external fun readComputedResolvedFont(computedPtr: Long): ResolvedFontStruct
     @JvmStatic external fun readComputedStyledStr(computedPtr: Long): StyledStrStruct
+    @JvmStatic external fun readComputedStyledStrFlat(computedPtr: Long): FlatStyledStrStruct
     @JvmStatic external fun readComputedPickerItems(computedPtr: Long): Array<PickerItemStruct>
+    @JvmStatic external fun snapshotPickerItemsDiff(computedPtr: Long, watcherData: Long): PickerItemsDiffStruct?
     @JvmStatic external fun readComputedColorScheme(computedPtr: Long): Int
     @JvmStatic external fun readComputedColor(computedPtr: Long): Long
     @JvmStatic external fun dropComputedColor(computedPtr: Long)
@@ -192,17 +231,19 @@ object WatcherJni {
 
     // ========== Watcher Creation ==========
 
-    @JvmStatic external fun createBoolWatcher(callback: WatcherCallback<Boolean>): WatcherStruct
-    @JvmStatic external fun createIntWatcher(callback: WatcherCallback<Int>): WatcherStruct
-    @JvmStatic external fun createDoubleWatcher(callback: WatcherCallback<Double>): WatcherStruct
-    @JvmStatic external fun createFloatWatcher(callback: WatcherCallback<Float>): WatcherStruct
+    @JvmStatic external fun createBoolWatcher(callback: BoolWatcherCallback): WatcherStruct
+    @JvmStatic external fun createIntWatcher(callback: IntWatcherCallback): WatcherStruct
+    @JvmStatic external fun createDoubleWatcher(callback: DoubleWatcherCallback): WatcherStruct
+    @JvmStatic external fun createFloatWatcher(callback: FloatWatcherCallback): WatcherStruct
     @JvmStatic external fun createStringWatcher(callback: WatcherCallback<String>): WatcherStruct
     @JvmStatic external fun createVideoWatcher(callback: WatcherCallback<VideoStruct>): WatcherStruct
     @JvmStatic external fun createAnyViewWatcher(callback: WatcherCallback<Long>): WatcherStruct
     @JvmStatic external fun createStyledStrWatcher(callback: WatcherCallback<StyledStrStruct>): WatcherStruct
+    @JvmStatic external fun createFlatStyledStrWatcher(callback: WatcherCallback<FlatStyledStrStruct>): WatcherStruct
     @JvmStatic external fun createResolvedColorWatcher(callback: WatcherCallback<ResolvedColorStruct>): WatcherStruct
     @JvmStatic external fun createResolvedFontWatcher(callback: WatcherCallback<ResolvedFontStruct>): WatcherStruct
     @JvmStatic external fun createPickerItemsWatcher(callback: WatcherCallback<Array<PickerItemStruct>>): WatcherStruct
+    @JvmStatic external fun createPickerItemsDiffWatcher(callback: WatcherCallback<PickerItemsDiffStruct>): WatcherStruct
 
     // ========== Watch Binding ==========
 
@@ -264,6 +305,23 @@ object WatcherJni {
     @JvmStatic external fun themeInstallColor(envPtr: Long, slot: Int, signalPtr: Long)
     @JvmStatic external fun themeInstallFont(envPtr: Long, slot: Int, signalPtr: Long)
     @JvmStatic external fun themeInstallColorScheme(envPtr: Long, signalPtr: Long)
+    @JvmStatic external fun themeInstallPalette(
+        envPtr: Long,
+        scheme: Int,
+        colorSlots: IntArray,
+        argb: IntArray,
+        fontSlots: IntArray,
+        fontSizes: FloatArray,
+        fontWeights: IntArray
+    ): Long
+    @JvmStatic external fun themeUpdatePalette(
+        palettePtr: Long,
+        scheme: Int,
+        argb: IntArray,
+        fontSizes: FloatArray,
+        fontWeights: IntArray
+    )
+    @JvmStatic external fun themeDropPalette(palettePtr: Long)
     @JvmStatic external fun themeColor(envPtr: Long, slot: Int): Long
     @JvmStatic external fun themeFont(envPtr: Long, slot: Int): Long
     @JvmStatic external fun themeColorScheme(envPtr: Long): Long
@@ -273,6 +331,65 @@ object WatcherJni {
 
     @JvmStatic external fun layoutSizeThatFits(layoutPtr: Long, proposal: ProposalStruct, subviews: Array<SubViewStruct>): SizeStruct
     @JvmStatic external fun layoutPlace(layoutPtr: Long, bounds: RectStruct, subviews: Array<SubViewStruct>): Array<RectStruct>
+    @JvmStatic external fun layoutSizeThatFitsBulk(
+        layoutPtr: Long,
+        cacheToken: Long,
+        generation: Int,
+        proposalWidth: Float,
+        proposalHeight: Float,
+        childInfo: IntArray,
+        measurements: FloatArray,
+        entriesPerChild: Int,
+        measurer: SubViewMeasurer?,
+        outSize: FloatArray
+    ): Boolean
+    @JvmStatic external fun layoutPlaceBulk(
+        layoutPtr: Long,
+        cacheToken: Long,
+        generation: Int,
+        x: Float,
+        y: Float,
+        width: Float,
+        height: Float,
+        childInfo: IntArray,
+        measurements: FloatArray,
+        entriesPerChild: Int,
+        measurer: SubViewMeasurer?,
+        outPlacements: FloatArray
+    ): Int
+    @JvmStatic external fun layoutCachedSize(
+        cacheToken: Long,
+        generation: Int,
+        proposalWidth: Float,
+        proposalHeight: Float,
+        outSize: FloatArray
+    ): Boolean
+    @JvmStatic external fun layoutCachedPlacements(
+        cacheToken: Long,
+        generation: Int,
+        width: Float,
+        height: Float,
+        outPlacements: FloatArray
+    ): Int
+    @JvmStatic external fun releaseLayoutCache(cacheToken: Long)
+    @JvmStatic external fun layoutSizeThatFitsSnapshot(
+        layoutPtr: Long,
+        proposalWidth: Float,
+        proposalHeight: Float,
+        childInfo: IntArray,
+        measurements: FloatArray,
+        entriesPerChild: Int,
+        outSize: FloatArray
+    ): Int
+    @JvmStatic external fun layoutPlaceSnapshot(
+        layoutPtr: Long,
+        width: Float,
+        height: Float,
+        childInfo: IntArray,
+        measurements: FloatArray,
+        entriesPerChild: Int,
+        outPlacements: FloatArray
+    ): Int
 
     // ========== Type ID Functions ==========
 
@@ -372,7 +489,7 @@ object WatcherJni {
     @JvmStatic external fun readComputedCursorStyle(computedPtr: Long): Int
     @JvmStatic external fun watchComputedCursorStyle(computedPtr: Long, watcher: WatcherStruct): Long
     @JvmStatic external fun dropComputedCursorStyle(computedPtr: Long)
-    @JvmStatic external fun createCursorStyleWatcher(callback: WatcherCallback<Int>): WatcherStruct
+    @JvmStatic external fun createCursorStyleWatcher(callback: IntWatcherCallback): WatcherStruct
 
     // ========== Retain Functions ==========
 
@@ -385,6 +502,11 @@ object WatcherJni {
     @JvmStatic external fun gpuSurfaceInit(rendererPtr: Long, surface: android.view.Surface, width: Int, height: Int): Long
     @JvmStatic external fun gpuSurfaceRender(statePtr: Long, width: Int, height: Int): Boolean
     @JvmStatic external fun gpuSurfaceDrop(statePtr: Long)
+    @JvmStatic external fun gpuSurfaceStartDriver(rendererPtr: Long, surface: android.view.Surface, width: Int, height: Int): Long
+    @JvmStatic external fun gpuSurfaceDriverResize(driverPtr: Long, width: Int, height: Int)
+    @JvmStatic external fun gpuSurfaceDriverSetPaused(driverPtr: Long, paused: Boolean)
+    @JvmStatic external fun gpuSurfaceStopDriver(driverPtr: Long)
+    @JvmStatic external fun gpuSurfaceStats(driverPtr: Long, out: LongArray): Int
 
     // ========== WebView Functions ==========
     @JvmStatic external fun webviewNativeHandle(webviewPtr: Long): Long
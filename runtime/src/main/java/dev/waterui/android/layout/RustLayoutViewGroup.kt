@@ -10,8 +10,15 @@ import dev.waterui.android.runtime.NativeBindings
 import dev.waterui.android.runtime.ProposalStruct
 import dev.waterui.android.runtime.RectStruct
 import dev.waterui.android.runtime.StretchAxis
-import dev.waterui.android.runtime.SubViewStruct
+import dev.waterui.android.runtime.SubViewMeasurer
 import dev.waterui.android.runtime.WuiTypeId
+import dev.waterui.android.runtime.packSize
+import dev.waterui.android.runtime.proposalToMeasureSpec
+import java.util.concurrent.ExecutorService
+import java.util.concurrent.Executors
+import java.util.concurrent.atomic.AtomicLong
+import java.util.concurrent.locks.ReentrantLock
+import kotlin.concurrent.withLock
 import kotlin.math.roundToInt
 
 /**
@@ -21,6 +28,26 @@ import kotlin.math.roundToInt
  * Uses the new 2-phase layout system:
  * 1. `size_that_fits` - Rust calls back to measure children as needed
  * 2. `place` - Returns final positions for all children
+ *
+ * Children cross JNI in one batch through the bulk entry points: child metadata
+ * and pre-measured sizes are passed as flat arrays and placements are written
+ * into a reused [FloatArray], so no per-child Java objects are allocated.
+ *
+ * With [asyncLayout], only the first pass runs on the UI thread. Later passes
+ * snapshot the measurement table, re-measuring only the children that requested
+ * layout (at the proposals the previous synchronous pass probed), and compute
+ * the Rust layout on a background thread while the previous layout stays on
+ * screen; the result is applied when it arrives. Meanwhile the group reports
+ * its previous size resolved against the new constraints, and the UI thread
+ * never waits for the background pass: it only takes [layoutLock] when it is
+ * free. A layout that probed a proposal the snapshot did not hold is discarded
+ * and redone synchronously, which records the new probes.
+ *
+ * The group owns [layoutPtr]. `waterui_force_as_layout_container` and
+ * `waterui_force_as_fixed_container` consume their AnyView and hand its layout
+ * to the caller, and the container renderers pass it on to this group without
+ * keeping a copy, so nothing else can drop it. [releaseLayout] drops it, and
+ * the native results cached under [cacheToken], when the group is disposed.
  */
 class RustLayoutViewGroup @JvmOverloads constructor(
     context: Context,
@@ -49,48 +76,328 @@ class RustLayoutViewGroup @JvmOverloads constructor(
      */
     private fun Float.pxToDp(): Float = this / density
 
+    /** Per child: `[stretchAxis, priority]`. */
+    private var childInfo = IntArray(0)
+
+    /**
+     * Per child, [ENTRIES_PER_CHILD] entries of `[proposalWidth, proposalHeight, width, height]` in dp.
+     * Entry 0 is the unspecified probe taken in [onMeasure]; the rest hold the
+     * last [PROBE_SLOTS] fallback probes, so [onLayout] can answer them natively
+     * and background passes know which proposals to snapshot.
+     */
+    private var measurements = FloatArray(0)
+
+    /** Per child: fallback probes recorded since the last synchronous [prepareChildren]. */
+    private var probeCounts = IntArray(0)
+
+    /** Per child: `[x, y, width, height]` in dp, written by native code. */
+    private var placements = FloatArray(0)
+
+    private val measuredSize = FloatArray(2)
+
+    /**
+     * Compute layouts off the UI thread (see the class docs). Suits containers
+     * whose layout probes the same proposals from frame to frame, such as
+     * stacks of nested Rust layouts; the container renderers enable it there.
+     */
+    var asyncLayout: Boolean = false
+
+    /**
+     * Native layout calls take this lock: the layout may be busy on [layoutExecutor].
+     * The UI thread only ever [tryLock][ReentrantLock.tryLock]s it.
+     */
+    private val layoutLock = ReentrantLock()
+
+    /**
+     * Bumped whenever a child requests layout; results for older generations
+     * are stale, both here and in the native layout result cache.
+     */
+    private var generation = 0
+
+    /** Keys this group's native result cache; unlike [layoutPtr], never reused. */
+    private val cacheToken = nextCacheToken.getAndIncrement()
+
+    /** Set once [releaseLayout] has dropped [layoutPtr]; later passes are no-ops. */
+    private var released = false
+
+    /** Set while applying a background result, whose requestLayout must not bump [generation]. */
+    private var publishing = false
+
+    /** The layout computed in the background, applied by the next matching pass. */
+    private var precomputed: PrecomputedLayout? = null
+
+    /** The pass a background computation is running for, if any. */
+    private var pendingSpec: PrecomputedLayout? = null
+
+    /** Forces the next pass onto the UI thread after a snapshot was not exact. */
+    private var forceSync = false
+
+    /** Set when a synchronous pass found [layoutLock] busy; the background pass's end redoes it. */
+    private var skippedSync = false
+
+    private val measurer = SubViewMeasurer { index, proposalWidth, proposalHeight ->
+        val child = getChildAt(index)
+        child.measure(
+            proposalToMeasureSpec(proposalWidth * density),
+            proposalToMeasureSpec(proposalHeight * density)
+        )
+        val width = child.measuredWidth.toFloat().pxToDp()
+        val height = child.measuredHeight.toFloat().pxToDp()
+        if (index < probeCounts.size) {
+            val slot = probeCounts[index]++ % PROBE_SLOTS
+            storeMeasurement(index, 1 + slot, proposalWidth, proposalHeight, width, height)
+        }
+        packSize(width, height)
+    }
+
+    private fun storeMeasurement(index: Int, entry: Int, proposalWidth: Float, proposalHeight: Float, width: Float, height: Float) {
+        val base = (index * ENTRIES_PER_CHILD + entry) * 4
+        measurements[base] = proposalWidth
+        measurements[base + 1] = proposalHeight
+        measurements[base + 2] = width
+        measurements[base + 3] = height
+    }
+
+    /**
+     * Rebuilds [childInfo] and the pre-measured table for the current children.
+     * A synchronous pass clears the recorded probes so [measurer] records its
+     * own; a [snapshot] keeps the table and re-measures, at the recorded
+     * proposals, only the children that requested layout since.
+     */
+    private fun prepareChildren(snapshot: Boolean = false) {
+        val count = childCount
+        var fresh = false
+        if (childInfo.size != count * 2) {
+            childInfo = IntArray(count * 2)
+            measurements = FloatArray(count * ENTRIES_PER_CHILD * 4)
+            placements = FloatArray(count * 4)
+            probeCounts = IntArray(count)
+            clearProbes()
+            fresh = true
+        }
+        val unspecified = View.MeasureSpec.makeMeasureSpec(0, View.MeasureSpec.UNSPECIFIED)
+        for (index in 0 until count) {
+            val descriptor = descriptors.getOrNull(index)
+            childInfo[index * 2] = (descriptor?.stretchAxis ?: StretchAxis.NONE).value
+            childInfo[index * 2 + 1] = descriptor?.priority ?: 0
+
+            val child = getChildAt(index)
+            // A child that has not requested layout still measures as its table entries say
+            if (snapshot && !fresh && !child.isLayoutRequested) continue
+            child.measure(unspecified, unspecified)
+            storeMeasurement(
+                index, 0, Float.NaN, Float.NaN,
+                child.measuredWidth.toFloat().pxToDp(), child.measuredHeight.toFloat().pxToDp()
+            )
+            if (snapshot) {
+                for (entry in 1 until ENTRIES_PER_CHILD) {
+                    val base = (index * ENTRIES_PER_CHILD + entry) * 4
+                    val proposalWidth = measurements[base]
+                    val proposalHeight = measurements[base + 1]
+                    if (proposalWidth < 0f) continue
+                    child.measure(
+                        proposalToMeasureSpec(proposalWidth * density),
+                        proposalToMeasureSpec(proposalHeight * density)
+                    )
+                    measurements[base + 2] = child.measuredWidth.toFloat().pxToDp()
+                    measurements[base + 3] = child.measuredHeight.toFloat().pxToDp()
+                }
+            }
+        }
+        if (!snapshot) clearProbes()
+    }
+
+    private fun clearProbes() {
+        probeCounts.fill(0)
+        for (index in probeCounts.indices) {
+            for (entry in 1 until ENTRIES_PER_CHILD) {
+                // Proposals are never negative, so this entry cannot match until a fallback probe fills it.
+                storeMeasurement(index, entry, -1f, -1f, 0f, 0f)
+            }
+        }
+    }
+
+    /**
+     * Drops the native layout and its cached results. Called when the group is
+     * disposed; waits for a background pass still using the layout.
+     */
+    fun releaseLayout() {
+        layoutLock.withLock {
+            if (released || layoutPtr == 0L) return
+            released = true
+            NativeBindings.waterui_release_layout_cache(cacheToken)
+            NativeBindings.waterui_drop_layout(layoutPtr)
+        }
+        precomputed = null
+        pendingSpec = null
+    }
+
+    override fun forceLayout() {
+        super.forceLayout()
+        // Parents force layout on configuration changes without a requestLayout
+        if (!publishing) generation++
+    }
+
+    override fun requestLayout() {
+        super.requestLayout()
+        if (publishing) return
+        // Local only: the new generation reaches native code with the next pass
+        generation++
+    }
+
     override fun onMeasure(widthMeasureSpec: Int, heightMeasureSpec: Int) {
         require(layoutPtr != 0L) { "onMeasure called with null layout pointer" }
 
-        // Empty containers should report zero size
-        if (childCount == 0) {
+        // Empty or released containers should report zero size
+        if (childCount == 0 || released) {
             setMeasuredDimension(0, 0)
             return
         }
 
+        if (asyncLayout && measureAsync(widthMeasureSpec, heightMeasureSpec)) {
+            return
+        }
+        forceSync = false
+
         val constraints = LayoutConstraints.fromMeasureSpecs(widthMeasureSpec, heightMeasureSpec)
         // Convert pixel constraints to dp for Rust layout engine
         val parentProposal = constraints.toProposalStruct(density)
 
-        // Create SubViewStruct array - Rust will call back to measure each child
-        // Pass density so child measurements can convert between dp and pixels
-        val subviews = Array(childCount) { index ->
-            val child = getChildAt(index)
-            val descriptor = descriptors.getOrNull(index)
-            SubViewStruct(
-                view = child,
-                stretchAxis = descriptor?.stretchAxis ?: StretchAxis.NONE,
-                priority = descriptor?.priority ?: 0,
-                density = density
-            )
+        // A repeated pass with the same proposal and unchanged children is a native lookup
+        if (!NativeBindings.waterui_layout_cached_size(cacheToken, generation, parentProposal, measuredSize)) {
+            // Pre-measure children; Rust only calls back into [measurer] for proposals not in the table
+            prepareChildren()
+
+            // Rust computes layout in dp, convert result to pixels for Android.
+            // The lock is only busy while a background pass runs; don't wait for it
+            if (!layoutLock.tryLock()) {
+                skippedSync = true
+                forceSync = asyncLayout
+                keepPreviousSize(constraints)
+                return
+            }
+            try {
+                val ok = NativeBindings.waterui_layout_size_that_fits_bulk(
+                    layoutPtr, cacheToken, generation, parentProposal, childInfo, measurements, ENTRIES_PER_CHILD,
+                    measurer, measuredSize
+                )
+                // A child threw while measuring (logged natively); report an empty size
+                if (!ok) measuredSize.fill(0f)
+            } finally {
+                layoutLock.unlock()
+            }
         }
-
-        // Rust computes layout in dp, convert result to pixels for Android
-        val requestedSize = NativeBindings.waterui_layout_size_that_fits(layoutPtr, parentProposal, subviews)
-        val measuredWidth = requestedSize.width.dpToPx().resolveDimension(constraints.minWidth, constraints.maxWidth)
-        val measuredHeight = requestedSize.height.dpToPx().resolveDimension(constraints.minHeight, constraints.maxHeight)
+        val measuredWidth = measuredSize[0].dpToPx().resolveDimension(constraints.minWidth, constraints.maxWidth)
+        val measuredHeight = measuredSize[1].dpToPx().resolveDimension(constraints.minHeight, constraints.maxHeight)
 
         setMeasuredDimension(measuredWidth, measuredHeight)
     }
 
+    /**
+     * Measures from a background result if one matches, or keeps the previous
+     * size while one is computed. Returns false when the pass must run
+     * synchronously: the first pass, or after an inexact snapshot.
+     */
+    private fun measureAsync(widthMeasureSpec: Int, heightMeasureSpec: Int): Boolean {
+        val ready = precomputed
+        if (ready != null && ready.matches(widthMeasureSpec, heightMeasureSpec, generation)) {
+            setMeasuredDimension(ready.width, ready.height)
+            return true
+        }
+        if (forceSync || !isLaidOut || childInfo.size != childCount * 2) {
+            return false
+        }
+        schedulePrecompute(widthMeasureSpec, heightMeasureSpec)
+        keepPreviousSize(LayoutConstraints.fromMeasureSpecs(widthMeasureSpec, heightMeasureSpec))
+        return true
+    }
+
+    /**
+     * Reports the previous size while a background result is computed, resolved
+     * against the current constraints so an exact or tighter spec is honoured
+     * at once. The pending result's requestLayout brings the real size.
+     */
+    private fun keepPreviousSize(constraints: LayoutConstraints) {
+        setMeasuredDimension(
+            measuredWidth.toFloat().resolveDimension(constraints.minWidth, constraints.maxWidth),
+            measuredHeight.toFloat().resolveDimension(constraints.minHeight, constraints.maxHeight)
+        )
+    }
+
+    private fun schedulePrecompute(widthMeasureSpec: Int, heightMeasureSpec: Int) {
+        if (pendingSpec?.matches(widthMeasureSpec, heightMeasureSpec, generation) == true) {
+            return
+        }
+        // Snapshot on the UI thread; only the Rust layout moves off it
+        prepareChildren(snapshot = true)
+        val spec = PrecomputedLayout(widthMeasureSpec, heightMeasureSpec, generation)
+        val info = childInfo.copyOf()
+        val table = measurements.copyOf()
+        pendingSpec = spec
+        layoutExecutor.execute {
+            val result = computeSnapshot(spec, info, table)
+            post {
+                if (pendingSpec === spec) pendingSpec = null
+                val current = spec.generation == generation
+                if (current) {
+                    if (result != null) precomputed = result else forceSync = true
+                }
+                if (current || skippedSync) {
+                    skippedSync = false
+                    publishing = true
+                    requestLayout()
+                    publishing = false
+                }
+            }
+        }
+    }
+
+    /** Runs on [layoutExecutor]. Returns null unless every probe hit the snapshot. */
+    private fun computeSnapshot(spec: PrecomputedLayout, info: IntArray, table: FloatArray): PrecomputedLayout? {
+        val constraints = LayoutConstraints.fromMeasureSpecs(spec.widthSpec, spec.heightSpec)
+        val size = FloatArray(2)
+        val placed = FloatArray(info.size / 2 * 4)
+        layoutLock.withLock {
+            if (released) return null
+            val measureMisses = NativeBindings.waterui_layout_size_that_fits_snapshot(
+                layoutPtr, constraints.toProposalStruct(density), info, table, ENTRIES_PER_CHILD, size
+            )
+            if (measureMisses != 0) return null
+            spec.width = size[0].dpToPx().resolveDimension(constraints.minWidth, constraints.maxWidth)
+            spec.height = size[1].dpToPx().resolveDimension(constraints.minHeight, constraints.maxHeight)
+            val placeMisses = NativeBindings.waterui_layout_place_snapshot(
+                layoutPtr, spec.width.toFloat().pxToDp(), spec.height.toFloat().pxToDp(),
+                info, table, ENTRIES_PER_CHILD, placed
+            )
+            if (placeMisses != 0) return null
+        }
+        spec.placements = placed
+        return spec
+    }
+
     override fun onLayout(changed: Boolean, left: Int, top: Int, right: Int, bottom: Int) {
         require(layoutPtr != 0L) { "onLayout called with null layout pointer" }
 
-        // Nothing to layout for empty containers
-        if (childCount == 0) {
+        // Nothing to layout for empty or released containers
+        if (childCount == 0 || released) {
             return
         }
 
+        if (asyncLayout) {
+            val ready = precomputed
+            if (ready != null && ready.generation == generation &&
+                ready.width == right - left && ready.height == bottom - top &&
+                ready.placements.size == childCount * 4
+            ) {
+                applyPlacements(ready.placements, childCount)
+                return
+            }
+            // The previous layout stays until the background result arrives
+            if (pendingSpec != null) {
+                return
+            }
+        }
+
         // Convert pixel bounds to dp for Rust layout engine
         val bounds = RectStruct(
             x = 0f,
@@ -99,29 +406,43 @@ class RustLayoutViewGroup @JvmOverloads constructor(
             height = (bottom - top).toFloat().pxToDp()
         )
 
-        // Create SubViewStruct array for placement
-        // Pass density so child measurements can convert between dp and pixels
-        val subviews = Array(childCount) { index ->
-            val child = getChildAt(index)
-            val descriptor = descriptors.getOrNull(index)
-            SubViewStruct(
-                view = child,
-                stretchAxis = descriptor?.stretchAxis ?: StretchAxis.NONE,
-                priority = descriptor?.priority ?: 0,
-                density = density
-            )
+        // Reuse the table from onMeasure unless the children changed since
+        if (childInfo.size != childCount * 2) {
+            prepareChildren()
         }
 
-        // Rust returns placements in dp, convert to pixels for Android layout
-        val placements = NativeBindings.waterui_layout_place(layoutPtr, bounds, subviews)
+        val cached = NativeBindings.waterui_layout_cached_placements(
+            cacheToken, generation, bounds.width, bounds.height, placements
+        )
+        if (cached >= 0) {
+            applyPlacements(placements, minOf(childCount, cached))
+            return
+        }
 
-        for (index in 0 until childCount) {
-            val rect = placements[index]
+        // Rust returns placements in dp, convert to pixels for Android layout.
+        // A busy lock means a background pass; its result lays the group out again
+        if (!layoutLock.tryLock()) {
+            skippedSync = true
+            return
+        }
+        val placed = try {
+            NativeBindings.waterui_layout_place_bulk(
+                layoutPtr, cacheToken, generation, bounds, childInfo, measurements, ENTRIES_PER_CHILD, measurer, placements
+            )
+        } finally {
+            layoutLock.unlock()
+        }
+        applyPlacements(placements, minOf(childCount, placed))
+    }
+
+    private fun applyPlacements(placements: FloatArray, count: Int) {
+        for (index in 0 until count) {
+            val base = index * 4
             val child = getChildAt(index)
 
             // Convert dp to pixels
-            val allocatedWidth = rect.width.dpToPx().roundToInt()
-            val allocatedHeight = rect.height.dpToPx().roundToInt()
+            val allocatedWidth = placements[base + 2].dpToPx().roundToInt()
+            val allocatedHeight = placements[base + 3].dpToPx().roundToInt()
 
             // Re-measure child at allocated size if different from measured size.
             // This is critical for StretchAxis::Horizontal components (TextField, Slider, etc.)
@@ -134,8 +455,8 @@ class RustLayoutViewGroup @JvmOverloads constructor(
             }
 
             // Convert dp positions to pixels
-            val childLeft = rect.x.dpToPx().roundToInt()
-            val childTop = rect.y.dpToPx().roundToInt()
+            val childLeft = placements[base].dpToPx().roundToInt()
+            val childTop = placements[base + 1].dpToPx().roundToInt()
             val childRight = childLeft + allocatedWidth
             val childBottom = childTop + allocatedHeight
             child.layout(childLeft, childTop, childRight, childBottom)
@@ -212,6 +533,36 @@ class RustLayoutViewGroup @JvmOverloads constructor(
     override fun onTouchEvent(event: MotionEvent): Boolean {
         return false
     }
+    private companion object {
+        /** Fallback probes remembered per child. */
+        const val PROBE_SLOTS = 3
+
+        /** Pre-measured entries per child in [measurements]: the unspecified probe plus [PROBE_SLOTS]. */
+        const val ENTRIES_PER_CHILD = 1 + PROBE_SLOTS
+
+        /** Source of [cacheToken]s; positive, so they never meet the native benchmark's. */
+        val nextCacheToken = AtomicLong(1)
+
+        /** Shared by every [asyncLayout] container; one thread keeps passes in order. */
+        val layoutExecutor: ExecutorService by lazy {
+            Executors.newSingleThreadExecutor { runnable ->
+                Thread(runnable, "WaterUI-layout").apply { isDaemon = true }
+            }
+        }
+    }
+}
+
+/**
+ * A layout pass computed off the UI thread: the measure specs and child
+ * generation it was computed for, and its result in pixels / dp placements.
+ */
+private class PrecomputedLayout(val widthSpec: Int, val heightSpec: Int, val generation: Int) {
+    var width = 0
+    var height = 0
+    var placements = FloatArray(0)
+
+    fun matches(widthSpec: Int, heightSpec: Int, generation: Int): Boolean =
+        this.widthSpec == widthSpec && this.heightSpec == heightSpec && this.generation == generation
 }
 
 data class ChildDescriptor(
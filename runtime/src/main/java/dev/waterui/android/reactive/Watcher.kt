@@ -20,3 +20,30 @@ data class WuiWatcherMetadata(val pointer: Long) {
 fun interface WatcherCallback<T> {
     fun onChanged(value: T, metadata: WuiWatcherMetadata)
 }
+
+/*
+ * Primitive watcher callbacks. Native code invokes these without boxing the value or
+ * allocating a [WuiWatcherMetadata]: [metadata] is the raw pointer and is only valid
+ * until the callback returns, so read anything you need via [watcherAnimation] first.
+ * Emits are coalesced per watcher and delivered on the main thread once per frame
+ * (see [WatcherDispatcher]).
+ */
+
+fun interface BoolWatcherCallback {
+    fun onBool(value: Boolean, metadata: Long)
+}
+
+fun interface IntWatcherCallback {
+    fun onInt(value: Int, metadata: Long)
+}
+
+fun interface DoubleWatcherCallback {
+    fun onDouble(value: Double, metadata: Long)
+}
+
+fun interface FloatWatcherCallback {
+    fun onFloat(value: Float, metadata: Long)
+}
+
+/** Reads the animation from a raw metadata pointer passed to a primitive watcher callback. */
+fun watcherAnimation(metadata: Long): WuiAnimation = NativeBindings.waterui_get_animation(metadata)
@@ -0,0 +1,76 @@
+package dev.waterui.android.reactive
+
+import android.os.Handler
+import android.os.Looper
+import android.view.Choreographer
+import dev.waterui.android.ffi.WatcherJni
+
+/**
+ * Main-thread end of the native watcher dispatch queue.
+ *
+ * Every watcher emit is queued natively in emit order (primitives coalesced, last value per
+ * watcher wins) and delivered once per frame: the first emit into an empty queue calls
+ * [scheduleFlush], the next [Choreographer] frame drains the queue, and native code hands the
+ * whole batch to [deliverBatch] in a single call. Emits caused by a binding write or action on
+ * the main thread are flushed before that call returns.
+ */
+internal object WatcherDispatcher : Choreographer.FrameCallback {
+    // Must match WatcherValueKind in waterui_jni.cpp
+    const val KIND_BOOL = 0
+    const val KIND_INT = 1
+    const val KIND_DOUBLE = 2
+    const val KIND_FLOAT = 3
+    const val KIND_OBJECT = 4
+
+    private val mainHandler = Handler(Looper.getMainLooper())
+    private val postFrame = Runnable { Choreographer.getInstance().postFrameCallback(this) }
+
+    /** Called from native code (any thread) when the queue becomes non-empty. */
+    @JvmStatic
+    fun scheduleFlush() {
+        if (Looper.myLooper() == Looper.getMainLooper()) {
+            postFrame.run()
+        } else {
+            mainHandler.post(postFrame)
+        }
+    }
+
+    override fun doFrame(frameTimeNanos: Long) {
+        WatcherJni.flushWatcherQueue()
+    }
+
+    /**
+     * Called from native code on the main thread with [count] entries; the arrays are reused
+     * between flushes and may be longer. [metadata] pointers are valid until this returns;
+     * [values] hold raw primitive bits and [objects] the values of [KIND_OBJECT] entries.
+     */
+    @JvmStatic
+    fun deliverBatch(
+        count: Int,
+        callbacks: Array<Any?>,
+        kinds: IntArray,
+        values: LongArray,
+        metadata: LongArray,
+        objects: Array<Any?>,
+    ) {
+        try {
+            for (i in 0 until count) {
+                val callback = callbacks[i] ?: continue // Dropped before the flush
+                when (kinds[i]) {
+                    KIND_BOOL -> (callback as BoolWatcherCallback).onBool(values[i] != 0L, metadata[i])
+                    KIND_INT -> (callback as IntWatcherCallback).onInt(values[i].toInt(), metadata[i])
+                    KIND_DOUBLE -> (callback as DoubleWatcherCallback).onDouble(Double.fromBits(values[i]), metadata[i])
+                    KIND_FLOAT -> (callback as FloatWatcherCallback).onFloat(Float.fromBits(values[i].toInt()), metadata[i])
+                    KIND_OBJECT -> {
+                        @Suppress("UNCHECKED_CAST")
+                        (callback as WatcherCallback<Any?>).onChanged(objects[i], WuiWatcherMetadata(metadata[i]))
+                    }
+                }
+            }
+        } finally {
+            // Don't keep callbacks or values reachable from the reused arrays.
+            callbacks.fill(null, 0, count)
+            objects.fill(null, 0, count)
+        }
+    }
+}
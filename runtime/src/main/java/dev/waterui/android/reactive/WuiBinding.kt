@@ -3,9 +3,12 @@ package dev.waterui.android.reactive
 import android.os.Handler
 import android.os.Looper
 import dev.waterui.android.ffi.WatcherJni
+import dev.waterui.android.runtime.NativeBindings
 import dev.waterui.android.runtime.NativePointer
 import dev.waterui.android.runtime.DateStruct
+import dev.waterui.android.runtime.FlatStyledStrStruct
 import dev.waterui.android.runtime.PickerItemStruct
+import dev.waterui.android.runtime.PickerItemsDiffStruct
 import dev.waterui.android.runtime.ResolvedColorStruct
 import dev.waterui.android.runtime.ResolvedFontStruct
 import dev.waterui.android.runtime.StyledStrStruct
@@ -22,12 +25,15 @@ class WuiBinding<T>(
     bindingPtr: Long,
     private val reader: (Long) -> T,
     private val writer: (Long, T) -> Unit,
-    private val watcherFactory: (Long, WatcherCallback<T>) -> WatcherStruct,
+    private val watcherFactory: ((Long, WatcherCallback<T>) -> WatcherStruct)?,
     private val watcherRegistrar: (Long, WatcherStruct) -> Long,
     private val dropper: (Long) -> Unit,
-    private val env: WuiEnvironment
+    private val env: WuiEnvironment,
+    /** Typed watcher for primitive bindings; used instead of [watcherFactory]. */
+    private val primitiveWatcher: ((WuiBinding<T>) -> WatcherStruct)? = null
 ) : NativePointer(bindingPtr) {
 
+    private val mainHandler = Handler(Looper.getMainLooper())
     private var watcherGuard: WatcherGuard? = null
     private var syncingFromRust = false
     private var observer: ((T, WuiAnimation) -> Unit)? = null
@@ -47,10 +53,17 @@ class WuiBinding<T>(
 
     private fun ensureWatcher() {
         if (watcherGuard != null || isReleased) return
+        val watcher = primitiveWatcher?.invoke(this) ?: postingWatcher(watcherFactory!!)
+        val guardHandle = watcherRegistrar(raw(), watcher)
+        if (guardHandle != 0L) {
+            watcherGuard = WatcherGuard(guardHandle)
+        }
+    }
+
+    private fun postingWatcher(factory: (Long, WatcherCallback<T>) -> WatcherStruct): WatcherStruct {
         // Use Handler to post to main thread - this ensures the callback returns immediately
         // even if called synchronously from Rust, preventing deadlocks
-        val mainHandler = Handler(Looper.getMainLooper())
-        val watcher = watcherFactory(raw()) { value, metadata ->
+        return factory(raw()) { value, metadata ->
             // IMPORTANT: Extract animation IMMEDIATELY before posting, because the metadata
             // pointer may become invalid after this callback returns to Rust
             val animation = metadata.animation
@@ -70,12 +83,59 @@ class WuiBinding<T>(
                 }
             }
         }
-        val guardHandle = watcherRegistrar(raw(), watcher)
-        if (guardHandle != 0L) {
-            watcherGuard = WatcherGuard(guardHandle)
+    }
+
+    /**
+     * Applies a primitive emit. Primitive watchers are delivered on the main
+     * thread by [WatcherDispatcher], so nothing is posted, and the animation is
+     * only read from [metadata] when an observer sees the change. Without the
+     * dispatcher, native code delivers on the emitting thread; the emit is then
+     * posted, with its animation read while [metadata] is still valid.
+     */
+    internal fun applyFromRust(value: T, metadata: Long) {
+        if (isReleased || currentValue == value) return
+        if (Looper.myLooper() !== Looper.getMainLooper()) {
+            val animation = if (metadata != 0L) watcherAnimation(metadata) else WuiAnimation.None
+            mainHandler.post { applyOnMain(value, animation) }
+            return
+        }
+        applyOnMain(value, if (observer != null && metadata != 0L) watcherAnimation(metadata) else WuiAnimation.None)
+    }
+
+    private fun applyOnMain(value: T, animation: WuiAnimation) {
+        if (isReleased || currentValue == value) return
+        syncingFromRust = true
+        try {
+            currentValue = value
+            observer?.invoke(value, animation)
+        } finally {
+            syncingFromRust = false
         }
     }
 
+    // Typed entry points for the primitive watchers. The value is compared
+    // unboxed, so an emit that changes nothing allocates nothing; only a change
+    // boxes it, to be stored as T.
+    @Suppress("UNCHECKED_CAST")
+    internal fun applyBool(value: Boolean, metadata: Long) {
+        if (currentValue as Boolean != value) applyFromRust(value as T, metadata)
+    }
+
+    @Suppress("UNCHECKED_CAST")
+    internal fun applyInt(value: Int, metadata: Long) {
+        if (currentValue as Int != value) applyFromRust(value as T, metadata)
+    }
+
+    @Suppress("UNCHECKED_CAST")
+    internal fun applyDouble(value: Double, metadata: Long) {
+        if ((currentValue as Double).compareTo(value) != 0) applyFromRust(value as T, metadata)
+    }
+
+    @Suppress("UNCHECKED_CAST")
+    internal fun applyFloat(value: Float, metadata: Long) {
+        if ((currentValue as Float).compareTo(value) != 0) applyFromRust(value as T, metadata)
+    }
+
     private var isSettingValue = false
     
     fun set(value: T) {
@@ -114,10 +174,13 @@ class WuiBinding<T>(
                 bindingPtr = bindingPtr,
                 reader = { ptr -> WatcherJni.readBindingBool(ptr) },
                 writer = { ptr, value -> WatcherJni.setBindingBool(ptr, value) },
-                watcherFactory = { _, callback -> WatcherStructFactory.bool(callback) },
+                watcherFactory = null,
                 watcherRegistrar = { ptr, watcher -> WatcherJni.watchBindingBool(ptr, watcher) },
                 dropper = { ptr -> WatcherJni.dropBindingBool(ptr) },
-                env = env
+                env = env,
+                primitiveWatcher = { binding ->
+                    WatcherStructFactory.bool { value, metadata -> binding.applyBool(value, metadata) }
+                }
             )
 
         fun int(bindingPtr: Long, env: WuiEnvironment): WuiBinding<Int> =
@@ -125,10 +188,13 @@ class WuiBinding<T>(
                 bindingPtr = bindingPtr,
                 reader = { ptr -> WatcherJni.readBindingInt(ptr) },
                 writer = { ptr, value -> WatcherJni.setBindingInt(ptr, value) },
-                watcherFactory = { _, callback -> WatcherStructFactory.int(callback) },
+                watcherFactory = null,
                 watcherRegistrar = { ptr, watcher -> WatcherJni.watchBindingInt(ptr, watcher) },
                 dropper = { ptr -> WatcherJni.dropBindingInt(ptr) },
-                env = env
+                env = env,
+                primitiveWatcher = { binding ->
+                    WatcherStructFactory.int { value, metadata -> binding.applyInt(value, metadata) }
+                }
             )
 
         fun double(bindingPtr: Long, env: WuiEnvironment): WuiBinding<Double> =
@@ -136,10 +202,13 @@ class WuiBinding<T>(
                 bindingPtr = bindingPtr,
                 reader = { ptr -> WatcherJni.readBindingDouble(ptr) },
                 writer = { ptr, value -> WatcherJni.setBindingDouble(ptr, value) },
-                watcherFactory = { _, callback -> WatcherStructFactory.double(callback) },
+                watcherFactory = null,
                 watcherRegistrar = { ptr, watcher -> WatcherJni.watchBindingDouble(ptr, watcher) },
                 dropper = { ptr -> WatcherJni.dropBindingDouble(ptr) },
-                env = env
+                env = env,
+                primitiveWatcher = { binding ->
+                    WatcherStructFactory.double { value, metadata -> binding.applyDouble(value, metadata) }
+                }
             )
 
         fun str(bindingPtr: Long, env: WuiEnvironment): WuiBinding<String> =
@@ -149,9 +218,7 @@ class WuiBinding<T>(
                     val bytes = WatcherJni.readBindingStr(ptr)
                     bytes.decodeToString()
                 },
-                writer = { ptr, value ->
-                    WatcherJni.setBindingStr(ptr, value.encodeToByteArray())
-                },
+                writer = { ptr, value -> NativeBindings.waterui_set_binding_str(ptr, value) },
                 watcherFactory = { _, callback -> WatcherStructFactory.string(callback) },
                 watcherRegistrar = { ptr, watcher -> WatcherJni.watchBindingStr(ptr, watcher) },
                 dropper = { ptr -> WatcherJni.dropBindingStr(ptr) },
@@ -163,10 +230,13 @@ class WuiBinding<T>(
                 bindingPtr = bindingPtr,
                 reader = { ptr -> WatcherJni.readBindingFloat(ptr) },
                 writer = { ptr, value -> WatcherJni.setBindingFloat(ptr, value) },
-                watcherFactory = { _, callback -> WatcherStructFactory.float(callback) },
+                watcherFactory = null,
                 watcherRegistrar = { ptr, watcher -> WatcherJni.watchBindingFloat(ptr, watcher) },
                 dropper = { ptr -> WatcherJni.dropBindingFloat(ptr) },
-                env = env
+                env = env,
+                primitiveWatcher = { binding ->
+                    WatcherStructFactory.float { value, metadata -> binding.applyFloat(value, metadata) }
+                }
             )
 
         fun date(bindingPtr: Long, env: WuiEnvironment): WuiBinding<DateStruct> =
@@ -186,19 +256,22 @@ class WuiBinding<T>(
  * Produces watcher struct handles backed by JNI trampolines.
  */
 object WatcherStructFactory {
-    fun bool(callback: WatcherCallback<Boolean>): WatcherStruct {
+    // Primitive watchers cross JNI unboxed and take the typed callbacks, which get
+    // the raw metadata pointer: nothing is boxed or allocated per emit.
+
+    fun bool(callback: BoolWatcherCallback): WatcherStruct {
         return WatcherJni.createBoolWatcher(callback)
     }
 
-    fun int(callback: WatcherCallback<Int>): WatcherStruct {
+    fun int(callback: IntWatcherCallback): WatcherStruct {
         return WatcherJni.createIntWatcher(callback)
     }
 
-    fun double(callback: WatcherCallback<Double>): WatcherStruct {
+    fun double(callback: DoubleWatcherCallback): WatcherStruct {
         return WatcherJni.createDoubleWatcher(callback)
     }
 
-    fun float(callback: WatcherCallback<Float>): WatcherStruct {
+    fun float(callback: FloatWatcherCallback): WatcherStruct {
         return WatcherJni.createFloatWatcher(callback)
     }
 
@@ -218,6 +291,10 @@ object WatcherStructFactory {
         return WatcherJni.createStyledStrWatcher(callback)
     }
 
+    fun flatStyledString(callback: WatcherCallback<FlatStyledStrStruct>): WatcherStruct {
+        return WatcherJni.createFlatStyledStrWatcher(callback)
+    }
+
     fun resolvedColor(callback: WatcherCallback<ResolvedColorStruct>): WatcherStruct {
         return WatcherJni.createResolvedColorWatcher(callback)
     }
@@ -230,6 +307,10 @@ object WatcherStructFactory {
         return WatcherJni.createPickerItemsWatcher(callback)
     }
 
+    fun pickerItemsDiff(callback: WatcherCallback<PickerItemsDiffStruct>): WatcherStruct {
+        return WatcherJni.createPickerItemsDiffWatcher(callback)
+    }
+
     fun date(callback: WatcherCallback<DateStruct>): WatcherStruct {
         return WatcherJni.createDateWatcher(callback)
     }
@@ -20,13 +20,16 @@ import dev.waterui.android.runtime.toModel
 class WuiComputed<T>(
     computedPtr: Long,
     private val reader: (Long) -> T,
-    private val watcherFactory: (Long, WatcherCallback<T>) -> WatcherStruct,
+    private val watcherFactory: ((Long, WatcherCallback<T>) -> WatcherStruct)?,
     private val watcherRegistrar: (Long, WatcherStruct) -> Long,
     private val dropper: (Long) -> Unit,
     private val env: WuiEnvironment,
-    private val valueReleaser: (T) -> Unit = {}
+    private val valueReleaser: (T) -> Unit = {},
+    /** Typed watcher for primitive computeds; used instead of [watcherFactory]. */
+    private val primitiveWatcher: ((WuiComputed<T>) -> WatcherStruct)? = null
 ) : NativePointer(computedPtr) {
 
+    private val mainHandler = Handler(Looper.getMainLooper())
     private var currentValue: T = reader(computedPtr)
     private var watcherGuard: WatcherGuard? = null
     private var observer: ((T, WuiAnimation) -> Unit)? = null
@@ -46,10 +49,19 @@ class WuiComputed<T>(
     private fun ensureWatcher() {
         if (watcherGuard != null || isReleased) return
         android.util.Log.d("WaterUI.Computed", "ensureWatcher: creating watcher for ${this::class.simpleName}")
+        val watcher = primitiveWatcher?.invoke(this) ?: postingWatcher(watcherFactory!!)
+        android.util.Log.d("WaterUI.Computed", "ensureWatcher: calling watcherRegistrar")
+        val guardHandle = watcherRegistrar(raw(), watcher)
+        android.util.Log.d("WaterUI.Computed", "ensureWatcher: watcherRegistrar returned $guardHandle")
+        if (guardHandle != 0L) {
+            watcherGuard = WatcherGuard(guardHandle)
+        }
+    }
+
+    private fun postingWatcher(factory: (Long, WatcherCallback<T>) -> WatcherStruct): WatcherStruct {
         // Use Handler to post to main thread - this ensures the callback returns immediately
         // even if called synchronously from Rust, preventing deadlocks
-        val mainHandler = Handler(Looper.getMainLooper())
-        val watcher = watcherFactory(raw()) { value, metadata ->
+        return factory(raw()) { value, metadata ->
             android.util.Log.d("WaterUI.Computed", "ensureWatcher: watcher callback invoked on thread ${Thread.currentThread().name}")
             // IMPORTANT: Extract animation IMMEDIATELY before posting, because the metadata
             // pointer may become invalid after this callback returns to Rust
@@ -66,12 +78,42 @@ class WuiComputed<T>(
                 android.util.Log.d("WaterUI.Computed", "ensureWatcher: observer invoked")
             }
         }
-        android.util.Log.d("WaterUI.Computed", "ensureWatcher: calling watcherRegistrar")
-        val guardHandle = watcherRegistrar(raw(), watcher)
-        android.util.Log.d("WaterUI.Computed", "ensureWatcher: watcherRegistrar returned $guardHandle")
-        if (guardHandle != 0L) {
-            watcherGuard = WatcherGuard(guardHandle)
+    }
+
+    /**
+     * Applies a primitive emit on the main thread, where [WatcherDispatcher]
+     * delivers primitive watchers; the animation is only read from [metadata]
+     * for an observer. An emit delivered on another thread (no dispatcher) is
+     * posted, with its animation read while [metadata] is still valid.
+     */
+    internal fun applyFromRust(value: T, metadata: Long) {
+        if (isReleased) return
+        if (Looper.myLooper() !== Looper.getMainLooper()) {
+            val animation = if (metadata != 0L) watcherAnimation(metadata) else WuiAnimation.None
+            mainHandler.post { applyOnMain(value, animation) }
+            return
         }
+        applyOnMain(value, if (observer != null && metadata != 0L) watcherAnimation(metadata) else WuiAnimation.None)
+    }
+
+    private fun applyOnMain(value: T, animation: WuiAnimation) {
+        if (isReleased) return
+        val previous = currentValue
+        currentValue = value
+        observer?.invoke(value, animation)
+        valueReleaser(previous)
+    }
+
+    // Typed entry points for the primitive watchers: compared unboxed, so an
+    // unchanged emit allocates nothing.
+    @Suppress("UNCHECKED_CAST")
+    internal fun applyInt(value: Int, metadata: Long) {
+        if (currentValue as Int != value) applyFromRust(value as T, metadata)
+    }
+
+    @Suppress("UNCHECKED_CAST")
+    internal fun applyDouble(value: Double, metadata: Long) {
+        if ((currentValue as Double).compareTo(value) != 0) applyFromRust(value as T, metadata)
     }
 
     override fun close() {
@@ -93,20 +135,23 @@ class WuiComputed<T>(
             WuiComputed(
                 computedPtr = ptr,
                 reader = { p -> WatcherJni.readComputedF64(p) },
-                watcherFactory = { _, callback -> WatcherStructFactory.double(callback) },
+                watcherFactory = null,
                 watcherRegistrar = { p, watcher -> WatcherJni.watchComputedF64(p, watcher) },
                 dropper = { p -> WatcherJni.dropComputedF64(p) },
-                env = env
+                env = env,
+                primitiveWatcher = { computed ->
+                    WatcherStructFactory.double { value, metadata -> computed.applyDouble(value, metadata) }
+                }
             )
 
         fun styledString(ptr: Long, env: WuiEnvironment): WuiComputed<WuiStyledStr> =
             WuiComputed(
                 computedPtr = ptr,
                 reader = { p ->
-                    WatcherJni.readComputedStyledStr(p).toModel()
+                    WatcherJni.readComputedStyledStrFlat(p).toModel()
                 },
                 watcherFactory = { _, callback ->
-                    WatcherStructFactory.styledString { struct, metadata ->
+                    WatcherStructFactory.flatStyledString { struct, metadata ->
                         callback.onChanged(struct.toModel(), metadata)
                     }
                 },
@@ -148,10 +193,13 @@ class WuiComputed<T>(
             WuiComputed(
                 computedPtr = ptr,
                 reader = { p -> WatcherJni.readComputedI32(p) },
-                watcherFactory = { _, callback -> WatcherStructFactory.int(callback) },
+                watcherFactory = null,
                 watcherRegistrar = { p, watcher -> WatcherJni.watchComputedI32(p, watcher) },
                 dropper = { p -> WatcherJni.dropComputedI32(p) },
-                env = env
+                env = env,
+                primitiveWatcher = { computed ->
+                    WatcherStructFactory.int { value, metadata -> computed.applyInt(value, metadata) }
+                }
             )
 
         fun colorFromComputed(ptr: Long, env: WuiEnvironment): WuiComputed<ResolvedColorStruct> =
@@ -0,0 +1,51 @@
+package dev.waterui.android.reactive
+
+import android.os.Handler
+import android.os.Looper
+import dev.waterui.android.ffi.WatcherJni
+import dev.waterui.android.runtime.NativePointer
+import dev.waterui.android.runtime.PickerItemsDiffStruct
+import dev.waterui.android.runtime.toModel
+
+/**
+ * Picker items as a stream of keyed change sets.
+ *
+ * Unlike [WuiComputed] there is no current value: [observe] first delivers an
+ * explicit snapshot that inserts every item, read together with the native
+ * diff baseline, and then each later change set in order. Observers own the
+ * labels they receive.
+ */
+class WuiPickerItemsDiff(computedPtr: Long) : NativePointer(computedPtr) {
+
+    private var watcherGuard: WatcherGuard? = null
+
+    fun observe(onDiff: (PickerItemsDiffStruct) -> Unit) {
+        if (watcherGuard != null || isReleased) return
+        val mainHandler = Handler(Looper.getMainLooper())
+        val watcher = WatcherStructFactory.pickerItemsDiff { diff, _ ->
+            mainHandler.post {
+                if (isReleased) diff.releaseLabels() else onDiff(diff)
+            }
+        }
+        // Seeds the watcher's baseline, so it must precede registration
+        WatcherJni.snapshotPickerItemsDiff(raw(), watcher.dataPtr)?.let(onDiff)
+        val guardHandle = WatcherJni.watchComputedPickerItems(raw(), watcher)
+        if (guardHandle != 0L) {
+            watcherGuard = WatcherGuard(guardHandle)
+        }
+    }
+
+    override fun close() {
+        watcherGuard?.close()
+        watcherGuard = null
+        super.close()
+    }
+
+    override fun release(ptr: Long) {
+        WatcherJni.dropComputedPickerItems(ptr)
+    }
+}
+
+private fun PickerItemsDiffStruct.releaseLabels() {
+    labels.forEach { it.toModel().close() }
+}
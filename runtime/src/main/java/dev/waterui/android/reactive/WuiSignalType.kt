@@ -36,8 +36,8 @@ sealed class WuiSignalType<T>(val id: Int) {
     object WuiBool : WuiSignalType<Boolean>(0) {
         override val read: (Long) -> Boolean = NativeBindings::waterui_read_binding_bool
         override val write: (Long, Boolean) -> Unit = NativeBindings::waterui_set_binding_bool
-        override val createWatcher = { cb: WatcherCallback<Boolean> -> 
-            NativeBindings.waterui_create_bool_watcher(cb)
+        override val createWatcher = { cb: WatcherCallback<Boolean> ->
+            WatcherStructFactory.bool { value, metadata -> cb.onChanged(value, WuiWatcherMetadata(metadata)) }
         }
         override val watchComputed: (Long, WatcherStruct) -> Long = { _, _ -> 0L } // Not used for bool
         override val watchBinding: (Long, WatcherStruct) -> Long = NativeBindings::waterui_watch_binding_bool
@@ -48,8 +48,8 @@ sealed class WuiSignalType<T>(val id: Int) {
     object WuiInt : WuiSignalType<Int>(1) {
         override val read: (Long) -> Int = NativeBindings::waterui_read_binding_int
         override val write: (Long, Int) -> Unit = NativeBindings::waterui_set_binding_int
-        override val createWatcher = { cb: WatcherCallback<Int> -> 
-            NativeBindings.waterui_create_int_watcher(cb)
+        override val createWatcher = { cb: WatcherCallback<Int> ->
+            WatcherStructFactory.int { value, metadata -> cb.onChanged(value, WuiWatcherMetadata(metadata)) }
         }
         override val watchComputed: (Long, WatcherStruct) -> Long = NativeBindings::waterui_watch_computed_i32
         override val watchBinding: (Long, WatcherStruct) -> Long = NativeBindings::waterui_watch_binding_int
@@ -60,8 +60,8 @@ sealed class WuiSignalType<T>(val id: Int) {
     object WuiDouble : WuiSignalType<Double>(2) {
         override val read: (Long) -> Double = NativeBindings::waterui_read_binding_double
         override val write: (Long, Double) -> Unit = NativeBindings::waterui_set_binding_double
-        override val createWatcher = { cb: WatcherCallback<Double> -> 
-            NativeBindings.waterui_create_double_watcher(cb)
+        override val createWatcher = { cb: WatcherCallback<Double> ->
+            WatcherStructFactory.double { value, metadata -> cb.onChanged(value, WuiWatcherMetadata(metadata)) }
         }
         override val watchComputed: (Long, WatcherStruct) -> Long = NativeBindings::waterui_watch_computed_f64
         override val watchBinding: (Long, WatcherStruct) -> Long = NativeBindings::waterui_watch_binding_double
@@ -74,7 +74,7 @@ sealed class WuiSignalType<T>(val id: Int) {
             NativeBindings.waterui_read_binding_str(ptr).decodeToString()
         }
         override val write: (Long, String) -> Unit = { ptr, value ->
-            NativeBindings.waterui_set_binding_str(ptr, value.encodeToByteArray())
+            NativeBindings.waterui_set_binding_str(ptr, value)
         }
         override val createWatcher = { cb: WatcherCallback<String> -> 
             NativeBindings.waterui_create_string_watcher(cb)
@@ -113,9 +113,9 @@ sealed class WuiSignalType<T>(val id: Int) {
         // ColorScheme is represented as int (0=Light, 1=Dark)
         override val read: (Long) -> Int = NativeBindings::waterui_read_computed_color_scheme
         override val write: ((Long, Int) -> Unit)? = null // Read-only
-        override val createWatcher = { cb: WatcherCallback<Int> -> 
+        override val createWatcher = { cb: WatcherCallback<Int> ->
             // Use int watcher for color scheme
-            NativeBindings.waterui_create_int_watcher(cb)
+            WatcherStructFactory.int { value, metadata -> cb.onChanged(value, WuiWatcherMetadata(metadata)) }
         }
         override val watchComputed: (Long, WatcherStruct) -> Long = NativeBindings::waterui_watch_computed_color_scheme
         override val watchBinding: ((Long, WatcherStruct) -> Long)? = null
@@ -0,0 +1,194 @@
+package dev.waterui.android.runtime
+
+import android.content.ComponentCallbacks2
+import android.content.Context
+import android.content.res.Configuration
+import android.graphics.Bitmap
+import android.graphics.BitmapFactory
+import android.os.Build
+import android.util.Log
+import android.util.LruCache
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Deferred
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.SupervisorJob
+import kotlinx.coroutines.async
+import java.net.URL
+
+/**
+ * Process-wide cache of decoded images keyed by source URL and target size.
+ *
+ * Photos decoded for one view are reused by every other view showing the same
+ * source at a similar size, so scrolling a grid back and forth does not
+ * download or decode again. Requests for an entry that is still decoding share
+ * that decode.
+ *
+ * Target sizes are rounded up to [SIZE_BUCKET_PX] so views that differ by a few
+ * pixels share an entry; the image is subsampled to the smallest power of two
+ * that still covers the bucket. On API 26+ entries are hardware bitmaps, so the
+ * pixels live in an AHardwareBuffer owned by the graphics driver rather than
+ * on the Java heap, and on API 31+ [Bitmap.getHardwareBuffer] hands the same
+ * buffer to a GPU texture without a copy.
+ *
+ * Entries are evicted least-recently-used once [maxBytes] is exceeded, and
+ * trimmed when the system reports memory pressure.
+ */
+object DecodedImageCache {
+    private const val TAG = "WaterUI.ImageCache"
+    private const val SIZE_BUCKET_PX = 64
+    private const val TIMEOUT_MS = 10_000
+
+    data class Key(val source: String, val width: Int, val height: Int)
+
+    private val maxBytes = (Runtime.getRuntime().maxMemory() / 8)
+        .coerceAtMost(Int.MAX_VALUE.toLong())
+        .toInt()
+
+    private val cache = object : LruCache<Key, Bitmap>(maxBytes) {
+        override fun sizeOf(key: Key, value: Bitmap): Int = value.allocationByteCount
+    }
+
+    // Guarded by itself.
+    private val inFlight = HashMap<Key, Deferred<Bitmap?>>()
+
+    private val scope = CoroutineScope(SupervisorJob() + Dispatchers.IO)
+
+    private val trimCallbacks = object : ComponentCallbacks2 {
+        override fun onTrimMemory(level: Int) = trim(level)
+        override fun onConfigurationChanged(newConfig: Configuration) = Unit
+        @Deprecated("Deprecated in Java")
+        override fun onLowMemory() = cache.evictAll()
+    }
+
+    @Volatile
+    private var registered = false
+
+    /**
+     * Registers for memory-pressure callbacks. Safe to call repeatedly.
+     */
+    @JvmStatic
+    fun init(context: Context) {
+        if (registered) return
+        synchronized(this) {
+            if (registered) return
+            context.applicationContext.registerComponentCallbacks(trimCallbacks)
+            registered = true
+        }
+    }
+
+    /**
+     * Cache key for showing [source] in a [widthPx] x [heightPx] view.
+     */
+    @JvmStatic
+    fun keyFor(source: String, widthPx: Int, heightPx: Int): Key =
+        Key(source, bucket(widthPx), bucket(heightPx))
+
+    /**
+     * Returns the cached bitmap for [key] without loading it.
+     */
+    @JvmStatic
+    fun peek(key: Key): Bitmap? = cache.get(key)
+
+    /**
+     * Returns the bitmap for [key], decoding it on the IO dispatcher if it is
+     * not cached. Completes with null when the source cannot be decoded.
+     * Cancelling the caller does not cancel a decode other callers may share.
+     */
+    suspend fun load(key: Key): Bitmap? {
+        cache.get(key)?.let { return it }
+        return request(key).await()
+    }
+
+    /**
+     * Starts decoding every source not already cached or decoding, e.g. for
+     * the rows about to scroll into view.
+     */
+    @JvmStatic
+    fun prefetch(sources: List<String>, widthPx: Int, heightPx: Int) {
+        for (source in sources) {
+            val key = keyFor(source, widthPx, heightPx)
+            if (cache.get(key) == null) {
+                request(key)
+            }
+        }
+    }
+
+    /**
+     * Applies a [ComponentCallbacks2] trim level: background and moderate
+     * pressure halve the cache, critical pressure empties it.
+     */
+    @JvmStatic
+    fun trim(level: Int) {
+        @Suppress("DEPRECATION")
+        when {
+            level >= ComponentCallbacks2.TRIM_MEMORY_COMPLETE ||
+                level == ComponentCallbacks2.TRIM_MEMORY_RUNNING_CRITICAL -> cache.evictAll()
+            level >= ComponentCallbacks2.TRIM_MEMORY_BACKGROUND ||
+                level == ComponentCallbacks2.TRIM_MEMORY_RUNNING_LOW ||
+                level == ComponentCallbacks2.TRIM_MEMORY_UI_HIDDEN -> cache.trimToSize(maxBytes / 2)
+        }
+    }
+
+    private fun request(key: Key): Deferred<Bitmap?> {
+        synchronized(inFlight) {
+            inFlight[key]?.let { return it }
+            // The decode cannot remove itself before it is registered: it
+            // needs the lock held here.
+            val deferred = scope.async {
+                try {
+                    decode(key)?.also { cache.put(key, it) }
+                } finally {
+                    synchronized(inFlight) { inFlight.remove(key) }
+                }
+            }
+            inFlight[key] = deferred
+            return deferred
+        }
+    }
+
+    private fun decode(key: Key): Bitmap? {
+        val bytes = try {
+            val connection = URL(key.source).openConnection()
+            connection.connectTimeout = TIMEOUT_MS
+            connection.readTimeout = TIMEOUT_MS
+            connection.getInputStream().use { it.readBytes() }
+        } catch (e: Exception) {
+            Log.w(TAG, "Failed to read ${key.source}: ${e.message}")
+            return null
+        }
+
+        val bounds = BitmapFactory.Options().apply { inJustDecodeBounds = true }
+        BitmapFactory.decodeByteArray(bytes, 0, bytes.size, bounds)
+        if (bounds.outWidth <= 0 || bounds.outHeight <= 0) {
+            Log.w(TAG, "Cannot decode ${key.source}")
+            return null
+        }
+
+        val options = BitmapFactory.Options().apply {
+            inSampleSize = sampleSize(bounds.outWidth, bounds.outHeight, key.width, key.height)
+            if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.O) {
+                inPreferredConfig = Bitmap.Config.HARDWARE
+            }
+        }
+        return BitmapFactory.decodeByteArray(bytes, 0, bytes.size, options)
+    }
+
+    private fun bucket(px: Int): Int {
+        if (px <= 0) return 0
+        return (px + SIZE_BUCKET_PX - 1) / SIZE_BUCKET_PX * SIZE_BUCKET_PX
+    }
+
+    // Largest power of two that keeps both dimensions at or above the target.
+    // A zero target dimension does not constrain the sample size.
+    private fun sampleSize(width: Int, height: Int, targetWidth: Int, targetHeight: Int): Int {
+        if (targetWidth <= 0 && targetHeight <= 0) return 1
+        var sample = 1
+        while (true) {
+            val next = sample * 2
+            val fitsWidth = targetWidth <= 0 || width / next >= targetWidth
+            val fitsHeight = targetHeight <= 0 || height / next >= targetHeight
+            if (!fitsWidth || !fitsHeight) return sample
+            sample = next
+        }
+    }
+}
@@ -0,0 +1,58 @@
+package dev.waterui.android.runtime
+
+import java.nio.ByteBuffer
+import java.nio.CharBuffer
+import java.nio.charset.CharsetEncoder
+import java.nio.charset.CodingErrorAction
+
+/**
+ * Per-thread direct buffer for handing UTF-8 strings to native code.
+ *
+ * Text crosses JNI without a `byte[]` allocation. Native code may only read the
+ * buffer during the call; anything that outlives it is copied out first.
+ */
+internal object DirectUtf8 {
+    private const val INITIAL_CAPACITY = 256
+
+    private class Scratch {
+        val encoder: CharsetEncoder = Charsets.UTF_8.newEncoder()
+            .onMalformedInput(CodingErrorAction.REPLACE)
+            .onUnmappableCharacter(CodingErrorAction.REPLACE)
+        var buffer: ByteBuffer = ByteBuffer.allocateDirect(INITIAL_CAPACITY)
+    }
+
+    private val scratch = object : ThreadLocal<Scratch>() {
+        override fun initialValue() = Scratch()
+    }
+
+    /**
+     * Encodes [value] into this thread's buffer and passes it with its byte length
+     * to [block]. With [wipe], the bytes are zeroed afterwards (secure text).
+     */
+    inline fun <R> withUtf8(value: String, wipe: Boolean = false, block: (ByteBuffer, Int) -> R): R {
+        val buffer = encode(value)
+        val length = buffer.position()
+        try {
+            return block(buffer, length)
+        } finally {
+            if (wipe) {
+                for (i in 0 until length) buffer.put(i, 0)
+            }
+        }
+    }
+
+    fun encode(value: String): ByteBuffer {
+        val state = scratch.get()!!
+        // UTF-8 needs at most 3 bytes per UTF-16 unit
+        val needed = value.length * 3
+        if (state.buffer.capacity() < needed) {
+            state.buffer = ByteBuffer.allocateDirect(Integer.highestOneBit(needed) shl 1)
+        }
+        val buffer = state.buffer
+        buffer.clear()
+        state.encoder.reset()
+        state.encoder.encode(CharBuffer.wrap(value), buffer, true)
+        state.encoder.flush(buffer)
+        return buffer
+    }
+}
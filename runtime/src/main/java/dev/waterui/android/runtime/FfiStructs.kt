@@ -89,16 +89,38 @@ data class SubViewStruct(
         // Convert pixel result back to dp for Rust
         return SizeStruct(view.measuredWidth.toFloat() / density, view.measuredHeight.toFloat() / density)
     }
+}
 
-    private fun proposalToMeasureSpec(proposalPx: Float): Int {
-        return when {
-            proposalPx.isNaN() -> android.view.View.MeasureSpec.makeMeasureSpec(0, android.view.View.MeasureSpec.UNSPECIFIED)
-            proposalPx.isInfinite() -> android.view.View.MeasureSpec.makeMeasureSpec(0, android.view.View.MeasureSpec.UNSPECIFIED)
-            else -> android.view.View.MeasureSpec.makeMeasureSpec(proposalPx.toInt().coerceAtLeast(0), android.view.View.MeasureSpec.AT_MOST)
-        }
+/** Converts a proposal in pixels to a MeasureSpec; NaN/infinite means unspecified. */
+internal fun proposalToMeasureSpec(proposalPx: Float): Int {
+    return when {
+        proposalPx.isNaN() -> android.view.View.MeasureSpec.makeMeasureSpec(0, android.view.View.MeasureSpec.UNSPECIFIED)
+        proposalPx.isInfinite() -> android.view.View.MeasureSpec.makeMeasureSpec(0, android.view.View.MeasureSpec.UNSPECIFIED)
+        else -> android.view.View.MeasureSpec.makeMeasureSpec(proposalPx.toInt().coerceAtLeast(0), android.view.View.MeasureSpec.AT_MOST)
     }
 }
 
+/**
+ * Fallback measurement hook for the bulk layout entry points
+ * ([NativeBindings.waterui_layout_size_that_fits_bulk] and
+ * [NativeBindings.waterui_layout_place_bulk]).
+ *
+ * Native code answers measure probes from the pre-measured table and only calls
+ * this when Rust asks for a proposal that is not in the table.
+ */
+fun interface SubViewMeasurer {
+    /**
+     * Measures child [index] for a proposal in dp.
+     *
+     * @return The measured size in dp, packed with [packSize].
+     */
+    fun measureSubView(index: Int, proposalWidth: Float, proposalHeight: Float): Long
+}
+
+/** Packs a size into a Long (width in the high 32 bits) for [SubViewMeasurer]. */
+fun packSize(width: Float, height: Float): Long =
+    (width.toRawBits().toLong() shl 32) or (height.toRawBits().toLong() and 0xFFFFFFFFL)
+
 // ========== Safe Area Structs ==========
 
 /**
@@ -699,6 +721,31 @@ data class StyledStrStruct(val chunks: Array<StyledChunkStruct>) {
 
 data class StyledChunkStruct(val text: String, val style: TextStyleStruct)
 
+/**
+ * Flat styled string: the whole text plus parallel run tables.
+ * Run i is `runs[i * 3 ..]` = (start, length, flags) in UTF-16 units and
+ * `styles[i * 3 ..]` = (font, foreground, background) native pointers.
+ */
+data class FlatStyledStrStruct(val text: String, val runs: IntArray, val styles: LongArray) {
+    val runCount: Int get() = runs.size / RUN_STRIDE
+
+    override fun equals(other: Any?): Boolean {
+        if (this === other) return true
+        if (other !is FlatStyledStrStruct) return false
+        return text == other.text && runs.contentEquals(other.runs) && styles.contentEquals(other.styles)
+    }
+    override fun hashCode(): Int = 31 * (31 * text.hashCode() + runs.contentHashCode()) + styles.contentHashCode()
+
+    companion object {
+        const val RUN_STRIDE = 3
+        const val STYLE_STRIDE = 3
+
+        const val FLAG_ITALIC = 1 shl 0
+        const val FLAG_UNDERLINE = 1 shl 1
+        const val FLAG_STRIKETHROUGH = 1 shl 2
+    }
+}
+
 data class TextStyleStruct(
     val fontPtr: Long,
     val italic: Boolean,
@@ -710,6 +757,24 @@ data class TextStyleStruct(
 
 data class PickerItemStruct(val tag: Int, val label: StyledStrStruct)
 
+/**
+ * Keyed change set for picker items (see [DiffOp]). [tags] is the full new tag
+ * list; [labels] holds one label per inserted, updated or reloaded position in
+ * ascending index order, owned by the receiver.
+ */
+data class PickerItemsDiffStruct(
+    val ops: IntArray,
+    val tags: IntArray,
+    val labels: Array<FlatStyledStrStruct>
+) {
+    override fun equals(other: Any?): Boolean {
+        if (this === other) return true
+        if (other !is PickerItemsDiffStruct) return false
+        return ops.contentEquals(other.ops) && tags.contentEquals(other.tags) && labels.contentEquals(other.labels)
+    }
+    override fun hashCode(): Int = 31 * (31 * ops.contentHashCode() + tags.contentHashCode()) + labels.contentHashCode()
+}
+
 // ========== Photo Structs ==========
 
 /**
@@ -768,6 +833,41 @@ data class WebViewStruct(val webviewPtr: Long)
  */
 data class GpuSurfaceStruct(val rendererPtr: Long)
 
+/**
+ * Frame timing of a native GPU render driver. Per-frame arrays are oldest first:
+ * vsync timestamp, delay from vsync to render start, and CPU time in render.
+ */
+class GpuSurfaceStats(
+    val framesRendered: Long,
+    val framesSkipped: Long,
+    val reconfigurations: Long,
+    val vsyncNanos: LongArray,
+    val startLatencyNanos: LongArray,
+    val cpuNanos: LongArray
+) {
+    companion object {
+        const val HEADER_SIZE = 4
+        const val RECORD_STRIDE = 3
+        const val MAX_RECORDS = 128
+
+        /** Buffer size that holds every record the driver keeps. */
+        const val BUFFER_SIZE = HEADER_SIZE + MAX_RECORDS * RECORD_STRIDE
+
+        fun read(driverPtr: Long, buffer: LongArray = LongArray(BUFFER_SIZE)): GpuSurfaceStats? {
+            if (NativeBindings.waterui_gpu_surface_stats(driverPtr, buffer) < HEADER_SIZE) return null
+            val count = buffer[3].toInt()
+            return GpuSurfaceStats(
+                framesRendered = buffer[0],
+                framesSkipped = buffer[1],
+                reconfigurations = buffer[2],
+                vsyncNanos = LongArray(count) { buffer[HEADER_SIZE + it * RECORD_STRIDE] },
+                startLatencyNanos = LongArray(count) { buffer[HEADER_SIZE + it * RECORD_STRIDE + 1] },
+                cpuNanos = LongArray(count) { buffer[HEADER_SIZE + it * RECORD_STRIDE + 2] }
+            )
+        }
+    }
+}
+
 // ========== MediaPicker Structs ==========
 
 /**
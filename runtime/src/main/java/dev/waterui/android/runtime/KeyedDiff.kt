@@ -0,0 +1,90 @@
+package dev.waterui.android.runtime
+
+/**
+ * Op kinds of a packed keyed change set produced by the JNI bridge.
+ *
+ * Each op is [STRIDE] ints: (kind, position, count), except [MOVE] which is
+ * (kind, from, to). Ops are replayed in order against the previous list;
+ * insert and update positions are final indices in the new list.
+ */
+object DiffOp {
+    const val REMOVE = 0
+    const val INSERT = 1
+    const val MOVE = 2
+    const val UPDATE = 3
+    const val RELOAD = 4
+
+    const val STRIDE = 3
+}
+
+/** Receives the structural changes applied by [applyKeyedDiff]. */
+interface KeyedDiffListener {
+    fun onRemoved(position: Int, count: Int) {}
+    fun onInserted(position: Int, count: Int) {}
+    fun onMoved(from: Int, to: Int) {}
+    fun onUpdated(position: Int, count: Int) {}
+    fun onReloaded(count: Int) {}
+}
+
+/**
+ * Marks the new-list indices whose items are carried by a change set:
+ * inserted, updated or reloaded positions.
+ */
+fun keyedDiffPayloadMask(ops: IntArray, newCount: Int): BooleanArray {
+    val mask = BooleanArray(newCount)
+    for (i in ops.indices step DiffOp.STRIDE) {
+        when (ops[i]) {
+            DiffOp.INSERT, DiffOp.UPDATE, DiffOp.RELOAD -> {
+                val start = ops[i + 1]
+                for (index in start until start + ops[i + 2]) mask[index] = true
+            }
+        }
+    }
+    return mask
+}
+
+/**
+ * Replays [ops] onto this list. [payload] supplies the item for a new-list
+ * index that was inserted, updated or reloaded; [discard] sees every item that
+ * leaves the list.
+ */
+fun <T> MutableList<T>.applyKeyedDiff(
+    ops: IntArray,
+    payload: (Int) -> T,
+    discard: (T) -> Unit = {},
+    listener: KeyedDiffListener? = null
+) {
+    for (i in ops.indices step DiffOp.STRIDE) {
+        val a = ops[i + 1]
+        val b = ops[i + 2]
+        when (ops[i]) {
+            DiffOp.REMOVE -> {
+                val range = subList(a, a + b)
+                range.forEach(discard)
+                range.clear()
+                listener?.onRemoved(a, b)
+            }
+            DiffOp.INSERT -> {
+                addAll(a, List(b) { payload(a + it) })
+                listener?.onInserted(a, b)
+            }
+            DiffOp.MOVE -> {
+                add(b, removeAt(a))
+                listener?.onMoved(a, b)
+            }
+            DiffOp.UPDATE -> {
+                for (index in a until a + b) {
+                    discard(this[index])
+                    this[index] = payload(index)
+                }
+                listener?.onUpdated(a, b)
+            }
+            DiffOp.RELOAD -> {
+                forEach(discard)
+                clear()
+                addAll(List(b) { payload(it) })
+                listener?.onReloaded(b)
+            }
+        }
+    }
+}
@@ -6,8 +6,13 @@ import android.os.Build
 import android.webkit.MimeTypeMap
 import java.io.File
 import java.io.FileOutputStream
+import java.io.InputStream
+import java.util.concurrent.CancellationException
 import java.util.concurrent.ConcurrentHashMap
-import java.util.concurrent.Executors
+import java.util.concurrent.FutureTask
+import java.util.concurrent.LinkedBlockingQueue
+import java.util.concurrent.ThreadPoolExecutor
+import java.util.concurrent.TimeUnit
 import java.util.concurrent.atomic.AtomicInteger
 
 /**
@@ -24,16 +29,53 @@ object MediaType {
  *
  * This singleton manages:
  * 1. Registration of selected media URIs with unique IDs
- * 2. Loading media from content:// URIs to temp files
+ * 2. Loading media from content:// URIs to temp files on a bounded worker pool
  * 3. Motion Photo detection and splitting
- * 4. Callback to Rust when loading completes
+ * 4. Completing the native load request when loading finishes or fails
  * 5. Caching of loaded results to allow multiple loads of the same selection
+ * 6. Cancelling loads when the picker that produced a selection is disposed
+ *
+ * Every request handle passed to [loadMedia] is completed exactly once, through
+ * [nativeCompleteMediaLoad] or [nativeFailMediaLoad].
  */
 object MediaLoader {
+    private const val TAG = "MediaLoader"
+    private const val COPY_BUFFER_SIZE = 64 * 1024
+
+    /**
+     * Loads waiting for a worker. When full, the oldest waiting load is failed
+     * to make room: after a fast scroll it belongs to a row no longer shown.
+     */
+    private const val MAX_QUEUED_LOADS = 16
+
+    /** Selections not tied to a picker view; never released. */
+    const val NO_OWNER = 0
+
+    private val workerCount = Runtime.getRuntime().availableProcessors().coerceIn(1, 2)
     private val nextId = AtomicInteger(1)
+    private val nextOwner = AtomicInteger(1)
     private val pendingMedia = ConcurrentHashMap<Int, PendingMedia>()
     private val loadedResults = ConcurrentHashMap<Int, LoadResult>()
-    private val executor = Executors.newCachedThreadPool()
+
+    // Guarded by itself, together with loadedResults writes, so a request
+    // either joins an in-flight load, hits the cache, or starts a new load.
+    private val inFlight = HashMap<Int, LoadTask>()
+
+    private val executor = ThreadPoolExecutor(
+        workerCount,
+        workerCount,
+        30,
+        TimeUnit.SECONDS,
+        LinkedBlockingQueue(MAX_QUEUED_LOADS),
+        { runnable -> Thread(runnable, "WaterUI-media").apply { isDaemon = true } },
+        { runnable, pool ->
+            // Evict until the new load fits; another thread may refill the
+            // queue between poll and offer.
+            while (!pool.isShutdown && !pool.queue.offer(runnable)) {
+                (pool.queue.poll() as? LoadFuture)?.let(::evict)
+            }
+        }
+    ).apply { allowCoreThreadTimeOut(true) }
 
     private var appContext: Context? = null
 
@@ -42,7 +84,8 @@ object MediaLoader {
      */
     data class PendingMedia(
         val uri: Uri,
-        val mimeType: String?
+        val mimeType: String?,
+        val owner: Int = NO_OWNER
     )
 
     /**
@@ -54,6 +97,19 @@ object MediaLoader {
         val mediaType: Byte
     )
 
+    /**
+     * One copy of a selection, shared by every request made while it runs.
+     */
+    private class LoadTask {
+        val requests = ArrayList<Long>()
+        @Volatile var cancelled = false
+        var future: LoadFuture? = null
+    }
+
+    /** The queued run of a [LoadTask]; lets the rejection policy find it. */
+    private class LoadFuture(val id: Int, val task: LoadTask, body: Runnable) :
+        FutureTask<Unit>(body, Unit)
+
     /**
      * Initialize with application context.
      * Must be called before any media loading.
@@ -63,75 +119,166 @@ object MediaLoader {
         appContext = context.applicationContext
     }
 
+    /**
+     * Allocates an owner token for a picker; pass it to [register] and call
+     * [release] with it when the picker is disposed.
+     */
+    @JvmStatic
+    fun newOwner(): Int = nextOwner.getAndIncrement()
+
     /**
      * Register a content URI and return its unique ID.
      * Called when user selects media from the picker.
      */
     @JvmStatic
-    fun register(uri: Uri, mimeType: String? = null): Int {
+    fun register(uri: Uri, mimeType: String? = null, owner: Int = NO_OWNER): Int {
         val id = nextId.getAndIncrement()
-        pendingMedia[id] = PendingMedia(uri, mimeType)
+        pendingMedia[id] = PendingMedia(uri, mimeType, owner)
         return id
     }
 
     /**
-     * Load media by ID and invoke callback when done.
-     * Called from JNI when Rust's Selected::load() is invoked.
-     * Supports multiple loads of the same selection via caching.
+     * Queue a load by ID. Called from JNI when Rust's Selected::load() is
+     * invoked; returns immediately. Repeated loads of the same selection share
+     * the in-flight copy or the cached result.
      *
      * @param id The media selection ID
-     * @param callbackData Opaque pointer to callback data
-     * @param callFnPtr Function pointer to invoke callback
+     * @param request Native request handle, completed exactly once
      */
     @JvmStatic
-    fun loadMedia(id: Int, callbackData: Long, callFnPtr: Long) {
-        // Check cache first for repeated loads
-        val cachedResult = loadedResults[id]
-        if (cachedResult != null) {
-            nativeCompleteMediaLoad(
-                callbackData,
-                callFnPtr,
-                cachedResult.imageUrl,
-                cachedResult.videoUrl,
-                cachedResult.mediaType
-            )
+    fun loadMedia(id: Int, request: Long) {
+        var queued = false
+        var started: LoadFuture? = null
+        val cached = synchronized(inFlight) {
+            loadedResults[id] ?: run {
+                val pending = pendingMedia[id]
+                val context = appContext
+                if (pending != null && context != null) {
+                    val existing = inFlight[id]
+                    if (existing != null) {
+                        existing.requests.add(request)
+                    } else {
+                        val task = LoadTask()
+                        task.requests.add(request)
+                        inFlight[id] = task
+                        started = LoadFuture(id, task) { runLoad(id, context, pending, task) }
+                        task.future = started
+                    }
+                    queued = true
+                }
+                null
+            }
+        }
+        if (queued) {
+            // Outside the lock: a full queue evicts, which completes requests.
+            started?.let(executor::execute)
             return
         }
+        if (cached != null) {
+            nativeCompleteMediaLoad(request, cached.imageUrl, cached.videoUrl, cached.mediaType)
+        } else if (appContext == null) {
+            nativeFailMediaLoad(request, "MediaLoader: context not initialized")
+        } else {
+            nativeFailMediaLoad(request, "MediaLoader: no media found for id $id")
+        }
+    }
+
+    /**
+     * Cancel and forget every selection registered with [owner]: in-flight
+     * loads complete as failed and cached temp files are deleted.
+     */
+    @JvmStatic
+    fun release(owner: Int) {
+        if (owner == NO_OWNER) return
+        val ids = pendingMedia.entries.filter { it.value.owner == owner }.map { it.key }
+        if (ids.isEmpty()) return
+
+        val cancelled = ArrayList<Long>()
+        val stale = ArrayList<LoadResult>()
+        synchronized(inFlight) {
+            for (id in ids) {
+                pendingMedia.remove(id)
+                loadedResults.remove(id)?.let(stale::add)
+                val task = inFlight.remove(id) ?: continue
+                task.cancelled = true
+                task.future?.cancel(true)
+                cancelled.addAll(task.requests)
+            }
+        }
+        for (request in cancelled) {
+            nativeFailMediaLoad(request, "MediaLoader: load cancelled")
+        }
+        stale.forEach(::deleteResultFiles)
+    }
+
+    /** Fails a queued load that was pushed out by newer ones. */
+    private fun evict(future: LoadFuture) {
+        future.cancel(false)
+        val requests = synchronized(inFlight) {
+            if (inFlight[future.id] !== future.task) return
+            inFlight.remove(future.id)
+            future.task.cancelled = true
+            ArrayList(future.task.requests)
+        }
+        for (request in requests) {
+            nativeFailMediaLoad(request, "MediaLoader: load superseded by newer requests")
+        }
+    }
+
+    private fun runLoad(id: Int, context: Context, pending: PendingMedia, task: LoadTask) {
+        var failure: String? = null
+        val result = try {
+            loadMediaSync(context, pending, task)
+        } catch (e: CancellationException) {
+            failure = "MediaLoader: load cancelled"
+            null
+        } catch (e: Exception) {
+            android.util.Log.e(TAG, "Failed to load media $id: ${e.message}", e)
+            failure = "MediaLoader: ${e.message ?: e.javaClass.simpleName}"
+            null
+        }
 
-        val pending = pendingMedia[id]
-            ?: error("MediaLoader.loadMedia: no media found for id $id")
-
-        val context = appContext
-            ?: error("MediaLoader.loadMedia: context not initialized")
-
-        // Load asynchronously
-        executor.execute {
-            val result = loadMediaSync(context, pending)
-            // Cache the result for future loads
-            loadedResults[id] = result
-            nativeCompleteMediaLoad(
-                callbackData,
-                callFnPtr,
-                result.imageUrl,
-                result.videoUrl,
-                result.mediaType
-            )
+        val requests: List<Long>
+        synchronized(inFlight) {
+            if (inFlight[id] !== task) {
+                // Released while copying; release() already failed the requests.
+                result?.let(::deleteResultFiles)
+                return
+            }
+            inFlight.remove(id)
+            if (result != null) {
+                loadedResults[id] = result
+            }
+            requests = ArrayList(task.requests)
+        }
+        for (request in requests) {
+            if (result != null) {
+                nativeCompleteMediaLoad(request, result.imageUrl, result.videoUrl, result.mediaType)
+            } else {
+                nativeFailMediaLoad(request, failure ?: "MediaLoader: load failed")
+            }
+        }
+    }
+
+    private fun deleteResultFiles(result: LoadResult) {
+        for (url in listOfNotNull(result.imageUrl, result.videoUrl)) {
+            File(url.removePrefix("file://")).delete()
         }
     }
 
     /**
      * Synchronously load media, handling Motion Photos specially.
      */
-    private fun loadMediaSync(context: Context, pending: PendingMedia): LoadResult {
+    private fun loadMediaSync(context: Context, pending: PendingMedia, task: LoadTask): LoadResult {
         val resolvedMime = pending.mimeType ?: context.contentResolver.getType(pending.uri)
 
         // Check if it's a Motion Photo (Google Photos' Live Photo equivalent)
         if (isMotionPhoto(context, pending.uri)) {
-            return loadMotionPhoto(context, pending.uri, resolvedMime)
+            return loadMotionPhoto(context, pending.uri, resolvedMime, task)
         }
 
         // Regular image or video
-        val fileUrl = copyToTempFile(context, pending.uri, resolvedMime)
+        val fileUrl = copyToTempFile(context, pending.uri, resolvedMime, task)
         val mediaType = detectMediaType(resolvedMime)
         return LoadResult(fileUrl, null, mediaType)
     }
@@ -159,21 +306,35 @@ object MediaLoader {
                 false
             } ?: false
         } catch (e: Exception) {
-            android.util.Log.w("MediaLoader", "Failed to check Motion Photo: ${e.message}")
+            android.util.Log.w(TAG, "Failed to check Motion Photo: ${e.message}")
             false
         }
     }
 
     /**
      * Load a Motion Photo, extracting both image and video components.
+     * Falls back to a still image when the video cannot be extracted.
      */
-    private fun loadMotionPhoto(context: Context, uri: Uri, mimeType: String?): LoadResult {
+    private fun loadMotionPhoto(
+        context: Context,
+        uri: Uri,
+        mimeType: String?,
+        task: LoadTask
+    ): LoadResult {
         // Copy the main image file
-        val imageUrl = copyToTempFile(context, uri, mimeType, suffix = "_image")
+        val imageUrl = copyToTempFile(context, uri, mimeType, task, suffix = "_image")
 
         // Try to extract the video component
-        val videoUrl = extractMotionPhotoVideo(context, uri)
-            ?: error("MediaLoader: failed to extract video from Motion Photo")
+        val videoUrl = try {
+            extractMotionPhotoVideo(context, uri, task)
+        } catch (e: CancellationException) {
+            File(imageUrl.removePrefix("file://")).delete()
+            throw e
+        }
+        if (videoUrl == null) {
+            android.util.Log.w(TAG, "Motion Photo video unavailable, loading as image")
+            return LoadResult(imageUrl, null, MediaType.IMAGE)
+        }
 
         return LoadResult(imageUrl, videoUrl, MediaType.MOTION_PHOTO)
     }
@@ -184,7 +345,7 @@ object MediaLoader {
      * Motion Photos have video data embedded after the JPEG data.
      * On Android R+, we can use MediaStore to get the video offset.
      */
-    private fun extractMotionPhotoVideo(context: Context, uri: Uri): String? {
+    private fun extractMotionPhotoVideo(context: Context, uri: Uri, task: LoadTask): String? {
         if (Build.VERSION.SDK_INT < Build.VERSION_CODES.R) {
             return null
         }
@@ -205,7 +366,7 @@ object MediaLoader {
             }
 
             if (videoOffset <= 0) {
-                android.util.Log.w("MediaLoader", "Motion Photo video offset not found or invalid: $videoOffset")
+                android.util.Log.w(TAG, "Motion Photo video offset not found or invalid: $videoOffset")
                 return null
             }
 
@@ -216,19 +377,19 @@ object MediaLoader {
                 // Skip to video offset
                 val skipped = input.skip(videoOffset)
                 if (skipped != videoOffset) {
-                    android.util.Log.w("MediaLoader", "Failed to skip to video offset: skipped $skipped, expected $videoOffset")
+                    android.util.Log.w(TAG, "Failed to skip to video offset: skipped $skipped, expected $videoOffset")
                     return null
                 }
 
                 // Write remaining bytes to video file
-                FileOutputStream(tempFile).use { output ->
-                    input.copyTo(output)
-                }
+                copyCancellable(input, tempFile, task)
 
                 return "file://${tempFile.absolutePath}"
             }
+        } catch (e: CancellationException) {
+            throw e
         } catch (e: Exception) {
-            android.util.Log.e("MediaLoader", "Failed to extract Motion Photo video: ${e.message}", e)
+            android.util.Log.e(TAG, "Failed to extract Motion Photo video: ${e.message}", e)
         }
 
         return null
@@ -241,20 +402,45 @@ object MediaLoader {
         context: Context,
         uri: Uri,
         mimeType: String?,
+        task: LoadTask,
         suffix: String = ""
     ): String {
         val extension = getExtension(context, uri, mimeType)
         val tempFile = File.createTempFile("media${suffix}_", ".$extension", context.cacheDir)
 
-        context.contentResolver.openInputStream(uri)?.use { input ->
-            FileOutputStream(tempFile).use { output ->
-                input.copyTo(output)
-            }
-        } ?: error("MediaLoader: cannot open input stream for $uri")
+        val input = context.contentResolver.openInputStream(uri)
+        if (input == null) {
+            tempFile.delete()
+            error("cannot open input stream for $uri")
+        }
+        input.use { copyCancellable(it, tempFile, task) }
 
         return "file://${tempFile.absolutePath}"
     }
 
+    /**
+     * Copy [input] into [target], checking for cancellation between chunks.
+     * The partial file is deleted if the copy fails or is cancelled.
+     */
+    private fun copyCancellable(input: InputStream, target: File, task: LoadTask) {
+        try {
+            FileOutputStream(target).use { output ->
+                val buffer = ByteArray(COPY_BUFFER_SIZE)
+                while (true) {
+                    if (task.cancelled || Thread.currentThread().isInterrupted) {
+                        throw CancellationException()
+                    }
+                    val read = input.read(buffer)
+                    if (read < 0) break
+                    output.write(buffer, 0, read)
+                }
+            }
+        } catch (e: Exception) {
+            target.delete()
+            throw e
+        }
+    }
+
     /**
      * Get file extension from URI or MIME type.
      */
@@ -296,20 +482,25 @@ object MediaLoader {
 
     /**
      * Native method to complete media loading.
-     * Calls back into Rust with the result.
+     * Calls back into Rust with the result and consumes the request.
      *
-     * @param callbackData Opaque pointer to callback data
-     * @param callFnPtr Function pointer to invoke callback
+     * @param request Native request handle passed to [loadMedia]
      * @param imageUrl The image file URL (always present)
      * @param videoUrl The video file URL (only for Motion Photos)
      * @param mediaType The media type (0=Image, 1=Video, 2=MotionPhoto)
      */
     @JvmStatic
     private external fun nativeCompleteMediaLoad(
-        callbackData: Long,
-        callFnPtr: Long,
+        request: Long,
         imageUrl: String,
         videoUrl: String?,
         mediaType: Byte
     )
+
+    /**
+     * Native method to fail a media load. Logs [message] and completes the
+     * Rust callback with an empty result, consuming the request.
+     */
+    @JvmStatic
+    private external fun nativeFailMediaLoad(request: Long, message: String)
 }
@@ -0,0 +1,61 @@
+package dev.waterui.android.runtime
+
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+
+/**
+ * A run of nested filter and opacity modifiers peeled off a view in one
+ * native call.
+ *
+ * [kinds] and [valuePtrs] are outermost first; each value is the layer's
+ * `Computed<f32>`, now owned by the caller. [contentPtr] is the first view
+ * below the run, not yet consumed.
+ */
+class MetadataChain private constructor(
+    val kinds: IntArray,
+    val valuePtrs: LongArray,
+    val contentPtr: Long
+) {
+    val size: Int get() = kinds.size
+
+    companion object {
+        // Layer kinds, mirroring MetadataChainKind in waterui_jni.cpp.
+        const val KIND_BLUR = 0
+        const val KIND_BRIGHTNESS = 1
+        const val KIND_SATURATION = 2
+        const val KIND_CONTRAST = 3
+        const val KIND_HUE_ROTATION = 4
+        const val KIND_GRAYSCALE = 5
+        const val KIND_OPACITY = 6
+
+        private const val HEADER_SIZE = 16
+        private const val RECORD_SIZE = 16
+
+        // Longer runs stop here; the rest is peeled when the content inflates.
+        private const val MAX_LAYERS = 16
+
+        private val scratch = object : ThreadLocal<ByteBuffer>() {
+            override fun initialValue(): ByteBuffer =
+                ByteBuffer.allocateDirect(HEADER_SIZE + MAX_LAYERS * RECORD_SIZE)
+                    .order(ByteOrder.nativeOrder())
+        }
+
+        /**
+         * Consumes [viewPtr], which must be a filter or opacity layer, and the
+         * layers directly below it.
+         */
+        fun peel(viewPtr: Long): MetadataChain? {
+            val buffer = scratch.get()!!
+            val count = NativeBindings.waterui_peel_metadata_chain(viewPtr, buffer)
+            if (count < 0) return null
+            val kinds = IntArray(count)
+            val valuePtrs = LongArray(count)
+            for (i in 0 until count) {
+                val offset = HEADER_SIZE + i * RECORD_SIZE
+                kinds[i] = buffer.getInt(offset)
+                valuePtrs[i] = buffer.getLong(offset + 8)
+            }
+            return MetadataChain(kinds, valuePtrs, buffer.getLong(0))
+        }
+    }
+}
@@ -0,0 +1,122 @@
+package dev.waterui.android.runtime
+
+import android.os.Looper
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+import java.nio.FloatBuffer
+import java.nio.IntBuffer
+
+/**
+ * Animates f32 computeds natively.
+ *
+ * Each bound computed gets a slot in the native animation engine. Emits never
+ * reach Kotlin: the engine reads the emit's animation, interpolates on the main
+ * thread's Choreographer and, once per frame, writes the new values into a
+ * shared direct buffer and calls [onFrame] with the slots that changed. A view
+ * property animated this way costs one lambda call per frame instead of a
+ * watcher upcall, four animation-metadata JNI calls and an animator object.
+ *
+ * Linear, ease and spring curves match [interpolatorFor] and [springForceFrom].
+ * [watch] returns null when the engine is unavailable or full; callers then
+ * fall back to a Kotlin watcher and [AnimatedFloat].
+ */
+object NativeAnimator {
+    private const val CAPACITY = 1024
+
+    /** Smallest visible changes, as used by DynamicAnimation. */
+    const val MIN_VISIBLE_CHANGE_ALPHA = 1f / 256f
+    const val MIN_VISIBLE_CHANGE_SCALE = 1f / 500f
+    const val MIN_VISIBLE_CHANGE_DP = 0.1f
+
+    // CAPACITY slot values, then CAPACITY changed-slot indices.
+    private val buffer: ByteBuffer = ByteBuffer.allocateDirect(CAPACITY * 8)
+        .order(ByteOrder.nativeOrder())
+    private val values: FloatBuffer = buffer.asFloatBuffer()
+    private val changed: IntBuffer = run {
+        buffer.position(CAPACITY * 4)
+        buffer.slice().order(ByteOrder.nativeOrder()).asIntBuffer().also { buffer.position(0) }
+    }
+
+    // Main thread only.
+    private val appliers = arrayOfNulls<(Float) -> Unit>(CAPACITY)
+    private var initialized = false
+    private var available = false
+
+    /** An animated binding; [close] stops watching and frees the slot. */
+    class Binding internal constructor(private val slot: Int, private val guard: Long) : AutoCloseable {
+        private var closed = false
+
+        override fun close() {
+            if (closed) return
+            closed = true
+            if (guard != 0L) NativeBindings.waterui_drop_watcher_guard(guard)
+            NativeBindings.waterui_animator_close_slot(slot)
+            appliers[slot] = null
+        }
+    }
+
+    /**
+     * Watches [computedPtr] and calls [apply] on the main thread with each
+     * animated value, starting with [initial]. Must be called on the main
+     * thread; the caller still owns [computedPtr].
+     */
+    fun watch(
+        computedPtr: Long,
+        initial: Float,
+        minVisibleChange: Float,
+        apply: (Float) -> Unit
+    ): Binding? {
+        if (computedPtr == 0L || !ensureInitialized()) return null
+        val slot = NativeBindings.waterui_animator_open_slot(initial, minVisibleChange)
+        if (slot < 0) return null
+        val watcher = NativeBindings.waterui_create_animated_float_watcher(slot)
+        if (watcher == null) {
+            NativeBindings.waterui_animator_close_slot(slot)
+            return null
+        }
+        appliers[slot] = apply
+        apply(initial)
+        val guard = NativeBindings.waterui_watch_computed_f32(computedPtr, watcher)
+        return Binding(slot, guard)
+    }
+
+    /** One property for [watchAll]. */
+    class Target(val computedPtr: Long, val initial: Float, val apply: (Float) -> Unit)
+
+    /**
+     * Binds every target with a non-zero computed, or none: returns null after
+     * closing any it bound if one cannot be animated natively, so properties
+     * that animate together do not end up split across two mechanisms.
+     */
+    fun watchAll(minVisibleChange: Float, vararg targets: Target): List<Binding>? {
+        val bindings = ArrayList<Binding>(targets.size)
+        for (target in targets) {
+            if (target.computedPtr == 0L) continue
+            val binding = watch(target.computedPtr, target.initial, minVisibleChange, target.apply)
+            if (binding == null) {
+                bindings.forEach { it.close() }
+                return null
+            }
+            bindings.add(binding)
+        }
+        return bindings
+    }
+
+    private fun ensureInitialized(): Boolean {
+        if (Looper.myLooper() != Looper.getMainLooper()) return false
+        if (!initialized) {
+            initialized = true
+            available = NativeBindings.waterui_animator_init(buffer, CAPACITY)
+        }
+        return available
+    }
+
+    /** Called by the native engine on the main thread once per animated frame. */
+    @JvmStatic
+    fun onFrame(count: Int) {
+        for (i in 0 until count) {
+            val slot = changed.get(i)
+            appliers[slot]?.invoke(values.get(slot))
+        }
+    }
+}
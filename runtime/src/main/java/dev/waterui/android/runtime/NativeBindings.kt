@@ -1,6 +1,10 @@
 package dev.waterui.android.runtime
 
 import dev.waterui.android.ffi.WatcherJni
+import dev.waterui.android.reactive.BoolWatcherCallback
+import dev.waterui.android.reactive.DoubleWatcherCallback
+import dev.waterui.android.reactive.FloatWatcherCallback
+import dev.waterui.android.reactive.IntWatcherCallback
 import dev.waterui.android.reactive.WatcherCallback
 
 /**
@@ -13,22 +17,34 @@ internal object NativeBindings {
 
     /**
      * Bootstrap the native library. Must be called before any other functions.
-     * This loads libwaterui_app.so via dlopen and resolves all symbols.
+     * This loads libwaterui_app.so via dlopen and resolves all symbols, and
+     * names native threads attached from then on "<threadNamePrefix>-<tid>".
      */
-    fun bootstrapNativeBindings() {
+    fun bootstrapNativeBindings(threadNamePrefix: String) {
         // Initialize WatcherJni - this loads libwaterui_app.so via dlopen
         WatcherJni
+        // Before waterui_init, so threads spawned while creating the app are named too
+        waterui_set_native_thread_name_prefix(threadNamePrefix)
     }
 
     // ========== Core Functions ==========
 
     fun waterui_init(): Long = WatcherJni.init()
+    fun waterui_set_native_thread_name_prefix(prefix: String) = WatcherJni.setNativeThreadNamePrefix(prefix)
     fun waterui_app(envPtr: Long): AppStruct = WatcherJni.app(envPtr)
     fun waterui_env_install_media_picker_manager(envPtr: Long) = WatcherJni.envInstallMediaPickerManager(envPtr)
     fun waterui_env_install_webview_controller(envPtr: Long) = WatcherJni.envInstallWebViewController(envPtr)
     fun waterui_view_id(anyViewPtr: Long): TypeIdStruct = WatcherJni.viewId(anyViewPtr)
     fun waterui_view_body(anyViewPtr: Long, envPtr: Long): Long = WatcherJni.viewBody(anyViewPtr, envPtr)
     fun waterui_view_stretch_axis(anyViewPtr: Long): Int = WatcherJni.viewStretchAxis(anyViewPtr)
+    fun waterui_view_type_set_create(ids: LongArray, flags: IntArray): Long = WatcherJni.viewTypeSetCreate(ids, flags)
+    fun waterui_resolve_views(typeSet: Long, views: LongArray, envPtr: Long, out: java.nio.ByteBuffer): Int =
+        WatcherJni.resolveViews(typeSet, views, envPtr, out)
+    fun waterui_peel_metadata_chain(anyViewPtr: Long, out: java.nio.ByteBuffer): Int =
+        WatcherJni.peelMetadataChain(anyViewPtr, out)
+    fun waterui_component_kind_count(): Int = WatcherJni.componentKindCount()
+    fun waterui_type_id_kind(typeId: WuiTypeId): Int = WatcherJni.typeIdKind(typeId.low, typeId.high)
+    fun waterui_view_kind(anyViewPtr: Long): Int = WatcherJni.viewKind(anyViewPtr)
     fun waterui_configure_hot_reload_endpoint(host: String, port: Int) = WatcherJni.configureHotReloadEndpoint(host, port)
     fun waterui_configure_hot_reload_directory(path: String) = WatcherJni.configureHotReloadDirectory(path)
 
@@ -81,6 +97,26 @@ internal object NativeBindings {
     fun waterui_theme_install_font(envPtr: Long, slot: Int, signalPtr: Long) = WatcherJni.themeInstallFont(envPtr, slot, signalPtr)
     fun waterui_theme_font(envPtr: Long, slot: Int): Long = WatcherJni.themeFont(envPtr, slot)
 
+    // ========== Theme: Palette ==========
+
+    fun waterui_theme_install_palette(
+        envPtr: Long,
+        scheme: Int,
+        colorSlots: IntArray,
+        argb: IntArray,
+        fontSlots: IntArray,
+        fontSizes: FloatArray,
+        fontWeights: IntArray
+    ): Long = WatcherJni.themeInstallPalette(envPtr, scheme, colorSlots, argb, fontSlots, fontSizes, fontWeights)
+    fun waterui_theme_update_palette(
+        palettePtr: Long,
+        scheme: Int,
+        argb: IntArray,
+        fontSizes: FloatArray,
+        fontWeights: IntArray
+    ) = WatcherJni.themeUpdatePalette(palettePtr, scheme, argb, fontSizes, fontWeights)
+    fun waterui_theme_drop_palette(palettePtr: Long) = WatcherJni.themeDropPalette(palettePtr)
+
     // ========== Theme: Legacy per-token APIs ==========
 
     fun waterui_theme_color_background(envPtr: Long): Long = WatcherJni.themeColorBackground(envPtr)
@@ -112,6 +148,103 @@ internal object NativeBindings {
         WatcherJni.layoutSizeThatFits(layoutPtr, proposal, subviews)
     fun waterui_layout_place(layoutPtr: Long, bounds: RectStruct, subviews: Array<SubViewStruct>): Array<RectStruct> =
         WatcherJni.layoutPlace(layoutPtr, bounds, subviews)
+
+    /**
+     * Bulk variant of [waterui_layout_size_that_fits]. See [SubViewMeasurer] for
+     * the array layout; writes the result (in dp) into `outSize[0..1]`.
+     * The result is cached under [cacheToken] and [generation]; see
+     * [waterui_layout_cached_size].
+     */
+    fun waterui_layout_size_that_fits_bulk(
+        layoutPtr: Long,
+        cacheToken: Long,
+        generation: Int,
+        proposal: ProposalStruct,
+        childInfo: IntArray,
+        measurements: FloatArray,
+        entriesPerChild: Int,
+        measurer: SubViewMeasurer?,
+        outSize: FloatArray
+    ): Boolean = WatcherJni.layoutSizeThatFitsBulk(
+        layoutPtr, cacheToken, generation, proposal.width, proposal.height, childInfo, measurements, entriesPerChild, measurer, outSize
+    )
+
+    /**
+     * Bulk variant of [waterui_layout_place]. Writes `[x, y, width, height]` per
+     * child into [outPlacements] and returns the number of rects written.
+     * Placements for bounds at the origin are cached under [cacheToken] and [generation].
+     */
+    fun waterui_layout_place_bulk(
+        layoutPtr: Long,
+        cacheToken: Long,
+        generation: Int,
+        bounds: RectStruct,
+        childInfo: IntArray,
+        measurements: FloatArray,
+        entriesPerChild: Int,
+        measurer: SubViewMeasurer?,
+        outPlacements: FloatArray
+    ): Int = WatcherJni.layoutPlaceBulk(
+        layoutPtr, cacheToken, generation, bounds.x, bounds.y, bounds.width, bounds.height,
+        childInfo, measurements, entriesPerChild, measurer, outPlacements
+    )
+
+    /**
+     * Size cached by [waterui_layout_size_that_fits_bulk] for [proposal] while
+     * the container's children are at [generation] (bumped on every child
+     * layout request). [cacheToken] is minted once per container and never
+     * reused, unlike a layout address. Returns false on a miss.
+     */
+    fun waterui_layout_cached_size(cacheToken: Long, generation: Int, proposal: ProposalStruct, outSize: FloatArray): Boolean =
+        WatcherJni.layoutCachedSize(cacheToken, generation, proposal.width, proposal.height, outSize)
+
+    /**
+     * Placements cached by [waterui_layout_place_bulk] for bounds of this size
+     * at [generation]; returns the number of rects written, or -1 on a miss.
+     */
+    fun waterui_layout_cached_placements(
+        cacheToken: Long,
+        generation: Int,
+        width: Float,
+        height: Float,
+        outPlacements: FloatArray
+    ): Int = WatcherJni.layoutCachedPlacements(cacheToken, generation, width, height, outPlacements)
+
+    /** Erases the results cached under [cacheToken]; called once its container is disposed. */
+    fun waterui_release_layout_cache(cacheToken: Long) = WatcherJni.releaseLayoutCache(cacheToken)
+
+    /**
+     * [waterui_layout_size_that_fits_bulk] without a measurer, safe to call off
+     * the UI thread. Probes missing from [measurements] are estimated; returns
+     * how many were, so the size is exact when 0, or -1 on invalid arrays.
+     */
+    fun waterui_layout_size_that_fits_snapshot(
+        layoutPtr: Long,
+        proposal: ProposalStruct,
+        childInfo: IntArray,
+        measurements: FloatArray,
+        entriesPerChild: Int,
+        outSize: FloatArray
+    ): Int = WatcherJni.layoutSizeThatFitsSnapshot(
+        layoutPtr, proposal.width, proposal.height, childInfo, measurements, entriesPerChild, outSize
+    )
+
+    /**
+     * [waterui_layout_place_bulk] without a measurer for bounds at the origin;
+     * returns the estimated-probe count as [waterui_layout_size_that_fits_snapshot]
+     * does, or -1 if fewer rects than children were placed.
+     */
+    fun waterui_layout_place_snapshot(
+        layoutPtr: Long,
+        width: Float,
+        height: Float,
+        childInfo: IntArray,
+        measurements: FloatArray,
+        entriesPerChild: Int,
+        outPlacements: FloatArray
+    ): Int = WatcherJni.layoutPlaceSnapshot(
+        layoutPtr, width, height, childInfo, measurements, entriesPerChild, outPlacements
+    )
     fun waterui_drop_layout(layoutPtr: Long) = WatcherJni.dropLayout(layoutPtr)
 
     // ========== AnyViews ==========
@@ -119,20 +252,27 @@ internal object NativeBindings {
     fun waterui_any_views_len(handle: Long): Int = WatcherJni.anyViewsLen(handle)
     fun waterui_any_views_get_view(handle: Long, index: Int): Long = WatcherJni.anyViewsGetView(handle, index)
     fun waterui_any_views_get_id(handle: Long, index: Int): Int = WatcherJni.anyViewsGetId(handle, index)
+    fun waterui_any_views_diff(handle: Long, previousIds: IntArray): IntArray = WatcherJni.anyViewsDiff(handle, previousIds)
+    fun waterui_any_views_snapshot(handle: Long, start: Int, count: Int, outViews: LongArray, outIds: IntArray?): Int =
+        WatcherJni.anyViewsSnapshot(handle, start, count, outViews, outIds)
+    fun waterui_any_views_snapshot_direct(handle: Long, start: Int, count: Int, out: java.nio.ByteBuffer): Int =
+        WatcherJni.anyViewsSnapshotDirect(handle, start, count, out)
     fun waterui_drop_any_views(handle: Long) = WatcherJni.dropAnyViews(handle)
 
     // ========== Watcher creation ==========
 
-    fun waterui_create_bool_watcher(callback: WatcherCallback<Boolean>): WatcherStruct = WatcherJni.createBoolWatcher(callback)
-    fun waterui_create_int_watcher(callback: WatcherCallback<Int>): WatcherStruct = WatcherJni.createIntWatcher(callback)
-    fun waterui_create_double_watcher(callback: WatcherCallback<Double>): WatcherStruct = WatcherJni.createDoubleWatcher(callback)
-    fun waterui_create_float_watcher(callback: WatcherCallback<Float>): WatcherStruct = WatcherJni.createFloatWatcher(callback)
+    fun waterui_create_bool_watcher(callback: BoolWatcherCallback): WatcherStruct = WatcherJni.createBoolWatcher(callback)
+    fun waterui_create_int_watcher(callback: IntWatcherCallback): WatcherStruct = WatcherJni.createIntWatcher(callback)
+    fun waterui_create_double_watcher(callback: DoubleWatcherCallback): WatcherStruct = WatcherJni.createDoubleWatcher(callback)
+    fun waterui_create_float_watcher(callback: FloatWatcherCallback): WatcherStruct = WatcherJni.createFloatWatcher(callback)
     fun waterui_create_string_watcher(callback: WatcherCallback<String>): WatcherStruct = WatcherJni.createStringWatcher(callback)
     fun waterui_create_any_view_watcher(callback: WatcherCallback<Long>): WatcherStruct = WatcherJni.createAnyViewWatcher(callback)
     fun waterui_create_styled_str_watcher(callback: WatcherCallback<StyledStrStruct>): WatcherStruct = WatcherJni.createStyledStrWatcher(callback)
+    fun waterui_create_flat_styled_str_watcher(callback: WatcherCallback<FlatStyledStrStruct>): WatcherStruct = WatcherJni.createFlatStyledStrWatcher(callback)
     fun waterui_create_resolved_color_watcher(callback: WatcherCallback<ResolvedColorStruct>): WatcherStruct = WatcherJni.createResolvedColorWatcher(callback)
     fun waterui_create_resolved_font_watcher(callback: WatcherCallback<ResolvedFontStruct>): WatcherStruct = WatcherJni.createResolvedFontWatcher(callback)
     fun waterui_create_picker_items_watcher(callback: WatcherCallback<Array<PickerItemStruct>>): WatcherStruct = WatcherJni.createPickerItemsWatcher(callback)
+    fun waterui_create_picker_items_diff_watcher(callback: WatcherCallback<PickerItemsDiffStruct>): WatcherStruct = WatcherJni.createPickerItemsDiffWatcher(callback)
 
     // ========== Watch binding ==========
 
@@ -148,6 +288,16 @@ internal object NativeBindings {
     fun waterui_set_binding_double(bindingPtr: Long, value: Double) = WatcherJni.setBindingDouble(bindingPtr, value)
     fun waterui_set_binding_str(bindingPtr: Long, bytes: ByteArray) = WatcherJni.setBindingStr(bindingPtr, bytes)
     fun waterui_set_binding_secure(bindingPtr: Long, bytes: ByteArray) = WatcherJni.setBindingSecure(bindingPtr, bytes)
+
+    /** Writes [value] through a borrowed direct buffer instead of a byte[] copy. */
+    fun waterui_set_binding_str(bindingPtr: Long, value: String) =
+        DirectUtf8.withUtf8(value) { buffer, length -> WatcherJni.setBindingStrDirect(bindingPtr, buffer, length) }
+
+    /** Like [waterui_set_binding_str]; the scratch bytes are wiped after the call. */
+    fun waterui_set_binding_secure(bindingPtr: Long, value: String) =
+        DirectUtf8.withUtf8(value, wipe = true) { buffer, length ->
+            WatcherJni.setBindingSecureDirect(bindingPtr, buffer, length)
+        }
     fun waterui_set_binding_color(bindingPtr: Long, colorPtr: Long) = WatcherJni.setBindingColor(bindingPtr, colorPtr)
     fun waterui_read_binding_bool(bindingPtr: Long): Boolean = WatcherJni.readBindingBool(bindingPtr)
     fun waterui_read_binding_int(bindingPtr: Long): Int = WatcherJni.readBindingInt(bindingPtr)
@@ -179,12 +329,15 @@ internal object NativeBindings {
     fun waterui_drop_computed_i32(computedPtr: Long) = WatcherJni.dropComputedI32(computedPtr)
     fun waterui_watch_computed_i32(computedPtr: Long, watcher: WatcherStruct): Long = WatcherJni.watchComputedI32(computedPtr, watcher)
     fun waterui_read_computed_styled_str(computedPtr: Long): StyledStrStruct = WatcherJni.readComputedStyledStr(computedPtr)
+    fun waterui_read_computed_styled_str_flat(computedPtr: Long): FlatStyledStrStruct = WatcherJni.readComputedStyledStrFlat(computedPtr)
     fun waterui_drop_computed_styled_str(computedPtr: Long) = WatcherJni.dropComputedStyledStr(computedPtr)
     fun waterui_watch_computed_styled_str(computedPtr: Long, watcher: WatcherStruct): Long = WatcherJni.watchComputedStyledStr(computedPtr, watcher)
     fun waterui_read_computed_resolved_font(computedPtr: Long): ResolvedFontStruct = WatcherJni.readComputedResolvedFont(computedPtr)
     fun waterui_drop_computed_resolved_font(computedPtr: Long) = WatcherJni.dropComputedResolvedFont(computedPtr)
     fun waterui_watch_computed_resolved_font(computedPtr: Long, watcher: WatcherStruct): Long = WatcherJni.watchComputedResolvedFont(computedPtr, watcher)
     fun waterui_read_computed_picker_items(computedPtr: Long): Array<PickerItemStruct> = WatcherJni.readComputedPickerItems(computedPtr)
+    fun waterui_snapshot_picker_items_diff(computedPtr: Long, watcherData: Long): PickerItemsDiffStruct? =
+        WatcherJni.snapshotPickerItemsDiff(computedPtr, watcherData)
     fun waterui_drop_computed_picker_items(computedPtr: Long) = WatcherJni.dropComputedPickerItems(computedPtr)
     fun waterui_watch_computed_picker_items(computedPtr: Long, watcher: WatcherStruct): Long = WatcherJni.watchComputedPickerItems(computedPtr, watcher)
 
@@ -228,6 +381,8 @@ internal object NativeBindings {
 
     fun waterui_drop_watcher_guard(guardPtr: Long) = WatcherJni.dropWatcherGuard(guardPtr)
 
+    fun waterui_handle_tracker_dump(): String? = WatcherJni.handleTrackerDump()
+
     // ========== Animation ==========
 
     /** Get full animation from metadata with all parameters */
@@ -239,6 +394,14 @@ internal object NativeBindings {
         return WuiAnimation.fromNative(tag, durationMs, stiffness, damping)
     }
 
+    fun waterui_animator_init(buffer: java.nio.ByteBuffer, capacity: Int): Boolean =
+        WatcherJni.animatorInit(buffer, capacity)
+    fun waterui_animator_open_slot(initial: Float, minVisibleChange: Float): Int =
+        WatcherJni.animatorOpenSlot(initial, minVisibleChange)
+    fun waterui_animator_close_slot(slot: Int) = WatcherJni.animatorCloseSlot(slot)
+    fun waterui_create_animated_float_watcher(slot: Int): WatcherStruct? =
+        WatcherJni.createAnimatedFloatWatcher(slot)
+
     /** Legacy: get animation tag only (deprecated) */
     @Deprecated("Use waterui_get_animation instead for full animation support")
     fun waterui_get_animation_tag(metadataPtr: Long): Int = WatcherJni.getAnimationTag(metadataPtr)
@@ -395,7 +558,7 @@ internal object NativeBindings {
     fun waterui_read_computed_cursor_style(computedPtr: Long): Int = WatcherJni.readComputedCursorStyle(computedPtr)
     fun waterui_watch_computed_cursor_style(computedPtr: Long, watcher: WatcherStruct): Long = WatcherJni.watchComputedCursorStyle(computedPtr, watcher)
     fun waterui_drop_computed_cursor_style(computedPtr: Long) = WatcherJni.dropComputedCursorStyle(computedPtr)
-    fun waterui_create_cursor_style_watcher(callback: dev.waterui.android.reactive.WatcherCallback<Int>): WatcherStruct = WatcherJni.createCursorStyleWatcher(callback)
+    fun waterui_create_cursor_style_watcher(callback: IntWatcherCallback): WatcherStruct = WatcherJni.createCursorStyleWatcher(callback)
 
     // ========== Retain ==========
 
@@ -410,6 +573,14 @@ internal object NativeBindings {
     fun waterui_gpu_surface_render(statePtr: Long, width: Int, height: Int): Boolean =
         WatcherJni.gpuSurfaceRender(statePtr, width, height)
     fun waterui_gpu_surface_drop(statePtr: Long) = WatcherJni.gpuSurfaceDrop(statePtr)
+    fun waterui_gpu_surface_start_driver(rendererPtr: Long, surface: android.view.Surface, width: Int, height: Int): Long =
+        WatcherJni.gpuSurfaceStartDriver(rendererPtr, surface, width, height)
+    fun waterui_gpu_surface_driver_resize(driverPtr: Long, width: Int, height: Int) =
+        WatcherJni.gpuSurfaceDriverResize(driverPtr, width, height)
+    fun waterui_gpu_surface_driver_set_paused(driverPtr: Long, paused: Boolean) =
+        WatcherJni.gpuSurfaceDriverSetPaused(driverPtr, paused)
+    fun waterui_gpu_surface_stop_driver(driverPtr: Long) = WatcherJni.gpuSurfaceStopDriver(driverPtr)
+    fun waterui_gpu_surface_stats(driverPtr: Long, out: LongArray): Int = WatcherJni.gpuSurfaceStats(driverPtr, out)
 
     // ========== Reactive State Creation (for theme) ==========
 
@@ -440,8 +611,8 @@ internal object NativeBindings {
         WatcherJni.callDropExitHandler(dropDestPtr, envPtr)
 }
 
-fun bootstrapWaterUiRuntime() {
-    NativeBindings.bootstrapNativeBindings()
+fun bootstrapWaterUiRuntime(threadNamePrefix: String = "WaterUI") {
+    NativeBindings.bootstrapNativeBindings(threadNamePrefix)
 }
 
 fun configureHotReloadEndpoint(host: String, port: Int) {
@@ -50,18 +50,42 @@ class NativeAnyViews(handle: Long) : NativePointer(handle) {
     }
 
     fun toList(): List<Long> {
-        val result = ArrayList<Long>(size())
         val count = size()
-        for (i in 0 until count) {
-            val ptr = viewAt(i)
-            if (ptr != 0L) {
-                result += ptr
+        if (count == 0) return emptyList()
+        val views = LongArray(count)
+        val written = NativeBindings.waterui_any_views_snapshot(raw(), 0, count, views, null)
+        val result = ArrayList<Long>(count)
+        for (i in 0 until written) {
+            if (views[i] != 0L) {
+                result += views[i]
             }
         }
         return result
     }
 
+    /**
+     * Copies view pointers and ids for `[start, start + count)` in one JNI call.
+     * Returns the number of entries written.
+     */
+    fun snapshot(start: Int, count: Int, outViews: LongArray, outIds: IntArray? = null): Int {
+        if (isReleased) return 0
+        return NativeBindings.waterui_any_views_snapshot(raw(), start, count, outViews, outIds).coerceAtLeast(0)
+    }
+
+    /**
+     * Fills a direct [out] buffer (native byte order) with [SNAPSHOT_RECORD_SIZE]-byte
+     * records: view pointer (long) at offset 0, id (int) at offset 8.
+     */
+    fun snapshotInto(start: Int, count: Int, out: java.nio.ByteBuffer): Int {
+        if (isReleased) return 0
+        return NativeBindings.waterui_any_views_snapshot_direct(raw(), start, count, out).coerceAtLeast(0)
+    }
+
     override fun release(ptr: Long) {
         NativeBindings.waterui_drop_any_views(ptr)
     }
+
+    companion object {
+        const val SNAPSHOT_RECORD_SIZE = 16
+    }
 }
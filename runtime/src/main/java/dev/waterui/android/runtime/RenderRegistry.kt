@@ -1,6 +1,7 @@
 package dev.waterui.android.runtime
 
 import android.content.Context
+import android.util.Log
 import android.view.View
 import dev.waterui.android.components.*
 
@@ -13,21 +14,152 @@ import dev.waterui.android.components.*
  */
 class RenderRegistry private constructor(
     private val entries: Map<WuiTypeId, WuiRenderer>,
-    private val metadataTypes: Set<WuiTypeId>
+    private val metadataTypes: Set<WuiTypeId>,
+    private val deferred: DeferredComponents
 ) {
-    fun resolve(typeId: WuiTypeId): WuiRenderer? = entries[typeId]
+    fun resolve(typeId: WuiTypeId): WuiRenderer? =
+        entries[typeId] ?: if (isComponent(typeId)) deferred.resolve(typeId) else null
+
+    /**
+     * Resolves by native component kind (see [NativeBindings.waterui_view_kind]),
+     * an array index instead of a hash lookup. Falls back to [typeId] for types
+     * without a kind, such as custom renderers added through [with], and for
+     * deferred components, whose kinds are filled in as they resolve.
+     */
+    fun resolve(kind: Int, typeId: WuiTypeId): WuiRenderer? =
+        byKind.getOrNull(kind) ?: resolve(typeId)?.also { renderer ->
+            if (kind in byKind.indices) {
+                byKind[kind] = renderer
+                kindTypeIds[kind] = typeId
+            }
+        }
+
+    /**
+     * Type id of a rendered native component kind, so a caller holding the kind
+     * need not ask native code for the id. Null for kinds this registry does not
+     * render, or renders through a deferred component not resolved yet.
+     */
+    fun typeIdForKind(kind: Int): WuiTypeId? = kindTypeIds.getOrNull(kind)
 
     /** Returns true if this type is a Metadata<T> type (transparent for layout). */
-    fun isMetadata(typeId: WuiTypeId): Boolean = typeId in metadataTypes
+    fun isMetadata(typeId: WuiTypeId): Boolean =
+        typeId in metadataTypes ||
+            (typeId !in entries && isComponent(typeId) && deferred.isMetadata(typeId))
+
+    /**
+     * Whether [typeId] is one of the native components, deferred ones included
+     * (their ids are cached natively before their groups resolve). Composite
+     * views are not, so meeting one never touches the deferred components.
+     */
+    private fun isComponent(typeId: WuiTypeId): Boolean =
+        NativeBindings.waterui_type_id_kind(typeId) >= 0
 
     fun with(typeId: WuiTypeId, renderer: WuiRenderer): RenderRegistry =
-        RenderRegistry(entries + (typeId to renderer), metadataTypes)
+        RenderRegistry(entries + (typeId to renderer), metadataTypes, deferred)
 
     fun withMetadata(typeId: WuiTypeId, renderer: WuiRenderer): RenderRegistry =
-        RenderRegistry(entries + (typeId to renderer), metadataTypes + typeId)
+        RenderRegistry(entries + (typeId to renderer), metadataTypes + typeId, deferred)
+
+    private val byKind: Array<WuiRenderer?> get() = kindTables.first
+
+    private val kindTypeIds: Array<WuiTypeId?> get() = kindTables.second
+
+    private val kindTables: Pair<Array<WuiRenderer?>, Array<WuiTypeId?>> by lazy {
+        val count = NativeBindings.waterui_component_kind_count()
+        val table = arrayOfNulls<WuiRenderer>(count)
+        val typeIds = arrayOfNulls<WuiTypeId>(count)
+        fun add(typeId: WuiTypeId, renderer: WuiRenderer) {
+            val kind = NativeBindings.waterui_type_id_kind(typeId)
+            if (kind in table.indices) {
+                table[kind] = renderer
+                typeIds[kind] = typeId
+            }
+        }
+        // Deferred components are left out; resolve(kind, typeId) adds them
+        // as they are met, so building the table fetches none of their ids.
+        for ((typeId, renderer) in entries) add(typeId, renderer)
+        table to typeIds
+    }
+
+    /**
+     * Native lookup table of the types this registry renders eagerly, used by
+     * [inflateAnyViews] to expand composite views without leaving native code.
+     * Deferred components are left out: the walker stops at any native
+     * component it does not find here and hands it back for [resolve].
+     * Zero if the table could not be built.
+     */
+    internal val nativeTypeSet: Long by lazy {
+        val count = entries.size
+        val ids = LongArray(count * 2)
+        val flags = IntArray(count)
+        var index = 0
+        fun add(typeId: WuiTypeId, metadata: Boolean) {
+            ids[2 * index] = typeId.low
+            ids[2 * index + 1] = typeId.high
+            flags[index] = if (metadata) VIEW_TYPE_METADATA else 0
+            index++
+        }
+        for (typeId in entries.keys) add(typeId, typeId in metadataTypes)
+        NativeBindings.waterui_view_type_set_create(ids, flags)
+    }
 
     companion object {
-        fun default(): RenderRegistry = RenderRegistry(defaultComponents, defaultMetadataTypes)
+        /** Mirrors kViewTypeMetadata in waterui_jni.cpp. */
+        private const val VIEW_TYPE_METADATA = 1
+
+        private val defaultRegistry: RenderRegistry by lazy {
+            RenderRegistry(defaultComponents, defaultMetadataTypes, defaultDeferred)
+        }
+
+        fun default(): RenderRegistry = defaultRegistry
+    }
+}
+
+/**
+ * Components whose type ids come from lazily resolved native symbol groups
+ * (webview, video, photo, GPU surface, drag and drop). Their ids are fetched
+ * the first time the registry meets a native component the eager entries do
+ * not know. Fetching an id does not resolve its group: native code caches the
+ * ids at init and looks up the rest of a group when a view of it is first
+ * rendered. A group the app library does not export is skipped.
+ */
+internal class DeferredComponents(pending: List<DeferredEntry>) {
+    internal class DeferredEntry(
+        val idProvider: () -> WuiTypeId,
+        val renderer: WuiRenderer,
+        val metadata: Boolean
+    )
+
+    private val unresolved = ArrayDeque(pending)
+    private val entries = HashMap<WuiTypeId, WuiRenderer>()
+    private val metadataTypes = HashSet<WuiTypeId>()
+
+    fun resolve(typeId: WuiTypeId): WuiRenderer? = find(typeId)
+
+    fun isMetadata(typeId: WuiTypeId): Boolean {
+        find(typeId)
+        return typeId in metadataTypes
+    }
+
+    /**
+     * Fetches the ids of pending entries, in registration order, until one is
+     * [typeId].
+     */
+    private fun find(typeId: WuiTypeId): WuiRenderer? {
+        entries[typeId]?.let { return it }
+        while (unresolved.isNotEmpty()) {
+            val entry = unresolved.removeFirst()
+            val id = try {
+                entry.idProvider()
+            } catch (e: UnsatisfiedLinkError) {
+                Log.w("WaterUI.Registry", "Skipping component: ${e.message}")
+                continue
+            }
+            entries[id] = entry.renderer
+            if (entry.metadata) metadataTypes.add(id)
+            if (id == typeId) return entry.renderer
+        }
+        return null
     }
 }
 
@@ -53,6 +185,7 @@ data class WuiNode(
 class RegistryBuilder {
     internal val components = mutableMapOf<WuiTypeId, WuiRenderer>()
     internal val metadataTypes = mutableSetOf<WuiTypeId>()
+    internal val deferred = mutableListOf<DeferredComponents.DeferredEntry>()
 
     /** Register a native view component. */
     fun register(idProvider: () -> WuiTypeId, renderer: WuiRenderer) {
@@ -65,12 +198,25 @@ class RegistryBuilder {
         components[typeId] = renderer
         metadataTypes.add(typeId)
     }
+
+    /**
+     * Register a component from a lazily resolved native symbol group. The id
+     * provider is not called until the registry meets an unknown native
+     * component.
+     */
+    fun registerDeferred(
+        idProvider: () -> WuiTypeId,
+        renderer: WuiRenderer,
+        metadata: Boolean = false
+    ) {
+        deferred.add(DeferredComponents.DeferredEntry(idProvider, renderer, metadata))
+    }
 }
 
 /**
  * Populated lazily to avoid referencing components before they are defined.
  */
-private val registryData: Pair<Map<WuiTypeId, WuiRenderer>, Set<WuiTypeId>> by lazy {
+private val registryData: RegistryBuilder by lazy {
     val builder = RegistryBuilder()
     with(builder) {
         registerWuiEmptyView()
@@ -142,8 +288,9 @@ private val registryData: Pair<Map<WuiTypeId, WuiRenderer>, Set<WuiTypeId>> by l
         registerWuiDraggable()
         registerWuiDropDestination()
     }
-    builder.components to builder.metadataTypes
+    builder
 }
 
-private val defaultComponents: Map<WuiTypeId, WuiRenderer> get() = registryData.first
-private val defaultMetadataTypes: Set<WuiTypeId> get() = registryData.second
+private val defaultComponents: Map<WuiTypeId, WuiRenderer> get() = registryData.components
+private val defaultMetadataTypes: Set<WuiTypeId> get() = registryData.metadataTypes
+private val defaultDeferred: DeferredComponents by lazy { DeferredComponents(registryData.deferred) }
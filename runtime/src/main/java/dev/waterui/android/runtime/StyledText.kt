@@ -13,152 +13,138 @@ import android.text.style.UnderlineSpan
 import java.io.Closeable
 import kotlin.math.roundToInt
 
+internal fun FlatStyledStrStruct.toModel(): WuiStyledStr = WuiStyledStr(text, runs, styles)
+
 internal fun StyledStrStruct.toModel(): WuiStyledStr {
-    val chunkModels = chunks.map { chunk ->
-        StyledChunk(
-            text = chunk.text,
-            style = chunk.style.toModel()
-        )
+    val text = StringBuilder()
+    val runs = IntArray(chunks.size * FlatStyledStrStruct.RUN_STRIDE)
+    val styles = LongArray(chunks.size * FlatStyledStrStruct.STYLE_STRIDE)
+    chunks.forEachIndexed { index, chunk ->
+        val style = chunk.style
+        var flags = 0
+        if (style.italic) flags = flags or FlatStyledStrStruct.FLAG_ITALIC
+        if (style.underline) flags = flags or FlatStyledStrStruct.FLAG_UNDERLINE
+        if (style.strikethrough) flags = flags or FlatStyledStrStruct.FLAG_STRIKETHROUGH
+
+        val run = index * FlatStyledStrStruct.RUN_STRIDE
+        runs[run] = text.length
+        runs[run + 1] = chunk.text.length
+        runs[run + 2] = flags
+
+        val slot = index * FlatStyledStrStruct.STYLE_STRIDE
+        styles[slot] = style.fontPtr
+        styles[slot + 1] = style.foregroundPtr
+        styles[slot + 2] = style.backgroundPtr
+
+        text.append(chunk.text)
     }
-    return WuiStyledStr(chunkModels)
+    return WuiStyledStr(text.toString(), runs, styles)
 }
 
+/**
+ * Styled text in flat form (see [FlatStyledStrStruct]). Owns the font and color
+ * handles referenced by [styles] until [close].
+ */
 class WuiStyledStr internal constructor(
-    private val chunks: List<StyledChunk>
+    private val text: String,
+    private val runs: IntArray,
+    private val styles: LongArray
 ) : Closeable {
+    private var closed = false
 
     fun toCharSequence(env: WuiEnvironment): CharSequence {
-        val builder = SpannableStringBuilder()
-        chunks.forEach { chunk ->
-            val start = builder.length
-            builder.append(chunk.text)
-            val end = builder.length
+        val builder = SpannableStringBuilder(text)
+        if (closed) return builder
+        val runCount = runs.size / FlatStyledStrStruct.RUN_STRIDE
+        for (index in 0 until runCount) {
+            val run = index * FlatStyledStrStruct.RUN_STRIDE
+            val start = runs[run]
+            val end = start + runs[run + 1]
             if (start != end) {
-                chunk.style.applySpans(env, builder, start, end)
+                val slot = index * FlatStyledStrStruct.STYLE_STRIDE
+                applySpans(
+                    env, builder, start, end,
+                    flags = runs[run + 2],
+                    fontPtr = styles[slot],
+                    foregroundPtr = styles[slot + 1],
+                    backgroundPtr = styles[slot + 2]
+                )
             }
         }
         return builder
     }
 
     override fun close() {
-        chunks.forEach { it.close() }
+        if (closed) return
+        closed = true
+        for (slot in styles.indices step FlatStyledStrStruct.STYLE_STRIDE) {
+            val foreground = styles[slot + 1]
+            val background = styles[slot + 2]
+            if (foreground != 0L) NativeBindings.waterui_drop_color(foreground)
+            if (background != 0L && background != foreground) NativeBindings.waterui_drop_color(background)
+            if (styles[slot] != 0L) NativeBindings.waterui_drop_font(styles[slot])
+        }
     }
 }
 
-internal class StyledChunk(
-    val text: String,
-    val style: StyledTextStyle
-) : Closeable {
-    override fun close() {
-        style.close()
+private fun applySpans(
+    env: WuiEnvironment,
+    builder: SpannableStringBuilder,
+    start: Int,
+    end: Int,
+    flags: Int,
+    fontPtr: Long,
+    foregroundPtr: Long,
+    backgroundPtr: Long
+) {
+    val italic = flags and FlatStyledStrStruct.FLAG_ITALIC != 0
+    val resolvedFont = resolveFont(fontPtr, env)
+    val typefaceStyle = resolveTypefaceStyle(resolvedFont.weight, italic)
+    if (typefaceStyle != Typeface.NORMAL) {
+        builder.setSpan(StyleSpan(typefaceStyle), start, end, Spanned.SPAN_EXCLUSIVE_EXCLUSIVE)
     }
-}
-
-internal class StyledTextStyle(
-    private val font: WuiFont,
-    private val italic: Boolean,
-    private val underline: Boolean,
-    private val strikethrough: Boolean,
-    private val foreground: WuiColor?,
-    private val background: WuiColor?
-) : Closeable {
+    builder.setSpan(AbsoluteSizeSpan(resolvedFont.size.roundToInt(), true), start, end, Spanned.SPAN_EXCLUSIVE_EXCLUSIVE)
 
-    fun applySpans(env: WuiEnvironment, builder: SpannableStringBuilder, start: Int, end: Int) {
-        val resolvedFont = font.resolveOnce(env)
-        val typefaceStyle = resolveTypefaceStyle(resolvedFont.weight, italic)
-        if (typefaceStyle != Typeface.NORMAL) {
-            builder.setSpan(StyleSpan(typefaceStyle), start, end, Spanned.SPAN_EXCLUSIVE_EXCLUSIVE)
-        }
-        builder.setSpan(AbsoluteSizeSpan(resolvedFont.size.roundToInt(), true), start, end, Spanned.SPAN_EXCLUSIVE_EXCLUSIVE)
-
-        val foregroundColor = foreground?.resolveOnce(env)?.toColorInt()
-        if (foregroundColor != null) {
-            builder.setSpan(ForegroundColorSpan(foregroundColor), start, end, Spanned.SPAN_EXCLUSIVE_EXCLUSIVE)
-        }
-
-        val backgroundColor = background?.resolveOnce(env)?.toColorInt()
-        if (backgroundColor != null) {
-            builder.setSpan(BackgroundColorSpan(backgroundColor), start, end, Spanned.SPAN_EXCLUSIVE_EXCLUSIVE)
-        }
-
-        if (underline) {
-            builder.setSpan(UnderlineSpan(), start, end, Spanned.SPAN_EXCLUSIVE_EXCLUSIVE)
-        }
-        if (strikethrough) {
-            builder.setSpan(StrikethroughSpan(), start, end, Spanned.SPAN_EXCLUSIVE_EXCLUSIVE)
-        }
+    if (foregroundPtr != 0L) {
+        val foregroundColor = resolveColor(foregroundPtr, env).toColorInt()
+        builder.setSpan(ForegroundColorSpan(foregroundColor), start, end, Spanned.SPAN_EXCLUSIVE_EXCLUSIVE)
     }
 
-    private fun resolveTypefaceStyle(weight: Int, italic: Boolean): Int {
-        val isBold = weight >= 5
-        return when {
-            isBold && italic -> Typeface.BOLD_ITALIC
-            isBold -> Typeface.BOLD
-            italic -> Typeface.ITALIC
-            else -> Typeface.NORMAL
-        }
+    if (backgroundPtr != 0L) {
+        val backgroundColor = resolveColor(backgroundPtr, env).toColorInt()
+        builder.setSpan(BackgroundColorSpan(backgroundColor), start, end, Spanned.SPAN_EXCLUSIVE_EXCLUSIVE)
     }
 
-    override fun close() {
-        foreground?.close()
-        if (background !== foreground) {
-            background?.close()
-        }
-        font.close()
-    }
-}
-
-internal class WuiFont(
-    handle: Long
-) : NativePointer(handle) {
-
-    fun resolveOnce(env: WuiEnvironment): ResolvedFontStruct {
-        val computedPtr = NativeBindings.waterui_resolve_font(raw(), env.raw())
-        val resolved = NativeBindings.waterui_read_computed_resolved_font(computedPtr)
-        NativeBindings.waterui_drop_computed_resolved_font(computedPtr)
-        return resolved
+    if (flags and FlatStyledStrStruct.FLAG_UNDERLINE != 0) {
+        builder.setSpan(UnderlineSpan(), start, end, Spanned.SPAN_EXCLUSIVE_EXCLUSIVE)
     }
-
-    override fun release(ptr: Long) {
-        if (ptr != 0L) {
-            NativeBindings.waterui_drop_font(ptr)
-        }
+    if (flags and FlatStyledStrStruct.FLAG_STRIKETHROUGH != 0) {
+        builder.setSpan(StrikethroughSpan(), start, end, Spanned.SPAN_EXCLUSIVE_EXCLUSIVE)
     }
 }
 
-internal class WuiColor(
-    handle: Long
-) : NativePointer(handle) {
-
-    fun resolveOnce(env: WuiEnvironment): ResolvedColorStruct {
-        val computedPtr = NativeBindings.waterui_resolve_color(raw(), env.raw())
-        val color = NativeBindings.waterui_read_computed_resolved_color(computedPtr)
-        NativeBindings.waterui_drop_computed_resolved_color(computedPtr)
-        return color
+private fun resolveTypefaceStyle(weight: Int, italic: Boolean): Int {
+    val isBold = weight >= 5
+    return when {
+        isBold && italic -> Typeface.BOLD_ITALIC
+        isBold -> Typeface.BOLD
+        italic -> Typeface.ITALIC
+        else -> Typeface.NORMAL
     }
+}
 
-    override fun release(ptr: Long) {
-        if (ptr != 0L) {
-            NativeBindings.waterui_drop_color(ptr)
-        }
-    }
+private fun resolveFont(fontPtr: Long, env: WuiEnvironment): ResolvedFontStruct {
+    val computedPtr = NativeBindings.waterui_resolve_font(fontPtr, env.raw())
+    val resolved = NativeBindings.waterui_read_computed_resolved_font(computedPtr)
+    NativeBindings.waterui_drop_computed_resolved_font(computedPtr)
+    return resolved
 }
 
-private fun TextStyleStruct.toModel(): StyledTextStyle {
-    val foregroundColor = foregroundPtr.takeIf { it != 0L }?.let(::WuiColor)
-    val backgroundColor = when {
-        backgroundPtr == 0L -> null
-        backgroundPtr == foregroundPtr && foregroundColor != null -> foregroundColor
-        else -> WuiColor(backgroundPtr)
-    }
-    return StyledTextStyle(
-        font = WuiFont(fontPtr),
-        italic = italic,
-        underline = underline,
-        strikethrough = strikethrough,
-        foreground = foregroundColor,
-        background = backgroundColor
-    )
+private fun resolveColor(colorPtr: Long, env: WuiEnvironment): ResolvedColorStruct {
+    val computedPtr = NativeBindings.waterui_resolve_color(colorPtr, env.raw())
+    val color = NativeBindings.waterui_read_computed_resolved_color(computedPtr)
+    NativeBindings.waterui_drop_computed_resolved_color(computedPtr)
+    return color
 }
 
 fun ResolvedFontStruct.toTypeface(): Typeface {
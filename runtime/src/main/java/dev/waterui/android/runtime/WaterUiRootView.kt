@@ -16,8 +16,6 @@ import com.google.android.material.color.MaterialColors
 import dev.waterui.android.components.WebViewManager
 import dev.waterui.android.reactive.WuiComputed
 import dev.waterui.android.runtime.ColorSlot
-import dev.waterui.android.runtime.ReactiveColorSignal
-import java.util.EnumMap
 
 /**
  * Root view that owns the WaterUI environment and inflates the Rust-driven
@@ -197,7 +195,8 @@ class WaterUiRootView @JvmOverloads constructor(
         backgroundTheme?.close()
         backgroundTheme = null
 
-        // 3. Clear theme bridge (signals are owned by Rust after install)
+        // 3. Clear theme bridge (installed signals are owned by Rust)
+        themeBridge?.close()
         themeBridge = null
 
         // 4. Clear the borrowed env view (does NOT drop the native pointer)
@@ -415,6 +414,10 @@ private data class MaterialThemeFonts(
  * The signals survive the waterui_app() call because they're installed into
  * the environment. User code can override via env.install(Theme::new()...),
  * in which case the native signals are replaced.
+ *
+ * The whole palette is one native object: installing and updating it are a
+ * single call each, and an update stores every value before notifying the
+ * watchers of the slots that changed.
  */
 private class ThemeBridgeController(
     envPtr: Long,
@@ -422,65 +425,74 @@ private class ThemeBridgeController(
     fonts: MaterialThemeFonts,
     scheme: ColorScheme
 ) {
-    private val colorSchemeSignal = ReactiveColorSchemeSignal(scheme)
-    private val colorSignals = EnumMap<ColorSlot, ReactiveColorSignal>(ColorSlot::class.java)
-    private val fontSignals = EnumMap<FontSlot, ReactiveFontSignal>(FontSlot::class.java)
-
-    init {
-        install(envPtr, palette, fonts)
-    }
+    private var palettePtr: Long = NativeBindings.waterui_theme_install_palette(
+        envPtr,
+        scheme.value,
+        COLOR_SLOTS,
+        colorValues(palette),
+        FONT_SLOTS,
+        fontSizes(fonts),
+        fontWeights(fonts)
+    )
 
     fun update(palette: MaterialThemePalette, fonts: MaterialThemeFonts, scheme: ColorScheme) {
-        colorSchemeSignal.setValue(scheme)
-        colorSignals[ColorSlot.Background]?.setValue(palette.background)
-        colorSignals[ColorSlot.Surface]?.setValue(palette.surface)
-        colorSignals[ColorSlot.SurfaceVariant]?.setValue(palette.surfaceVariant)
-        colorSignals[ColorSlot.Border]?.setValue(palette.border)
-        colorSignals[ColorSlot.Foreground]?.setValue(palette.foreground)
-        colorSignals[ColorSlot.MutedForeground]?.setValue(palette.mutedForeground)
-        colorSignals[ColorSlot.Accent]?.setValue(palette.accent)
-        colorSignals[ColorSlot.AccentForeground]?.setValue(palette.accentForeground)
-
-        fontSignals[FontSlot.Body]?.setValue(fonts.body.sizeSp, fonts.body.weight)
-        fontSignals[FontSlot.Title]?.setValue(fonts.title.sizeSp, fonts.title.weight)
-        fontSignals[FontSlot.Headline]?.setValue(fonts.headline.sizeSp, fonts.headline.weight)
-        fontSignals[FontSlot.Subheadline]?.setValue(fonts.subheadline.sizeSp, fonts.subheadline.weight)
-        fontSignals[FontSlot.Caption]?.setValue(fonts.caption.sizeSp, fonts.caption.weight)
-        fontSignals[FontSlot.Footnote]?.setValue(fonts.footnote.sizeSp, fonts.footnote.weight)
+        if (palettePtr == 0L) return
+        NativeBindings.waterui_theme_update_palette(
+            palettePtr,
+            scheme.value,
+            colorValues(palette),
+            fontSizes(fonts),
+            fontWeights(fonts)
+        )
     }
 
-    private fun install(envPtr: Long, palette: MaterialThemePalette, fonts: MaterialThemeFonts) {
-        // Install color scheme
-        NativeBindings.waterui_theme_install_color_scheme(envPtr, colorSchemeSignal.toComputed())
-
-        // Install colors
-        installColorSlot(envPtr, ColorSlot.Background, palette.background)
-        installColorSlot(envPtr, ColorSlot.Surface, palette.surface)
-        installColorSlot(envPtr, ColorSlot.SurfaceVariant, palette.surfaceVariant)
-        installColorSlot(envPtr, ColorSlot.Border, palette.border)
-        installColorSlot(envPtr, ColorSlot.Foreground, palette.foreground)
-        installColorSlot(envPtr, ColorSlot.MutedForeground, palette.mutedForeground)
-        installColorSlot(envPtr, ColorSlot.Accent, palette.accent)
-        installColorSlot(envPtr, ColorSlot.AccentForeground, palette.accentForeground)
-
-        // Install fonts
-        installFontSlot(envPtr, FontSlot.Body, fonts.body)
-        installFontSlot(envPtr, FontSlot.Title, fonts.title)
-        installFontSlot(envPtr, FontSlot.Headline, fonts.headline)
-        installFontSlot(envPtr, FontSlot.Subheadline, fonts.subheadline)
-        installFontSlot(envPtr, FontSlot.Caption, fonts.caption)
-        installFontSlot(envPtr, FontSlot.Footnote, fonts.footnote)
+    fun close() {
+        if (palettePtr == 0L) return
+        NativeBindings.waterui_theme_drop_palette(palettePtr)
+        palettePtr = 0L
     }
 
-    private fun installColorSlot(envPtr: Long, slot: ColorSlot, argb: Int) {
-        val signal = ReactiveColorSignal(argb)
-        NativeBindings.waterui_theme_install_color(envPtr, slot.value, signal.toComputed())
-        colorSignals[slot] = signal
-    }
+    private companion object {
+        val COLOR_SLOTS = intArrayOf(
+            ColorSlot.Background.value,
+            ColorSlot.Surface.value,
+            ColorSlot.SurfaceVariant.value,
+            ColorSlot.Border.value,
+            ColorSlot.Foreground.value,
+            ColorSlot.MutedForeground.value,
+            ColorSlot.Accent.value,
+            ColorSlot.AccentForeground.value
+        )
+
+        val FONT_SLOTS = intArrayOf(
+            FontSlot.Body.value,
+            FontSlot.Title.value,
+            FontSlot.Headline.value,
+            FontSlot.Subheadline.value,
+            FontSlot.Caption.value,
+            FontSlot.Footnote.value
+        )
+
+        // Same order as COLOR_SLOTS.
+        fun colorValues(palette: MaterialThemePalette) = intArrayOf(
+            palette.background,
+            palette.surface,
+            palette.surfaceVariant,
+            palette.border,
+            palette.foreground,
+            palette.mutedForeground,
+            palette.accent,
+            palette.accentForeground
+        )
+
+        // Same order as FONT_SLOTS.
+        private fun MaterialThemeFonts.all() =
+            arrayOf(body, title, headline, subheadline, caption, footnote)
+
+        fun fontSizes(fonts: MaterialThemeFonts): FloatArray =
+            fonts.all().map { it.sizeSp }.toFloatArray()
 
-    private fun installFontSlot(envPtr: Long, slot: FontSlot, font: MaterialThemeFont) {
-        val signal = ReactiveFontSignal(font.sizeSp, font.weight)
-        NativeBindings.waterui_theme_install_font(envPtr, slot.value, signal.toComputed())
-        fontSignals[slot] = signal
+        fun fontWeights(fonts: MaterialThemeFonts): IntArray =
+            fonts.all().map { it.weight }.toIntArray()
     }
 }
@@ -3,6 +3,8 @@ package dev.waterui.android.runtime
 import android.content.Context
 import android.view.View
 import android.widget.TextView
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
 
 /**
  * Tag key for storing stretch axis on inflated views.
@@ -23,10 +25,71 @@ fun inflateAnyView(
     pointer: Long,
     environment: WuiEnvironment,
     registry: RenderRegistry = RenderRegistry.default()
+): android.view.View = inflateAnyViews(context, longArrayOf(pointer), environment, registry)[0]
+
+/**
+ * Inflates several sibling `AnyView`s, e.g. a container's children.
+ *
+ * Composite views are expanded to the first type [registry] can render in
+ * native code, for all [pointers] in one JNI call, instead of a
+ * viewId / viewStretchAxis / viewBody round trip per node. Each resolved view
+ * is then created by its renderer, in order. Only this level is resolved in
+ * the call: renderers inflate their own children with another one, so a tree
+ * costs one call per container.
+ */
+fun inflateAnyViews(
+    context: Context,
+    pointers: LongArray,
+    environment: WuiEnvironment,
+    registry: RenderRegistry = RenderRegistry.default()
+): List<android.view.View> {
+    if (pointers.isEmpty()) return emptyList()
+    val resolved = ResolvedViews.resolve(pointers, environment, registry)
+        ?: return pointers.map { inflateByRoundTrips(context, it, environment, registry) }
+
+    // Records are copied out before any renderer runs: renderers inflate their
+    // own children and reuse this thread's buffer.
+    return List(pointers.size) { i ->
+        if (resolved.flags[i] and ResolvedViews.COMPONENT != 0) {
+            // A native component outside the type set, e.g. a deferred one
+            return@List inflateByRoundTrips(context, resolved.views[i], environment, registry)
+        }
+        val typeId = WuiTypeId(resolved.typeLow[i], resolved.typeHigh[i])
+        val renderer = if (resolved.flags[i] and ResolvedViews.RESOLVED != 0) {
+            registry.resolve(resolved.kinds[i], typeId)
+        } else {
+            null
+        }
+        if (renderer == null) {
+            MissingComponentView(context, typeId)
+        } else {
+            // Create the view (this consumes the pointer via force_as_* FFI functions)
+            val view = renderer.createView(context, WuiNode(resolved.views[i], typeId), environment, registry)
+            // Metadata types don't implement NativeView, they propagate stretch axis from content.
+            if (resolved.flags[i] and ResolvedViews.METADATA == 0) {
+                view.setTag(TAG_STRETCH_AXIS, StretchAxis.fromInt(resolved.stretchAxes[i]))
+            }
+            view
+        }
+    }
+}
+
+/**
+ * Per-node inflation, used when the registry's native type set is unavailable
+ * and for native components the set leaves out.
+ */
+private fun inflateByRoundTrips(
+    context: Context,
+    pointer: Long,
+    environment: WuiEnvironment,
+    registry: RenderRegistry
 ): android.view.View {
-    val typeId = NativeBindings.waterui_view_id(pointer).toTypeId()
+    // One call for the kind; the id is only fetched for types without one
+    val kind = NativeBindings.waterui_view_kind(pointer)
+    val typeId = registry.typeIdForKind(kind)
+        ?: NativeBindings.waterui_view_id(pointer).toTypeId()
     val node = WuiNode(pointer, typeId)
-    val renderer = registry.resolve(typeId)
+    val renderer = registry.resolve(kind, typeId)
 
     if (renderer != null) {
         // Get stretch axis BEFORE createView - the pointer is consumed/invalidated by createView!
@@ -50,12 +113,66 @@ fun inflateAnyView(
 
     val fallbackPtr = NativeBindings.waterui_view_body(pointer, environment.raw())
     if (fallbackPtr != 0L) {
-        return inflateAnyView(context, fallbackPtr, environment, registry)
+        return inflateByRoundTrips(context, fallbackPtr, environment, registry)
     }
 
     return MissingComponentView(context, typeId)
 }
 
+/**
+ * Decoded native walker records; see resolveViews in waterui_jni.cpp.
+ */
+private class ResolvedViews(count: Int) {
+    val views = LongArray(count)
+    val typeLow = LongArray(count)
+    val typeHigh = LongArray(count)
+    val stretchAxes = IntArray(count)
+    val flags = IntArray(count)
+    val kinds = IntArray(count)
+
+    companion object {
+        private const val RECORD_SIZE = 40
+        private const val INITIAL_CAPACITY = 16 * RECORD_SIZE
+
+        // Record flags, mirroring kViewRecord* in waterui_jni.cpp.
+        const val RESOLVED = 1
+        const val METADATA = 2
+        const val COMPONENT = 4
+
+        private val scratch = object : ThreadLocal<ByteBuffer>() {
+            override fun initialValue(): ByteBuffer =
+                ByteBuffer.allocateDirect(INITIAL_CAPACITY).order(ByteOrder.nativeOrder())
+        }
+
+        /** Returns null, having consumed nothing, if the walker could not run. */
+        fun resolve(pointers: LongArray, environment: WuiEnvironment, registry: RenderRegistry): ResolvedViews? {
+            val typeSet = registry.nativeTypeSet
+            if (typeSet == 0L) return null
+            val needed = pointers.size * RECORD_SIZE
+            var buffer = scratch.get()!!
+            if (buffer.capacity() < needed) {
+                buffer = ByteBuffer.allocateDirect(Integer.highestOneBit(needed) shl 1)
+                    .order(ByteOrder.nativeOrder())
+                scratch.set(buffer)
+            }
+            val written = NativeBindings.waterui_resolve_views(typeSet, pointers, environment.raw(), buffer)
+            if (written < 0) return null
+
+            val result = ResolvedViews(pointers.size)
+            for (i in 0 until written) {
+                val offset = i * RECORD_SIZE
+                result.views[i] = buffer.getLong(offset)
+                result.typeLow[i] = buffer.getLong(offset + 8)
+                result.typeHigh[i] = buffer.getLong(offset + 16)
+                result.stretchAxes[i] = buffer.getInt(offset + 24)
+                result.flags[i] = buffer.getInt(offset + 28)
+                result.kinds[i] = buffer.getInt(offset + 32)
+            }
+            return result
+        }
+    }
+}
+
 /**
  * Gets the stretch axis stored on a view during inflation.
  * Returns NONE if the view wasn't inflated by WaterUI or is missing the tag.
@@ -0,0 +1,94 @@
+package dev.waterui.android.runtime
+
+import org.junit.Test
+import org.junit.Assert.*
+
+class KeyedDiffTest {
+    private class RecordingListener : KeyedDiffListener {
+        val events = mutableListOf<String>()
+        override fun onRemoved(position: Int, count: Int) { events += "remove $position $count" }
+        override fun onInserted(position: Int, count: Int) { events += "insert $position $count" }
+        override fun onMoved(from: Int, to: Int) { events += "move $from $to" }
+        override fun onUpdated(position: Int, count: Int) { events += "update $position $count" }
+        override fun onReloaded(count: Int) { events += "reload $count" }
+    }
+
+    private fun ops(vararg values: Int) = values
+
+    @Test
+    fun insertAddsPayloadAtFinalIndex() {
+        val list = mutableListOf("a", "d")
+        val target = listOf("a", "b", "c", "d")
+        val listener = RecordingListener()
+        list.applyKeyedDiff(ops(DiffOp.INSERT, 1, 2), payload = { target[it] }, listener = listener)
+        assertEquals(target, list)
+        assertEquals(listOf("insert 1 2"), listener.events)
+    }
+
+    @Test
+    fun removeDiscardsRemovedItems() {
+        val list = mutableListOf("a", "b", "c", "d")
+        val discarded = mutableListOf<String>()
+        list.applyKeyedDiff(ops(DiffOp.REMOVE, 1, 2), payload = { error("no payload expected") }, discard = { discarded += it })
+        assertEquals(listOf("a", "d"), list)
+        assertEquals(listOf("b", "c"), discarded)
+    }
+
+    @Test
+    fun moveKeepsTheItem() {
+        val list = mutableListOf("a", "b", "c", "d")
+        val listener = RecordingListener()
+        list.applyKeyedDiff(ops(DiffOp.MOVE, 0, 3), payload = { error("no payload expected") }, listener = listener)
+        assertEquals(listOf("b", "c", "d", "a"), list)
+        assertEquals(listOf("move 0 3"), listener.events)
+    }
+
+    @Test
+    fun updateReplacesItemsInPlace() {
+        val list = mutableListOf("a", "b", "c")
+        val target = listOf("a", "B", "C")
+        val discarded = mutableListOf<String>()
+        list.applyKeyedDiff(ops(DiffOp.UPDATE, 1, 2), payload = { target[it] }, discard = { discarded += it })
+        assertEquals(target, list)
+        assertEquals(listOf("b", "c"), discarded)
+    }
+
+    @Test
+    fun reloadReplacesEverything() {
+        val list = mutableListOf("a", "b")
+        val target = listOf("x", "y", "z")
+        val discarded = mutableListOf<String>()
+        val listener = RecordingListener()
+        list.applyKeyedDiff(
+            ops(DiffOp.RELOAD, 0, 3),
+            payload = { target[it] },
+            discard = { discarded += it },
+            listener = listener
+        )
+        assertEquals(target, list)
+        assertEquals(listOf("a", "b"), discarded)
+        assertEquals(listOf("reload 3"), listener.events)
+    }
+
+    @Test
+    fun payloadPositionsAreFinalIndices() {
+        // [a, b, c, d] -> [d, a, x, c'], as the bridge encodes it: removes first,
+        // then moves, then inserts and updates at their final indices.
+        val list = mutableListOf("a", "b", "c", "d")
+        val target = listOf("d", "a", "x", "c'")
+        val requested = mutableListOf<Int>()
+        val diff = ops(
+            DiffOp.REMOVE, 1, 1,
+            DiffOp.MOVE, 2, 0,
+            DiffOp.INSERT, 2, 1,
+            DiffOp.UPDATE, 3, 1
+        )
+        list.applyKeyedDiff(diff, payload = { requested += it; target[it] })
+        assertEquals(target, list)
+        assertEquals(listOf(2, 3), requested)
+        assertArrayEquals(
+            booleanArrayOf(false, false, true, true),
+            keyedDiffPayloadMask(diff, target.size)
+        )
+    }
+}